@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstddef>
+
+// Counts heap allocations made through global operator new on the calling
+// thread. The replacement operators live in alloc_counter.cpp and are linked
+// into the whole benchmark binary; they only bump a thread_local counter, so
+// every other benchmark is unaffected apart from one increment per allocation.
+namespace bench {
+
+std::size_t allocationCount() noexcept;
+
+// Allocation delta over a scope: construct before the measured region and
+// read count() after it
+class AllocationScope {
+public:
+    AllocationScope() noexcept : start_(allocationCount()) {}
+    std::size_t count() const noexcept { return allocationCount() - start_; }
+
+private:
+    std::size_t start_;
+};
+
+} // namespace bench
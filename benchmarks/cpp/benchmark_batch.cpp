@@ -0,0 +1,125 @@
+#include "orderbook/oms/instrument_manager.hpp"
+#include "orderbook/net/request_handler.hpp"
+#include "orderbook/core/types.hpp"
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace ob;
+using namespace ob::core;
+
+namespace {
+
+constexpr std::size_t QUOTE_BURST = 1024; // quotes per iteration, within the event queue
+
+// Both sides at one price, so every other quote trades and the book stays small
+Order quote(OrderId id, std::uint32_t symbolId, std::size_t i) {
+    return Order{id, symbolId, (i & 1) ? Side::Sell : Side::Buy, OrderType::Limit, 100, 10, {}};
+}
+
+// An InstrumentManager with one instrument that counts acks
+struct AckedManager {
+    oms::InstrumentManager manager;
+    std::uint32_t symbolId{0};
+    std::atomic<std::size_t> acks{0};
+
+    AckedManager() {
+        symbolId = manager.addInstrument("BATCH", "", "", 100.0);
+        manager.setEventCallback([this](const events::Event& event) {
+            if (event.type == events::EventType::Ack) acks.fetch_add(1, std::memory_order_relaxed);
+        });
+    }
+    ~AckedManager() { manager.stop(); }
+
+    void drain(std::size_t expected) {
+        while (acks.load(std::memory_order_relaxed) < expected) {
+            manager.processEvents();
+            std::this_thread::yield();
+        }
+        acks.store(0, std::memory_order_relaxed);
+    }
+};
+
+} // namespace
+
+// Quote entry through IOrderBookService: each iteration submits QUOTE_BURST
+// quotes and waits until all are acknowledged, so real time is bounded by
+// the matching thread and CPU time is what entry costs the client thread.
+// Arg batch: quotes per call, 1 = submitOrder per quote, otherwise
+// submitOrders runs of that size.
+static void BM_Batch_Service(benchmark::State& state) {
+    const auto batch = static_cast<std::size_t>(state.range(0));
+    AckedManager book;
+    std::vector<Order> orders(batch);
+    std::unique_ptr<bool[]> queued(new bool[batch]);
+    OrderId orderId = 1;
+
+    for (auto _ : state) {
+        for (std::size_t sent = 0; sent < QUOTE_BURST; sent += batch) {
+            if (batch == 1) {
+                const Order order = quote(orderId++, book.symbolId, sent);
+                while (!book.manager.submitOrder(order)) std::this_thread::yield();
+                continue;
+            }
+            for (std::size_t i = 0; i < batch; ++i) orders[i] = quote(orderId++, book.symbolId, sent + i);
+            std::span<const Order> pending(orders);
+            while (!pending.empty()) {
+                const std::size_t n = book.manager.submitOrders(pending, std::span<bool>(queued.get(), batch));
+                pending = pending.subspan(n); // queued orders are always a prefix
+                if (!pending.empty()) std::this_thread::yield();
+            }
+        }
+        book.drain(QUOTE_BURST);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(QUOTE_BURST));
+}
+
+BENCHMARK(BM_Batch_Service)
+    ->Name("Batch_Service")
+    ->ArgNames({"batch"})
+    ->Arg(1)
+    ->Arg(16)
+    ->Arg(64)
+    ->UseRealTime();
+
+// The same through the text protocol handler, parsing included: ADD lines
+// (batch 1) against BATCH lines of that many quotes
+static void BM_Batch_Text(benchmark::State& state) {
+    const auto batch = static_cast<std::size_t>(state.range(0));
+    AckedManager book;
+    net::RequestHandler handler(book.manager);
+    const std::string symbol = std::to_string(book.symbolId);
+    const std::string buy = symbol + " B L 100 10";
+    const std::string sell = symbol + " S L 100 10";
+    const std::string single[2] = {"ADD " + buy, "ADD " + sell};
+    std::string request = "BATCH ";
+    for (std::size_t i = 0; i < batch; ++i) request += (i ? ";" : "") + ((i & 1) ? sell : buy);
+
+    std::size_t refused = 0;
+    for (auto _ : state) {
+        std::size_t accepted = 0;
+        for (std::size_t sent = 0; sent < QUOTE_BURST; sent += batch) {
+            const std::string reply = handler.handleText(batch == 1 ? single[sent & 1] : request);
+            for (std::size_t at = reply.find("OK "); at != std::string::npos; at = reply.find("OK ", at + 3)) ++accepted;
+        }
+        refused += QUOTE_BURST - accepted; // queue full: only accepted quotes are acked
+        book.drain(accepted);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(QUOTE_BURST));
+    state.counters["refused"] = static_cast<double>(refused);
+}
+
+BENCHMARK(BM_Batch_Text)
+    ->Name("Batch_Text")
+    ->ArgNames({"batch"})
+    ->Arg(1)
+    ->Arg(16)
+    ->Arg(64)
+    ->UseRealTime();
+
+// BENCHMARK_MAIN(); // Defined in benchmark_orderbook.cpp
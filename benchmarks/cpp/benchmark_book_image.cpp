@@ -0,0 +1,181 @@
+#include "orderbook/book/book_image.hpp"
+#include "orderbook/book/order_book.hpp"
+#include "orderbook/book/ladder_order_book.hpp"
+#include "orderbook/engine/matching_engine.hpp"
+#include "orderbook/replay/order_flow.hpp"
+#include "orderbook/core/command.hpp"
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace ob;
+using namespace ob::core;
+
+namespace {
+
+constexpr std::size_t IMAGE_FLOW_COMMANDS = 200'000;
+constexpr std::size_t IMAGE_BATCH = 64;      // commands applied between publishes
+constexpr std::uint32_t IMAGE_SYMBOL = 1;
+
+const replay::OrderFlow& imageFlow() {
+    static const replay::OrderFlow flow = [] {
+        replay::FlowConfig config;
+        config.commands = IMAGE_FLOW_COMMANDS;
+        return replay::generateFlow(config);
+    }();
+    return flow;
+}
+
+std::shared_ptr<book::IOrderBook> makeBook(std::int64_t kind, Price referencePrice) {
+    if (kind == 1) return std::make_shared<book::LadderOrderBook>(referencePrice, DEFAULT_LADDER_LEVELS);
+    return std::make_shared<book::OrderBook>();
+}
+
+Command flowCommand(const replay::FlowRecord& record) noexcept {
+    Command command = journal::toCommand(record);
+    command.symbolId = IMAGE_SYMBOL;
+    return command;
+}
+
+// Applies the clustered flow in IMAGE_BATCH-command batches and publishes
+// into image after each, starting over on a fresh book when the flow runs
+// out, until stopped: the matching thread of a busy instrument
+class MatchingLoad {
+public:
+    MatchingLoad(book::PublishedBook& image, std::int64_t bookKind)
+        : thread_([this, &image, bookKind] { run(image, bookKind); }) {}
+
+    ~MatchingLoad() {
+        running_.store(false, std::memory_order_relaxed);
+        thread_.join();
+    }
+
+    std::uint64_t commands() const noexcept { return commands_.load(std::memory_order_relaxed); }
+
+private:
+    void run(book::PublishedBook& image, std::int64_t bookKind) {
+        const replay::OrderFlow& flow = imageFlow();
+        while (running_.load(std::memory_order_relaxed)) {
+            auto orderBook = makeBook(bookKind, flow.referencePrice);
+            engine::MatchingEngine engine(orderBook, nullptr, IMAGE_SYMBOL);
+            for (std::size_t i = 0; i < flow.records.size() && running_.load(std::memory_order_relaxed);) {
+                const std::size_t end = std::min(i + IMAGE_BATCH, flow.records.size());
+                for (; i < end; ++i) engine.apply(flowCommand(flow.records[i]));
+                image.publish(*orderBook);
+                commands_.fetch_add(IMAGE_BATCH, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    std::atomic<bool> running_{true};
+    std::atomic<std::uint64_t> commands_{0};
+    std::thread thread_; // last: started once the flags above exist
+};
+
+template <typename Read>
+std::uint64_t readUntil(const std::atomic<bool>& stop, Read&& read) {
+    std::uint64_t reads = 0;
+    while (!stop.load(std::memory_order_relaxed)) {
+        read();
+        ++reads;
+    }
+    return reads;
+}
+
+} // namespace
+
+// Reader throughput against a matching thread that keeps publishing. The
+// benchmark thread reads in the timed loop; Arg readers - 1 more threads
+// read flat out alongside it. Arg read: 0 = top(), 1 = read() of 10
+// levels per side. Arg book: 0 = map, 1 = ladder. reads/s counts every
+// reader; matchCmds/s is what the matching thread applied meanwhile, so
+// it shows whether readers slow the writer down. On a machine with fewer
+// cores than threads the numbers mostly measure the scheduler.
+static void BM_BookImage_Readers(benchmark::State& state) {
+    const auto readers = static_cast<std::size_t>(state.range(0));
+    const bool levels = state.range(1) == 1;
+    book::PublishedBook image;
+    MatchingLoad load(image, state.range(2));
+
+    auto readOnce = [&image, levels](book::BookImage& out) {
+        if (levels) {
+            image.read(out, 10);
+            benchmark::DoNotOptimize(out.bidCount);
+        } else {
+            const book::TopOfBook top = image.top();
+            benchmark::DoNotOptimize(top);
+        }
+    };
+
+    std::atomic<bool> stop{false};
+    std::vector<std::uint64_t> helperReads(readers - 1, 0);
+    std::vector<std::thread> helpers;
+    for (std::size_t i = 0; i + 1 < readers; ++i) {
+        helpers.emplace_back([&, i] {
+            book::BookImage out;
+            helperReads[i] = readUntil(stop, [&] { readOnce(out); });
+        });
+    }
+
+    const std::uint64_t startCommands = load.commands();
+    const auto start = std::chrono::steady_clock::now();
+    book::BookImage out;
+    for (auto _ : state) {
+        readOnce(out);
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    const std::uint64_t matched = load.commands() - startCommands;
+    stop.store(true, std::memory_order_relaxed);
+    for (auto& helper : helpers) helper.join();
+
+    std::uint64_t reads = static_cast<std::uint64_t>(state.iterations());
+    for (const std::uint64_t n : helperReads) reads += n;
+    state.counters["reads/s"] = seconds > 0 ? static_cast<double>(reads) / seconds : 0.0;
+    state.counters["matchCmds/s"] = seconds > 0 ? static_cast<double>(matched) / seconds : 0.0;
+    state.counters["version"] = static_cast<double>(image.top().version);
+}
+
+BENCHMARK(BM_BookImage_Readers)
+    ->Name("BookImage_Readers")
+    ->ArgNames({"readers", "read", "book"})
+    ->ArgsProduct({{1, 2, 4}, {0, 1}, {0, 1}})
+    ->UseRealTime()
+    ->MinTime(0.5);
+
+// What publishing costs the matching thread: one IMAGE_BATCH-command batch
+// of the clustered flow per iteration, applied and then, with Arg publish 1,
+// published as the processors do. Arg book: 0 = map, 1 = ladder.
+static void BM_BookImage_Publish(benchmark::State& state) {
+    const replay::OrderFlow& flow = imageFlow();
+    const bool publish = state.range(0) == 1;
+    std::shared_ptr<book::IOrderBook> orderBook;
+    std::unique_ptr<engine::MatchingEngine> engine;
+    std::size_t next = flow.records.size();
+
+    for (auto _ : state) {
+        if (next + IMAGE_BATCH > flow.records.size()) {
+            state.PauseTiming();
+            orderBook = makeBook(state.range(1), flow.referencePrice);
+            engine = std::make_unique<engine::MatchingEngine>(orderBook, nullptr, IMAGE_SYMBOL);
+            next = 0;
+            state.ResumeTiming();
+        }
+        for (const std::size_t end = next + IMAGE_BATCH; next < end; ++next) {
+            engine->apply(flowCommand(flow.records[next]));
+        }
+        if (publish) engine->publishImage();
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(IMAGE_BATCH));
+    state.counters["batch"] = static_cast<double>(IMAGE_BATCH);
+}
+
+BENCHMARK(BM_BookImage_Publish)
+    ->Name("BookImage_Publish")
+    ->ArgNames({"publish", "book"})
+    ->ArgsProduct({{0, 1}, {0, 1}});
+
+// BENCHMARK_MAIN(); // Defined in benchmark_orderbook.cpp
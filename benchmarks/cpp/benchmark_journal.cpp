@@ -0,0 +1,228 @@
+#include "orderbook/journal/journal_writer.hpp"
+#include "orderbook/journal/journal_reader.hpp"
+#include "orderbook/oms/instrument_manager.hpp"
+#include "orderbook/engine/matching_engine.hpp"
+#include "orderbook/book/order_book.hpp"
+#include "orderbook/core/command.hpp"
+#include "orderbook/core/types.hpp"
+#include <benchmark/benchmark.h>
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+using namespace ob;
+using namespace ob::core;
+
+namespace {
+
+constexpr std::uint32_t JOURNAL_SYMBOL = 1;
+constexpr Price JOURNAL_MID = 10000;
+constexpr std::size_t JOURNAL_BATCH = 64; // one processor wakeup (DEFAULT_PROCESS_BATCH)
+
+// Journal directory under the system temp dir, removed again afterwards
+struct ScratchDir {
+    std::filesystem::path path;
+    explicit ScratchDir(const std::string& name)
+        : path(std::filesystem::temp_directory_path() / (name + "-" + std::to_string(::getpid()))) {
+        std::filesystem::remove_all(path);
+    }
+    ~ScratchDir() {
+        std::error_code ec;
+        std::filesystem::remove_all(path, ec);
+    }
+};
+
+// Order flow for one symbol: 60% limit orders in a band around the mid
+// (about a third of them cross), 25% cancels and 15% amends of earlier ids
+std::vector<Command> makeFlow(std::size_t count, std::uint32_t seed = 42) {
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<int> kind(0, 99);
+    std::uniform_int_distribution<Price> offset(-20, 40);
+    std::uniform_int_distribution<Quantity> qty(1, 100);
+    std::vector<Command> flow;
+    flow.reserve(count);
+    OrderId nextId = 1;
+    for (std::size_t i = 0; i < count; ++i) {
+        const int k = kind(gen);
+        if (k < 60 || nextId < 16) {
+            const Side side = (gen() & 1) ? Side::Buy : Side::Sell;
+            const Price price = side == Side::Buy ? JOURNAL_MID - offset(gen) : JOURNAL_MID + offset(gen);
+            Order order{nextId++, JOURNAL_SYMBOL, side, OrderType::Limit, price, qty(gen), {}};
+            flow.push_back(Command::newOrder(order));
+        } else {
+            std::uniform_int_distribution<OrderId> earlier(nextId > 2000 ? nextId - 2000 : 1, nextId - 1);
+            if (k < 85) {
+                flow.push_back(Command::cancel(JOURNAL_SYMBOL, earlier(gen)));
+            } else {
+                flow.push_back(Command::amend(JOURNAL_SYMBOL, earlier(gen), JOURNAL_MID + offset(gen), qty(gen)));
+            }
+        }
+    }
+    return flow;
+}
+
+journal::InstrumentEntry benchInstrument() {
+    journal::InstrumentEntry entry;
+    entry.symbolId = JOURNAL_SYMBOL;
+    entry.ticker = "JRNL";
+    entry.description = "journal benchmark";
+    entry.industry = "bench";
+    entry.initialPrice = static_cast<double>(JOURNAL_MID);
+    entry.waitStrategy = static_cast<std::uint8_t>(queue::WaitStrategyType::SpinPark);
+    return entry;
+}
+
+// Journal with the instrument and count commands of flow, ready to replay
+void writeJournal(const std::filesystem::path& dir, std::size_t count) {
+    journal::JournalConfig config;
+    config.directory = dir.string();
+    journal::JournalWriter writer(config);
+    writer.start();
+    writer.appendInstrumentAdded(benchInstrument());
+    const auto flow = makeFlow(count);
+    for (std::size_t i = 0; i < flow.size(); i += JOURNAL_BATCH) {
+        writer.append(flow.data() + i, std::min(JOURNAL_BATCH, flow.size() - i));
+    }
+    writer.stop();
+}
+
+} // namespace
+
+// What a matching thread pays per order for journaling: one processor batch
+// is appended (or not) and then applied to the book. Arg 0 runs without a
+// journal; 1 journals with FsyncPolicy::None, 2 with EveryCommit.
+static void BM_Journal_ApplyBatch(benchmark::State& state) {
+    const int mode = static_cast<int>(state.range(0));
+    ScratchDir dir("ob-bench-journal-apply");
+    std::unique_ptr<journal::JournalWriter> writer;
+    if (mode != 0) {
+        journal::JournalConfig config;
+        config.directory = dir.path.string();
+        config.fsync = mode == 2 ? journal::FsyncPolicy::EveryCommit : journal::FsyncPolicy::None;
+        writer = std::make_unique<journal::JournalWriter>(config);
+        writer->start();
+    }
+
+    auto book = std::make_shared<book::OrderBook>();
+    engine::MatchingEngine engine(book, nullptr, JOURNAL_SYMBOL);
+    const auto flow = makeFlow(1 << 20);
+    std::size_t next = 0;
+
+    for (auto _ : state) {
+        const Command* batch = flow.data() + next;
+        if (writer) writer->append(batch, JOURNAL_BATCH);
+        for (std::size_t i = 0; i < JOURNAL_BATCH; ++i) {
+            engine.apply(batch[i]);
+        }
+        next = (next + JOURNAL_BATCH) % flow.size();
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(JOURNAL_BATCH));
+    if (writer) {
+        writer->flush();
+        const auto stats = writer->stats();
+        state.counters["stalls"] = static_cast<double>(stats.stalls);
+        state.counters["cmds/commit"] = stats.commits ? static_cast<double>(stats.commands) / stats.commits : 0.0;
+        state.counters["syncs"] = static_cast<double>(stats.syncs);
+        writer->stop();
+    }
+}
+
+// append() alone, on the producer side: the ring copy, plus any waiting
+// for room when the writer falls behind (counted as stalls)
+static void BM_Journal_Append(benchmark::State& state) {
+    ScratchDir dir("ob-bench-journal-append");
+    journal::JournalConfig config;
+    config.directory = dir.path.string();
+    journal::JournalWriter writer(config);
+    writer.start();
+    const auto flow = makeFlow(1 << 16);
+    std::size_t next = 0;
+
+    for (auto _ : state) {
+        writer.append(flow.data() + next, JOURNAL_BATCH);
+        next = (next + JOURNAL_BATCH) % flow.size();
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(JOURNAL_BATCH));
+    writer.flush();
+    state.counters["stalls"] = static_cast<double>(writer.stats().stalls);
+    writer.stop();
+}
+
+// Startup recovery: InstrumentManager::openJournal rebuilding one book from
+// state.range(0) journaled commands. Timed from the recovery's own clock.
+static void BM_Journal_Replay(benchmark::State& state) {
+    const auto count = static_cast<std::size_t>(state.range(0));
+    ScratchDir dir("ob-bench-journal-replay");
+    writeJournal(dir.path, count);
+
+    journal::JournalConfig config;
+    config.directory = dir.path.string();
+    std::uint64_t commands = 0;
+    double seconds = 0.0;
+    for (auto _ : state) {
+        oms::InstrumentManager manager;
+        const auto recovered = manager.openJournal(config);
+        if (!recovered || recovered->commands != count) {
+            state.SkipWithError("replay did not recover the journal");
+            break;
+        }
+        const double elapsed = std::chrono::duration<double>(recovered->elapsed).count();
+        state.SetIterationTime(elapsed);
+        seconds += elapsed;
+        commands += recovered->commands;
+        benchmark::DoNotOptimize(manager.getBestBid(JOURNAL_SYMBOL));
+    }
+
+    state.SetItemsProcessed(static_cast<std::int64_t>(commands));
+    state.counters["orders/s"] = seconds > 0 ? static_cast<double>(commands) / seconds : 0.0;
+}
+
+// Reading alone: segment scan, checksum and decode of state.range(0) commands
+static void BM_Journal_Read(benchmark::State& state) {
+    const auto count = static_cast<std::size_t>(state.range(0));
+    ScratchDir dir("ob-bench-journal-read");
+    writeJournal(dir.path, count);
+
+    std::uint64_t records = 0;
+    for (auto _ : state) {
+        journal::JournalReader reader(dir.path.string());
+        journal::JournalRecord record;
+        while (reader.next(record)) {
+            benchmark::DoNotOptimize(record.command.orderId);
+            ++records;
+        }
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(records));
+}
+
+BENCHMARK(BM_Journal_ApplyBatch)
+    ->Name("Journal_ApplyBatch")
+    ->ArgName("mode")
+    ->Arg(0)
+    ->Arg(1)
+    ->Arg(2)
+    ->UseRealTime();
+
+BENCHMARK(BM_Journal_Append)
+    ->Name("Journal_Append");
+
+BENCHMARK(BM_Journal_Replay)
+    ->Name("Journal_Replay")
+    ->Arg(1 << 20)
+    ->UseManualTime()
+    ->Unit(benchmark::kMillisecond)
+    ->Iterations(3);
+
+BENCHMARK(BM_Journal_Read)
+    ->Name("Journal_Read")
+    ->Arg(1 << 20)
+    ->Unit(benchmark::kMillisecond)
+    ->Iterations(3);
+
+// BENCHMARK_MAIN(); // Defined in benchmark_orderbook.cpp
@@ -1,4 +1,5 @@
 #include "orderbook/book/order_book.hpp"
+#include "orderbook/book/ladder_order_book.hpp"
 #include "orderbook/engine/matching_engine.hpp"
 #include "orderbook/oms/order_management_system.hpp"
 #include "orderbook/core/types.hpp"
@@ -10,6 +11,10 @@
 #include <thread>
 #include <atomic>
 #include <chrono>
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <type_traits>
 
 using namespace ob::book;
 using namespace ob::core;
@@ -62,7 +67,7 @@ static void BM_LoadTest_HighFrequencyOrders(benchmark::State& state) {
             }
         }
         
-        benchmark::DoNotOptimize(book);
+        benchmark::ClobberMemory(); // keep book updates observable
     }
     
     state.SetItemsProcessed(state.iterations() * BATCH_SIZE);
@@ -152,6 +157,78 @@ static void BM_LoadTest_LargeOrderBook(benchmark::State& state) {
     state.SetItemsProcessed(state.iterations());
 }
 
+// Load test: cancel-heavy market-maker flow. A fixed population of quotes
+// rests in a narrow band so levels are deep; every iteration cancels a
+// random resting quote (usually mid-queue) and replaces it with a new one.
+constexpr Price MM_CENTER = 15000;
+constexpr Price MM_BAND = 10;
+
+template <typename Book>
+static std::unique_ptr<Book> makeLoadBook() {
+    if constexpr (std::is_same_v<Book, LadderOrderBook>) {
+        return std::make_unique<LadderOrderBook>(MM_CENTER);
+    } else {
+        return std::make_unique<Book>();
+    }
+}
+
+static Order generateQuote(OrderId id, std::mt19937& gen) {
+    std::uniform_int_distribution<Price> offsetDist(1, MM_BAND);
+    std::uniform_int_distribution<Quantity> qtyDist(1, 1000);
+    std::uniform_int_distribution<int> sideDist(0, 1);
+    
+    Side side = (sideDist(gen) == 0) ? Side::Buy : Side::Sell;
+    Price price = (side == Side::Buy) ? MM_CENTER - offsetDist(gen) : MM_CENTER + offsetDist(gen);
+    
+    auto now = std::chrono::steady_clock::now();
+    auto nowNs = std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch());
+    
+    return Order{id, 1, side, OrderType::Limit, price, qtyDist(gen), Timestamp{nowNs}};
+}
+
+template <typename Book>
+static void BM_LoadTest_CancelHeavy(benchmark::State& state) {
+    auto book = makeLoadBook<Book>();
+    std::mt19937 gen(42);
+    const auto restingOrders = static_cast<std::size_t>(state.range(0));
+    
+    std::vector<OrderId> live;
+    live.reserve(restingOrders);
+    OrderId orderId = 1;
+    for (std::size_t i = 0; i < restingOrders; ++i) {
+        book->addOrder(generateQuote(orderId, gen));
+        live.push_back(orderId++);
+    }
+    
+    std::uniform_int_distribution<std::size_t> pickDist(0, restingOrders - 1);
+    std::vector<double> latencies;
+    latencies.reserve(static_cast<std::size_t>(state.max_iterations));
+    
+    for (auto _ : state) {
+        const std::size_t slot = pickDist(gen);
+        Order replacement = generateQuote(orderId, gen);
+        
+        auto start = std::chrono::steady_clock::now();
+        bool cancelled = book->cancelOrder(live[slot]);
+        book->addOrder(std::move(replacement));
+        auto end = std::chrono::steady_clock::now();
+        
+        live[slot] = orderId++;
+        latencies.push_back(static_cast<double>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()));
+        benchmark::DoNotOptimize(cancelled);
+    }
+    
+    if (!latencies.empty()) {
+        std::sort(latencies.begin(), latencies.end());
+        state.counters["CancelReplace_P50_ns"] = latencies[latencies.size() / 2];
+        state.counters["CancelReplace_P99_ns"] = latencies[static_cast<std::size_t>(static_cast<double>(latencies.size()) * 0.99)];
+        state.counters["CancelReplace_Max_ns"] = latencies.back();
+    }
+    state.counters["OrdersPerLevel"] = static_cast<double>(restingOrders) / static_cast<double>(2 * MM_BAND);
+    state.SetItemsProcessed(state.iterations() * 2);
+}
+
 // Register load test benchmarks
 BENCHMARK(BM_LoadTest_HighFrequencyOrders)
     ->Name("LoadTest_HighFrequencyOrders")
@@ -168,5 +245,19 @@ BENCHMARK(BM_LoadTest_LargeOrderBook)
     ->UseRealTime()
     ->Iterations(10000);
 
+BENCHMARK_TEMPLATE(BM_LoadTest_CancelHeavy, OrderBook)
+    ->Name("LoadTest_CancelHeavy/Map")
+    ->Arg(1000)
+    ->Arg(20000)
+    ->UseRealTime()
+    ->Iterations(200000);
+
+BENCHMARK_TEMPLATE(BM_LoadTest_CancelHeavy, LadderOrderBook)
+    ->Name("LoadTest_CancelHeavy/Ladder")
+    ->Arg(1000)
+    ->Arg(20000)
+    ->UseRealTime()
+    ->Iterations(200000);
+
 // BENCHMARK_MAIN(); // Defined in benchmark_orderbook.cpp
 
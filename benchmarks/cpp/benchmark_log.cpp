@@ -0,0 +1,80 @@
+#include "orderbook/core/async_log.hpp"
+#include "orderbook/core/types.hpp"
+#include <benchmark/benchmark.h>
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+using namespace ob;
+using namespace ob::core;
+
+namespace {
+
+constexpr const char* TRADE_FORMAT = "TRADE maker={} taker={} px={} qty={}";
+constexpr const char* LOG_BENCH_FILE = "/tmp/ob_benchmark_log.bin";
+
+Trade tradeAt(std::uint64_t i) noexcept {
+    return Trade{i, i + 1, static_cast<Price>(10'000 + (i & 63)), static_cast<Quantity>(1 + (i & 7)), {}};
+}
+
+} // namespace
+
+// What one TRADE log line costs the matching thread. Arg sink: 0 = an
+// OB_LOG record for the background writer (binary file), 1 = the former
+// OB_LOG, a formatted << chain ending in std::endl (into /dev/null, so the
+// terminal is left out and the number is a lower bound). dropped counts
+// records that found the ring full because the writer fell behind.
+static void BM_Log_Call(benchmark::State& state) {
+    const bool stream = state.range(0) == 1;
+    std::ofstream devNull("/dev/null");
+    AsyncLog::open(LogConfig{LOG_BENCH_FILE});
+    const std::uint32_t site = registerLogSite<OrderId, OrderId, Price, Quantity>(TRADE_FORMAT);
+    const std::uint64_t droppedBefore = AsyncLog::dropped();
+
+    std::uint64_t i = 0;
+    for (auto _ : state) {
+        const Trade t = tradeAt(i++);
+        if (stream) {
+            devNull << nowNs() << " | " << "TRADE maker=" << t.makerId << " taker=" << t.takerId << " px=" << t.price
+                    << " qty=" << t.quantity << std::endl;
+        } else {
+            logRecord(site, t.makerId, t.takerId, t.price, t.quantity);
+        }
+    }
+
+    AsyncLog::flush();
+    state.SetItemsProcessed(state.iterations());
+    state.counters["dropped"] = static_cast<double>(AsyncLog::dropped() - droppedBefore);
+    AsyncLog::open(LogConfig{});
+    std::remove(LOG_BENCH_FILE);
+}
+
+BENCHMARK(BM_Log_Call)
+    ->Name("Log_Call")
+    ->ArgNames({"sink"})
+    ->Arg(0)
+    ->Arg(1);
+
+// The writer thread's share: formatting one TRADE record into a line
+static void BM_Log_Format(benchmark::State& state) {
+    const LogSite site{TRADE_FORMAT, 4, {LogArg::UInt, LogArg::UInt, LogArg::Int, LogArg::Int}};
+    std::string out;
+    std::uint64_t i = 0;
+    for (auto _ : state) {
+        const Trade t = tradeAt(i++);
+        LogRecord record;
+        record.ts = nowNs();
+        record.args[0] = t.makerId;
+        record.args[1] = t.takerId;
+        record.args[2] = static_cast<std::uint64_t>(t.price);
+        record.args[3] = static_cast<std::uint64_t>(t.quantity);
+        out.clear();
+        formatLogRecord(site, record, out);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_Log_Format)->Name("Log_Format");
+
+// BENCHMARK_MAIN(); // Defined in benchmark_orderbook.cpp
@@ -1,8 +1,10 @@
 #include "orderbook/engine/matching_engine.hpp"
 #include "orderbook/book/order_book.hpp"
+#include "orderbook/book/ladder_order_book.hpp"
 #include "orderbook/core/types.hpp"
 #include "orderbook/events/event_publisher.hpp"
 #include "orderbook/events/event_types.hpp"
+#include "alloc_counter.hpp"
 #include <benchmark/benchmark.h>
 #include <random>
 #include <vector>
@@ -10,6 +12,7 @@
 #include <algorithm>
 #include <chrono>
 #include <cmath>
+#include <type_traits>
 
 using namespace ob::engine;
 using namespace ob::core;
@@ -173,6 +176,277 @@ static void BM_MatchingEngine_PartialFill(benchmark::State& state) {
     state.SetItemsProcessed(state.iterations());
 }
 
+// Head-to-head: map book vs ladder book under narrow-band crossing flow.
+// Both sides rest within +/- BAND_WIDTH ticks of BAND_CENTER; each iteration
+// sends an aggressive order a few ticks through the touch and then re-quotes
+// the consumed side so book depth stays roughly constant.
+constexpr Price BAND_CENTER = 15000;
+constexpr Price BAND_WIDTH = 50;
+
+template <typename Book>
+static std::shared_ptr<Book> makeBook() {
+    if constexpr (std::is_same_v<Book, LadderOrderBook>) {
+        return std::make_shared<LadderOrderBook>(BAND_CENTER);
+    } else {
+        return std::make_shared<Book>();
+    }
+}
+
+template <typename Book>
+static void BM_MatchingCompare_Sweep(benchmark::State& state) {
+    auto orderBook = makeBook<Book>();
+    auto eventPublisher = std::make_shared<NullEventPublisher>();
+    MatchingEngine engine(orderBook, eventPublisher);
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<Price> offsetDist(1, BAND_WIDTH);
+    std::uniform_int_distribution<Price> aggressDist(0, 3);
+    std::uniform_int_distribution<int> sideDist(0, 1);
+    LatencyStats stats;
+    
+    OrderId orderId = 1;
+    auto restingOrder = [&](Side side) {
+        Price price = (side == Side::Buy) ? BAND_CENTER - offsetDist(gen) : BAND_CENTER + offsetDist(gen);
+        return generateMatchingOrder(orderId++, 1, side, price, gen);
+    };
+    
+    constexpr std::size_t INITIAL_ORDERS = 2000;
+    for (std::size_t i = 0; i < INITIAL_ORDERS; ++i) {
+        Order order = restingOrder(i % 2 == 0 ? Side::Buy : Side::Sell);
+        engine.process(order);
+    }
+    
+    for (auto _ : state) {
+        Side side = (sideDist(gen) == 0) ? Side::Buy : Side::Sell;
+        Side contra = (side == Side::Buy) ? Side::Sell : Side::Buy;
+        auto touch = (side == Side::Buy) ? orderBook->findBestAsk() : orderBook->findBestBid();
+        Price price = touch ? *touch : BAND_CENTER;
+        price += (side == Side::Buy) ? aggressDist(gen) : -aggressDist(gen);
+        Order taker = generateMatchingOrder(orderId++, 1, side, price, gen);
+        
+        auto start = std::chrono::steady_clock::now();
+        auto trades = engine.process(taker);
+        auto end = std::chrono::steady_clock::now();
+        
+        auto latency = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+        stats.record(static_cast<double>(latency));
+        benchmark::DoNotOptimize(trades);
+        
+        // Replenish the side the taker consumed (untimed)
+        for (std::size_t i = 0; i < trades.size(); ++i) {
+            Order order = restingOrder(contra);
+            engine.process(order);
+        }
+    }
+    
+    stats.report(state, "Sweep");
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Sweep one deep level: state.range(0) makers of qty 1 rest at a single
+// price and one taker consumes all of them. Time per maker reflects how
+// densely resting orders are packed in memory. Refill is untimed.
+// Hardware cache counters: run with
+//   --benchmark_perf_counters=L1-DCACHE-LOAD-MISSES,l2_rqsts:miss
+// when the benchmark library is built with libpfm.
+static void BM_MatchingEngine_LevelSweep(benchmark::State& state) {
+    auto orderBook = std::make_shared<OrderBook>();
+    auto eventPublisher = std::make_shared<NullEventPublisher>();
+    MatchingEngine engine(orderBook, eventPublisher);
+    const auto makers = static_cast<Quantity>(state.range(0));
+    constexpr Price PRICE = 10000;
+    // Reused, so the timed sweep does not include growing a trade vector
+    std::vector<Trade> trades;
+    trades.reserve(static_cast<std::size_t>(makers));
+    
+    OrderId orderId = 1;
+    for (auto _ : state) {
+        state.PauseTiming();
+        for (Quantity i = 0; i < makers; ++i) {
+            orderBook->addOrder(Order{orderId++, 1, Side::Sell, OrderType::Limit, PRICE, 1, {}});
+        }
+        Order taker{orderId++, 1, Side::Buy, OrderType::Limit, PRICE, makers, {}};
+        state.ResumeTiming();
+        
+        engine.process(taker, &trades);
+        benchmark::DoNotOptimize(trades.data());
+    }
+    
+    state.SetItemsProcessed(state.iterations() * makers);
+}
+
+// Steady-state add/match/cancel flow with the reusable trade buffer.
+// Makers are qty 1 so every fill retires exactly one resting order and the
+// book size stays constant; any taker remainder is cancelled. After a warm-up
+// pass (which grows the pool, locator table and level pools to their working
+// size) the timed loop must not touch the heap at all.
+template <typename Book>
+static void BM_MatchingCompare_AllocFree(benchmark::State& state) {
+    auto orderBook = makeBook<Book>();
+    auto eventPublisher = std::make_shared<NullEventPublisher>();
+    MatchingEngine engine(orderBook, eventPublisher);
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<Price> offsetDist(1, BAND_WIDTH);
+    std::uniform_int_distribution<Quantity> takerQtyDist(1, 8);
+    std::uniform_int_distribution<int> sideDist(0, 1);
+    std::vector<Trade> trades;
+    trades.reserve(64);
+    
+    OrderId orderId = 1;
+    auto rest = [&](Side side) {
+        Price price = (side == Side::Buy) ? BAND_CENTER - offsetDist(gen) : BAND_CENTER + offsetDist(gen);
+        Order order{orderId++, 1, side, OrderType::Limit, price, 1, {}};
+        engine.process(order, &trades);
+    };
+    auto step = [&]() {
+        Side side = (sideDist(gen) == 0) ? Side::Buy : Side::Sell;
+        Side contra = (side == Side::Buy) ? Side::Sell : Side::Buy;
+        Price price = (side == Side::Buy) ? BAND_CENTER + BAND_WIDTH / 2 : BAND_CENTER - BAND_WIDTH / 2;
+        Order taker{orderId++, 1, side, OrderType::Limit, price, takerQtyDist(gen), {}};
+        engine.process(taker, &trades);
+        const std::size_t filled = trades.size();
+        if (taker.quantity > 0) orderBook->cancelOrder(taker.orderId);
+        for (std::size_t i = 0; i < filled; ++i) rest(contra);
+    };
+    
+    constexpr std::size_t RESTING = 2000;
+    constexpr std::size_t WARMUP_STEPS = 200000;
+    for (std::size_t i = 0; i < RESTING; ++i) rest(i % 2 == 0 ? Side::Buy : Side::Sell);
+    for (std::size_t i = 0; i < WARMUP_STEPS; ++i) step();
+    
+    bench::AllocationScope allocations;
+    for (auto _ : state) {
+        step();
+        benchmark::DoNotOptimize(trades.data());
+    }
+    const std::size_t allocs = allocations.count();
+    
+    state.counters["Allocs"] = static_cast<double>(allocs);
+    state.counters["AllocsPerOrder"] = static_cast<double>(allocs) / static_cast<double>(state.iterations());
+    state.SetItemsProcessed(state.iterations());
+    if (allocs > 0) state.SkipWithError("matching path allocated in steady state");
+}
+
+// Market-maker quote updates against a resting book. Each iteration revises
+// one of QUOTES live quotes: half the updates size down at the same price,
+// the other half move the quote to a new, non-crossing price with fresh size.
+// range(0) == 0 uses amend (size-down in place keeps priority); range(0) == 1
+// does the same update as cancel followed by add under a new order id.
+template <typename Book>
+static void BM_MatchingCompare_QuoteUpdate(benchmark::State& state) {
+    auto orderBook = makeBook<Book>();
+    auto eventPublisher = std::make_shared<NullEventPublisher>();
+    MatchingEngine engine(orderBook, eventPublisher);
+    const bool cancelReplace = state.range(0) == 1;
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<Price> offsetDist(1, BAND_WIDTH);
+    std::uniform_int_distribution<int> coin(0, 1);
+    std::vector<Trade> trades;
+    trades.reserve(16);
+    
+    struct Quote { OrderId id; Side side; Price price; Quantity qty; };
+    constexpr std::size_t QUOTES = 2000;
+    constexpr Quantity FRESH_QTY = 100;
+    std::uniform_int_distribution<std::size_t> pick(0, QUOTES - 1);
+    std::vector<Quote> quotes;
+    quotes.reserve(QUOTES);
+    
+    OrderId orderId = 1;
+    auto priceFor = [&](Side side) {
+        return (side == Side::Buy) ? BAND_CENTER - offsetDist(gen) : BAND_CENTER + offsetDist(gen);
+    };
+    for (std::size_t i = 0; i < QUOTES; ++i) {
+        Side side = (i % 2 == 0) ? Side::Buy : Side::Sell;
+        Quote q{orderId++, side, priceFor(side), FRESH_QTY};
+        Order order{q.id, 1, q.side, OrderType::Limit, q.price, q.qty, {}};
+        engine.process(order, &trades);
+        quotes.push_back(q);
+    }
+    
+    LatencyStats stats;
+    for (auto _ : state) {
+        Quote& q = quotes[pick(gen)];
+        const bool sizeDown = q.qty > 1 && coin(gen) == 0;
+        const Price newPrice = sizeDown ? q.price : priceFor(q.side);
+        const Quantity newQty = sizeDown ? q.qty - 1 : FRESH_QTY;
+        
+        auto start = std::chrono::steady_clock::now();
+        if (cancelReplace) {
+            engine.cancel(q.id);
+            q.id = orderId++;
+            Order order{q.id, 1, q.side, OrderType::Limit, newPrice, newQty, {}};
+            engine.process(order, &trades);
+        } else {
+            engine.amend(q.id, newPrice, newQty);
+        }
+        auto end = std::chrono::steady_clock::now();
+        stats.record(static_cast<double>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()));
+        q.price = newPrice;
+        q.qty = newQty;
+    }
+    
+    stats.report(state, "Update");
+    state.SetItemsProcessed(state.iterations());
+}
+
+// The same SPSC publisher seen only through IEventPublisher: the engine
+// cannot resolve it, so every trade is published with a virtual call, as
+// with any publisher other than SpscEventPublisher
+class InterfacePublisher : public IEventPublisher {
+public:
+    explicit InterfacePublisher(std::shared_ptr<SpscEventPublisher> target) : target_(std::move(target)) {}
+    bool publish(const Event& event) override { return target_->publish(event); }
+    bool publish(Event&& event) override { return target_->publish(std::move(event)); }
+    void flush() override { target_->flush(); }
+
+private:
+    std::shared_ptr<SpscEventPublisher> target_;
+};
+
+// Devirtualized sweep against the interface path. Each iteration rests
+// SWEEP_MAKERS qty-1 makers over a few levels on one side, straight into
+// the book, and sends a taker that takes them all, alternating sides, then
+// drains the event queue as the event thread would. The taker's sweep and
+// its 64 trade publishes are most of the time.
+// range(0) == 1 hands the engine the SpscEventPublisher itself (trades are
+// published through the concrete type and inlined); range(0) == 0 hands it
+// the same publisher behind InterfacePublisher.
+template <typename Book>
+static void BM_MatchingCompare_Publish(benchmark::State& state) {
+    constexpr Quantity SWEEP_MAKERS = 64;
+    constexpr Price SWEEP_LEVELS = 4;
+    const bool direct = state.range(0) == 1;
+    auto orderBook = makeBook<Book>();
+    auto eventQueue = std::make_shared<ob::queue::SpscRingBuffer<Event>>(4096);
+    auto spsc = std::make_shared<SpscEventPublisher>(eventQueue);
+    std::shared_ptr<IEventPublisher> publisher = spsc;
+    if (!direct) publisher = std::make_shared<InterfacePublisher>(spsc);
+    MatchingEngine engine(orderBook, publisher);
+    std::vector<Trade> trades;
+    trades.reserve(SWEEP_MAKERS);
+    Event event;
+    
+    OrderId orderId = 1;
+    std::size_t round = 0;
+    for (auto _ : state) {
+        const Side taker = (round++ & 1) ? Side::Buy : Side::Sell;
+        const Side maker = taker == Side::Buy ? Side::Sell : Side::Buy;
+        for (Quantity i = 0; i < SWEEP_MAKERS; ++i) {
+            const Price offset = 1 + i % SWEEP_LEVELS;
+            orderBook->addOrder(Order{orderId++, 1, maker, OrderType::Limit,
+                                      maker == Side::Sell ? BAND_CENTER + offset : BAND_CENTER - offset, 1, {}});
+        }
+        const Price limit = taker == Side::Buy ? BAND_CENTER + SWEEP_LEVELS : BAND_CENTER - SWEEP_LEVELS;
+        Order order{orderId++, 1, taker, OrderType::Limit, limit, SWEEP_MAKERS, {}};
+        engine.process(order, &trades);
+        benchmark::DoNotOptimize(trades.data());
+        while (eventQueue->tryPop(event)) {}
+    }
+    
+    state.counters["dropped"] = static_cast<double>(spsc->droppedEvents());
+    state.SetItemsProcessed(state.iterations() * SWEEP_MAKERS);
+}
+
 // Register benchmarks
 BENCHMARK(BM_MatchingEngine_MatchLimitOrder)
     ->Name("MatchingEngine_MatchLimitOrder")
@@ -189,5 +463,57 @@ BENCHMARK(BM_MatchingEngine_PartialFill)
     ->UseRealTime()
     ->Iterations(10000);
 
+BENCHMARK(BM_MatchingEngine_LevelSweep)
+    ->Name("MatchingEngine_LevelSweep")
+    ->Arg(1000)
+    ->Arg(100000)
+    ->UseRealTime();
+
+BENCHMARK_TEMPLATE(BM_MatchingCompare_Sweep, OrderBook)
+    ->Name("MatchingCompare_Sweep/Map")
+    ->UseRealTime()
+    ->Iterations(100000);
+
+BENCHMARK_TEMPLATE(BM_MatchingCompare_Sweep, LadderOrderBook)
+    ->Name("MatchingCompare_Sweep/Ladder")
+    ->UseRealTime()
+    ->Iterations(100000);
+
+BENCHMARK_TEMPLATE(BM_MatchingCompare_AllocFree, OrderBook)
+    ->Name("MatchingCompare_AllocFree/Map")
+    ->Iterations(200000);
+
+BENCHMARK_TEMPLATE(BM_MatchingCompare_AllocFree, LadderOrderBook)
+    ->Name("MatchingCompare_AllocFree/Ladder")
+    ->Iterations(200000);
+
+BENCHMARK_TEMPLATE(BM_MatchingCompare_QuoteUpdate, OrderBook)
+    ->Name("MatchingCompare_QuoteUpdate/Map")
+    ->ArgName("cancelReplace")
+    ->Arg(0)
+    ->Arg(1)
+    ->UseRealTime()
+    ->Iterations(200000);
+
+BENCHMARK_TEMPLATE(BM_MatchingCompare_QuoteUpdate, LadderOrderBook)
+    ->Name("MatchingCompare_QuoteUpdate/Ladder")
+    ->ArgName("cancelReplace")
+    ->Arg(0)
+    ->Arg(1)
+    ->UseRealTime()
+    ->Iterations(200000);
+
+BENCHMARK_TEMPLATE(BM_MatchingCompare_Publish, OrderBook)
+    ->Name("MatchingCompare_Publish/Map")
+    ->ArgName("direct")
+    ->Arg(0)
+    ->Arg(1);
+
+BENCHMARK_TEMPLATE(BM_MatchingCompare_Publish, LadderOrderBook)
+    ->Name("MatchingCompare_Publish/Ladder")
+    ->ArgName("direct")
+    ->Arg(0)
+    ->Arg(1);
+
 // BENCHMARK_MAIN(); // Defined in benchmark_orderbook.cpp
 
@@ -1,7 +1,14 @@
 #include "orderbook/oms/order_management_system.hpp"
+#include "orderbook/oms/instrument_manager.hpp"
 #include "orderbook/core/types.hpp"
 #include <benchmark/benchmark.h>
 #include <random>
+#include <algorithm>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <ctime>
 
 using namespace ob::oms;
 using namespace ob::core;
@@ -43,36 +50,65 @@ static void BM_OMS_SubmitOrder(benchmark::State& state) {
     state.SetItemsProcessed(state.iterations());
 }
 
-// Benchmark order cancellation through OMS
+// Benchmark order cancellation through OMS. Cancels are sequenced through
+// the matching thread, so each iteration times the full round trip: queue
+// the cancel, then poll events until its CancelAck arrives. The cancelled
+// order is replaced (untimed) so the book depth stays constant.
 static void BM_OMS_CancelOrder(benchmark::State& state) {
     OrderManagementSystem oms;
+    std::atomic<OrderId> lastStatus{0};
+    oms.setEventCallback([&lastStatus](const ob::events::Event& event) {
+        if (event.type == ob::events::EventType::Ack ||
+            event.type == ob::events::EventType::CancelAck ||
+            event.type == ob::events::EventType::CancelReject) {
+            lastStatus.store(event.orderId, std::memory_order_relaxed);
+        }
+    });
     oms.start();
     
-    std::mt19937 gen(42);
-    
-    // Pre-submit orders
+    auto awaitStatus = [&](OrderId id) {
+        while (lastStatus.load(std::memory_order_relaxed) != id) {
+            oms.processEvents();
+            std::this_thread::yield();
+        }
+    };
+    // Resting bids only, so nothing trades and every cancel finds its order
     constexpr std::size_t INITIAL_ORDERS = 1000;
     std::vector<OrderId> orderIds;
     orderIds.reserve(INITIAL_ORDERS);
+    OrderId nextId = 1;
+    auto rest = [&](std::size_t slot) {
+        const OrderId id = nextId++;
+        oms.submitOrder(Order{id, 1, Side::Buy, OrderType::Limit, static_cast<Price>(10000 + slot), 10, {}});
+        awaitStatus(id);
+        return id;
+    };
+    for (std::size_t i = 0; i < INITIAL_ORDERS; ++i) orderIds.push_back(rest(i));
     
-    for (OrderId id = 1; id <= INITIAL_ORDERS; ++id) {
-        Order order = generateOrder(id, 1, gen);
-        oms.submitOrder(std::move(order));
-        orderIds.push_back(id);
-        oms.processEvents();
-    }
-    
+    std::vector<double> latencies;
+    latencies.reserve(static_cast<std::size_t>(state.max_iterations));
     std::size_t cancelIndex = 0;
     for (auto _ : state) {
-        if (cancelIndex >= orderIds.size()) {
-            cancelIndex = 0;
-        }
-        bool cancelled = oms.cancelOrder(orderIds[cancelIndex++]);
+        const OrderId id = orderIds[cancelIndex];
+        const auto start = std::chrono::steady_clock::now();
+        bool cancelled = oms.cancelOrder(id);
+        awaitStatus(id);
+        const auto end = std::chrono::steady_clock::now();
+        latencies.push_back(std::chrono::duration<double, std::nano>(end - start).count());
         benchmark::DoNotOptimize(cancelled);
-        oms.processEvents();
+        
+        state.PauseTiming();
+        orderIds[cancelIndex] = rest(cancelIndex);
+        cancelIndex = (cancelIndex + 1) % INITIAL_ORDERS;
+        state.ResumeTiming();
     }
     
     oms.stop();
+    std::sort(latencies.begin(), latencies.end());
+    if (!latencies.empty()) {
+        state.counters["Cancel_P50_ns"] = latencies[latencies.size() / 2];
+        state.counters["Cancel_P99_ns"] = latencies[latencies.size() * 99 / 100];
+    }
     state.SetItemsProcessed(state.iterations());
 }
 
@@ -107,6 +143,172 @@ static void BM_OMS_GetMarketData(benchmark::State& state) {
     state.SetItemsProcessed(state.iterations());
 }
 
+// End-to-end throughput vs processor batch size: submit a burst of orders,
+// then drain events until every order has been acknowledged. state.range(0)
+// is OmsConfig::processBatch (1 = one pop and one event push per order).
+static void BM_OMS_BatchThroughput(benchmark::State& state) {
+    constexpr std::size_t BURST = 4096;
+    OmsConfig config;
+    config.queueSize = 1 << 16; // large enough that neither queue drops during a burst
+    config.processBatch = static_cast<std::size_t>(state.range(0));
+    config.eventBatch = config.processBatch > 1 ? DEFAULT_EVENT_BATCH : 0;
+    OrderManagementSystem oms(config);
+    
+    std::size_t acks = 0;
+    oms.setEventCallback([&acks](const ob::events::Event& event) {
+        if (event.type == ob::events::EventType::Ack) ++acks;
+    });
+    oms.start();
+    
+    std::mt19937 gen(42);
+    OrderId orderId = 1;
+    for (auto _ : state) {
+        acks = 0;
+        for (std::size_t i = 0; i < BURST; ++i) {
+            while (!oms.submitOrder(generateOrder(orderId, 1, gen))) std::this_thread::yield();
+            ++orderId;
+        }
+        while (acks < BURST) {
+            oms.processEvents();
+            std::this_thread::yield();
+        }
+    }
+    
+    oms.stop();
+    state.counters["Batch"] = static_cast<double>(config.processBatch);
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(BURST));
+}
+
+// Wait strategy comparison. First measures the processor's CPU use while its
+// queue is idle (main thread sleeps, process CPU clock gives the processor's
+// share), then times submit -> Ack round trips, which include the wake-up
+// cost of a parked or sleeping processor.
+static void BM_OMS_WaitStrategy(benchmark::State& state) {
+    OmsConfig config;
+    config.waitStrategy = static_cast<ob::queue::WaitStrategyType>(state.range(0));
+    OrderManagementSystem oms(config);
+    
+    std::atomic<std::size_t> acks{0};
+    oms.setEventCallback([&acks](const ob::events::Event& event) {
+        if (event.type == ob::events::EventType::Ack) acks.fetch_add(1, std::memory_order_relaxed);
+    });
+    oms.start();
+    
+    constexpr auto IDLE_WINDOW = std::chrono::milliseconds(200);
+    const std::clock_t cpuStart = std::clock();
+    std::this_thread::sleep_for(IDLE_WINDOW);
+    const double idleCpuSec = static_cast<double>(std::clock() - cpuStart) / CLOCKS_PER_SEC;
+    
+    std::mt19937 gen(42);
+    OrderId orderId = 1;
+    for (auto _ : state) {
+        const std::size_t target = acks.load(std::memory_order_relaxed) + 1;
+        while (!oms.submitOrder(generateOrder(orderId, 1, gen))) std::this_thread::yield();
+        ++orderId;
+        while (acks.load(std::memory_order_relaxed) < target) {
+            oms.processEvents();
+            std::this_thread::yield(); // lets the processor run on small hosts
+        }
+    }
+    
+    oms.stop();
+    state.counters["IdleCpuPct"] = 100.0 * idleCpuSec / std::chrono::duration<double>(IDLE_WINDOW).count();
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Instruments vs throughput for both execution modes. state.range(0)
+// instruments are added to an InstrumentManager; each iteration submits a
+// burst round-robin across them (buy then sell at one price, so books stay
+// small and every other order trades) and drains events until every order
+// is acknowledged. PerInstrument runs one processor thread per symbol;
+// Sharded runs them all on state.range(1) shard workers.
+static void runInstrumentScaling(benchmark::State& state, InstrumentManager& manager) {
+    const auto instruments = static_cast<std::uint32_t>(state.range(0));
+    constexpr std::size_t ORDERS_PER_INSTRUMENT = 256; // stays within each event queue
+    std::vector<std::uint32_t> symbols;
+    for (std::uint32_t i = 0; i < instruments; ++i) {
+        symbols.push_back(manager.addInstrument("SYM" + std::to_string(i), "", "", 100.0));
+    }
+    std::atomic<std::size_t> acks{0};
+    manager.setEventCallback([&acks](const ob::events::Event& event) {
+        if (event.type == ob::events::EventType::Ack) acks.fetch_add(1, std::memory_order_relaxed);
+    });
+    
+    const std::size_t burst = ORDERS_PER_INSTRUMENT * instruments;
+    OrderId orderId = 1;
+    for (auto _ : state) {
+        acks.store(0, std::memory_order_relaxed);
+        for (std::size_t i = 0; i < ORDERS_PER_INSTRUMENT; ++i) {
+            const Side side = (i % 2 == 0) ? Side::Buy : Side::Sell;
+            for (std::uint32_t symbol : symbols) {
+                Order order{orderId++, symbol, side, OrderType::Limit, 100, 10, {}};
+                while (!manager.submitOrder(order)) {
+                    manager.processEvents();
+                    std::this_thread::yield();
+                }
+            }
+        }
+        while (acks.load(std::memory_order_relaxed) < burst) {
+            manager.processEvents();
+            std::this_thread::yield();
+        }
+    }
+    
+    manager.stop();
+    state.counters["Instruments"] = static_cast<double>(instruments);
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(burst));
+}
+
+static void BM_OMS_InstrumentScaling_PerInstrument(benchmark::State& state) {
+    InstrumentManager manager;
+    runInstrumentScaling(state, manager);
+}
+
+static void BM_OMS_InstrumentScaling_Sharded(benchmark::State& state) {
+    ob::processors::ShardConfig config;
+    config.numShards = static_cast<std::size_t>(state.range(1));
+    InstrumentManager manager(config);
+    runInstrumentScaling(state, manager);
+    state.counters["Shards"] = static_cast<double>(config.numShards);
+}
+
+// Concurrent submit path as ob_server's ADD handler drives it: every client
+// thread calls hasInstrument() then submitOrder() on a shared manager. Symbol
+// resolution is wait-free, so per-thread cost should stay flat as threads
+// are added. Orders are spread over the instruments; a full ingress queue
+// counts as a rejected submit rather than being retried, and only accepted
+// submits count as items, so the fast refusal path does not inflate the rate.
+static InstrumentManager* gConcurrentManager = nullptr;
+
+static void BM_OMS_ConcurrentSubmit(benchmark::State& state) {
+    constexpr std::uint32_t INSTRUMENTS = 8;
+    if (state.thread_index() == 0) {
+        gConcurrentManager = new InstrumentManager();
+        for (std::uint32_t i = 0; i < INSTRUMENTS; ++i) {
+            gConcurrentManager->addInstrument("SYM" + std::to_string(i), "", "", 100.0);
+        }
+    }
+    
+    std::mt19937 gen(static_cast<std::mt19937::result_type>(state.thread_index() + 1));
+    OrderId orderId = static_cast<OrderId>(state.thread_index()) << 40;
+    std::int64_t rejected = 0;
+    for (auto _ : state) {
+        ++orderId;
+        Order order = generateOrder(orderId, static_cast<std::uint32_t>(orderId % INSTRUMENTS) + 1, gen);
+        if (!gConcurrentManager->hasInstrument(order.symbolId) || !gConcurrentManager->submitOrder(std::move(order))) {
+            ++rejected;
+        }
+    }
+    
+    state.counters["Rejected"] = benchmark::Counter(static_cast<double>(rejected), benchmark::Counter::kAvgThreads);
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) - rejected);
+    if (state.thread_index() == 0) {
+        gConcurrentManager->stop();
+        delete gConcurrentManager;
+        gConcurrentManager = nullptr;
+    }
+}
+
 // Register benchmarks
 BENCHMARK(BM_OMS_SubmitOrder)
     ->Name("OMS_SubmitOrder")
@@ -123,5 +325,34 @@ BENCHMARK(BM_OMS_GetMarketData)
     ->UseRealTime()
     ->Iterations(100000);
 
+BENCHMARK(BM_OMS_BatchThroughput)
+    ->Name("OMS_BatchThroughput")
+    ->RangeMultiplier(4)->Range(1, 256)
+    ->UseRealTime();
+
+BENCHMARK(BM_OMS_WaitStrategy)
+    ->Name("OMS_WaitStrategy")
+    ->ArgName("strategy")  // 0=BusySpin 1=SpinYield 2=SpinPark 3=TimedBackoff
+    ->DenseRange(0, 3)
+    ->UseRealTime()
+    ->Iterations(2000);
+
+BENCHMARK(BM_OMS_InstrumentScaling_PerInstrument)
+    ->Name("OMS_InstrumentScaling/PerInstrument")
+    ->ArgNames({"instruments"})
+    ->Arg(1)->Arg(8)->Arg(64)->Arg(200)
+    ->UseRealTime();
+
+BENCHMARK(BM_OMS_InstrumentScaling_Sharded)
+    ->Name("OMS_InstrumentScaling/Sharded")
+    ->ArgNames({"instruments", "shards"})
+    ->ArgsProduct({{1, 8, 64, 200}, {1, 4}})
+    ->UseRealTime();
+
+BENCHMARK(BM_OMS_ConcurrentSubmit)
+    ->Name("OMS_ConcurrentSubmit")
+    ->ThreadRange(1, 8)
+    ->UseRealTime();
+
 // BENCHMARK_MAIN(); // Defined in benchmark_orderbook.cpp
 
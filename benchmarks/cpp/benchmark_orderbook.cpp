@@ -1,4 +1,5 @@
 #include "orderbook/book/order_book.hpp"
+#include "orderbook/book/ladder_order_book.hpp"
 #include "orderbook/core/types.hpp"
 #include <benchmark/benchmark.h>
 #include <random>
@@ -6,6 +7,8 @@
 #include <algorithm>
 #include <chrono>
 #include <cmath>
+#include <memory>
+#include <type_traits>
 
 using namespace ob::book;
 using namespace ob::core;
@@ -67,6 +70,35 @@ static Order generateOrder(OrderId id, std::uint32_t symbolId, std::mt19937& gen
     return Order{id, symbolId, side, OrderType::Limit, price, qty, Timestamp{nowNs}};
 }
 
+// Narrow-band flow for map vs ladder comparisons: prices cluster within
+// +/- BAND_WIDTH ticks of BAND_CENTER, bids below and asks above the centre
+constexpr Price BAND_CENTER = 15000;
+constexpr Price BAND_WIDTH = 50;
+
+static Order generateBandOrder(OrderId id, std::uint32_t symbolId, std::mt19937& gen) {
+    std::uniform_int_distribution<Price> offsetDist(1, BAND_WIDTH);
+    std::uniform_int_distribution<Quantity> qtyDist(1, 1000);
+    std::uniform_int_distribution<int> sideDist(0, 1);
+    
+    Side side = (sideDist(gen) == 0) ? Side::Buy : Side::Sell;
+    Price price = (side == Side::Buy) ? BAND_CENTER - offsetDist(gen) : BAND_CENTER + offsetDist(gen);
+    Quantity qty = qtyDist(gen);
+    
+    auto now = std::chrono::steady_clock::now();
+    auto nowNs = std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch());
+    
+    return Order{id, symbolId, side, OrderType::Limit, price, qty, Timestamp{nowNs}};
+}
+
+template <typename Book>
+static std::unique_ptr<Book> makeBook() {
+    if constexpr (std::is_same_v<Book, LadderOrderBook>) {
+        return std::make_unique<LadderOrderBook>(BAND_CENTER);
+    } else {
+        return std::make_unique<Book>();
+    }
+}
+
 // Benchmark adding orders to empty book (with latency tracking)
 static void BM_OrderBook_AddOrder(benchmark::State& state) {
     OrderBook book;
@@ -84,7 +116,7 @@ static void BM_OrderBook_AddOrder(benchmark::State& state) {
         auto latency = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
         stats.record(static_cast<double>(latency));
         
-        benchmark::DoNotOptimize(book);
+        benchmark::ClobberMemory(); // keep book updates observable
     }
     
     stats.report(state, "AddOrder");
@@ -107,7 +139,7 @@ static void BM_OrderBook_AddOrder_WithDepth(benchmark::State& state) {
     for (auto _ : state) {
         Order order = generateOrder(orderId++, 1, gen);
         book.addOrder(std::move(order));
-        benchmark::DoNotOptimize(book);
+        benchmark::ClobberMemory(); // keep book updates observable
     }
     
     state.SetItemsProcessed(state.iterations());
@@ -193,6 +225,121 @@ static void BM_OrderBook_GetSnapshot(benchmark::State& state) {
     state.SetItemsProcessed(state.iterations());
 }
 
+// Head-to-head: map book vs ladder book on narrow-band flow
+template <typename Book>
+static void BM_BookCompare_AddOrder(benchmark::State& state) {
+    auto book = makeBook<Book>();
+    std::mt19937 gen(42);
+    LatencyStats stats;
+    
+    OrderId orderId = 1;
+    for (auto _ : state) {
+        Order order = generateBandOrder(orderId++, 1, gen);
+        
+        auto start = std::chrono::steady_clock::now();
+        book->addOrder(std::move(order));
+        auto end = std::chrono::steady_clock::now();
+        
+        auto latency = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+        stats.record(static_cast<double>(latency));
+        
+        benchmark::ClobberMemory(); // keep book updates observable
+    }
+    
+    stats.report(state, "AddOrder");
+    state.SetItemsProcessed(state.iterations());
+}
+
+template <typename Book>
+static void BM_BookCompare_AddCancel(benchmark::State& state) {
+    auto book = makeBook<Book>();
+    std::mt19937 gen(42);
+    
+    // Keep a steady resting population; each iteration adds one order and cancels the oldest
+    constexpr std::size_t RESTING_ORDERS = 10000;
+    OrderId orderId = 1;
+    for (; orderId <= RESTING_ORDERS; ++orderId) {
+        book->addOrder(generateBandOrder(orderId, 1, gen));
+    }
+    
+    OrderId cancelId = 1;
+    for (auto _ : state) {
+        book->addOrder(generateBandOrder(orderId++, 1, gen));
+        bool cancelled = book->cancelOrder(cancelId++);
+        benchmark::DoNotOptimize(cancelled);
+    }
+    
+    state.SetItemsProcessed(state.iterations() * 2);
+}
+
+template <typename Book>
+static void BM_BookCompare_GetBestPrice(benchmark::State& state) {
+    auto book = makeBook<Book>();
+    std::mt19937 gen(42);
+    
+    constexpr std::size_t INITIAL_ORDERS = 1000;
+    for (OrderId id = 1; id <= INITIAL_ORDERS; ++id) {
+        book->addOrder(generateBandOrder(id, 1, gen));
+    }
+    
+    for (auto _ : state) {
+        auto bestBid = book->findBestBid();
+        auto bestAsk = book->findBestAsk();
+        benchmark::DoNotOptimize(bestBid);
+        benchmark::DoNotOptimize(bestAsk);
+    }
+    
+    state.SetItemsProcessed(state.iterations());
+}
+
+template <typename Book>
+static void BM_BookCompare_GetSnapshot(benchmark::State& state) {
+    auto book = makeBook<Book>();
+    std::mt19937 gen(42);
+    
+    constexpr std::size_t INITIAL_ORDERS = 1000;
+    for (OrderId id = 1; id <= INITIAL_ORDERS; ++id) {
+        book->addOrder(generateBandOrder(id, 1, gen));
+    }
+    
+    for (auto _ : state) {
+        auto bids = book->snapshotBidsL2(10);
+        auto asks = book->snapshotAsksL2(10);
+        benchmark::DoNotOptimize(bids);
+        benchmark::DoNotOptimize(asks);
+    }
+    
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Deep queues: 10 levels per side with state.range(0) orders each. Thanks to
+// per-level running totals a depth-10 snapshot should cost the same however
+// deep the queues are.
+template <typename Book>
+static void BM_BookCompare_DeepQueueSnapshot(benchmark::State& state) {
+    auto book = makeBook<Book>();
+    const auto ordersPerLevel = static_cast<std::size_t>(state.range(0));
+    constexpr Price LEVELS = 10;
+    
+    OrderId orderId = 1;
+    for (Price offset = 1; offset <= LEVELS; ++offset) {
+        for (std::size_t i = 0; i < ordersPerLevel; ++i) {
+            book->addOrder(Order{orderId++, 1, Side::Buy, OrderType::Limit, BAND_CENTER - offset, 10, {}});
+            book->addOrder(Order{orderId++, 1, Side::Sell, OrderType::Limit, BAND_CENTER + offset, 10, {}});
+        }
+    }
+    
+    for (auto _ : state) {
+        auto bids = book->snapshotBidsL2(10);
+        auto asks = book->snapshotAsksL2(10);
+        benchmark::DoNotOptimize(bids);
+        benchmark::DoNotOptimize(asks);
+    }
+    
+    state.counters["RestingOrders"] = static_cast<double>(orderId - 1);
+    state.SetItemsProcessed(state.iterations());
+}
+
 // Register benchmarks
 BENCHMARK(BM_OrderBook_AddOrder)
     ->Name("OrderBook_AddOrder")
@@ -219,5 +366,59 @@ BENCHMARK(BM_OrderBook_GetSnapshot)
     ->UseRealTime()
     ->Iterations(10000);
 
+BENCHMARK_TEMPLATE(BM_BookCompare_AddOrder, OrderBook)
+    ->Name("BookCompare_AddOrder/Map")
+    ->UseRealTime()
+    ->Iterations(100000);
+
+BENCHMARK_TEMPLATE(BM_BookCompare_AddOrder, LadderOrderBook)
+    ->Name("BookCompare_AddOrder/Ladder")
+    ->UseRealTime()
+    ->Iterations(100000);
+
+BENCHMARK_TEMPLATE(BM_BookCompare_AddCancel, OrderBook)
+    ->Name("BookCompare_AddCancel/Map")
+    ->UseRealTime()
+    ->Iterations(100000);
+
+BENCHMARK_TEMPLATE(BM_BookCompare_AddCancel, LadderOrderBook)
+    ->Name("BookCompare_AddCancel/Ladder")
+    ->UseRealTime()
+    ->Iterations(100000);
+
+BENCHMARK_TEMPLATE(BM_BookCompare_GetBestPrice, OrderBook)
+    ->Name("BookCompare_GetBestPrice/Map")
+    ->UseRealTime()
+    ->Iterations(1000000);
+
+BENCHMARK_TEMPLATE(BM_BookCompare_GetBestPrice, LadderOrderBook)
+    ->Name("BookCompare_GetBestPrice/Ladder")
+    ->UseRealTime()
+    ->Iterations(1000000);
+
+BENCHMARK_TEMPLATE(BM_BookCompare_GetSnapshot, OrderBook)
+    ->Name("BookCompare_GetSnapshot/Map")
+    ->UseRealTime()
+    ->Iterations(10000);
+
+BENCHMARK_TEMPLATE(BM_BookCompare_GetSnapshot, LadderOrderBook)
+    ->Name("BookCompare_GetSnapshot/Ladder")
+    ->UseRealTime()
+    ->Iterations(10000);
+
+BENCHMARK_TEMPLATE(BM_BookCompare_DeepQueueSnapshot, OrderBook)
+    ->Name("BookCompare_DeepQueueSnapshot/Map")
+    ->Arg(1)
+    ->Arg(100)
+    ->Arg(10000)
+    ->UseRealTime();
+
+BENCHMARK_TEMPLATE(BM_BookCompare_DeepQueueSnapshot, LadderOrderBook)
+    ->Name("BookCompare_DeepQueueSnapshot/Ladder")
+    ->Arg(1)
+    ->Arg(100)
+    ->Arg(10000)
+    ->UseRealTime();
+
 BENCHMARK_MAIN();
 
@@ -0,0 +1,71 @@
+#include "orderbook/book/order_book.hpp"
+#include "orderbook/book/ladder_order_book.hpp"
+#include "orderbook/core/memory.hpp"
+#include "orderbook/core/types.hpp"
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+
+using namespace ob;
+using namespace ob::book;
+using namespace ob::core;
+
+namespace {
+
+constexpr std::size_t FIRST_ORDERS = 1 << 16; // orders into each fresh book
+constexpr Price PREWARM_CENTER = 10'000;
+constexpr Price PREWARM_SPREAD = 200;          // resting prices per side
+
+template <typename Book>
+std::unique_ptr<Book> freshBook() {
+    if constexpr (std::is_same_v<Book, LadderOrderBook>) {
+        return std::make_unique<LadderOrderBook>(PREWARM_CENTER);
+    } else {
+        return std::make_unique<Book>();
+    }
+}
+
+} // namespace
+
+// The first FIRST_ORDERS orders a new book takes: resting limit orders on
+// both sides over PREWARM_SPREAD prices each, none crossing. Cold books
+// grow the order pool and id lookup and allocate level nodes as the
+// orders arrive; prewarmed ones were sized (and faulted in) beforehand,
+// untimed. Arg prewarm: 0 = cold book, 1 = prewarm(FIRST_ORDERS).
+template <typename Book>
+static void BM_Prewarm_FirstOrders(benchmark::State& state) {
+    const bool prewarm = state.range(0) == 1;
+    MemoryConfig memory;
+    memory.prefault = true;
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto book = freshBook<Book>();
+        if (prewarm) book->prewarm(FIRST_ORDERS, memory);
+        state.ResumeTiming();
+        for (std::size_t i = 0; i < FIRST_ORDERS; ++i) {
+            const bool buy = (i & 1) != 0;
+            const auto offset = static_cast<Price>(1 + (i >> 1) % PREWARM_SPREAD);
+            book->addOrder(Order{i + 1, 1, buy ? Side::Buy : Side::Sell, OrderType::Limit,
+                                 buy ? PREWARM_CENTER - offset : PREWARM_CENTER + offset, 10, {}});
+        }
+        state.PauseTiming();
+        book.reset();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(FIRST_ORDERS));
+}
+
+BENCHMARK_TEMPLATE(BM_Prewarm_FirstOrders, OrderBook)
+    ->Name("Prewarm_FirstOrders/Map")
+    ->ArgNames({"prewarm"})
+    ->Arg(0)
+    ->Arg(1);
+
+BENCHMARK_TEMPLATE(BM_Prewarm_FirstOrders, LadderOrderBook)
+    ->Name("Prewarm_FirstOrders/Ladder")
+    ->ArgNames({"prewarm"})
+    ->Arg(0)
+    ->Arg(1);
+
+// BENCHMARK_MAIN(); // Defined in benchmark_orderbook.cpp
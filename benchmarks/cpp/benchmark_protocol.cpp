@@ -0,0 +1,331 @@
+#include "orderbook/net/binary_protocol.hpp"
+#include "orderbook/net/request_handler.hpp"
+#include "orderbook/net/tcp_server.hpp"
+#include "orderbook/oms/i_order_book_service.hpp"
+#include "orderbook/core/types.hpp"
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace ob;
+using namespace ob::core;
+namespace binary = ob::net::binary;
+
+// Service that accepts everything without matching, so the benchmarks
+// measure the wire protocol and the socket round trip only
+class AcceptAllService : public oms::IOrderBookService {
+public:
+    std::uint32_t addInstrument(const std::string&, const std::string&, const std::string&, double,
+                                book::BookType, queue::WaitStrategyType) override { return 1; }
+    bool removeInstrument(std::uint32_t) override { return true; }
+    bool hasInstrument(std::uint32_t symbolId) const override { return symbolId == 1; }
+    std::optional<Instrument> getInstrument(std::uint32_t) const override { return std::nullopt; }
+    std::vector<Instrument> listInstruments() const override { return {}; }
+    bool submitOrder(const Order& order) override { return order.symbolId == 1; }
+    bool submitOrder(Order&& order) override { return order.symbolId == 1; }
+    std::size_t submitOrders(std::span<const Order> orders, std::span<bool> queued) override {
+        std::size_t n = 0;
+        for (std::size_t i = 0; i < orders.size(); ++i) n += (queued[i] = orders[i].symbolId == 1);
+        return n;
+    }
+    bool cancelOrder(std::uint32_t symbolId, OrderId) override { return symbolId == 1; }
+    bool amendOrder(std::uint32_t symbolId, OrderId, Price, Quantity) override { return symbolId == 1; }
+    std::optional<Price> getBestBid(std::uint32_t) const override { return 99; }
+    std::optional<Price> getBestAsk(std::uint32_t) const override { return 101; }
+    std::vector<book::LevelSummary> getBidsSnapshot(std::uint32_t, std::size_t) const override { return {}; }
+    std::vector<book::LevelSummary> getAsksSnapshot(std::uint32_t, std::size_t) const override { return {}; }
+    bool getBookImage(std::uint32_t, book::BookImage& out, std::size_t) const override {
+        out = book::BookImage{};
+        return true;
+    }
+    void processEvents() override {}
+    void setEventCallback(std::function<void(const events::Event&)>) override {}
+    bool startEventDrain(const processors::EventDrainConfig&) override { return false; }
+    std::uint64_t droppedEvents(std::uint32_t) const override { return 0; }
+    void collectMetrics(core::ServiceMetrics& out) const override { out = core::ServiceMetrics{}; }
+    std::optional<journal::RecoveryStats> openJournal(const journal::JournalConfig&) override { return std::nullopt; }
+    std::optional<journal::SnapshotStats> saveSnapshot() override { return std::nullopt; }
+    void start() override {}
+    void stop() override {}
+    bool isRunning() const noexcept override { return true; }
+};
+
+static binary::NewOrderMsg newOrderMsg(std::uint64_t tag) {
+    auto msg = binary::make<binary::NewOrderMsg>(binary::MsgType::NewOrder);
+    msg.symbolId = 1;
+    msg.side = (tag & 1) ? Side::Sell : Side::Buy;
+    msg.orderType = OrderType::Limit;
+    msg.price = 100;
+    msg.quantity = 10;
+    msg.clientTag = tag;
+    return msg;
+}
+
+static const char* const TEXT_ADD = "ADD 1 B L 100 10\n";
+
+// Request decode + response encode inside the server, no sockets
+static void BM_Protocol_Handle_Text(benchmark::State& state) {
+    AcceptAllService service;
+    net::RequestHandler handler(service);
+    const std::string request = TEXT_ADD;
+    for (auto _ : state) {
+        std::string response = handler.handleText(request);
+        benchmark::DoNotOptimize(response.data());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_Protocol_Handle_Binary(benchmark::State& state) {
+    AcceptAllService service;
+    net::RequestHandler handler(service);
+    std::string request;
+    binary::append(request, newOrderMsg(1));
+    std::string response;
+    for (auto _ : state) {
+        response.clear();
+        std::size_t consumed = handler.handleBinary(request.data(), request.size(), response);
+        benchmark::DoNotOptimize(consumed);
+        benchmark::DoNotOptimize(response.data());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// ob_server's reactor on a free loopback port, run on a background thread
+class LoopbackServer {
+public:
+    explicit LoopbackServer(net::RequestHandler& handler, std::size_t reactors = 1)
+        : server_(handler, config(reactors)), thread_([this] { server_.run(); }) {}
+
+    ~LoopbackServer() {
+        server_.stop();
+        thread_.join();
+    }
+
+    int connect() const {
+        int fd = socket(AF_INET, SOCK_STREAM, 0);
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = htons(server_.port());
+        ::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+        return fd;
+    }
+
+private:
+    static net::ServerConfig config(std::size_t reactors) {
+        net::ServerConfig config;
+        config.port = 0;
+        config.reactors = reactors;
+        return config;
+    }
+
+    net::TcpServer server_;
+    std::thread thread_;
+};
+
+static bool recvExactly(int fd, char* data, std::size_t size) {
+    std::size_t got = 0;
+    while (got < size) {
+        ssize_t n = recv(fd, data + got, size - got, 0);
+        if (n <= 0) return false;
+        got += static_cast<std::size_t>(n);
+    }
+    return true;
+}
+
+static void reportRoundTrips(benchmark::State& state, std::vector<double>& latencies, std::size_t messages) {
+    std::sort(latencies.begin(), latencies.end());
+    if (!latencies.empty()) {
+        state.counters["RoundTrip_P50_ns"] = latencies[latencies.size() / 2];
+        state.counters["RoundTrip_P99_ns"] = latencies[latencies.size() * 99 / 100];
+    }
+    state.counters["Msgs_per_sec"] = benchmark::Counter(static_cast<double>(messages), benchmark::Counter::kIsRate);
+}
+
+// ADD round trip over loopback TCP; range(0) lines are pipelined per write
+static void BM_Protocol_RoundTrip_Text(benchmark::State& state) {
+    AcceptAllService service;
+    net::RequestHandler handler(service);
+    LoopbackServer server(handler);
+    int fd = server.connect();
+    const auto burst = static_cast<std::size_t>(state.range(0));
+    std::string requests;
+    for (std::size_t i = 0; i < burst; ++i) requests += TEXT_ADD;
+    char reply[4096];
+    std::vector<double> latencies;
+    latencies.reserve(static_cast<std::size_t>(state.max_iterations));
+
+    for (auto _ : state) {
+        auto start = std::chrono::steady_clock::now();
+        send(fd, requests.data(), requests.size(), MSG_NOSIGNAL);
+        // Each reply is a single "OK <id>\n" line
+        std::size_t lines = 0;
+        while (lines < burst) {
+            ssize_t n = recv(fd, reply, sizeof(reply), 0);
+            if (n <= 0) break;
+            lines += static_cast<std::size_t>(std::count(reply, reply + n, '\n'));
+        }
+        auto end = std::chrono::steady_clock::now();
+        latencies.push_back(static_cast<double>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()));
+    }
+    close(fd);
+    reportRoundTrips(state, latencies, state.iterations() * burst);
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * burst));
+}
+
+// Binary round trip; range(0) requests are pipelined per write, so each
+// iteration times one burst and its replies
+static void BM_Protocol_RoundTrip_Binary(benchmark::State& state) {
+    AcceptAllService service;
+    net::RequestHandler handler(service);
+    LoopbackServer server(handler);
+    int fd = server.connect();
+    const auto burst = static_cast<std::size_t>(state.range(0));
+
+    const auto logon = binary::makeLogon();
+    send(fd, &logon, sizeof(logon), MSG_NOSIGNAL);
+    binary::LogonMsg ack{};
+    recvExactly(fd, reinterpret_cast<char*>(&ack), sizeof(ack));
+    if (ack.header.type != binary::MsgType::LogonAck) {
+        state.SkipWithError("binary logon refused");
+        close(fd);
+        return;
+    }
+
+    std::string requests;
+    std::vector<char> replies(burst * sizeof(binary::ResponseMsg));
+    std::vector<double> latencies;
+    latencies.reserve(static_cast<std::size_t>(state.max_iterations));
+    std::uint64_t tag = 0;
+
+    for (auto _ : state) {
+        requests.clear();
+        for (std::size_t i = 0; i < burst; ++i) binary::append(requests, newOrderMsg(++tag));
+        auto start = std::chrono::steady_clock::now();
+        send(fd, requests.data(), requests.size(), MSG_NOSIGNAL);
+        recvExactly(fd, replies.data(), replies.size());
+        auto end = std::chrono::steady_clock::now();
+        latencies.push_back(static_cast<double>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()));
+    }
+
+    const auto last = binary::load<binary::ResponseMsg>(replies.data() + replies.size() - sizeof(binary::ResponseMsg));
+    if (last.header.type != binary::MsgType::Accepted || last.clientTag != tag) {
+        state.SkipWithError("unexpected binary reply");
+    }
+    close(fd);
+    reportRoundTrips(state, latencies, state.iterations() * burst);
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * burst));
+}
+
+// Connection scaling: range(0) clients spread over range(1) server reactors,
+// each with one binary NewOrder in flight. An iteration sends one request on
+// every connection and collects all replies through a client-side epoll set;
+// latency is per request, from its send to its reply being read.
+static void BM_Server_ConnectionScaling(benchmark::State& state) {
+    AcceptAllService service;
+    net::RequestHandler handler(service);
+    LoopbackServer server(handler, static_cast<std::size_t>(state.range(1)));
+    const auto clients = static_cast<std::size_t>(state.range(0));
+
+    std::vector<int> fds(clients);
+    const int epollFd = epoll_create1(0);
+    const auto logon = binary::makeLogon();
+    for (std::size_t i = 0; i < clients; ++i) {
+        fds[i] = server.connect();
+        send(fds[i], &logon, sizeof(logon), MSG_NOSIGNAL);
+        binary::LogonMsg ack{};
+        if (!recvExactly(fds[i], reinterpret_cast<char*>(&ack), sizeof(ack))) {
+            state.SkipWithError("connect/logon failed");
+            break;
+        }
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.u64 = i;
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, fds[i], &ev);
+    }
+
+    std::vector<std::chrono::steady_clock::time_point> sentAt(clients);
+    std::vector<epoll_event> ready(clients);
+    std::vector<double> latencies;
+    latencies.reserve(static_cast<std::size_t>(state.max_iterations) * clients);
+    std::uint64_t tag = 0;
+
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < clients; ++i) {
+            const auto msg = newOrderMsg(++tag);
+            sentAt[i] = std::chrono::steady_clock::now();
+            send(fds[i], &msg, sizeof(msg), MSG_NOSIGNAL);
+        }
+        std::size_t pending = clients;
+        while (pending > 0) {
+            const int n = epoll_wait(epollFd, ready.data(), static_cast<int>(ready.size()), 1000);
+            if (n <= 0) break;
+            const auto now = std::chrono::steady_clock::now();
+            for (int k = 0; k < n; ++k) {
+                const auto i = static_cast<std::size_t>(ready[static_cast<std::size_t>(k)].data.u64);
+                binary::ResponseMsg reply{};
+                recvExactly(fds[i], reinterpret_cast<char*>(&reply), sizeof(reply));
+                latencies.push_back(static_cast<double>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(now - sentAt[i]).count()));
+                --pending;
+            }
+        }
+        if (pending > 0) {
+            state.SkipWithError("timed out waiting for replies");
+            break;
+        }
+    }
+
+    for (int fd : fds) close(fd);
+    close(epollFd);
+    reportRoundTrips(state, latencies, state.iterations() * clients);
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * clients));
+}
+
+BENCHMARK(BM_Protocol_Handle_Text)
+    ->Name("Protocol_Handle/Text");
+
+BENCHMARK(BM_Protocol_Handle_Binary)
+    ->Name("Protocol_Handle/Binary");
+
+BENCHMARK(BM_Protocol_RoundTrip_Text)
+    ->Name("Protocol_RoundTrip/Text")
+    ->ArgName("pipeline")
+    ->Arg(1)
+    ->Arg(32)
+    ->UseRealTime()
+    ->Iterations(20000);
+
+BENCHMARK(BM_Protocol_RoundTrip_Binary)
+    ->Name("Protocol_RoundTrip/Binary")
+    ->ArgName("pipeline")
+    ->Arg(1)
+    ->Arg(32)
+    ->UseRealTime()
+    ->Iterations(20000);
+
+BENCHMARK(BM_Server_ConnectionScaling)
+    ->Name("Server_ConnectionScaling")
+    ->ArgNames({"clients", "reactors"})
+    ->Args({10, 1})
+    ->Args({100, 1})
+    ->Args({1000, 1})
+    ->Args({1000, 2})
+    ->UseRealTime()
+    ->Iterations(200);
+
+// BENCHMARK_MAIN(); // Defined in benchmark_orderbook.cpp
@@ -1,10 +1,14 @@
 #include "orderbook/queue/spsc_queue.hpp"
+#include "orderbook/queue/mpsc_queue.hpp"
 #include "orderbook/core/types.hpp"
+#include "orderbook/events/event_types.hpp"
 #include <benchmark/benchmark.h>
+#include <optional>
 #include <thread>
 #include <atomic>
 #include <vector>
 #include <memory>
+#include <algorithm>
 
 using namespace ob::queue;
 using namespace ob::core;
@@ -106,6 +110,234 @@ static void BM_SPSCQueue_Concurrent(benchmark::State& state) {
     state.SetItemsProcessed(pushed.load() + popped.load());
 }
 
+// Producer-scaling transfer: state.range(0) producer threads push a fixed
+// number of orders per iteration and the benchmark thread drains them as the
+// single consumer. Producer threads persist across iterations and start each
+// round when the generation counter advances. Full/empty queues back off
+// with yield so oversubscribed runs (more threads than cores) still progress.
+template <typename Queue>
+static void BM_QueueTransfer(benchmark::State& state) {
+    constexpr std::size_t QUEUE_SIZE = 1024;
+    constexpr std::size_t ITEMS_PER_ROUND = 1 << 15;
+    const auto producers = static_cast<std::size_t>(state.range(0));
+    const std::size_t perProducer = ITEMS_PER_ROUND / producers;
+    const std::size_t total = perProducer * producers;
+    Queue queue(QUEUE_SIZE);
+    
+    std::atomic<std::uint64_t> generation{0};
+    std::atomic<bool> running{true};
+    std::vector<std::thread> threads;
+    threads.reserve(producers);
+    for (std::size_t p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p]() {
+            Order order{static_cast<OrderId>(p), 1, Side::Buy, OrderType::Limit, 10000, 100, {}};
+            std::uint64_t seen = 0;
+            while (true) {
+                std::uint64_t gen;
+                while ((gen = generation.load(std::memory_order_acquire)) == seen) {
+                    if (!running.load(std::memory_order_relaxed)) return;
+                    std::this_thread::yield();
+                }
+                seen = gen;
+                for (std::size_t i = 0; i < perProducer; ++i) {
+                    while (!queue.tryPush(order)) std::this_thread::yield();
+                }
+            }
+        });
+    }
+    
+    Order out;
+    for (auto _ : state) {
+        generation.fetch_add(1, std::memory_order_release);
+        for (std::size_t received = 0; received < total;) {
+            if (queue.tryPop(out)) {
+                ++received;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+        benchmark::DoNotOptimize(out);
+    }
+    
+    running.store(false);
+    for (auto& t : threads) t.join();
+    
+    state.counters["Producers"] = static_cast<double>(producers);
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(total));
+}
+
+// Batch-size sweep: one producer pushes with tryPushN and the consumer drains
+// with tryPopN, state.range(0) items at a time (1 = per-item index updates).
+// Larger batches amortise the shared head/tail cache-line traffic.
+template <typename Queue>
+static void BM_QueueBatchTransfer(benchmark::State& state) {
+    constexpr std::size_t QUEUE_SIZE = 1024;
+    constexpr std::size_t ITEMS_PER_ROUND = 1 << 15;
+    const auto batch = static_cast<std::size_t>(state.range(0));
+    Queue queue(QUEUE_SIZE);
+    
+    std::atomic<std::uint64_t> generation{0};
+    std::atomic<bool> running{true};
+    std::thread producer([&]() {
+        std::vector<Order> items(batch, Order{1, 1, Side::Buy, OrderType::Limit, 10000, 100, {}});
+        std::uint64_t seen = 0;
+        while (true) {
+            std::uint64_t gen;
+            while ((gen = generation.load(std::memory_order_acquire)) == seen) {
+                if (!running.load(std::memory_order_relaxed)) return;
+                std::this_thread::yield();
+            }
+            seen = gen;
+            for (std::size_t sent = 0; sent < ITEMS_PER_ROUND;) {
+                const std::size_t n = queue.tryPushN(items.data(), std::min(batch, ITEMS_PER_ROUND - sent));
+                if (n == 0) std::this_thread::yield();
+                sent += n;
+            }
+        }
+    });
+    
+    std::vector<Order> out(batch);
+    for (auto _ : state) {
+        generation.fetch_add(1, std::memory_order_release);
+        for (std::size_t received = 0; received < ITEMS_PER_ROUND;) {
+            const std::size_t n = queue.tryPopN(out.data(), batch);
+            if (n == 0) std::this_thread::yield();
+            received += n;
+        }
+        benchmark::DoNotOptimize(out.data());
+    }
+    
+    running.store(false);
+    producer.join();
+    
+    state.counters["Batch"] = static_cast<double>(batch);
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(ITEMS_PER_ROUND));
+}
+
+// Uncontended single-thread push/pop cost of the MPSC ring (CAS on claim)
+static void BM_MPSCQueue_PushPop(benchmark::State& state) {
+    constexpr std::size_t QUEUE_SIZE = 1024;
+    MpscRingBuffer<Order> queue(QUEUE_SIZE);
+    Order order{1, 1, Side::Buy, OrderType::Limit, 10000, 100, {}};
+    Order out;
+    
+    for (auto _ : state) {
+        bool pushed = queue.tryPush(order);
+        bool popped = queue.tryPop(out);
+        benchmark::DoNotOptimize(pushed);
+        benchmark::DoNotOptimize(popped);
+    }
+    
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Event ring layouts. LegacyEvent is the previous record (optional<Trade>
+// payload on every event) in constructed-flag slots; the compact Event is
+// trivially copyable and stored in plain slots.
+struct LegacyEvent {
+    ob::events::EventType type{ob::events::EventType::Ack};
+    OrderId orderId{};
+    std::optional<Trade> trade;
+    Timestamp ts{};
+    std::uint32_t symbolId{0};
+};
+
+using LegacyEventRing = SpscRingBuffer<LegacyEvent, false>;
+using CompactEventRing = SpscRingBuffer<ob::events::Event>;
+
+template <typename Ev>
+static Ev sampleEvent(std::uint64_t i) {
+    // One trade per ack, roughly the mix of a crossing order flow
+    Trade t{i, i + 1, 10000, 100, {}};
+    if constexpr (std::is_same_v<Ev, LegacyEvent>) {
+        LegacyEvent e;
+        e.type = (i & 1) ? ob::events::EventType::Trade : ob::events::EventType::Ack;
+        e.orderId = i;
+        if (i & 1) e.trade = t;
+        return e;
+    } else {
+        if (i & 1) return ob::events::Event::makeTrade(t, 1);
+        ob::events::Event e;
+        e.orderId = i;
+        return e;
+    }
+}
+
+// Event-queue transfer: one producer thread (the matching thread's role)
+// pushes ITEMS_PER_ROUND events, the benchmark thread drains them like the
+// event-drain thread. state.range(0) is the push/pop batch (1 = per item).
+template <typename Queue, typename Ev>
+static void BM_EventTransfer(benchmark::State& state) {
+    constexpr std::size_t QUEUE_SIZE = 16384;
+    constexpr std::size_t ITEMS_PER_ROUND = 1 << 16;
+    const auto batch = static_cast<std::size_t>(state.range(0));
+    Queue queue(QUEUE_SIZE);
+    
+    std::atomic<std::uint64_t> generation{0};
+    std::atomic<bool> running{true};
+    std::thread producer([&]() {
+        std::vector<Ev> items;
+        for (std::size_t i = 0; i < batch; ++i) items.push_back(sampleEvent<Ev>(i));
+        std::uint64_t seen = 0;
+        while (true) {
+            std::uint64_t gen;
+            while ((gen = generation.load(std::memory_order_acquire)) == seen) {
+                if (!running.load(std::memory_order_relaxed)) return;
+                std::this_thread::yield();
+            }
+            seen = gen;
+            for (std::size_t sent = 0; sent < ITEMS_PER_ROUND;) {
+                std::size_t n;
+                if (batch == 1) n = queue.tryPush(items[0]) ? 1 : 0;
+                else n = queue.tryPushN(items.data(), std::min(batch, ITEMS_PER_ROUND - sent));
+                if (n == 0) std::this_thread::yield();
+                sent += n;
+            }
+        }
+    });
+    
+    std::vector<Ev> out(batch);
+    for (auto _ : state) {
+        generation.fetch_add(1, std::memory_order_release);
+        for (std::size_t received = 0; received < ITEMS_PER_ROUND;) {
+            std::size_t n;
+            if (batch == 1) n = queue.tryPop(out[0]) ? 1 : 0;
+            else n = queue.tryPopN(out.data(), batch);
+            if (n == 0) std::this_thread::yield();
+            received += n;
+        }
+        benchmark::DoNotOptimize(out.data());
+    }
+    
+    running.store(false);
+    producer.join();
+    
+    state.counters["Batch"] = static_cast<double>(batch);
+    state.counters["EventBytes"] = static_cast<double>(sizeof(Ev));
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(ITEMS_PER_ROUND));
+    state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(ITEMS_PER_ROUND * sizeof(Ev)));
+}
+
+// Uncontended push+pop of one event: the per-item copy cost of each layout
+template <typename Queue, typename Ev>
+static void BM_EventPushPop(benchmark::State& state) {
+    constexpr std::size_t QUEUE_SIZE = 1024;
+    Queue queue(QUEUE_SIZE);
+    const Ev event = sampleEvent<Ev>(1);
+    Ev out;
+    
+    for (auto _ : state) {
+        bool pushed = queue.tryPush(event);
+        bool popped = queue.tryPop(out);
+        benchmark::DoNotOptimize(pushed);
+        benchmark::DoNotOptimize(popped);
+        benchmark::DoNotOptimize(out);
+    }
+    
+    state.counters["EventBytes"] = static_cast<double>(sizeof(Ev));
+    state.SetItemsProcessed(state.iterations());
+}
+
 // Register benchmarks
 BENCHMARK(BM_SPSCQueue_Push)
     ->Name("SPSCQueue_Push")
@@ -124,5 +356,49 @@ BENCHMARK(BM_SPSCQueue_Concurrent)
     ->UseRealTime()
     ->MinTime(2.0);  // Run for at least 2 seconds
 
+BENCHMARK(BM_MPSCQueue_PushPop)
+    ->Name("MPSCQueue_PushPop")
+    ->Iterations(1000000);
+
+// SPSC baseline: only valid with exactly one producer
+BENCHMARK_TEMPLATE(BM_QueueTransfer, SpscRingBuffer<Order>)
+    ->Name("QueueTransfer/SPSC")
+    ->Arg(1)
+    ->UseRealTime();
+
+BENCHMARK_TEMPLATE(BM_QueueTransfer, MpscRingBuffer<Order>)
+    ->Name("QueueTransfer/MPSC")
+    ->Arg(1)
+    ->Arg(2)
+    ->Arg(4)
+    ->Arg(8)
+    ->UseRealTime();
+
+BENCHMARK_TEMPLATE(BM_QueueBatchTransfer, SpscRingBuffer<Order>)
+    ->Name("QueueBatchTransfer/SPSC")
+    ->RangeMultiplier(4)->Range(1, 256)
+    ->UseRealTime();
+
+BENCHMARK_TEMPLATE(BM_QueueBatchTransfer, MpscRingBuffer<Order>)
+    ->Name("QueueBatchTransfer/MPSC")
+    ->RangeMultiplier(4)->Range(1, 256)
+    ->UseRealTime();
+
+BENCHMARK_TEMPLATE(BM_EventPushPop, LegacyEventRing, LegacyEvent)
+    ->Name("EventRing_PushPop/Legacy");
+
+BENCHMARK_TEMPLATE(BM_EventPushPop, CompactEventRing, ob::events::Event)
+    ->Name("EventRing_PushPop/Compact");
+
+BENCHMARK_TEMPLATE(BM_EventTransfer, LegacyEventRing, LegacyEvent)
+    ->Name("EventRing_Transfer/Legacy")
+    ->Arg(1)->Arg(64)
+    ->UseRealTime();
+
+BENCHMARK_TEMPLATE(BM_EventTransfer, CompactEventRing, ob::events::Event)
+    ->Name("EventRing_Transfer/Compact")
+    ->Arg(1)->Arg(64)
+    ->UseRealTime();
+
 // BENCHMARK_MAIN(); // Defined in benchmark_orderbook.cpp
 
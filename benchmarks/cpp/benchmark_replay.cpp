@@ -0,0 +1,135 @@
+#include "orderbook/replay/order_flow.hpp"
+#include "orderbook/replay/replay_harness.hpp"
+#include "orderbook/core/command.hpp"
+#include "orderbook/core/types.hpp"
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+
+using namespace ob;
+using namespace ob::core;
+
+namespace {
+
+constexpr std::size_t REPLAY_COMMANDS = 200'000;
+
+// The flow the older load benchmarks use: prices uniform over 10000-20000,
+// one cancel of a random earlier order per ten commands. Builds a wide,
+// shallow book that rarely trades.
+replay::OrderFlow uniformFlow() {
+    std::mt19937_64 gen(42);
+    std::uniform_int_distribution<Price> priceDist(10000, 20000);
+    std::uniform_int_distribution<Quantity> qtyDist(1, 1000);
+    replay::OrderFlow flow;
+    flow.referencePrice = 15000;
+    flow.records.reserve(REPLAY_COMMANDS);
+    OrderId nextId = 1;
+    for (std::size_t i = 0; i < REPLAY_COMMANDS; ++i) {
+        Command command;
+        if (i % 10 == 9) {
+            command = Command::cancel(1, std::uniform_int_distribution<OrderId>(1, nextId - 1)(gen));
+        } else {
+            const Side side = (gen() & 1) ? Side::Buy : Side::Sell;
+            command = Command::newOrder(Order{nextId++, 1, side, OrderType::Limit, priceDist(gen), qtyDist(gen), {}});
+        }
+        command.ts = Timestamp{std::chrono::nanoseconds{static_cast<std::int64_t>(i) * 1000}};
+        flow.records.push_back(journal::toRecord(command));
+    }
+    return flow;
+}
+
+const replay::OrderFlow& flowFor(std::int64_t kind) {
+    static const replay::OrderFlow uniform = uniformFlow();
+    static const replay::OrderFlow clustered = [] {
+        replay::FlowConfig config;
+        config.commands = REPLAY_COMMANDS;
+        return replay::generateFlow(config);
+    }();
+    return kind == 0 ? uniform : clustered;
+}
+
+void reportLatency(benchmark::State& state, const core::LatencyHistogram& latency, std::uint64_t trades,
+                   std::uint64_t commands) {
+    state.counters["p50_ns"] = static_cast<double>(latency.percentile(50.0));
+    state.counters["p99_ns"] = static_cast<double>(latency.percentile(99.0));
+    state.counters["p99.9_ns"] = static_cast<double>(latency.percentile(99.9));
+    state.counters["max_ns"] = static_cast<double>(latency.max());
+    state.counters["trades/cmd"] = commands ? static_cast<double>(trades) / static_cast<double>(commands) : 0.0;
+}
+
+} // namespace
+
+// One flow replayed through a fresh book per iteration, as fast as
+// possible. Arg flow: 0 = uniform prices (benchmark_load's generator),
+// 1 = generated clustered flow (replay::FlowConfig defaults). Arg target:
+// 0 = MatchingEngine::apply, 1 = OrderManagementSystem end to end. Arg
+// book: 0 = map, 1 = ladder. Latency percentiles are over every command
+// of every iteration.
+static void BM_Replay(benchmark::State& state) {
+    const replay::OrderFlow& flow = flowFor(state.range(0));
+    replay::ReplayConfig config;
+    config.target = state.range(1) == 1 ? replay::ReplayTarget::Oms : replay::ReplayTarget::Engine;
+    config.bookType = state.range(2) == 1 ? book::BookType::Ladder : book::BookType::Map;
+    core::LatencyHistogram latency;
+    std::uint64_t trades = 0;
+    std::uint64_t commands = 0;
+
+    for (auto _ : state) {
+        const replay::ReplayResult result = replay::replayFlow(flow, config);
+        state.SetIterationTime(std::chrono::duration<double>(result.elapsed).count());
+        latency.merge(result.latency);
+        trades += result.trades;
+        commands += result.commands;
+    }
+
+    state.SetItemsProcessed(static_cast<std::int64_t>(commands));
+    reportLatency(state, latency, trades, commands);
+}
+
+BENCHMARK(BM_Replay)
+    ->Name("Replay")
+    ->ArgNames({"flow", "target", "book"})
+    ->ArgsProduct({{0, 1}, {0, 1}, {0, 1}})
+    ->UseManualTime()
+    ->Unit(benchmark::kMillisecond);
+
+// The clustered flow released at its recorded pace (about 1.6 s of
+// arrivals, bursts included). Latency runs from each command's scheduled
+// release, so a burst that backs up the queue shows in the tail instead of
+// slowing the sender down. Arg target as for Replay, map book.
+static void BM_Replay_Paced(benchmark::State& state) {
+    const replay::OrderFlow& flow = flowFor(1);
+    replay::ReplayConfig config;
+    config.target = state.range(0) == 1 ? replay::ReplayTarget::Oms : replay::ReplayTarget::Engine;
+    config.speed = 1.0;
+    core::LatencyHistogram latency;
+    std::uint64_t trades = 0;
+    std::uint64_t commands = 0;
+    std::chrono::nanoseconds maxLag{0};
+
+    for (auto _ : state) {
+        const replay::ReplayResult result = replay::replayFlow(flow, config);
+        state.SetIterationTime(std::chrono::duration<double>(result.elapsed).count());
+        latency.merge(result.latency);
+        trades += result.trades;
+        commands += result.commands;
+        maxLag = std::max(maxLag, result.maxLag);
+    }
+
+    state.SetItemsProcessed(static_cast<std::int64_t>(commands));
+    reportLatency(state, latency, trades, commands);
+    state.counters["maxLag_us"] = static_cast<double>(maxLag.count()) / 1e3;
+}
+
+BENCHMARK(BM_Replay_Paced)
+    ->Name("Replay_Paced")
+    ->ArgName("target")
+    ->Arg(0)
+    ->Arg(1)
+    ->UseManualTime()
+    ->Unit(benchmark::kMillisecond)
+    ->Iterations(2);
+
+// BENCHMARK_MAIN(); // Defined in benchmark_orderbook.cpp
@@ -0,0 +1,136 @@
+#include "orderbook/risk/pre_trade_risk.hpp"
+#include "orderbook/engine/matching_engine.hpp"
+#include "orderbook/book/order_book.hpp"
+#include "orderbook/core/command.hpp"
+#include "orderbook/core/constants.hpp"
+#include "orderbook/core/types.hpp"
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace ob;
+using namespace ob::core;
+
+namespace {
+
+constexpr Price RISK_MID = 10'000;
+constexpr std::size_t RISK_FLOW = 1 << 16; // commands generated per run, replayed in a loop
+constexpr std::size_t CANCEL_LAG = 32;     // each add cancels the order added this many adds before
+
+// Every check on, with limits the flow below stays inside
+risk::RiskLimits benchLimits(std::size_t accounts) {
+    risk::RiskLimits limits;
+    limits.maxOrderQuantity = 1'000;
+    limits.maxOrderNotional = 100'000'000;
+    limits.priceCollarBps = 500;
+    limits.maxOpenOrders = 100'000;
+    limits.maxPosition = 1'000'000'000;
+    limits.maxMessages = 1'000'000'000;
+    limits.maxAccounts = accounts;
+    return limits;
+}
+
+// An order of the given account, with a session-style id as ob_server issues
+Order accountOrder(std::uint32_t account, std::uint64_t sequence, Side side, Price price, Quantity quantity,
+                   Timestamp ts) noexcept {
+    Order order{(static_cast<OrderId>(account) << ORDER_ID_SESSION_SHIFT) | sequence, 1, side, OrderType::Limit,
+                price, quantity, ts};
+    order.account = account;
+    return order;
+}
+
+// Limit orders around RISK_MID from the given number of accounts, each
+// followed by a cancel of an earlier one so the book stays bounded
+std::vector<Command> quoteFlow(std::size_t accounts) {
+    std::mt19937_64 gen(42);
+    std::uniform_int_distribution<Price> offset(-5, 5);
+    std::uniform_int_distribution<Quantity> qty(1, 10);
+    std::vector<Command> flow;
+    flow.reserve(RISK_FLOW);
+    std::vector<OrderId> added;
+    for (std::uint64_t i = 1; flow.size() + 1 < RISK_FLOW; ++i) {
+        const auto account = static_cast<std::uint32_t>(i % accounts);
+        const Side side = (i & 1) ? Side::Buy : Side::Sell;
+        const Price price = RISK_MID + offset(gen);
+        const Order order = accountOrder(account, i, side, price, qty(gen),
+                                         Timestamp{std::chrono::nanoseconds{static_cast<std::int64_t>(i * 1'000)}});
+        flow.push_back(Command::newOrder(order));
+        added.push_back(order.orderId);
+        if (added.size() > CANCEL_LAG) flow.push_back(Command::cancel(1, added[added.size() - 1 - CANCEL_LAG]));
+    }
+    return flow;
+}
+
+} // namespace
+
+// The check alone: one PreTradeRisk::checkOrder per iteration, orders
+// spread over the given number of accounts. Arg accounts: distinct
+// accounts, all tracked in the flat table.
+static void BM_Risk_Check(benchmark::State& state) {
+    const auto accounts = static_cast<std::size_t>(state.range(0));
+    risk::PreTradeRisk stage(benchLimits(accounts), RISK_MID);
+    std::vector<Order> orders;
+    orders.reserve(4096);
+    for (std::uint64_t i = 0; i < 4096; ++i) {
+        orders.push_back(accountOrder(static_cast<std::uint32_t>(i % accounts), i, (i & 1) ? Side::Buy : Side::Sell,
+                                      RISK_MID + static_cast<Price>(i % 11) - 5, static_cast<Quantity>(1 + i % 10),
+                                      Timestamp{}));
+    }
+    std::int64_t now = 0;
+    std::size_t i = 0;
+    for (auto _ : state) {
+        const Order& order = orders[i++ & 4095];
+        now += 1'000;
+        benchmark::DoNotOptimize(stage.checkOrder(order, Timestamp{std::chrono::nanoseconds{now}}));
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.counters["refused"] = static_cast<double>(stage.rejects());
+}
+
+BENCHMARK(BM_Risk_Check)
+    ->Name("Risk_Check")
+    ->ArgNames({"accounts"})
+    ->Arg(1)
+    ->Arg(64)
+    ->Arg(1024);
+
+// What the stage adds per command on the matching thread: a quote flow
+// (adds and cancels over 64 accounts) applied through MatchingEngine::apply.
+// Arg risk: 0 = no stage, 1 = every check on.
+static void BM_Risk_Engine(benchmark::State& state) {
+    const bool withRisk = state.range(0) == 1;
+    constexpr std::size_t accounts = 64;
+    const std::vector<Command> flow = quoteFlow(accounts);
+    // A fresh book and stage for every pass over the flow, as the ids repeat
+    auto makeEngine = [&] {
+        std::shared_ptr<risk::PreTradeRisk> stage;
+        if (withRisk) stage = std::make_shared<risk::PreTradeRisk>(benchLimits(accounts), RISK_MID);
+        return std::make_unique<engine::MatchingEngine>(std::make_shared<book::OrderBook>(), nullptr, 1, stage);
+    };
+    auto engine = makeEngine();
+    std::uint64_t rejects = 0;
+
+    std::size_t i = 0;
+    for (auto _ : state) {
+        engine->apply(flow[i]);
+        if (++i == flow.size()) {
+            state.PauseTiming();
+            rejects += engine->metrics().rejects.load();
+            engine = makeEngine();
+            i = 0;
+            state.ResumeTiming();
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.counters["rejects"] = static_cast<double>(rejects + engine->metrics().rejects.load());
+}
+
+BENCHMARK(BM_Risk_Engine)
+    ->Name("Risk_Engine")
+    ->ArgNames({"risk"})
+    ->Arg(0)
+    ->Arg(1);
+
+// BENCHMARK_MAIN(); // Defined in benchmark_orderbook.cpp
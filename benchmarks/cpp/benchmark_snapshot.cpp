@@ -0,0 +1,269 @@
+#include "orderbook/journal/snapshot.hpp"
+#include "orderbook/oms/instrument_manager.hpp"
+#include "orderbook/engine/matching_engine.hpp"
+#include "orderbook/book/order_book.hpp"
+#include "orderbook/book/ladder_order_book.hpp"
+#include "orderbook/core/command.hpp"
+#include "orderbook/core/constants.hpp"
+#include "orderbook/core/types.hpp"
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+using namespace ob;
+using namespace ob::core;
+
+namespace {
+
+constexpr std::uint32_t SNAPSHOT_SYMBOL = 1;
+constexpr Price SNAPSHOT_MID = 10000;
+constexpr Price SNAPSHOT_DEPTH = 1000;         // price levels per side
+constexpr std::size_t RESTING = 1 << 20;       // resting orders in every benchmark book
+constexpr std::size_t FLOW_BATCH = 64;         // one processor wakeup (DEFAULT_PROCESS_BATCH)
+
+struct ScratchDir {
+    std::filesystem::path path;
+    explicit ScratchDir(const std::string& name)
+        : path(std::filesystem::temp_directory_path() / (name + "-" + std::to_string(::getpid()))) {
+        std::filesystem::remove_all(path);
+        std::filesystem::create_directories(path);
+    }
+    ~ScratchDir() {
+        std::error_code ec;
+        std::filesystem::remove_all(path, ec);
+    }
+};
+
+// Resting order i: alternating sides, spread over SNAPSHOT_DEPTH levels a
+// side, never crossing
+Order restingOrder(OrderId id) {
+    const Side side = (id & 1) ? Side::Buy : Side::Sell;
+    const Price offset = 1 + static_cast<Price>((id >> 1) % SNAPSHOT_DEPTH);
+    const Price price = side == Side::Buy ? SNAPSHOT_MID - offset : SNAPSHOT_MID + offset;
+    return Order{id, SNAPSHOT_SYMBOL, side, OrderType::Limit, price, 1 + static_cast<Quantity>(id % 100), {}};
+}
+
+// Arg 0 = map book, 1 = ladder wide enough to hold every level
+std::shared_ptr<book::IOrderBook> makeBook(std::int64_t type) {
+    if (type == 1) {
+        return std::make_shared<book::LadderOrderBook>(SNAPSHOT_MID, static_cast<std::size_t>(4 * SNAPSHOT_DEPTH));
+    }
+    return std::make_shared<book::OrderBook>();
+}
+
+std::shared_ptr<book::IOrderBook> makeFullBook(std::int64_t type) {
+    auto book = makeBook(type);
+    for (OrderId id = 1; id <= RESTING; ++id) book->addOrder(restingOrder(id));
+    return book;
+}
+
+std::vector<book::SnapshotOrder> capture(book::IOrderBook& book) {
+    std::vector<book::SnapshotOrder> orders;
+    book.beginSnapshot(orders);
+    while (!book.snapshotStep(core::DEFAULT_SNAPSHOT_STEP)) {}
+    return orders;
+}
+
+const char* bookName(std::int64_t type) { return type == 1 ? "ladder" : "map"; }
+
+} // namespace
+
+// Matching-thread cost of snapshotting a book of 1M resting orders: the
+// cut plus every DEFAULT_SNAPSHOT_STEP slice. Arg 1 also applies one
+// 64-command batch (cancel the oldest order, add a new one) between slices,
+// as the processor does, so levels are copied on write as well. sliceUs and
+// maxSliceUs are the mean and longest time the matching thread spent in one
+// slice.
+static void BM_Snapshot_Capture(benchmark::State& state) {
+    const bool withFlow = state.range(0) != 0;
+    auto book = makeFullBook(state.range(1));
+    engine::MatchingEngine engine(book, nullptr, SNAPSHOT_SYMBOL);
+    OrderId oldest = 1;
+    OrderId nextId = RESTING + 1;
+    std::vector<book::SnapshotOrder> orders;
+    double maxSlice = 0.0;
+    double sliceTotal = 0.0;
+    std::uint64_t slices = 0;
+    std::uint64_t batches = 0;
+
+    for (auto _ : state) {
+        book->beginSnapshot(orders);
+        for (;;) {
+            const auto sliceStart = std::chrono::steady_clock::now();
+            const bool done = book->snapshotStep(core::DEFAULT_SNAPSHOT_STEP);
+            const double slice = std::chrono::duration<double, std::micro>(
+                std::chrono::steady_clock::now() - sliceStart).count();
+            maxSlice = std::max(maxSlice, slice);
+            sliceTotal += slice;
+            ++slices;
+            if (done) break;
+            if (!withFlow) continue;
+            for (std::size_t i = 0; i < FLOW_BATCH; i += 2) {
+                engine.apply(Command::cancel(SNAPSHOT_SYMBOL, oldest++));
+                engine.apply(Command::newOrder(restingOrder(nextId++)));
+            }
+            ++batches;
+        }
+        benchmark::DoNotOptimize(orders.data());
+    }
+
+    state.SetLabel(bookName(state.range(1)));
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(RESTING));
+    state.counters["maxSliceUs"] = maxSlice;
+    state.counters["sliceUs"] = sliceTotal / static_cast<double>(slices);
+    state.counters["slices"] = static_cast<double>(slices) / static_cast<double>(state.iterations());
+    state.counters["batches"] = static_cast<double>(batches) / static_cast<double>(state.iterations());
+}
+
+// Writing a captured 1M-order book to a snapshot file, fsync and rename included
+static void BM_Snapshot_Write(benchmark::State& state) {
+    ScratchDir dir("ob-bench-snapshot-write");
+    auto book = makeFullBook(0);
+    const auto orders = capture(*book);
+    journal::SnapshotSection section;
+    section.instrument.symbolId = SNAPSHOT_SYMBOL;
+    section.instrument.ticker = "SNAP";
+    section.orders = orders.data();
+    section.orderCount = orders.size();
+    std::uint64_t bytes = 0;
+    std::uint64_t id = 0;
+
+    for (auto _ : state) {
+        journal::SnapshotHeader header;
+        header.id = ++id;
+        bytes += journal::writeSnapshot(dir.path.string(), header, {section});
+        state.PauseTiming();
+        std::filesystem::remove(dir.path / journal::snapshotFileName(id));
+        state.ResumeTiming();
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(orders.size()));
+    state.SetBytesProcessed(static_cast<std::int64_t>(bytes));
+}
+
+// Rebuilding the book from a snapshot file: map and check the file, then
+// either bulk-load it (arg 0) or call addOrder once per order (arg 1)
+static void BM_Snapshot_Load(benchmark::State& state) {
+    const bool perOrder = state.range(0) != 0;
+    const std::int64_t type = state.range(1);
+    ScratchDir dir("ob-bench-snapshot-load");
+    {
+        auto book = makeFullBook(type);
+        const auto orders = capture(*book);
+        journal::SnapshotSection section;
+        section.instrument.symbolId = SNAPSHOT_SYMBOL;
+        section.orders = orders.data();
+        section.orderCount = orders.size();
+        journal::SnapshotHeader header;
+        header.id = 1;
+        journal::writeSnapshot(dir.path.string(), header, {section});
+    }
+    const std::string path = (dir.path / journal::snapshotFileName(1)).string();
+
+    for (auto _ : state) {
+        auto book = makeBook(type);
+        journal::SnapshotReader reader(path);
+        const auto& section = reader.sections().front();
+        if (perOrder) {
+            for (std::size_t i = 0; i < section.orderCount; ++i) book->addOrder(book::toOrder(section.orders[i]));
+        } else {
+            book->loadSnapshot(section.orders, section.orderCount);
+        }
+        benchmark::DoNotOptimize(book->findBestBid());
+        state.PauseTiming();
+        book.reset(); // tearing down 1M orders is not part of the load
+        state.ResumeTiming();
+    }
+
+    state.SetLabel(bookName(type));
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(RESTING));
+}
+
+// Startup recovery through InstrumentManager::openJournal of a book with
+// 1M resting orders and a 64k-command tail after it. Arg 0 replays the
+// whole journal; arg 1 loads a snapshot taken before the tail and replays
+// only the tail. Timed from the recovery's own clock.
+static void BM_Snapshot_Recover(benchmark::State& state) {
+    const bool withSnapshot = state.range(0) != 0;
+    ScratchDir dir("ob-bench-snapshot-recover");
+    journal::JournalConfig config;
+    config.directory = dir.path.string();
+    {
+        oms::InstrumentManager manager;
+        manager.openJournal(config);
+        manager.addInstrument("SNAP", "snapshot benchmark", "bench", static_cast<double>(SNAPSHOT_MID),
+                              book::BookType::Map, queue::WaitStrategyType::SpinPark);
+        auto submit = [&](const Order& order) {
+            while (!manager.submitOrder(order)) std::this_thread::yield();
+        };
+        for (OrderId id = 1; id <= RESTING; ++id) submit(restingOrder(id));
+        if (withSnapshot) manager.saveSnapshot();
+        OrderId oldest = 1;
+        for (OrderId id = RESTING + 1; id <= RESTING + (1 << 15); ++id) {
+            while (!manager.cancelOrder(SNAPSHOT_SYMBOL, oldest)) std::this_thread::yield();
+            ++oldest;
+            submit(restingOrder(id));
+        }
+        manager.stop();
+    }
+
+    double seconds = 0.0;
+    std::uint64_t commands = 0;
+    for (auto _ : state) {
+        oms::InstrumentManager manager;
+        const auto recovered = manager.openJournal(config);
+        if (!recovered || recovered->snapshotId != (withSnapshot ? 1u : 0u)) {
+            state.SkipWithError("recovery did not use the expected snapshot");
+            break;
+        }
+        const double elapsed = std::chrono::duration<double>(recovered->elapsed).count();
+        state.SetIterationTime(elapsed);
+        seconds += elapsed;
+        commands = recovered->commands;
+        benchmark::DoNotOptimize(manager.getBestBid(SNAPSHOT_SYMBOL));
+        manager.stop();
+    }
+
+    state.counters["replayed"] = static_cast<double>(commands);
+    state.counters["ms"] = state.iterations() ? 1e3 * seconds / static_cast<double>(state.iterations()) : 0.0;
+}
+
+BENCHMARK(BM_Snapshot_Capture)
+    ->Name("Snapshot_Capture")
+    ->ArgNames({"flow", "book"})
+    ->Args({0, 0})
+    ->Args({1, 0})
+    ->Args({0, 1})
+    ->Args({1, 1})
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK(BM_Snapshot_Write)
+    ->Name("Snapshot_Write")
+    ->Unit(benchmark::kMillisecond)
+    ->Iterations(5);
+
+BENCHMARK(BM_Snapshot_Load)
+    ->Name("Snapshot_Load")
+    ->ArgNames({"perOrder", "book"})
+    ->Args({0, 0})
+    ->Args({1, 0})
+    ->Args({0, 1})
+    ->Args({1, 1})
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK(BM_Snapshot_Recover)
+    ->Name("Snapshot_Recover")
+    ->ArgName("snapshot")
+    ->Arg(0)
+    ->Arg(1)
+    ->UseManualTime()
+    ->Unit(benchmark::kMillisecond)
+    ->Iterations(3);
+
+// BENCHMARK_MAIN(); // Defined in benchmark_orderbook.cpp
@@ -0,0 +1,74 @@
+#!/bin/bash
+
+# OrderBook server scaling sweep
+# Starts a fresh ob_server for every point and drives it with ob_loadgen
+# at a fixed open-loop rate, so each row of results/scaling.csv is one
+# point of a throughput/latency curve. Axes are space-separated lists:
+#   SHARDS       worker threads (0 = one processor thread per instrument)
+#   INSTRUMENTS  instruments the load is spread over
+#   CONNECTIONS  binary client connections
+#   RATES        offered messages per second
+# OB_BIN is the directory holding ob_server and ob_loadgen, SERVER_ARGS
+# and LOADGEN_ARGS are passed through (e.g. SERVER_ARGS="--reactors 2").
+
+set -e
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+cd "$SCRIPT_DIR"
+
+OB_BIN="${OB_BIN:-../orderbook/build}"
+SHARDS="${SHARDS:-0 1 2 4}"
+INSTRUMENTS="${INSTRUMENTS:-1 8}"
+CONNECTIONS="${CONNECTIONS:-1 8}"
+RATES="${RATES:-25000 50000 100000 200000}"
+DURATION="${DURATION:-5}"
+WARMUP="${WARMUP:-1}"
+OUT="${OUT:-results/scaling.csv}"
+PORT=9999
+
+mkdir -p "$(dirname "$OUT")"
+
+wait_for_port() {
+    for _ in $(seq 50); do
+        if (exec 3<>/dev/tcp/127.0.0.1/$PORT) 2>/dev/null; then return 0; fi
+        sleep 0.1
+    done
+    echo "ob_server did not start" >&2
+    return 1
+}
+
+echo "📈 OrderBook server scaling sweep -> $OUT"
+header_written=false
+for shards in $SHARDS; do
+    shard_args=()
+    if [ "$shards" -gt 0 ]; then shard_args=(--shards "$shards"); fi
+    for instruments in $INSTRUMENTS; do
+        for connections in $CONNECTIONS; do
+            for rate in $RATES; do
+                # shellcheck disable=SC2086
+                "$OB_BIN/ob_server" "${shard_args[@]}" $SERVER_ARGS > /dev/null 2>&1 &
+                server=$!
+                # set -e exits on a server that never came up: do not leave it holding the port
+                trap 'kill "$server" 2>/dev/null' EXIT
+                wait_for_port
+                # shellcheck disable=SC2086
+                row="$("$OB_BIN/ob_loadgen" --connections "$connections" --instruments "$instruments" \
+                       --rate "$rate" --duration "$DURATION" --warmup "$WARMUP" --format csv $LOADGEN_ARGS)" || true
+                kill "$server" 2>/dev/null || true
+                wait "$server" 2>/dev/null || true
+                trap - EXIT
+                if [ -z "$row" ]; then
+                    echo "  shards=$shards instruments=$instruments connections=$connections rate=$rate: no result" >&2
+                    continue
+                fi
+                if [ "$header_written" = false ]; then
+                    echo "shards,$(echo "$row" | head -n 1)" > "$OUT"
+                    header_written=true
+                fi
+                echo "$shards,$(echo "$row" | tail -n 1)" >> "$OUT"
+                echo "  shards=$shards instruments=$instruments connections=$connections rate=$rate done"
+            done
+        done
+    done
+done
+echo "✅ Done"
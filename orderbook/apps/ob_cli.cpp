@@ -18,12 +18,10 @@ int main() {
                 std::cout << "ACK: orderId=" << event.orderId << "\n";
                 break;
             case events::EventType::Trade:
-                if (event.trade) {
-                    std::cout << "TRADE: maker=" << event.trade->makerId 
-                              << " taker=" << event.trade->takerId
-                              << " price=" << event.trade->price
-                              << " qty=" << event.trade->quantity << "\n";
-                }
+                std::cout << "TRADE: maker=" << event.makerId 
+                          << " taker=" << event.orderId
+                          << " price=" << event.price
+                          << " qty=" << event.quantity << "\n";
                 break;
             case events::EventType::CancelAck:
                 std::cout << "CANCEL_ACK: orderId=" << event.orderId << "\n";
@@ -34,6 +32,12 @@ int main() {
             case events::EventType::Reject:
                 std::cout << "REJECT: orderId=" << event.orderId << "\n";
                 break;
+            case events::EventType::AmendAck:
+                std::cout << "AMEND_ACK: orderId=" << event.orderId << "\n";
+                break;
+            case events::EventType::AmendReject:
+                std::cout << "AMEND_REJECT: orderId=" << event.orderId << "\n";
+                break;
         }
     });
 
@@ -90,8 +94,16 @@ int main() {
         } else if (cmd == "cancel") {
             unsigned long long id;
             std::cin >> id;
+            // Result is reported as CANCEL_ACK / CANCEL_REJECT on the next poll
             bool ok = oms.cancelOrder(id);
-            std::cout << (ok ? "OK" : "NF") << "\n";
+            std::cout << (ok ? "SUBMITTED" : "QUEUE_FULL") << "\n";
+        } else if (cmd == "amend") {
+            unsigned long long id;
+            long long price;
+            long long qty;
+            std::cin >> id >> price >> qty;
+            bool ok = oms.amendOrder(id, static_cast<core::Price>(price), static_cast<core::Quantity>(qty));
+            std::cout << (ok ? "SUBMITTED" : "QUEUE_FULL") << "\n";
         } else if (cmd == "snap") {
             auto bids = oms.getBidsSnapshot();
             auto asks = oms.getAsksSnapshot();
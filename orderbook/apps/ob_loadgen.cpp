@@ -0,0 +1,135 @@
+#include "orderbook/loadgen/load_generator.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace ob;
+
+namespace {
+
+// ob_loadgen [--host H] [--port P] [--connections N] [--threads N]
+//            [--instruments N] [--existing on|off] [--book map|ladder]
+//            [--rate MSGS_PER_SEC] [--duration SEC] [--warmup SEC]
+//            [--cancel-ratio R] [--acks on|off] [--seed S] [--format text|csv]
+// Drives a running ob_server at a fixed open-loop rate over N binary
+// connections and M instruments (see loadgen::LoadConfig) and prints
+// throughput and latency from each message's due time. --existing on uses
+// symbols 1..N instead of adding LOAD<n> instruments; --acks on also
+// measures to each order's Ack execution report; --format csv prints a
+// header and one row, for sweeps such as benchmarks/run_scaling.sh.
+std::chrono::milliseconds seconds(const std::string& value) {
+    return std::chrono::milliseconds(static_cast<std::int64_t>(std::stod(value) * 1000.0));
+}
+
+bool onOff(const std::string& flag, const std::string& value) {
+    if (value != "on" && value != "off") throw std::invalid_argument(flag + " takes on or off");
+    return value == "on";
+}
+
+struct Options {
+    loadgen::LoadConfig load;
+    bool csv{false};
+};
+
+Options parseOptions(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; i += 2) {
+        const std::string flag = argv[i];
+        if (i + 1 >= argc) throw std::invalid_argument("missing value for " + flag);
+        const std::string value = argv[i + 1];
+        loadgen::LoadConfig& load = options.load;
+        if (flag == "--host") {
+            load.host = value;
+        } else if (flag == "--port") {
+            load.port = static_cast<std::uint16_t>(std::stoul(value));
+        } else if (flag == "--connections") {
+            load.connections = static_cast<std::size_t>(std::stoul(value));
+        } else if (flag == "--threads") {
+            load.threads = static_cast<std::size_t>(std::stoul(value));
+        } else if (flag == "--instruments") {
+            load.instruments = static_cast<std::size_t>(std::stoul(value));
+        } else if (flag == "--existing") {
+            load.createInstruments = !onOff(flag, value);
+        } else if (flag == "--book") {
+            if (value != "map" && value != "ladder") throw std::invalid_argument("unknown book " + value);
+            load.ladderBooks = value == "ladder";
+        } else if (flag == "--rate") {
+            load.rate = std::stod(value);
+        } else if (flag == "--duration") {
+            load.duration = seconds(value);
+        } else if (flag == "--warmup") {
+            load.warmup = seconds(value);
+        } else if (flag == "--cancel-ratio") {
+            load.cancelRatio = std::stod(value);
+        } else if (flag == "--acks") {
+            load.acks = onOff(flag, value);
+        } else if (flag == "--seed") {
+            load.seed = std::stoull(value);
+        } else if (flag == "--format") {
+            if (value != "text" && value != "csv") throw std::invalid_argument("unknown format " + value);
+            options.csv = value == "csv";
+        } else {
+            throw std::invalid_argument("unknown option " + flag);
+        }
+    }
+    return options;
+}
+
+unsigned long long ull(std::uint64_t value) { return static_cast<unsigned long long>(value); }
+
+void printLatency(const char* label, const core::LatencyHistogram& histogram) {
+    std::printf("%s latency ns (%llu recorded): min %llu  mean %.0f  max %llu\n", label, ull(histogram.count()),
+                ull(histogram.min()), histogram.mean(), ull(histogram.max()));
+    for (const double p : {50.0, 90.0, 99.0, 99.9, 99.99}) {
+        std::printf("  p%-6g %12llu\n", p, ull(histogram.percentile(p)));
+    }
+}
+
+void printText(const loadgen::LoadConfig& config, const loadgen::LoadResult& result) {
+    std::printf("%zu connections on %zu threads, %zu instruments, target %.0f msgs/s\n", config.connections,
+                std::min(config.threads, config.connections), config.instruments, config.rate);
+    std::printf("%llu sent, %llu answered (%llu rejected) in %.3f s: %.0f msgs/s\n", ull(result.sent),
+                ull(result.answered), ull(result.rejected), std::chrono::duration<double>(result.elapsed).count(),
+                result.throughput());
+    if (result.unanswered != 0) std::printf("%llu messages never answered\n", ull(result.unanswered));
+    // The schedule only holds if the generator keeps up with it
+    std::printf("generator furthest behind schedule: %lld ns\n", static_cast<long long>(result.maxLag.count()));
+    printLatency("response", result.response);
+    if (config.acks) printLatency("ack", result.ack);
+}
+
+void printCsv(const loadgen::LoadConfig& config, const loadgen::LoadResult& result) {
+    std::printf("connections,threads,instruments,target_rate,sent,answered,rejected,unanswered,throughput,"
+                "max_lag_ns,p50_ns,p90_ns,p99_ns,p999_ns,max_ns,ack_p50_ns,ack_p99_ns,ack_p999_ns\n");
+    const core::LatencyHistogram& r = result.response;
+    const core::LatencyHistogram& a = result.ack;
+    std::printf("%zu,%zu,%zu,%.0f,%llu,%llu,%llu,%llu,%.0f,%lld,%llu,%llu,%llu,%llu,%llu,%llu,%llu,%llu\n",
+                config.connections, std::min(config.threads, config.connections), config.instruments, config.rate,
+                ull(result.sent), ull(result.answered), ull(result.rejected), ull(result.unanswered), result.throughput(),
+                static_cast<long long>(result.maxLag.count()), ull(r.percentile(50)), ull(r.percentile(90)),
+                ull(r.percentile(99)), ull(r.percentile(99.9)), ull(r.max()), ull(a.percentile(50)),
+                ull(a.percentile(99)), ull(a.percentile(99.9)));
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    try {
+        const Options options = parseOptions(argc, argv);
+        const loadgen::LoadResult result = loadgen::runLoad(options.load);
+        if (options.csv) {
+            printCsv(options.load, result);
+        } else {
+            printText(options.load, result);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,25 @@
+#include "orderbook/core/async_log.hpp"
+
+#include <iostream>
+#include <stdexcept>
+
+using namespace ob;
+
+// ob_logdump FILE
+//   prints a binary log written by ob_server --log-file as the
+//   "<ns> | <message>" lines the server would otherwise have printed.
+int main(int argc, char** argv) {
+    if (argc != 2) {
+        std::cerr << "usage: ob_logdump FILE\n";
+        return 2;
+    }
+    try {
+        std::ios::sync_with_stdio(false);
+        core::decodeLogFile(argv[1], std::cout);
+        std::cout.flush();
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,152 @@
+#include "orderbook/replay/order_flow.hpp"
+#include "orderbook/replay/replay_harness.hpp"
+
+#include <bit>
+#include <cstdio>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace ob;
+
+namespace {
+
+// ob_replay generate OUT [--commands N] [--seed S] [--price P]
+//                        [--cancel-ratio R] [--amend-ratio R]
+//   writes a synthetic flow (see replay::FlowConfig);
+// ob_replay extract JOURNAL_DIR OUT [--symbol ID]
+//   cuts one instrument's flow out of an ob_server journal;
+// ob_replay run FLOW [--target engine|oms] [--book map|ladder] [--speed X]
+//   replays it, as fast as possible or at X times the recorded pace, and
+//   prints throughput and the latency histogram.
+void usage() {
+    std::cerr << "usage: ob_replay generate OUT [--commands N] [--seed S] [--price P]"
+                 " [--cancel-ratio R] [--amend-ratio R]\n"
+                 "       ob_replay extract JOURNAL_DIR OUT [--symbol ID]\n"
+                 "       ob_replay run FLOW [--target engine|oms] [--book map|ladder] [--speed X]\n";
+}
+
+// Flag/value pairs after the positional arguments
+template <typename Apply>
+void parseFlags(const std::vector<std::string>& args, std::size_t first, Apply&& apply) {
+    for (std::size_t i = first; i < args.size(); i += 2) {
+        if (i + 1 >= args.size()) throw std::invalid_argument("missing value for " + args[i]);
+        apply(args[i], args[i + 1]);
+    }
+}
+
+int generate(const std::vector<std::string>& args) {
+    replay::FlowConfig config;
+    parseFlags(args, 2, [&](const std::string& flag, const std::string& value) {
+        if (flag == "--commands") {
+            config.commands = static_cast<std::size_t>(std::stoull(value));
+        } else if (flag == "--seed") {
+            config.seed = std::stoull(value);
+        } else if (flag == "--price") {
+            config.referencePrice = std::stoll(value);
+        } else if (flag == "--cancel-ratio") {
+            config.cancelRatio = std::stod(value);
+        } else if (flag == "--amend-ratio") {
+            config.amendRatio = std::stod(value);
+        } else {
+            throw std::invalid_argument("unknown option " + flag);
+        }
+    });
+    const replay::OrderFlow flow = replay::generateFlow(config);
+    replay::writeFlow(args[1], flow);
+    const auto span = std::chrono::nanoseconds(flow.records.empty() ? 0 : flow.records.back().ts);
+    std::cout << "Wrote " << flow.records.size() << " commands spanning "
+              << std::chrono::duration<double>(span).count() << " s to " << args[1] << std::endl;
+    return 0;
+}
+
+int extract(const std::vector<std::string>& args) {
+    if (args.size() < 3) {
+        usage();
+        return 2;
+    }
+    std::uint32_t symbolId = 0;
+    parseFlags(args, 3, [&](const std::string& flag, const std::string& value) {
+        if (flag != "--symbol") throw std::invalid_argument("unknown option " + flag);
+        symbolId = static_cast<std::uint32_t>(std::stoul(value));
+    });
+    const replay::OrderFlow flow = replay::extractFlow(args[1], symbolId);
+    replay::writeFlow(args[2], flow);
+    std::cout << "Wrote " << flow.records.size() << " commands from " << args[1] << " to " << args[2] << std::endl;
+    return 0;
+}
+
+void printHistogram(const core::LatencyHistogram& histogram) {
+    std::printf("latency ns: min %llu  mean %.0f  max %llu\n", static_cast<unsigned long long>(histogram.min()),
+                histogram.mean(), static_cast<unsigned long long>(histogram.max()));
+    for (const double p : {50.0, 90.0, 99.0, 99.9, 99.99}) {
+        std::printf("  p%-6g %12llu\n", p, static_cast<unsigned long long>(histogram.percentile(p)));
+    }
+
+    // One row per power of two, with the running share of commands
+    std::vector<std::uint64_t> rows(64, 0);
+    histogram.forEachBucket([&](std::uint64_t lowest, std::uint64_t, std::uint64_t count) {
+        rows[static_cast<std::size_t>(std::bit_width(lowest))] += count;
+    });
+    std::uint64_t seen = 0;
+    std::printf("  %12s %12s %12s %8s\n", "from", "to", "count", "cum%");
+    for (std::size_t row = 0; row < rows.size(); ++row) {
+        if (rows[row] == 0) continue;
+        seen += rows[row];
+        const std::uint64_t from = row == 0 ? 0 : 1ull << (row - 1);
+        const std::uint64_t to = row == 0 ? 0 : (1ull << row) - 1;
+        std::printf("  %12llu %12llu %12llu %8.4f\n", static_cast<unsigned long long>(from),
+                    static_cast<unsigned long long>(to), static_cast<unsigned long long>(rows[row]),
+                    100.0 * static_cast<double>(seen) / static_cast<double>(histogram.count()));
+    }
+}
+
+int run(const std::vector<std::string>& args) {
+    replay::ReplayConfig config;
+    parseFlags(args, 2, [&](const std::string& flag, const std::string& value) {
+        if (flag == "--target") {
+            if (value != "engine" && value != "oms") throw std::invalid_argument("unknown target " + value);
+            config.target = value == "oms" ? replay::ReplayTarget::Oms : replay::ReplayTarget::Engine;
+        } else if (flag == "--book") {
+            if (value != "map" && value != "ladder") throw std::invalid_argument("unknown book " + value);
+            config.bookType = value == "ladder" ? book::BookType::Ladder : book::BookType::Map;
+        } else if (flag == "--speed") {
+            config.speed = std::stod(value);
+        } else {
+            throw std::invalid_argument("unknown option " + flag);
+        }
+    });
+    const replay::OrderFlow flow = replay::readFlow(args[1]);
+    const replay::ReplayResult result = replay::replayFlow(flow, config);
+
+    std::printf("%llu commands in %.3f s: %.0f commands/s, %llu trades, %llu rejects\n",
+                static_cast<unsigned long long>(result.commands),
+                std::chrono::duration<double>(result.elapsed).count(), result.throughput(),
+                static_cast<unsigned long long>(result.trades), static_cast<unsigned long long>(result.rejects));
+    if (config.speed > 0.0) {
+        std::printf("paced at %gx, furthest behind schedule: %lld ns\n", config.speed,
+                    static_cast<long long>(result.maxLag.count()));
+    }
+    if (result.unanswered != 0) {
+        std::printf("%llu commands never answered\n", static_cast<unsigned long long>(result.unanswered));
+    }
+    printHistogram(result.latency);
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::vector<std::string> args(argv + 1, argv + argc);
+    try {
+        if (args.size() >= 2 && args[0] == "generate") return generate(args);
+        if (args.size() >= 2 && args[0] == "extract") return extract(args);
+        if (args.size() >= 2 && args[0] == "run") return run(args);
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    usage();
+    return 2;
+}
@@ -1,20 +1,21 @@
 #include "orderbook/oms/i_order_book_service.hpp"
 #include "orderbook/oms/instrument_manager.hpp"
+#include "orderbook/net/request_handler.hpp"
+#include "orderbook/net/subscription_hub.hpp"
+#include "orderbook/net/tcp_server.hpp"
+#include "orderbook/core/async_log.hpp"
 #include "orderbook/core/types.hpp"
 #include <iostream>
 #include <string>
 #include <sstream>
-#include <limits>
-#include <chrono>
-#include <thread>
-#include <atomic>
-#include <cstring>
 #include <algorithm>
+#include <chrono>
+#include <condition_variable>
 #include <vector>
-#include <sys/socket.h>
-#include <netinet/in.h>
-#include <arpa/inet.h>
-#include <unistd.h>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
 
 using namespace ob;
 
@@ -25,25 +26,39 @@ using namespace ob;
  * - Testability (can inject mock service)
  * - Swappable implementations
  * - Follows Dependency Inversion Principle (SOLID)
+ *
+ * Connections are served by net::TcpServer's epoll reactors; this class
+ * wires them to the service. Events are drained by the service's event-drain
+ * threads into the subscription hub, which pushes them to subscribed
+ * connections, so no request path waits on event delivery.
+ *
+ * With a journal directory the service first replays what the previous run
+ * journaled, so resting orders survive a restart. A snapshot interval then
+ * writes book snapshots periodically so that replay stays short.
  */
 class OrderBookServer {
 public:
     /**
      * Constructor with dependency injection.
      * 
-     * @param port TCP port to listen on
+     * @param config Listening port and reactor count
      * @param service OrderBook service implementation (defaults to InstrumentManager)
+     * @param drain Event-drain threads (onDrained is set here)
+     * @param journal Write-ahead journal (empty directory = none)
+     * @param snapshotInterval Time between book snapshots (0 = none; needs a journal)
      */
     explicit OrderBookServer(
-        int port,
-        std::unique_ptr<oms::IOrderBookService> service = nullptr
-    ) : port_(port), running_(false) {
+        net::ServerConfig config,
+        std::unique_ptr<oms::IOrderBookService> service = nullptr,
+        processors::EventDrainConfig drain = {},
+        const journal::JournalConfig& journal = {},
+        std::chrono::seconds snapshotInterval = std::chrono::seconds{0}
+    ) : config_(config),
         // Use provided service or create default implementation
-        if (service) {
-            service_ = std::move(service);
-        } else {
-            service_ = std::make_unique<oms::InstrumentManager>();
-        }
+        service_(service ? std::move(service) : std::make_unique<oms::InstrumentManager>()),
+        handler_(*service_, &hub_) {
+        
+        if (!journal.directory.empty()) recover(journal);
         
         // Set up event callback
         service_->setEventCallback([this](const events::Event& event) {
@@ -51,7 +66,13 @@ public:
         });
         
         service_->start();
-        nextOrderId_ = 1;
+        
+        drain.onDrained = [this] { hub_.publishTopOfBook(*service_); };
+        service_->startEventDrain(drain);
+
+        if (!journal.directory.empty() && snapshotInterval.count() > 0) {
+            snapshotter_ = std::thread([this, snapshotInterval] { snapshotLoop(snapshotInterval); });
+        }
     }
     
     ~OrderBookServer() {
@@ -62,267 +83,209 @@ public:
     }
     
     void start() {
-        serverSocket_ = socket(AF_INET, SOCK_STREAM, 0);
-        if (serverSocket_ < 0) {
-            throw std::runtime_error("Failed to create socket");
-        }
-        
-        int opt = 1;
-        setsockopt(serverSocket_, SOL_SOCKET, SO_REUSEADDR, (const char*)&opt, sizeof(opt));
-        
-        sockaddr_in serverAddr{};
-        serverAddr.sin_family = AF_INET;
-        serverAddr.sin_addr.s_addr = INADDR_ANY;
-        serverAddr.sin_port = htons(port_);
-        
-        if (bind(serverSocket_, (sockaddr*)&serverAddr, sizeof(serverAddr)) < 0) {
-            close(serverSocket_);
-            throw std::runtime_error("Failed to bind socket");
-        }
-        
-        if (listen(serverSocket_, 5) < 0) {
-            close(serverSocket_);
-            throw std::runtime_error("Failed to listen on socket");
-        }
-        
-        running_ = true;
-        std::cout << "OrderBook Server listening on port " << port_ << std::endl;
-        
-        while (running_) {
-            sockaddr_in clientAddr{};
-            socklen_t clientLen = sizeof(clientAddr);
-            int clientSocket = accept(serverSocket_, (sockaddr*)&clientAddr, &clientLen);
-            
-            if (clientSocket < 0) {
-                if (running_) {
-                    std::cerr << "Failed to accept connection" << std::endl;
-                }
-                continue;
-            }
-            
-            std::cout << "Client connected" << std::endl;
-            std::thread(&OrderBookServer::handleClient, this, clientSocket).detach();
-        }
+        tcpServer_ = std::make_unique<net::TcpServer>(handler_, config_);
+        std::cout << "OrderBook Server listening on port " << tcpServer_->port()
+                  << " (" << config_.reactors << " reactor" << (config_.reactors == 1 ? "" : "s") << ")"
+                  << std::endl;
+        tcpServer_->run();
     }
     
     void stop() {
-        running_ = false;
-        if (serverSocket_ >= 0) {
-            close(serverSocket_);
-            serverSocket_ = -1;
+        if (tcpServer_) {
+            tcpServer_->stop();
         }
-    }
-    
-private:
-    void handleClient(int clientSocket) {
-        char buffer[4096];
-        
-        while (running_) {
-            memset(buffer, 0, sizeof(buffer));
-            int bytesRead = recv(clientSocket, buffer, sizeof(buffer) - 1, 0);
-            
-            if (bytesRead <= 0) {
-                break;
-            }
-            
-            std::string request(buffer, bytesRead);
-            std::string response = processRequest(request);
-            
-            // Process any pending events
-            if (service_) {
-                service_->processEvents();
-            }
-            
-            send(clientSocket, response.c_str(), response.length(), 0);
+        {
+            std::lock_guard<std::mutex> lock(snapshotMutex_);
+            stopping_ = true;
         }
-        
-        std::cout << "Client disconnected" << std::endl;
-        close(clientSocket);
+        snapshotWake_.notify_all();
+        if (snapshotter_.joinable()) snapshotter_.join();
     }
     
-    static std::string trim(const std::string& input) {
-        const auto start = input.find_first_not_of(" \t\r\n");
-        if (start == std::string::npos) {
-            return "";
+private:
+    void recover(const journal::JournalConfig& journal) {
+        const auto recovered = service_->openJournal(journal);
+        if (!recovered) throw std::runtime_error("journal could not be opened");
+        // Recovered orders keep their ids; new ones must not reuse them
+        handler_.reserveOrderIds(recovered->maxOrderId);
+        std::cout << "Recovered " << recovered->instruments << " instruments and " << recovered->commands
+                  << " commands from " << journal.directory << " in "
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(recovered->elapsed).count() << " ms";
+        if (recovered->snapshotId != 0) {
+            std::cout << " on top of snapshot " << recovered->snapshotId << " (" << recovered->snapshotOrders
+                      << " resting orders)";
         }
-        const auto end = input.find_last_not_of(" \t\r\n");
-        return input.substr(start, end - start + 1);
+        if (recovered->tornSegments != 0) std::cout << " (" << recovered->tornSegments << " torn segment tails skipped)";
+        std::cout << std::endl;
     }
-    
-    std::string processRequest(const std::string& request) {
-        std::istringstream iss(request);
-        std::string cmd;
-        iss >> cmd;
-        
-        if (cmd == "ADD_INSTRUMENT") {
-            std::string payload;
-            std::getline(iss, payload);
-            payload = trim(payload);
-            
-            std::vector<std::string> parts;
-            std::stringstream payloadStream(payload);
-            std::string part;
-            while (std::getline(payloadStream, part, '|')) {
-                parts.push_back(trim(part));
-            }
-            
-            if (parts.size() < 4) {
-                return "ERROR Invalid instrument payload\n";
-            }
-            
-            const std::string& ticker = parts[0];
-            const std::string& description = parts[1];
-            const std::string& industry = parts[2];
-            double initialPrice = 0.0;
+
+    void snapshotLoop(std::chrono::seconds interval) {
+        std::unique_lock<std::mutex> lock(snapshotMutex_);
+        while (!snapshotWake_.wait_for(lock, interval, [this] { return stopping_; })) {
+            lock.unlock();
             try {
-                initialPrice = std::stod(parts[3]);
-            } catch (...) {
-                return "ERROR Invalid initial price\n";
-            }
-            
-            if (ticker.empty() || initialPrice <= 0.0) {
-                return "ERROR Invalid ticker\n";
-            }
-            
-            std::uint32_t symbolId = service_->addInstrument(ticker, description, industry, initialPrice);
-            return "OK " + std::to_string(symbolId) + "\n";
-            
-        } else if (cmd == "REMOVE_INSTRUMENT") {
-            std::uint32_t symbolId;
-            iss >> symbolId;
-            bool ok = service_->removeInstrument(symbolId);
-            return ok ? "OK\n" : "ERROR Instrument not found\n";
-            
-        } else if (cmd == "LIST_INSTRUMENTS") {
-            std::ostringstream oss;
-            auto instruments = service_->listInstruments();
-            oss << "INSTRUMENTS " << instruments.size() << "\n";
-            for (const auto& inst : instruments) {
-                oss << inst.symbolId << "|" << inst.ticker << "|" 
-                    << inst.description << "|" << inst.industry << "|" << inst.initialPrice << "\n";
-            }
-            oss << "END\n";
-            return oss.str();
-            
-        } else if (cmd == "ADD") {
-            std::uint32_t symbolId;
-            char sideChar, typeChar;
-            long long price = 0;
-            long long qty;
-            iss >> symbolId >> sideChar >> typeChar >> price >> qty;
-            
-            if (!service_->hasInstrument(symbolId)) {
-                return "ERROR Instrument not found\n";
-            }
-            
-            core::Side s = (sideChar == 'B' ? core::Side::Buy : core::Side::Sell);
-            core::OrderType t = (typeChar == 'L' ? core::OrderType::Limit : core::OrderType::Market);
-            
-            // Validate LIMIT order price must be positive
-            if (t == core::OrderType::Limit && price <= 0) {
-                return "ERROR Invalid price for LIMIT order (must be > 0)\n";
-            }
-            
-            // Validate quantity must be positive
-            if (qty <= 0) {
-                return "ERROR Invalid quantity (must be > 0)\n";
-            }
-            
-            if (t == core::OrderType::Market) {
-                price = (s == core::Side::Buy 
-                    ? std::numeric_limits<long long>::max() 
-                    : std::numeric_limits<long long>::min());
-            }
-            
-            auto now = std::chrono::steady_clock::now();
-            auto nowNs = std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch());
-            
-            core::OrderId orderId = nextOrderId_++;
-            core::Order o{
-                orderId, 
-                symbolId, 
-                s, 
-                t, 
-                static_cast<core::Price>(price), 
-                static_cast<core::Quantity>(qty),
-                core::Timestamp{nowNs}
-            };
-            
-            bool submitted = service_->submitOrder(std::move(o));
-            if (!submitted) {
-                return "ERROR Failed to submit order (queue full or validation failed)\n";
-            }
-            return "OK " + std::to_string(orderId) + "\n";
-            
-        } else if (cmd == "CANCEL") {
-            std::uint32_t symbolId;
-            unsigned long long orderId;
-            iss >> symbolId >> orderId;
-            bool ok = service_->cancelOrder(symbolId, orderId);
-            return ok ? "OK\n" : "NOTFOUND\n";
-            
-        } else if (cmd == "SNAPSHOT") {
-            std::uint32_t symbolId;
-            iss >> symbolId;
-            
-            if (!service_->hasInstrument(symbolId)) {
-                return "ERROR Instrument not found\n";
-            }
-            
-            std::ostringstream oss;
-            auto bids = service_->getBidsSnapshot(symbolId, 10);
-            auto asks = service_->getAsksSnapshot(symbolId, 10);
-            
-            oss << "SNAPSHOT " << symbolId << "\n";
-            oss << "BIDS " << bids.size() << "\n";
-            for (const auto& l : bids) {
-                oss << l.price << " " << l.total << " " << l.numOrders << "\n";
-            }
-            oss << "ASKS " << asks.size() << "\n";
-            for (const auto& l : asks) {
-                oss << l.price << " " << l.total << " " << l.numOrders << "\n";
+                if (const auto saved = service_->saveSnapshot()) {
+                    std::cout << "Snapshot " << saved->id << ": " << saved->orders << " resting orders of "
+                              << saved->instruments << " instruments in "
+                              << std::chrono::duration_cast<std::chrono::milliseconds>(saved->elapsed).count()
+                              << " ms" << std::endl;
+                }
+            } catch (const std::exception& e) {
+                std::cerr << "Snapshot failed: " << e.what() << std::endl;
             }
-            oss << "END\n";
-            return oss.str();
-            
-        } else {
-            return "ERROR Unknown command\n";
+            lock.lock();
         }
     }
-    
+
     void handleEvent(const events::Event& event) {
-        // Events will be polled by clients via SNAPSHOT for now
-        // Could extend to push events via separate connection
-        switch (event.type) {
-            case events::EventType::Ack:
-                std::cout << "ACK: " << event.orderId << std::endl;
-                break;
-            case events::EventType::Trade:
-                if (event.trade) {
-                    std::cout << "TRADE: maker=" << event.trade->makerId 
-                              << " taker=" << event.trade->takerId
-                              << " price=" << event.trade->price
-                              << " qty=" << event.trade->quantity << std::endl;
-                }
-                break;
-            case events::EventType::CancelAck:
-                std::cout << "CANCEL_ACK: " << event.orderId << std::endl;
-                break;
-            default:
-                break;
-        }
+        hub_.onEvent(event);
     }
     
-    int port_;
-    int serverSocket_{-1};
-    std::atomic<bool> running_;
+    net::ServerConfig config_;
     std::unique_ptr<oms::IOrderBookService> service_;  // Dependency injection via interface
-    std::atomic<core::OrderId> nextOrderId_{1};
+    net::SubscriptionHub hub_;     // routes events to subscribed connections
+    net::RequestHandler handler_;  // text and binary protocol, shared by all clients
+    std::unique_ptr<net::TcpServer> tcpServer_;
+
+    std::thread snapshotter_;
+    std::mutex snapshotMutex_;
+    std::condition_variable snapshotWake_;
+    bool stopping_{false};
+};
+
+namespace {
+
+// ob_server [--shards N] [--cpus 0,2,4] [--reactors N] [--drain-threads N]
+//           [--journal DIR] [--fsync none|commit|MS] [--snapshot-every SEC]
+//           [--log-file PATH] [--risk-max-qty N] [--risk-max-notional N]
+//           [--risk-collar-bps N] [--risk-max-open N] [--risk-max-position N]
+//           [--risk-max-rate N] [--huge-pages none|2m|1g] [--prewarm N]
+//           [--mlock on|off] [--reactor-cpus 1,3] [--drain-cpus 5]
+// --shards runs instruments on N pinned worker threads instead of one
+// thread per instrument; --cpus lists the cores shards are pinned to, or
+// without shards the cores the per-instrument processors take in turn;
+// --reactors sets the number of epoll event-loop threads;
+// --drain-threads sets the event-drain threads (default one per shard);
+// --reactor-cpus and --drain-cpus pin those threads the same way;
+// --journal recovers from and journals to DIR; --fsync syncs it never
+// (default), after every group commit, or at most every MS milliseconds;
+// --snapshot-every writes a book snapshot into DIR every SEC seconds;
+// --log-file writes the verbose log undecoded to PATH (read it with
+// ob_logdump) instead of formatting it to stdout.
+// --risk-* turn on pre-trade checks per instrument and account (LOGON):
+// order size, notional (ticks x lots), a collar in basis points around the
+// last trade, resting orders, position and orders plus amends per second.
+// --huge-pages backs the queues (and advises the book arenas) with huge
+// pages where the system has them; --prewarm sizes every book for N
+// resting orders and faults the queues and arenas in up front; --mlock
+// locks them in memory. METRICS reports what was obtained.
+struct Options {
+    processors::ShardConfig shards;
+    net::ServerConfig server;
+    processors::EventDrainConfig drain;
+    journal::JournalConfig journal;
+    std::chrono::seconds snapshotInterval{0};
+    core::LogConfig log;
+    risk::RiskLimits risk;
+    oms::InstrumentResources resources;
 };
 
-int main() {
+std::vector<int> parseCpus(const std::string& value) {
+    std::vector<int> out;
+    std::stringstream cpus(value);
+    std::string cpu;
+    while (std::getline(cpus, cpu, ',')) out.push_back(std::stoi(cpu));
+    return out;
+}
+
+Options parseOptions(int argc, char** argv) {
+    Options options;
+    options.shards.numShards = 0;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        const std::string flag = argv[i];
+        const std::string value = argv[i + 1];
+        if (flag == "--shards") {
+            options.shards.numShards = static_cast<std::size_t>(std::stoul(value));
+        } else if (flag == "--cpus") {
+            options.shards.cpus = parseCpus(value);
+            options.resources.cpus = options.shards.cpus;
+        } else if (flag == "--reactor-cpus") {
+            options.server.cpus = parseCpus(value);
+        } else if (flag == "--drain-cpus") {
+            options.drain.cpus = parseCpus(value);
+        } else if (flag == "--reactors") {
+            options.server.reactors = std::max<std::size_t>(1, std::stoul(value));
+        } else if (flag == "--drain-threads") {
+            options.drain.threads = static_cast<std::size_t>(std::stoul(value));
+        } else if (flag == "--journal") {
+            options.journal.directory = value;
+        } else if (flag == "--fsync") {
+            if (value == "none") {
+                options.journal.fsync = journal::FsyncPolicy::None;
+            } else if (value == "commit") {
+                options.journal.fsync = journal::FsyncPolicy::EveryCommit;
+            } else {
+                options.journal.fsync = journal::FsyncPolicy::Interval;
+                options.journal.fsyncInterval = std::chrono::milliseconds(std::stoul(value));
+            }
+        } else if (flag == "--snapshot-every") {
+            options.snapshotInterval = std::chrono::seconds(std::stoul(value));
+        } else if (flag == "--log-file") {
+            options.log.binaryPath = value;
+        } else if (flag == "--risk-max-qty") {
+            options.risk.maxOrderQuantity = std::stoll(value);
+        } else if (flag == "--risk-max-notional") {
+            options.risk.maxOrderNotional = std::stoll(value);
+        } else if (flag == "--risk-collar-bps") {
+            options.risk.priceCollarBps = static_cast<std::uint32_t>(std::stoul(value));
+        } else if (flag == "--risk-max-open") {
+            options.risk.maxOpenOrders = static_cast<std::uint32_t>(std::stoul(value));
+        } else if (flag == "--risk-max-position") {
+            options.risk.maxPosition = std::stoll(value);
+        } else if (flag == "--risk-max-rate") {
+            options.risk.maxMessages = static_cast<std::uint32_t>(std::stoul(value));
+        } else if (flag == "--huge-pages") {
+            if (value == "none") {
+                options.resources.memory.pageSize = core::PageSize::Regular;
+            } else if (value == "2m") {
+                options.resources.memory.pageSize = core::PageSize::Huge2M;
+            } else if (value == "1g") {
+                options.resources.memory.pageSize = core::PageSize::Huge1G;
+            } else {
+                throw std::invalid_argument("--huge-pages takes none, 2m or 1g");
+            }
+        } else if (flag == "--prewarm") {
+            options.resources.prewarmOrders = static_cast<std::size_t>(std::stoul(value));
+            options.resources.memory.prefault = options.resources.prewarmOrders != 0;
+        } else if (flag == "--mlock") {
+            options.resources.memory.lock = value == "on";
+        } else {
+            throw std::invalid_argument("unknown option " + flag);
+        }
+    }
+    options.shards.memory = options.resources.memory;
+    return options;
+}
+
+std::unique_ptr<oms::IOrderBookService> makeService(const processors::ShardConfig& config,
+                                                   const risk::RiskLimits& limits,
+                                                   const oms::InstrumentResources& resources) {
+    // Per-instrument threads unless shards are asked for
+    auto service = config.numShards == 0 ? std::make_unique<oms::InstrumentManager>()
+                                         : std::make_unique<oms::InstrumentManager>(config);
+    service->setRiskLimits(limits);
+    service->setResources(resources);
+    return service;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
     try {
-        OrderBookServer server(9999);
+        const Options options = parseOptions(argc, argv);
+        if (!options.log.binaryPath.empty()) core::AsyncLog::open(options.log);
+        OrderBookServer server(options.server, makeService(options.shards, options.risk, options.resources),
+                               options.drain, options.journal, options.snapshotInterval);
         std::cout << "Starting OrderBook TCP Server on port 9999..." << std::endl;
         server.start();
     } catch (const std::exception& e) {
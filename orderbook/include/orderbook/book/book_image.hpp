@@ -0,0 +1,147 @@
+#pragma once
+
+#include "orderbook/book/i_order_book.hpp"
+#include "orderbook/core/constants.hpp"
+#include "orderbook/queue/wait_strategy.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+
+namespace ob::book {
+
+// Best bid and ask as last published; a quantity of 0 means that side is empty
+struct TopOfBook {
+    core::Price bidPrice{0};
+    core::Quantity bidQuantity{0};
+    core::Price askPrice{0};
+    core::Quantity askQuantity{0};
+    std::uint64_t version{0};
+};
+
+// A reader's copy of the published levels, best first on each side
+struct BookImage {
+    std::uint64_t version{0}; // publishes so far; 0 = nothing published yet
+    std::size_t bidCount{0};
+    std::size_t askCount{0};
+    // Only the first bidCount / askCount entries are set
+    std::array<LevelSummary, core::BOOK_IMAGE_DEPTH> bids;
+    std::array<LevelSummary, core::BOOK_IMAGE_DEPTH> asks;
+};
+
+/**
+ * Top of book and the best BOOK_IMAGE_DEPTH levels per side, published by
+ * the matching thread for readers on any other thread.
+ *
+ * A seqlock: the one writer makes the sequence odd, rewrites the words and
+ * makes it even again; a reader copies what it needs and retries if the
+ * sequence was odd or moved meanwhile. The writer never waits for readers,
+ * and readers never touch the live book. The words are accessed through
+ * relaxed atomic_ref loads and stores, ordered by the fences around them,
+ * so a torn read is discarded rather than being a data race. A reader only
+ * copies the levels it asked for.
+ */
+class PublishedBook {
+public:
+    // Matching thread only: copy the book's current top levels. The book is
+    // walked before the sequence goes odd, so readers only retry while the
+    // words themselves are being stored.
+    void publish(const IOrderBook& book) noexcept {
+        std::array<LevelSummary, core::BOOK_IMAGE_DEPTH> bids;
+        std::array<LevelSummary, core::BOOK_IMAGE_DEPTH> asks;
+        const std::size_t bidCount = book.copyBids(bids.data(), bids.size());
+        const std::size_t askCount = book.copyAsks(asks.data(), asks.size());
+
+        const std::uint64_t seq = seq_.load(std::memory_order_relaxed);
+        seq_.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        store(COUNTS, static_cast<std::uint64_t>(bidCount) | static_cast<std::uint64_t>(askCount) << 32);
+        for (std::size_t i = 0; i < bidCount; ++i) storeLevel(BID_BASE + i * LEVEL_WORDS, bids[i]);
+        for (std::size_t i = 0; i < askCount; ++i) storeLevel(ASK_BASE + i * LEVEL_WORDS, asks[i]);
+        seq_.store(seq + 2, std::memory_order_release);
+    }
+
+    // Any thread: the best depth levels per side (at most BOOK_IMAGE_DEPTH),
+    // all from one publish
+    void read(BookImage& out, std::size_t depth = core::BOOK_IMAGE_DEPTH) const noexcept {
+        if (depth > core::BOOK_IMAGE_DEPTH) depth = core::BOOK_IMAGE_DEPTH;
+        out.version = readConsistent([&] {
+            const std::uint64_t counts = load(COUNTS);
+            out.bidCount = std::min<std::size_t>(counts & 0xFFFFFFFFu, depth);
+            out.askCount = std::min<std::size_t>(counts >> 32, depth);
+            for (std::size_t i = 0; i < out.bidCount; ++i) out.bids[i] = loadLevel(BID_BASE + i * LEVEL_WORDS);
+            for (std::size_t i = 0; i < out.askCount; ++i) out.asks[i] = loadLevel(ASK_BASE + i * LEVEL_WORDS);
+        });
+    }
+
+    TopOfBook top() const noexcept {
+        TopOfBook out;
+        out.version = readConsistent([&] {
+            const std::uint64_t counts = load(COUNTS);
+            out = TopOfBook{};
+            if ((counts & 0xFFFFFFFFu) != 0) {
+                out.bidPrice = static_cast<core::Price>(load(BID_BASE));
+                out.bidQuantity = static_cast<core::Quantity>(load(BID_BASE + 1));
+            }
+            if ((counts >> 32) != 0) {
+                out.askPrice = static_cast<core::Price>(load(ASK_BASE));
+                out.askQuantity = static_cast<core::Quantity>(load(ASK_BASE + 1));
+            }
+        });
+        return out;
+    }
+
+private:
+    static constexpr std::size_t LEVEL_WORDS = 3; // price, total, numOrders
+    static constexpr std::size_t COUNTS = 0;      // bid count | ask count << 32
+    static constexpr std::size_t BID_BASE = 1;
+    static constexpr std::size_t ASK_BASE = BID_BASE + core::BOOK_IMAGE_DEPTH * LEVEL_WORDS;
+    static constexpr std::size_t WORDS = ASK_BASE + core::BOOK_IMAGE_DEPTH * LEVEL_WORDS;
+    static constexpr std::uint32_t SPINS_BEFORE_YIELD = 64;
+
+    // Runs copy until it saw one publish from start to end; returns that
+    // publish's version
+    template <typename Copy>
+    std::uint64_t readConsistent(Copy&& copy) const noexcept {
+        for (std::uint32_t attempt = 1;; ++attempt) {
+            const std::uint64_t before = seq_.load(std::memory_order_acquire);
+            if ((before & 1) == 0) {
+                copy();
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (seq_.load(std::memory_order_relaxed) == before) return before / 2;
+            }
+            // A writer preempted mid-publish would otherwise be spun against
+            if (attempt % SPINS_BEFORE_YIELD == 0) {
+                std::this_thread::yield();
+            } else {
+                queue::cpuRelax();
+            }
+        }
+    }
+
+    void store(std::size_t word, std::uint64_t value) noexcept {
+        std::atomic_ref<std::uint64_t>(words_[word]).store(value, std::memory_order_relaxed);
+    }
+
+    std::uint64_t load(std::size_t word) const noexcept {
+        return std::atomic_ref<std::uint64_t>(words_[word]).load(std::memory_order_relaxed);
+    }
+
+    void storeLevel(std::size_t word, const LevelSummary& level) noexcept {
+        store(word, static_cast<std::uint64_t>(level.price));
+        store(word + 1, static_cast<std::uint64_t>(level.total));
+        store(word + 2, static_cast<std::uint64_t>(level.numOrders));
+    }
+
+    LevelSummary loadLevel(std::size_t word) const noexcept {
+        return LevelSummary{static_cast<core::Price>(load(word)), static_cast<core::Quantity>(load(word + 1)),
+                            static_cast<std::size_t>(load(word + 2))};
+    }
+
+    alignas(64) std::atomic<std::uint64_t> seq_{0};
+    alignas(64) mutable std::array<std::uint64_t, WORDS> words_{};
+};
+
+} // namespace ob::book
@@ -0,0 +1,139 @@
+#pragma once
+
+#include "orderbook/book/order_pool.hpp"
+#include "orderbook/book/price_level.hpp"
+#include "orderbook/core/types.hpp"
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+namespace ob::book {
+
+// One resting order as stored in a book snapshot. Orders of a level are
+// consecutive and in queue order; levels may come in any order. The layout
+// is also the on-disk layout (see journal/snapshot.hpp).
+struct SnapshotOrder {
+    core::OrderId orderId{0};
+    core::Price price{0};
+    core::Quantity quantity{0};
+    std::int64_t ts{0}; // arrival timestamp, ns
+    core::Side side{core::Side::Buy};
+    core::TimeInForce tif{core::TimeInForce::GoodTillCancel}; // zero (GoodTillCancel) in older snapshots
+    std::uint8_t reserved[2]{};
+    std::uint32_t account{0}; // zero (the shared account) in older snapshots
+};
+static_assert(sizeof(SnapshotOrder) == 40, "snapshot order layout is part of the snapshot format");
+
+inline core::Order toOrder(const SnapshotOrder& order) noexcept {
+    core::Order out{order.orderId, 0, order.side, core::OrderType::Limit, order.price, order.quantity,
+                    core::Timestamp{std::chrono::nanoseconds{order.ts}}, order.tif};
+    out.account = order.account;
+    return out;
+}
+
+// One stop order waiting for its trigger at the cut, also as stored on disk
+struct SnapshotStop {
+    core::OrderId orderId{0};
+    core::Price price{0};     // limit price (StopLimit)
+    core::Price stopPrice{0};
+    core::Quantity quantity{0};
+    std::int64_t ts{0};       // arrival timestamp, ns
+    core::Side side{core::Side::Buy};
+    core::OrderType type{core::OrderType::Stop};
+    core::TimeInForce tif{core::TimeInForce::GoodTillCancel};
+    std::uint8_t reserved{0};
+    std::uint32_t account{0};
+};
+static_assert(sizeof(SnapshotStop) == 48, "snapshot stop layout is part of the snapshot format");
+
+inline core::Order toOrder(const SnapshotStop& stop) noexcept {
+    core::Order out{stop.orderId, 0, stop.side, stop.type, stop.price, stop.quantity,
+                    core::Timestamp{std::chrono::nanoseconds{stop.ts}}, stop.tif, stop.stopPrice};
+    out.account = stop.account;
+    return out;
+}
+
+// Risk state of one account at the cut that its resting orders do not
+// carry (they are relearned as the book loads), also as stored on disk
+struct SnapshotAccount {
+    std::uint32_t account{0};
+    std::uint32_t windowMessages{0}; // orders and amends counted in the rate window
+    core::Quantity position{0};      // bought minus sold
+    std::int64_t windowStart{0};     // ns, arrival time of the window's first message
+};
+static_assert(sizeof(SnapshotAccount) == 24, "snapshot account layout is part of the snapshot format");
+
+// Target of an incremental capture handed to the matching thread
+// (MatchingEngine::requestSnapshot). Written by the matching thread only;
+// readable by the requester once complete is set.
+struct BookSnapshot {
+    std::vector<SnapshotOrder> orders;
+    // Engine state at the cut, copied in one go: the waiting stop orders
+    // and the last trade price their triggers compare against
+    std::vector<SnapshotStop> stops;
+    core::Price lastTradePrice{0};
+    // The risk stage's accounts and collar reference, if it has one
+    std::vector<SnapshotAccount> accounts;
+    core::Price riskReference{0};
+    std::atomic<bool> complete{false};
+};
+
+/**
+ * Copy-on-write capture shared by the book implementations.
+ *
+ * begin() only opens a new epoch. From then on the book calls touch()
+ * before it changes a level, and a level not yet captured in this epoch
+ * is copied out first, so the snapshot sees it as it was at begin(). The
+ * book's own cursor copies the untouched levels a few at a time between
+ * batches. A level created after begin() is empty when first touched and
+ * contributes nothing, which is also what it held at the cut.
+ */
+class SnapshotCapture {
+public:
+    bool active() const noexcept { return out_ != nullptr; }
+
+    // expectedOrders = orders resting now; the capture never holds more, so
+    // copying never reallocates out
+    void begin(std::vector<SnapshotOrder>& out, std::size_t expectedOrders) {
+        out.clear();
+        out.reserve(expectedOrders);
+        out_ = &out;
+        ++epoch_;
+    }
+
+    void finish() noexcept { out_ = nullptr; }
+
+    // Before a change to level; the caller has checked active()
+    void touch(const OrderPool& pool, PriceLevel& level) {
+        if (level.snapshotEpoch != epoch_) capture(pool, level);
+    }
+
+    // Copy level if it is still uncaptured; returns the orders copied
+    std::size_t visit(const OrderPool& pool, PriceLevel& level) {
+        return level.snapshotEpoch != epoch_ ? capture(pool, level) : 0;
+    }
+
+private:
+    std::size_t capture(const OrderPool& pool, PriceLevel& level) {
+        level.snapshotEpoch = epoch_;
+        for (OrderHandle h = level.head; h != NULL_HANDLE; h = pool[h].next) {
+            const RestingOrder& node = pool[h];
+            const RestingOrderInfo& info = pool.info(h);
+            SnapshotOrder order;
+            order.orderId = node.orderId;
+            order.price = node.price;
+            order.quantity = node.quantity;
+            order.ts = info.ts.time_since_epoch().count();
+            order.side = info.side;
+            order.tif = info.tif;
+            order.account = info.account;
+            out_->push_back(order);
+        }
+        return level.orderCount;
+    }
+
+    std::vector<SnapshotOrder>* out_{nullptr};
+    std::uint32_t epoch_{0}; // levels start at 0, so the first capture sees every level as uncaptured
+};
+
+} // namespace ob::book
@@ -1,11 +1,19 @@
 #pragma once
 
+#include "orderbook/book/book_snapshot.hpp"
+#include "orderbook/core/memory.hpp"
 #include "orderbook/core/types.hpp"
 #include <optional>
 #include <vector>
 
 namespace ob::book {
 
+// Storage layout used for a book's price levels
+enum class BookType : std::uint8_t {
+    Map = 0,    // std::map of price levels, any price range
+    Ladder = 1  // Tick-indexed array centred on a reference price
+};
+
 struct LevelSummary {
     core::Price price{0};
     core::Quantity total{0};
@@ -20,12 +28,47 @@ public:
     // Order management
     virtual bool addOrder(core::Order order) = 0;
     virtual bool cancelOrder(core::OrderId id) = 0;
+    // Shrink a resting order to newQuantity (0 < newQuantity < current) in
+    // place, keeping its time priority. Returns false if not found or the
+    // new quantity is out of range.
+    virtual bool reduceOrder(core::OrderId id, core::Quantity newQuantity) = 0;
+    // Resting state of an order (remaining quantity), if it is on the book.
+    // Books do not track symbols, so symbolId is left 0.
+    virtual std::optional<core::Order> findOrder(core::OrderId id) const = 0;
     
     // Market data queries
     virtual std::optional<core::Price> findBestBid() const noexcept = 0;
     virtual std::optional<core::Price> findBestAsk() const noexcept = 0;
     virtual std::vector<LevelSummary> snapshotBidsL2(std::size_t depth = 0) const = 0;
     virtual std::vector<LevelSummary> snapshotAsksL2(std::size_t depth = 0) const = 0;
+    // Allocation-free form for the matching thread: the best levels, at
+    // most maxLevels, into out; returns how many were written
+    virtual std::size_t copyBids(LevelSummary* out, std::size_t maxLevels) const noexcept = 0;
+    virtual std::size_t copyAsks(LevelSummary* out, std::size_t maxLevels) const noexcept = 0;
+    // Depth: price levels holding orders on one side, and resting orders in all
+    virtual std::size_t levelCount(core::Side side) const noexcept = 0;
+    virtual std::size_t orderCount() const noexcept = 0;
+    // Quantity resting on side that a taker limited to limit could reach
+    // (asks at or below it, bids at or above it), summed from the level
+    // totals best first and stopping once it reaches wanted
+    virtual core::Quantity availableQuantity(core::Side side, core::Price limit,
+                                             core::Quantity wanted) const noexcept = 0;
+
+    // Point-in-time copy of every resting order, taken in slices on the
+    // owning thread: beginSnapshot() marks the cut, and each snapshotStep()
+    // copies about budget more orders and returns true once out holds the
+    // book as it was at the cut. The book may be changed freely in between.
+    virtual void beginSnapshot(std::vector<SnapshotOrder>& out) = 0;
+    virtual bool snapshotStep(std::size_t budget) = 0;
+    // Bulk-build an empty book from snapshot orders, without the checks and
+    // per-order lookups of addOrder. Returns false if the book is not empty.
+    virtual bool loadSnapshot(const SnapshotOrder* orders, std::size_t count) = 0;
+
+    // Grow the order arena, the id lookup and the level storage to hold
+    // orders resting orders (and a working set of price levels) now, faulted
+    // in and backed as memory asks, so the first orders cost what later ones
+    // do. Say so before the book is used; a no-op for capacity already there.
+    virtual void prewarm(std::size_t orders, const core::MemoryConfig& memory) = 0;
 };
 
 } // namespace ob::book
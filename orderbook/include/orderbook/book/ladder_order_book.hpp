@@ -0,0 +1,119 @@
+#pragma once
+
+#include "orderbook/book/book_snapshot.hpp"
+#include "orderbook/book/i_order_book.hpp"
+#include "orderbook/book/order_locator_table.hpp"
+#include "orderbook/book/order_pool.hpp"
+#include "orderbook/book/price_level.hpp"
+#include "orderbook/core/types.hpp"
+#include "orderbook/core/constants.hpp"
+#include <map>
+#include <memory_resource>
+#include <vector>
+#include <cstddef>
+
+namespace ob::book {
+
+// Order book backed by a contiguous, tick-indexed array of price levels
+// centred on a reference price. Prices inside the window are addressed
+// directly by index and the best bid/ask index is cached, so best-price
+// lookups and level access never walk a tree. Prices outside the window
+// fall back to a sparse std::map per side.
+class LadderOrderBook final : public IOrderBook {
+public:
+    explicit LadderOrderBook(core::Price referencePrice, std::size_t numLevels = core::DEFAULT_LADDER_LEVELS);
+
+    bool addOrder(core::Order order) override;
+    bool cancelOrder(core::OrderId id) override;
+    bool reduceOrder(core::OrderId id, core::Quantity newQuantity) override;
+    std::optional<core::Order> findOrder(core::OrderId id) const override;
+    void eraseFrontAtLevel(core::Side side, core::Price price, core::OrderId expectedId);
+
+    std::optional<core::Price> findBestBid() const noexcept override;
+    std::optional<core::Price> findBestAsk() const noexcept override;
+    std::vector<LevelSummary> snapshotBidsL2(std::size_t depth = 0) const override;
+    std::vector<LevelSummary> snapshotAsksL2(std::size_t depth = 0) const override;
+    std::size_t copyBids(LevelSummary* out, std::size_t maxLevels) const noexcept override;
+    std::size_t copyAsks(LevelSummary* out, std::size_t maxLevels) const noexcept override;
+    std::size_t levelCount(core::Side side) const noexcept override {
+        return side == core::Side::Buy ? activeBidLevels_ + farBids_.size() : activeAskLevels_ + farAsks_.size();
+    }
+    std::size_t orderCount() const noexcept override { return locators_.size(); }
+    core::Quantity availableQuantity(core::Side side, core::Price limit, core::Quantity wanted) const noexcept override;
+
+    void beginSnapshot(std::vector<SnapshotOrder>& out) override;
+    bool snapshotStep(std::size_t budget) override;
+    bool loadSnapshot(const SnapshotOrder* orders, std::size_t count) override;
+    void prewarm(std::size_t orders, const core::MemoryConfig& memory) override;
+
+    // Internal helpers for MatchingEngine (not part of interface)
+    PriceLevel* bestLevel(core::Side side) noexcept;
+    RestingOrder& frontOrder(PriceLevel& level) noexcept { return pool_.front(level); }
+    std::uint32_t frontAccount(const PriceLevel& level) const noexcept { return pool_.info(level.head).account; }
+    void reduceFront(PriceLevel& level, core::Quantity qty) {
+        touch(level);
+        pool_.reduceFront(level, qty);
+    }
+    void popFront(core::Side side, PriceLevel& level);
+
+    core::Price minLadderPrice() const noexcept { return base_; }
+    core::Price maxLadderPrice() const noexcept { return base_ + static_cast<core::Price>(numLevels_) - 1; }
+
+private:
+    using Level = PriceLevel;
+    using FarBidMap = std::pmr::map<core::Price, Level, std::greater<core::Price>>;
+    using FarAskMap = std::pmr::map<core::Price, Level, std::less<core::Price>>;
+
+    static constexpr std::ptrdiff_t NO_LEVEL = -1;
+
+    bool inLadder(core::Price price) const noexcept {
+        return price >= base_ && price <= maxLadderPrice();
+    }
+    std::ptrdiff_t indexOf(core::Price price) const noexcept {
+        return static_cast<std::ptrdiff_t>(price - base_);
+    }
+    core::Price priceAt(std::ptrdiff_t idx) const noexcept {
+        return base_ + static_cast<core::Price>(idx);
+    }
+
+    Level* findLevel(core::Side side, core::Price price) noexcept;
+    Level& levelFor(core::Side side, core::Price price); // creating it, and counting it active
+    // Every change to a level goes through here first while a snapshot runs
+    void touch(Level& level) {
+        if (capture_.active()) capture_.touch(pool_, level);
+    }
+    void removeLevelIfEmpty(core::Side side, core::Price price);
+    void refreshBestBid() noexcept;
+    void refreshBestAsk() noexcept;
+
+    OrderPool pool_{};
+    const std::size_t numLevels_;
+    const core::Price base_;
+
+    std::vector<Level> bidLevels_;
+    std::vector<Level> askLevels_;
+    std::ptrdiff_t bestBidIdx_{NO_LEVEL};
+    std::ptrdiff_t bestAskIdx_{NO_LEVEL};
+    std::size_t activeBidLevels_{0};
+    std::size_t activeAskLevels_{0};
+
+    std::pmr::unsynchronized_pool_resource farResource_{}; // reuses far-level nodes
+    FarBidMap farBids_{&farResource_}; // highest price first
+    FarAskMap farAsks_{&farResource_}; // lowest price first
+
+    // Order id -> pool handle; ladder slots and far-map nodes never move, so
+    // the handle's cold info can point straight at its level
+    OrderLocatorTable locators_{};
+
+    // Snapshot in progress. The cursor walks the bid window, the ask window,
+    // then each far map (resuming after cursorPrice_, since far levels may
+    // come and go between steps).
+    enum class CursorPhase : std::uint8_t { BidWindow, AskWindow, FarBids, FarAsks };
+    SnapshotCapture capture_{};
+    CursorPhase cursorPhase_{CursorPhase::BidWindow};
+    std::size_t cursorIndex_{0};
+    bool cursorStarted_{false};
+    core::Price cursorPrice_{0};
+};
+
+} // namespace ob::book
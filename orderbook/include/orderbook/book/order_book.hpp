@@ -1,48 +1,84 @@
 #pragma once
 
+#include "orderbook/book/book_snapshot.hpp"
 #include "orderbook/book/i_order_book.hpp"
+#include "orderbook/book/order_locator_table.hpp"
+#include "orderbook/book/order_pool.hpp"
+#include "orderbook/book/price_level.hpp"
 #include "orderbook/core/types.hpp"
 #include <map>
-#include <deque>
-#include <unordered_map>
+#include <memory_resource>
 
 namespace ob::book {
 
 // Concrete implementation of order book
 class OrderBook final : public IOrderBook {
 public:
+    // Level maps draw their nodes from a pool resource, so a level that
+    // empties and re-forms reuses its node instead of hitting the heap
+    using BidMap = std::pmr::map<core::Price, PriceLevel, std::greater<core::Price>>;
+    using AskMap = std::pmr::map<core::Price, PriceLevel, std::less<core::Price>>;
+
     OrderBook() = default;
 
     bool addOrder(core::Order order) override;
     bool cancelOrder(core::OrderId id) override;
+    bool reduceOrder(core::OrderId id, core::Quantity newQuantity) override;
+    std::optional<core::Order> findOrder(core::OrderId id) const override;
     void eraseFrontAtLevel(core::Side side, core::Price price, core::OrderId expectedId);
 
     std::optional<core::Price> findBestBid() const noexcept override;
     std::optional<core::Price> findBestAsk() const noexcept override;
     std::vector<LevelSummary> snapshotBidsL2(std::size_t depth = 0) const override;
     std::vector<LevelSummary> snapshotAsksL2(std::size_t depth = 0) const override;
+    std::size_t copyBids(LevelSummary* out, std::size_t maxLevels) const noexcept override;
+    std::size_t copyAsks(LevelSummary* out, std::size_t maxLevels) const noexcept override;
+    std::size_t levelCount(core::Side side) const noexcept override {
+        return side == core::Side::Buy ? bids_.size() : asks_.size();
+    }
+    std::size_t orderCount() const noexcept override { return locators_.size(); }
+    core::Quantity availableQuantity(core::Side side, core::Price limit, core::Quantity wanted) const noexcept override;
+
+    void beginSnapshot(std::vector<SnapshotOrder>& out) override;
+    bool snapshotStep(std::size_t budget) override;
+    bool loadSnapshot(const SnapshotOrder* orders, std::size_t count) override;
+    void prewarm(std::size_t orders, const core::MemoryConfig& memory) override;
 
     // Internal helpers for MatchingEngine (not part of interface)
-    std::deque<core::Order>& bestQueue(core::Side side);
-    std::map<core::Price, std::deque<core::Order>, std::greater<core::Price>>& bids() { return bids_; }
-    std::map<core::Price, std::deque<core::Order>, std::less<core::Price>>& asks() { return asks_; }
-    const std::deque<core::Order>* getQueueAt(core::Side side, core::Price price) const;
+    PriceLevel* bestLevel(core::Side side) noexcept;
+    RestingOrder& frontOrder(PriceLevel& level) noexcept { return pool_.front(level); }
+    std::uint32_t frontAccount(const PriceLevel& level) const noexcept { return pool_.info(level.head).account; }
+    void reduceFront(PriceLevel& level, core::Quantity qty) {
+        touch(level);
+        pool_.reduceFront(level, qty);
+    }
+    void popFront(core::Side side, PriceLevel& level);
+    BidMap& bids() { return bids_; }
+    AskMap& asks() { return asks_; }
+    const PriceLevel* getQueueAt(core::Side side, core::Price price) const;
 
 private:
-    using BidMap = std::map<core::Price, std::deque<core::Order>, std::greater<core::Price>>;
-    using AskMap = std::map<core::Price, std::deque<core::Order>, std::less<core::Price>>;
+    void releaseLevelIfEmpty(core::Side side, core::Price price, const PriceLevel& level);
+    // Every change to a level goes through here first while a snapshot runs
+    void touch(PriceLevel& level) {
+        if (capture_.active()) capture_.touch(pool_, level);
+    }
 
-    BidMap bids_{}; // highest price first
-    AskMap asks_{}; // lowest price first
+    OrderPool pool_{};
+    std::pmr::unsynchronized_pool_resource levelResource_{};
+    BidMap bids_{&levelResource_}; // highest price first
+    AskMap asks_{&levelResource_}; // lowest price first
 
-    struct OrderLocator {
-        core::Side side{core::Side::Buy};
-        core::Price price{0};
-        std::deque<core::Order>::iterator it;
-    };
+    // Order id -> pool handle; the handle's cold info records side and level
+    // (std::map nodes never move), so cancel never searches the level map
+    OrderLocatorTable locators_{};
 
-    std::unordered_map<core::OrderId, OrderLocator> locators_;
+    // Snapshot in progress: the cursor sweeps bids, then asks, resuming
+    // after cursorPrice_ since levels may come and go between steps
+    SnapshotCapture capture_{};
+    core::Side cursorSide_{core::Side::Buy};
+    bool cursorStarted_{false};
+    core::Price cursorPrice_{0};
 };
 
 } // namespace ob::book
-
@@ -0,0 +1,116 @@
+#pragma once
+
+#include "orderbook/book/price_level.hpp"
+#include "orderbook/core/memory.hpp"
+#include "orderbook/core/types.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ob::book {
+
+// Flat open-addressing map from OrderId to OrderHandle.
+// Replaces std::unordered_map for the book's locators: slots are 16 bytes
+// (four per cache line), lookups are a multiply-shift hash plus a short
+// linear probe, and erase uses backward-shift deletion so there are no
+// tombstones. Memory is only allocated when the table grows past half full.
+// Not thread-safe: owned and used by a single book.
+class OrderLocatorTable final {
+public:
+    explicit OrderLocatorTable(std::size_t expectedOrders = 1024) { rehash(capacityFor(expectedOrders)); }
+
+    [[nodiscard]] OrderHandle find(core::OrderId id) const noexcept {
+        for (std::size_t i = slotOf(id);; i = (i + 1) & mask_) {
+            const Slot& slot = slots_[i];
+            if (slot.handle == NULL_HANDLE) return NULL_HANDLE;
+            if (slot.id == id) return slot.handle;
+        }
+    }
+
+    // Returns false (and leaves the table unchanged) if id is already present
+    bool insert(core::OrderId id, OrderHandle handle) {
+        if ((size_ + 1) * 2 > slots_.size()) rehash(slots_.size() * 2);
+        for (std::size_t i = slotOf(id);; i = (i + 1) & mask_) {
+            Slot& slot = slots_[i];
+            if (slot.handle == NULL_HANDLE) {
+                slot = Slot{id, handle};
+                ++size_;
+                return true;
+            }
+            if (slot.id == id) return false;
+        }
+    }
+
+    bool erase(core::OrderId id) noexcept {
+        std::size_t i = slotOf(id);
+        for (;; i = (i + 1) & mask_) {
+            if (slots_[i].handle == NULL_HANDLE) return false;
+            if (slots_[i].id == id) break;
+        }
+        // Backward-shift: pull later entries of the probe run into the hole
+        std::size_t hole = i;
+        for (std::size_t j = (hole + 1) & mask_; slots_[j].handle != NULL_HANDLE; j = (j + 1) & mask_) {
+            const std::size_t home = slotOf(slots_[j].id);
+            if (((j - home) & mask_) >= ((j - hole) & mask_)) {
+                slots_[hole] = slots_[j];
+                hole = j;
+            }
+        }
+        slots_[hole] = Slot{};
+        --size_;
+        return true;
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept { return size_; }
+    [[nodiscard]] bool empty() const noexcept { return size_ == 0; }
+
+    void reserve(std::size_t expectedOrders) {
+        const std::size_t wanted = capacityFor(expectedOrders);
+        if (wanted > slots_.size()) rehash(wanted);
+    }
+    // reserve(), with the new slot array advised and locked as memory asks
+    // before it is filled
+    void prewarm(std::size_t expectedOrders, const core::MemoryConfig& memory) {
+        const std::size_t wanted = capacityFor(expectedOrders);
+        if (wanted > slots_.size()) rehash(wanted, &memory);
+    }
+
+private:
+    struct Slot {
+        core::OrderId id{0};
+        OrderHandle handle{NULL_HANDLE};
+    };
+
+    static std::size_t capacityFor(std::size_t orders) noexcept {
+        std::size_t cap = 16;
+        while (cap < orders * 2) cap <<= 1;
+        return cap;
+    }
+
+    std::size_t slotOf(core::OrderId id) const noexcept {
+        // Fibonacci hashing spreads sequential ids across the table
+        return static_cast<std::size_t>((id * 0x9E3779B97F4A7C15ull) >> shift_);
+    }
+
+    void rehash(std::size_t newCapacity, const core::MemoryConfig* memory = nullptr) {
+        std::vector<Slot> old;
+        old.swap(slots_);
+        slots_.reserve(newCapacity);
+        if (memory) core::adviseMemory(slots_.data(), newCapacity * sizeof(Slot), *memory);
+        slots_.assign(newCapacity, Slot{});
+        mask_ = newCapacity - 1;
+        shift_ = 64;
+        for (std::size_t c = newCapacity; c > 1; c >>= 1) --shift_;
+        size_ = 0;
+        for (const Slot& slot : old) {
+            if (slot.handle != NULL_HANDLE) insert(slot.id, slot.handle);
+        }
+    }
+
+    std::vector<Slot> slots_;
+    std::size_t mask_{0};
+    unsigned shift_{64};
+    std::size_t size_{0};
+};
+
+} // namespace ob::book
@@ -0,0 +1,167 @@
+#pragma once
+
+#include "orderbook/book/price_level.hpp"
+#include "orderbook/core/constants.hpp"
+#include "orderbook/core/memory.hpp"
+#include "orderbook/core/types.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+namespace ob::book {
+
+// Arena of resting orders addressed by 32-bit handles, with an intrusive
+// free list threaded through RestingOrder::next.
+// Hot fields (RestingOrder) and cold fields (RestingOrderInfo) live in
+// parallel arrays so matching only pulls the hot array into cache.
+// Capacity is reserved up front and grows geometrically in slab multiples,
+// so adding a resting order does not allocate in the steady state; released slots are
+// reused LIFO while still cache-warm. Growth may move the arrays, so keep
+// handles, not references, across calls that add orders.
+// Not thread-safe: owned and used by a single book.
+class OrderPool final {
+public:
+    explicit OrderPool(std::size_t slabSize = core::DEFAULT_ORDER_POOL_SLAB, std::size_t initialSlabs = 1)
+        : slabSize_(slabSize == 0 ? 1 : slabSize)
+    {
+        hot_.reserve(slabSize_ * initialSlabs);
+        cold_.reserve(slabSize_ * initialSlabs);
+        for (std::size_t i = 0; i < initialSlabs; ++i) grow();
+    }
+
+    OrderPool(const OrderPool&) = delete;
+    OrderPool& operator=(const OrderPool&) = delete;
+
+    [[nodiscard]] OrderHandle acquire(const core::Order& order, PriceLevel* level) {
+        if (freeList_ == NULL_HANDLE) grow();
+        const OrderHandle h = freeList_;
+        RestingOrder& node = hot_[h];
+        freeList_ = node.next;
+        node = RestingOrder{order.orderId, order.quantity, order.price, NULL_HANDLE, NULL_HANDLE};
+        cold_[h] = RestingOrderInfo{order.ts, level, order.side, order.tif, order.account};
+        ++inUse_;
+        return h;
+    }
+
+    void release(OrderHandle h) noexcept {
+        hot_[h].prev = NULL_HANDLE;
+        hot_[h].next = freeList_;
+        cold_[h].level = nullptr;
+        freeList_ = h;
+        --inUse_;
+    }
+
+    [[nodiscard]] RestingOrder& operator[](OrderHandle h) noexcept { return hot_[h]; }
+    [[nodiscard]] const RestingOrder& operator[](OrderHandle h) const noexcept { return hot_[h]; }
+    [[nodiscard]] RestingOrderInfo& info(OrderHandle h) noexcept { return cold_[h]; }
+    [[nodiscard]] const RestingOrderInfo& info(OrderHandle h) const noexcept { return cold_[h]; }
+
+    // Rebuild the API-boundary representation of a resting order
+    [[nodiscard]] core::Order toOrder(OrderHandle h, std::uint32_t symbolId) const noexcept {
+        const RestingOrder& node = hot_[h];
+        const RestingOrderInfo& info = cold_[h];
+        core::Order order{node.orderId, symbolId, info.side, core::OrderType::Limit, node.price, node.quantity, info.ts,
+                          info.tif};
+        order.account = info.account;
+        return order;
+    }
+
+    // Intrusive FIFO operations on a level
+    void pushBack(PriceLevel& level, OrderHandle h) noexcept {
+        RestingOrder& node = hot_[h];
+        node.prev = level.tail;
+        node.next = NULL_HANDLE;
+        if (level.tail != NULL_HANDLE) {
+            hot_[level.tail].next = h;
+        } else {
+            level.head = h;
+        }
+        level.tail = h;
+        level.totalQuantity += node.quantity;
+        ++level.orderCount;
+    }
+
+    // O(1) unlink of any order in the level
+    void erase(PriceLevel& level, OrderHandle h) noexcept {
+        RestingOrder& node = hot_[h];
+        if (node.prev != NULL_HANDLE) {
+            hot_[node.prev].next = node.next;
+        } else {
+            level.head = node.next;
+        }
+        if (node.next != NULL_HANDLE) {
+            hot_[node.next].prev = node.prev;
+        } else {
+            level.tail = node.prev;
+        }
+        node.prev = NULL_HANDLE;
+        node.next = NULL_HANDLE;
+        level.totalQuantity -= node.quantity;
+        --level.orderCount;
+    }
+
+    [[nodiscard]] RestingOrder& front(const PriceLevel& level) noexcept { return hot_[level.head]; }
+
+    // Partial fill of the order at the front of the level
+    void reduceFront(PriceLevel& level, core::Quantity qty) noexcept {
+        hot_[level.head].quantity -= qty;
+        level.totalQuantity -= qty;
+    }
+
+    // Shrink any queued order in place; its queue position is unchanged
+    void reduce(OrderHandle h, core::Quantity newQuantity) noexcept {
+        RestingOrder& node = hot_[h];
+        cold_[h].level->totalQuantity -= node.quantity - newQuantity;
+        node.quantity = newQuantity;
+    }
+
+    // Make room for orders more resting orders in one step, e.g. before a
+    // bulk load, so no acquire() in between has to grow the arrays
+    void reserve(std::size_t orders) {
+        const std::size_t wanted = inUse_ + orders;
+        if (wanted > hot_.size()) growTo(wanted);
+    }
+
+    // reserve() with the arrays' new storage advised and locked as memory
+    // asks before it is first written, so the slots are faulted in here, on
+    // huge pages where the system has them, rather than by later orders.
+    // Growth past this capacity allocates as before.
+    void prewarm(std::size_t orders, const core::MemoryConfig& memory) {
+        const std::size_t wanted = inUse_ + orders;
+        if (wanted <= hot_.size()) return;
+        hot_.reserve(wanted);
+        cold_.reserve(wanted);
+        core::adviseMemory(hot_.data(), hot_.capacity() * sizeof(RestingOrder), memory);
+        core::adviseMemory(cold_.data(), cold_.capacity() * sizeof(RestingOrderInfo), memory);
+        growTo(wanted);
+    }
+
+    [[nodiscard]] std::size_t capacity() const noexcept { return hot_.size(); }
+    [[nodiscard]] std::size_t inUse() const noexcept { return inUse_; }
+
+private:
+    void grow() { growTo(hot_.size() + std::max(slabSize_, hot_.size())); }
+
+    void growTo(std::size_t newSize) {
+        const std::size_t oldSize = hot_.size();
+        if (newSize > static_cast<std::size_t>(NULL_HANDLE)) {
+            throw std::length_error("OrderPool: handle space exhausted");
+        }
+        hot_.resize(newSize);
+        cold_.resize(newSize);
+        // Thread the new slots onto the free list in index order
+        for (std::size_t i = newSize; i-- > oldSize;) {
+            hot_[i].next = freeList_;
+            freeList_ = static_cast<OrderHandle>(i);
+        }
+    }
+
+    std::size_t slabSize_;
+    std::vector<RestingOrder> hot_;
+    std::vector<RestingOrderInfo> cold_;
+    OrderHandle freeList_{NULL_HANDLE};
+    std::size_t inUse_{0};
+};
+
+} // namespace ob::book
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "orderbook/core/types.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace ob::book {
+
+// 32-bit index of a resting order inside its book's OrderPool.
+// Handles are stable for the lifetime of the order, unlike pointers into
+// the pool's (growable) arrays.
+using OrderHandle = std::uint32_t;
+inline constexpr OrderHandle NULL_HANDLE = std::numeric_limits<OrderHandle>::max();
+
+// Hot part of a resting order: everything the matching loop reads, packed
+// into half a cache line so a sweep through a level streams memory.
+// symbolId and type are implied by the book (only limit orders rest).
+struct alignas(32) RestingOrder {
+    core::OrderId orderId{};
+    core::Quantity quantity{0};
+    core::Price price{0};
+    OrderHandle prev{NULL_HANDLE};
+    OrderHandle next{NULL_HANDLE};
+};
+static_assert(sizeof(RestingOrder) == 32, "RestingOrder must stay two per cache line");
+
+struct PriceLevel;
+
+// Cold part of a resting order, only touched on cancel and when the full
+// core::Order is rebuilt at the API boundary
+struct RestingOrderInfo {
+    core::Timestamp ts{};
+    PriceLevel* level{nullptr};
+    core::Side side{core::Side::Buy};
+    core::TimeInForce tif{core::TimeInForce::GoodTillCancel}; // kept so an amended post-only order stays one
+    std::uint32_t account{0}; // risk account, for fills and cancels
+};
+
+// Price level as an intrusive doubly linked FIFO of pool handles.
+// Links are maintained by OrderPool; running totals are maintained on every
+// link/unlink/fill so L2 queries never walk the queue.
+struct PriceLevel {
+    OrderHandle head{NULL_HANDLE};
+    OrderHandle tail{NULL_HANDLE};
+    core::Quantity totalQuantity{0};
+    std::uint32_t orderCount{0};    // bounded by the handle space
+    std::uint32_t snapshotEpoch{0}; // last SnapshotCapture epoch that copied this level
+
+    [[nodiscard]] bool empty() const noexcept { return head == NULL_HANDLE; }
+};
+static_assert(sizeof(PriceLevel) == 24, "ladder windows store PriceLevel by value");
+
+} // namespace ob::book
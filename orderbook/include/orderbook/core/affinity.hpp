@@ -0,0 +1,11 @@
+#pragma once
+
+namespace ob::core {
+
+// Pins the calling thread to one CPU. cpu < 0 asks for no pinning and
+// succeeds. False if the kernel refused the CPU (offline, outside the
+// process's cpuset): the thread keeps running unpinned, and the caller
+// names itself in the log line, since OB_LOG formats numbers only.
+bool pinCurrentThread(int cpu) noexcept;
+
+} // namespace ob::core
@@ -0,0 +1,169 @@
+#pragma once
+
+#include "orderbook/core/log.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <string>
+#include <type_traits>
+
+namespace ob::core {
+
+// Asynchronous binary logging.
+//
+// A log call copies a timestamp, its call site's id and its raw arguments
+// into a 64-byte LogRecord on the calling thread's own ring and returns;
+// nothing is formatted or written there and no lock is taken. A background
+// thread drains every ring, formats the records as "<ns> | <message>" lines
+// on stdout or appends them undecoded to a binary file, which ob_logdump
+// turns back into the same lines. A record that finds its ring full is
+// dropped and counted, never waited for; the writer logs how many were lost.
+
+inline constexpr std::size_t MAX_LOG_ARGS = 6;
+inline constexpr std::size_t DEFAULT_LOG_RING = 16384; // Records buffered per logging thread
+
+enum class LogArg : std::uint8_t { Int = 1, UInt = 2, Char = 3, Double = 4 };
+
+// A call site: its format, with one {} per argument, and the argument types.
+// format must outlive the process (OB_LOG only takes literals).
+struct LogSite {
+    const char* format{nullptr};
+    std::uint8_t argc{0};
+    std::array<LogArg, MAX_LOG_ARGS> types{};
+};
+
+// What a log call writes: one cache line
+struct LogRecord {
+    std::uint64_t ts{0};   // nowNs() at the call
+    std::uint32_t site{0}; // from AsyncLog::registerSite
+    std::uint32_t reserved{0};
+    std::uint64_t args[MAX_LOG_ARGS]{}; // raw bits, decoded by the site's types
+};
+static_assert(sizeof(LogRecord) == 64);
+
+struct LogConfig {
+    std::string binaryPath; // empty: format lines to stdout
+};
+
+class AsyncLog {
+public:
+    // Once per call site (OB_LOG keeps the id in a static); takes a lock
+    static std::uint32_t registerSite(const LogSite& site);
+
+    // Calling thread's ring; its first record registers the ring
+    static void write(const LogRecord& record) noexcept;
+
+    // Switches the output, after writing out what was logged before. Throws
+    // std::runtime_error when the file cannot be opened.
+    static void open(const LogConfig& config);
+
+    // Blocks until every record logged before the call has been written
+    static void flush();
+
+    // Records lost to full rings so far
+    static std::uint64_t dropped() noexcept;
+};
+
+// "<ts> | <message>" with site's placeholders replaced by record's arguments
+void formatLogRecord(const LogSite& site, const LogRecord& record, std::string& out);
+
+// Decodes a binary log written with LogConfig::binaryPath into out, as the
+// text lines it stands for; returns the records decoded. Throws
+// std::runtime_error when the file is missing or not a log.
+std::size_t decodeLogFile(const std::string& path, std::ostream& out);
+
+// Binary log layout: a LogFileHeader, then frames, each a 32-bit tag and a
+// body. A site frame (LOG_SITE_FRAME) is a LogSiteFrame and the format's
+// bytes, written before the first record of that site; a record frame
+// (LOG_RECORD_FRAME) is a LogRecord. A frame cut short by a crash ends the
+// log.
+inline constexpr std::uint32_t LOG_FILE_MAGIC = 0x474C424F; // "OBLG" little-endian
+inline constexpr std::uint32_t LOG_SITE_FRAME = 1;
+inline constexpr std::uint32_t LOG_RECORD_FRAME = 2;
+
+struct LogFileHeader {
+    std::uint32_t magic{LOG_FILE_MAGIC};
+    std::uint32_t version{1};
+};
+
+struct LogSiteFrame {
+    std::uint32_t site{0};
+    std::uint8_t argc{0};
+    std::array<LogArg, MAX_LOG_ARGS> types{};
+    std::uint8_t reserved{0};
+    std::uint32_t formatLength{0}; // bytes of format that follow
+};
+
+template <typename T>
+constexpr LogArg logArgType() noexcept {
+    using U = std::decay_t<T>;
+    if constexpr (std::is_enum_v<U>) {
+        return logArgType<std::underlying_type_t<U>>();
+    } else if constexpr (std::is_same_v<U, char>) {
+        return LogArg::Char;
+    } else if constexpr (std::is_floating_point_v<U>) {
+        return LogArg::Double;
+    } else {
+        static_assert(std::is_integral_v<U>, "OB_LOG arguments must be integers, chars, enums or floating point");
+        return std::is_signed_v<U> ? LogArg::Int : LogArg::UInt;
+    }
+}
+
+template <typename T>
+std::uint64_t logArgBits(const T& value) noexcept {
+    using U = std::decay_t<T>;
+    if constexpr (std::is_enum_v<U>) {
+        return logArgBits(static_cast<std::underlying_type_t<U>>(value));
+    } else if constexpr (std::is_floating_point_v<U>) {
+        const double wide = static_cast<double>(value);
+        std::uint64_t bits;
+        std::memcpy(&bits, &wide, sizeof(bits));
+        return bits;
+    } else if constexpr (std::is_signed_v<U>) {
+        return static_cast<std::uint64_t>(static_cast<std::int64_t>(value));
+    } else {
+        return static_cast<std::uint64_t>(value);
+    }
+}
+
+constexpr std::size_t countLogPlaceholders(const char* format) noexcept {
+    std::size_t count = 0;
+    for (; *format != '\0'; ++format) {
+        if (format[0] == '{' && format[1] == '}') ++count;
+    }
+    return count;
+}
+
+template <typename... Args>
+std::uint32_t registerLogSite(const char* format) {
+    return AsyncLog::registerSite(LogSite{format, static_cast<std::uint8_t>(sizeof...(Args)), {logArgType<Args>()...}});
+}
+
+template <typename... Args>
+void logRecord(std::uint32_t site, const Args&... args) noexcept {
+    LogRecord record;
+    record.ts = nowNs();
+    record.site = site;
+    [[maybe_unused]] std::size_t i = 0;
+    ((record.args[i++] = logArgBits(args)), ...);
+    AsyncLog::write(record);
+}
+
+} // namespace ob::core
+
+// OB_LOG("TRADE maker={} qty={}", makerId, quantity): one {} per argument.
+// Each expansion is its own lambda, so its static holds that site's id.
+#ifdef ORDERBOOK_VERBOSE_LOG
+#define OB_LOG(format, ...)                                                                                  \
+    [](const auto&... obLogArgs) {                                                                           \
+        static_assert(::ob::core::countLogPlaceholders("" format) == sizeof...(obLogArgs),                  \
+                      "OB_LOG needs one {} per argument");                                                   \
+        static_assert(sizeof...(obLogArgs) <= ::ob::core::MAX_LOG_ARGS, "too many OB_LOG arguments");        \
+        static const std::uint32_t obLogSite = ::ob::core::registerLogSite<decltype(obLogArgs)...>(format); \
+        ::ob::core::logRecord(obLogSite, obLogArgs...);                                                      \
+    }(__VA_ARGS__)
+#else
+#define OB_LOG(format, ...) do {} while(0)
+#endif
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "orderbook/core/types.hpp"
+#include <cstdint>
+
+namespace ob::core {
+
+enum class CommandType : std::uint8_t {
+    NewOrder = 0, // submit an order (all fields used)
+    Cancel = 1,   // cancel a resting order (orderId, symbolId)
+    Amend = 2,    // cancel-replace: new price and remaining quantity for orderId
+    Snapshot = 3  // cut point of a book snapshot (orderId carries the snapshot id)
+};
+
+// One message on the ingress queue. Orders and order-management requests
+// share a single tagged, fixed-size record so the matching thread applies
+// them strictly in arrival order and never contends with callers for the
+// book. Same cache-line footprint as Order.
+struct alignas(64) Command final {
+    CommandType type{CommandType::NewOrder};
+    Side        side{Side::Buy};
+    OrderType   orderType{OrderType::Limit};
+    TimeInForce tif{TimeInForce::GoodTillCancel};
+    std::uint32_t symbolId{0};
+    OrderId     orderId{};
+    Price       price{0};
+    Quantity    quantity{0};
+    Timestamp   ts{}; // arrival timestamp
+    Price       stopPrice{0};
+    std::uint32_t account{0}; // NewOrder: risk account of the order
+
+    static Command newOrder(const Order& order) noexcept {
+        Command cmd;
+        cmd.type = CommandType::NewOrder;
+        cmd.side = order.side;
+        cmd.orderType = order.type;
+        cmd.tif = order.tif;
+        cmd.symbolId = order.symbolId;
+        cmd.orderId = order.orderId;
+        cmd.price = order.price;
+        cmd.quantity = order.quantity;
+        cmd.ts = order.ts;
+        cmd.stopPrice = order.stopPrice;
+        cmd.account = order.account;
+        return cmd;
+    }
+
+    static Command cancel(std::uint32_t symbolId, OrderId orderId) noexcept {
+        Command cmd;
+        cmd.type = CommandType::Cancel;
+        cmd.symbolId = symbolId;
+        cmd.orderId = orderId;
+        return cmd;
+    }
+
+    static Command amend(std::uint32_t symbolId, OrderId orderId, Price newPrice, Quantity newQuantity) noexcept {
+        Command cmd;
+        cmd.type = CommandType::Amend;
+        cmd.symbolId = symbolId;
+        cmd.orderId = orderId;
+        cmd.price = newPrice;
+        cmd.quantity = newQuantity;
+        return cmd;
+    }
+
+    // Journaled like any input, so recovery knows where the snapshot's book
+    // state ends and the tail to replay begins
+    static Command snapshot(std::uint32_t symbolId, std::uint64_t snapshotId) noexcept {
+        Command cmd;
+        cmd.type = CommandType::Snapshot;
+        cmd.symbolId = symbolId;
+        cmd.orderId = snapshotId;
+        return cmd;
+    }
+
+    Order toOrder() const noexcept {
+        Order order{orderId, symbolId, side, orderType, price, quantity, ts, tif, stopPrice};
+        order.account = account;
+        return order;
+    }
+};
+
+static_assert(sizeof(Command) == 64, "Command should occupy exactly one cache line");
+
+} // namespace ob::core
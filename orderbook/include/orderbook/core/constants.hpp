@@ -5,6 +5,30 @@
 namespace ob::core {
 
 inline constexpr std::size_t DEFAULT_QUEUE_SIZE = 1024; // Power of 2 for SPSC queue
+inline constexpr std::size_t DEFAULT_LADDER_LEVELS = 2048; // Ticks covered by LadderOrderBook's dense window
+inline constexpr std::size_t DEFAULT_ORDER_POOL_SLAB = 4096; // Order nodes per book arena slab
+inline constexpr std::size_t PREWARM_LEVELS = 256; // Price-level map nodes a book prewarm pools ahead, per side
+
+inline constexpr std::size_t DEFAULT_PROCESS_BATCH = 64; // Orders OrderProcessor drains per wakeup
+inline constexpr std::size_t DEFAULT_EVENT_BATCH = 256; // Events SpscEventPublisher stages before a forced flush
+inline constexpr std::size_t DEFAULT_EVENT_QUEUE_SIZE = 16384; // Per-instrument event ring under InstrumentManager; absorbs bursts ahead of the drain thread
+inline constexpr std::size_t DEFAULT_EVENT_DRAIN_BATCH = 256; // Events OutputHandler pops per tryPopN
+
+inline constexpr std::size_t DEFAULT_SHARD_QUEUE_SIZE = 16384; // Multi-symbol ingress ring per shard
+inline constexpr std::size_t DEFAULT_MAX_SYMBOLS = 4096; // Dense symbolId routing table size per shard
+
+inline constexpr std::size_t DEFAULT_SUBSCRIBER_QUEUE = 4096; // Pushed messages buffered per subscribed connection
+inline constexpr std::size_t MAX_BATCH_ORDERS = 256; // Orders one BATCH request may carry
+inline constexpr unsigned ORDER_ID_SESSION_SHIFT = 40; // Order ids carry the submitting session above this bit
+
+inline constexpr std::size_t DEFAULT_RISK_ACCOUNTS = 1024; // Per-instrument account slots of the pre-trade risk stage
+
+inline constexpr std::size_t DEFAULT_JOURNAL_RING = 65536; // Commands buffered between the matching threads and the journal writer
+inline constexpr std::size_t DEFAULT_JOURNAL_COMMIT_BATCH = 4096; // Records written per group commit
+inline constexpr std::size_t DEFAULT_JOURNAL_SEGMENT_BYTES = 64 * 1024 * 1024; // Preallocated size of a journal segment file
+inline constexpr std::size_t BOOK_IMAGE_DEPTH = 64; // Levels per side the matching thread publishes for readers (binary MAX_SNAPSHOT_DEPTH)
+
+inline constexpr std::size_t DEFAULT_SNAPSHOT_STEP = 1024; // Resting orders a matching thread copies per snapshot slice, between batches
 
 } // namespace ob::core
 
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <thread>
+
+namespace ob::core {
+
+// Process-wide epoch-based reclamation (a minimal userspace RCU).
+// Readers wrap access to shared, unlinked-on-removal objects in an
+// EpochGuard; entering and leaving are one store plus a fence on a
+// per-thread, cache-line-sized slot, so the read side takes no lock and
+// never waits. A writer unlinks an object, calls synchronizeEpoch(), and may
+// then free it: every reader that could still hold the old pointer has left.
+//
+// Each thread claims a reader slot on first use and returns it at thread
+// exit. If all slots are taken, readers fall back to a shared counter,
+// which is still lock-free but contended.
+class EpochDomain final {
+public:
+    static constexpr std::size_t MAX_READERS = 512;
+    static constexpr std::uint64_t IDLE = std::numeric_limits<std::uint64_t>::max();
+
+    static EpochDomain& instance() {
+        static EpochDomain domain;
+        return domain;
+    }
+
+    void enter() noexcept {
+        ThreadState& state = threadState();
+        if (state.depth++ != 0) return; // nested guard: already protected
+        if (state.slot) {
+            state.slot->epoch.store(globalEpoch_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        } else {
+            overflowReaders_.fetch_add(1, std::memory_order_relaxed);
+        }
+        // Pairs with the fence in synchronize(): either the writer sees this
+        // reader, or this reader sees the writer's unlink
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+
+    void leave() noexcept {
+        ThreadState& state = threadState();
+        if (--state.depth != 0) return;
+        if (state.slot) {
+            state.slot->epoch.store(IDLE, std::memory_order_release);
+        } else {
+            overflowReaders_.fetch_sub(1, std::memory_order_release);
+        }
+    }
+
+    // Wait until every reader that entered before this call has left
+    void synchronize() noexcept {
+        const std::uint64_t target = globalEpoch_.fetch_add(1, std::memory_order_seq_cst) + 1;
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        for (auto& slot : slots_) {
+            for (;;) {
+                const std::uint64_t e = slot.epoch.load(std::memory_order_acquire);
+                if (e == IDLE || e >= target) break;
+                std::this_thread::yield();
+            }
+        }
+        while (overflowReaders_.load(std::memory_order_acquire) != 0) std::this_thread::yield();
+    }
+
+private:
+    struct alignas(64) Slot {
+        std::atomic<std::uint64_t> epoch{IDLE};
+        std::atomic<bool> owned{false};
+    };
+
+    struct ThreadState {
+        Slot* slot{nullptr};
+        std::uint32_t depth{0};
+        ~ThreadState() {
+            if (slot) slot->owned.store(false, std::memory_order_release);
+        }
+    };
+
+    EpochDomain() = default;
+
+    ThreadState& threadState() noexcept {
+        thread_local ThreadState state = claim();
+        return state;
+    }
+
+    ThreadState claim() noexcept {
+        ThreadState state;
+        for (auto& slot : slots_) {
+            bool expected = false;
+            if (!slot.owned.load(std::memory_order_relaxed) &&
+                slot.owned.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
+                state.slot = &slot;
+                break;
+            }
+        }
+        return state;
+    }
+
+    alignas(64) std::atomic<std::uint64_t> globalEpoch_{1};
+    alignas(64) std::atomic<std::size_t> overflowReaders_{0};
+    Slot slots_[MAX_READERS];
+};
+
+// RAII read-side critical section
+class EpochGuard final {
+public:
+    EpochGuard() noexcept { EpochDomain::instance().enter(); }
+    ~EpochGuard() { EpochDomain::instance().leave(); }
+    EpochGuard(const EpochGuard&) = delete;
+    EpochGuard& operator=(const EpochGuard&) = delete;
+};
+
+inline void synchronizeEpoch() noexcept { EpochDomain::instance().synchronize(); }
+
+} // namespace ob::core
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace ob::core {
+
+/**
+ * Fixed-size latency histogram with bounded relative error.
+ *
+ * Values are bucketed HDR-style: exact below 2 * SUB_BUCKETS, then
+ * SUB_BUCKETS linear buckets per power of two, so a bucket is never wider
+ * than 1/64 of its value (about 1.6%). Values up to 2^MAX_BITS - 1 (about
+ * 73 minutes in ns) are kept; larger ones land in the last bucket. Recording
+ * is a few integer operations and never allocates. Not thread-safe: keep
+ * one per thread and merge(). The *Shared variants let one writer thread
+ * record while other threads merge it: every word goes through a relaxed
+ * atomic_ref load or store (no read-modify-write, so recording still
+ * compiles to plain moves on x86). A merge may miss a record in flight.
+ */
+class LatencyHistogram {
+public:
+    static constexpr unsigned SUB_BUCKET_BITS = 6;
+    static constexpr std::uint64_t SUB_BUCKETS = 1ull << SUB_BUCKET_BITS;
+    static constexpr unsigned MAX_BITS = 42;
+    static constexpr std::uint64_t MAX_VALUE = (1ull << MAX_BITS) - 1;
+    static constexpr std::size_t BUCKETS = (MAX_BITS - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+    void record(std::uint64_t value) noexcept {
+        value = std::min(value, MAX_VALUE);
+        ++counts_[bucketOf(value)];
+        ++count_;
+        sum_ += value;
+        min_ = std::min(min_, value);
+        max_ = std::max(max_, value);
+    }
+
+    void merge(const LatencyHistogram& other) noexcept {
+        for (std::size_t i = 0; i < BUCKETS; ++i) counts_[i] += other.counts_[i];
+        count_ += other.count_;
+        sum_ += other.sum_;
+        min_ = std::min(min_, other.min_);
+        max_ = std::max(max_, other.max_);
+    }
+
+    void reset() noexcept { *this = LatencyHistogram{}; }
+
+    // Writer thread only
+    void recordShared(std::uint64_t value) noexcept {
+        value = std::min(value, MAX_VALUE);
+        bump(counts_[bucketOf(value)], 1);
+        bump(count_, 1);
+        bump(sum_, value);
+        if (value < load(min_)) store(min_, value);
+        if (value > load(max_)) store(max_, value);
+    }
+
+    void resetShared() noexcept {
+        for (auto& bucket : counts_) store(bucket, 0);
+        store(count_, 0);
+        store(sum_, 0);
+        store(min_, std::numeric_limits<std::uint64_t>::max());
+        store(max_, 0);
+    }
+
+    // Any thread: add what other's writer has recorded so far. The count is
+    // rebuilt from the buckets so percentiles stay consistent with them.
+    void mergeShared(const LatencyHistogram& other) noexcept {
+        std::uint64_t added = 0;
+        for (std::size_t i = 0; i < BUCKETS; ++i) {
+            const std::uint64_t n = load(other.counts_[i]);
+            counts_[i] += n;
+            added += n;
+        }
+        count_ += added;
+        sum_ += load(other.sum_);
+        min_ = std::min(min_, load(other.min_));
+        max_ = std::max(max_, load(other.max_));
+    }
+
+    std::uint64_t count() const noexcept { return count_; }
+    std::uint64_t min() const noexcept { return count_ ? min_ : 0; }
+    std::uint64_t max() const noexcept { return max_; }
+    double mean() const noexcept { return count_ ? static_cast<double>(sum_) / static_cast<double>(count_) : 0.0; }
+
+    // Smallest recorded bucket bound that percentile (0-100) of the values
+    // do not exceed; clamped to the exact max
+    std::uint64_t percentile(double percentile) const noexcept {
+        if (count_ == 0) return 0;
+        const double rank = std::clamp(percentile, 0.0, 100.0) / 100.0 * static_cast<double>(count_);
+        const auto target = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(rank + 0.5));
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < BUCKETS; ++i) {
+            seen += counts_[i];
+            if (seen >= target) return std::min(highestIn(i), max_);
+        }
+        return max_;
+    }
+
+    // fn(lowest, highest, count) for every non-empty bucket, in value order
+    template <typename Fn>
+    void forEachBucket(Fn&& fn) const {
+        for (std::size_t i = 0; i < BUCKETS; ++i) {
+            if (counts_[i] != 0) fn(lowestIn(i), highestIn(i), counts_[i]);
+        }
+    }
+
+private:
+    static std::uint64_t load(const std::uint64_t& word) noexcept {
+        return std::atomic_ref<std::uint64_t>(const_cast<std::uint64_t&>(word)).load(std::memory_order_relaxed);
+    }
+    static void store(std::uint64_t& word, std::uint64_t value) noexcept {
+        std::atomic_ref<std::uint64_t>(word).store(value, std::memory_order_relaxed);
+    }
+    static void bump(std::uint64_t& word, std::uint64_t by) noexcept { store(word, load(word) + by); }
+
+    // Power-of-two range m (0 for the exact buckets) and the value's top
+    // SUB_BUCKET_BITS + 1 bits within it
+    static std::size_t bucketOf(std::uint64_t value) noexcept {
+        const unsigned width = static_cast<unsigned>(std::bit_width(value));
+        const unsigned m = width > SUB_BUCKET_BITS + 1 ? width - SUB_BUCKET_BITS - 1 : 0;
+        return static_cast<std::size_t>(m * SUB_BUCKETS + (value >> m));
+    }
+
+    static unsigned rangeOf(std::size_t bucket) noexcept {
+        return bucket < 2 * SUB_BUCKETS ? 0 : static_cast<unsigned>(bucket / SUB_BUCKETS - 1);
+    }
+
+    static std::uint64_t lowestIn(std::size_t bucket) noexcept {
+        const unsigned m = rangeOf(bucket);
+        return (static_cast<std::uint64_t>(bucket) - m * SUB_BUCKETS) << m;
+    }
+
+    static std::uint64_t highestIn(std::size_t bucket) noexcept {
+        return lowestIn(bucket) + (1ull << rangeOf(bucket)) - 1;
+    }
+
+    std::array<std::uint64_t, BUCKETS> counts_{};
+    std::uint64_t count_{0};
+    std::uint64_t sum_{0};
+    std::uint64_t min_{std::numeric_limits<std::uint64_t>::max()};
+    std::uint64_t max_{0};
+};
+
+} // namespace ob::core
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "orderbook/core/latency_histogram.hpp"
+#include "orderbook/core/log.hpp"
+#include "orderbook/core/types.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <utility>
+
+namespace ob::core {
+
+// Build with ORDERBOOK_LATENCY_STATS to record; otherwise every call below
+// compiles to nothing, clock reads included
+#ifdef ORDERBOOK_LATENCY_STATS
+inline constexpr bool LATENCY_STATS_ENABLED = true;
+#else
+inline constexpr bool LATENCY_STATS_ENABLED = false;
+#endif
+
+// Where a command spends its time, in pipeline order
+enum class Stage : std::uint8_t {
+    Parse,   // request bytes to a decoded, validated command (reactor)
+    Enqueue, // service call: instrument lookup and ingress push (reactor)
+    Queue,   // arrival stamp to the matching thread starting on it
+    Match,   // applying it to the book (matching thread)
+    Publish, // per batch: book image and event flush (matching thread)
+    Send,    // event time to the subscriber's output buffer (reactor)
+};
+
+inline constexpr std::size_t STAGE_COUNT = 6;
+
+const char* stageName(Stage stage) noexcept;
+
+using StageHistograms = std::array<LatencyHistogram, STAGE_COUNT>;
+
+/**
+ * Process-wide per-thread, per-stage latency histograms.
+ *
+ * Each thread records into its own histograms, registered on its first
+ * record, so recording takes no lock and shares no cache line. Readers
+ * merge them on demand. A thread's histograms are folded into an "exited"
+ * total when it ends. reset() only bumps a generation: each thread clears
+ * its own histograms on its next record, and until then readers skip them.
+ */
+class LatencyStats {
+public:
+    // Calling thread
+    static void record(Stage stage, std::uint64_t ns) noexcept;
+    static void nameThread(std::string name); // label in perThread(); default "thread-N"
+
+    // Any thread
+    static void merged(StageHistograms& out);
+    static void perThread(const std::function<void(const std::string& name, const StageHistograms&)>& fn);
+    static void reset() noexcept;
+};
+
+// Timestamp to start a stage from; 0 when stats are compiled out
+inline std::uint64_t stageClock() noexcept {
+    if constexpr (LATENCY_STATS_ENABLED) {
+        return nowNs();
+    } else {
+        return 0;
+    }
+}
+
+// Record end - start for stage and return end, so consecutive stages chain
+// from one clock read each
+inline std::uint64_t recordStage(Stage stage, std::uint64_t start, std::uint64_t end) noexcept {
+    if constexpr (LATENCY_STATS_ENABLED) {
+        LatencyStats::record(stage, end > start ? end - start : 0);
+    }
+    return end;
+}
+
+inline std::uint64_t recordStage(Stage stage, std::uint64_t start) noexcept {
+    if constexpr (LATENCY_STATS_ENABLED) {
+        return recordStage(stage, start, nowNs());
+    } else {
+        return 0;
+    }
+}
+
+// Queue wait of a command that carries its arrival stamp (unstamped: skipped)
+inline void recordQueueWait(Timestamp arrival, std::uint64_t now) noexcept {
+    if constexpr (LATENCY_STATS_ENABLED) {
+        const auto arrivalNs = arrival.time_since_epoch().count();
+        if (arrivalNs > 0) recordStage(Stage::Queue, static_cast<std::uint64_t>(arrivalNs), now);
+    }
+}
+
+inline void nameStatsThread(std::string name) {
+    if constexpr (LATENCY_STATS_ENABLED) LatencyStats::nameThread(std::move(name));
+}
+
+} // namespace ob::core
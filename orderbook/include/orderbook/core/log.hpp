@@ -1,6 +1,5 @@
 #pragma once
 
-#include <iostream>
 #include <chrono>
 #include <cstdint>
 
@@ -12,10 +11,3 @@ inline std::uint64_t nowNs() {
 }
 
 } // namespace ob::core
-
-#ifdef ORDERBOOK_VERBOSE_LOG
-#define OB_LOG(msg) do { std::cout << ob::core::nowNs() << " | " << msg << std::endl; } while(0)
-#else
-#define OB_LOG(msg) do {} while(0)
-#endif
-
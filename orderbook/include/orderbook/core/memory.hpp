@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace ob::core {
+
+// Backing memory for long-lived buffers on the order path: the ingress and
+// event queues and the book arenas.
+//
+// By default they come from the heap and are faulted in page by page as
+// they are first touched. A MemoryConfig asks for huge pages instead (fewer
+// TLB misses over a large ring or arena), for every page to be faulted in
+// when the memory is allocated rather than on the first order that reaches
+// it, and for the pages to be locked so they are never swapped out or
+// reclaimed. Every request degrades: without reserved huge pages a region
+// falls back to regular pages marked for transparent huge pages, and a
+// failed mlock leaves the region usable but unlocked. memoryStats() counts
+// what was actually obtained.
+
+enum class PageSize : std::uint8_t {
+    Regular = 0,
+    Huge2M = 1,
+    Huge1G = 2  // only for regions of at least HUGE_1G_MIN_REGION; smaller ones take 2 MB pages
+};
+
+inline constexpr std::size_t HUGE_2M_BYTES = std::size_t{2} << 20;
+inline constexpr std::size_t HUGE_1G_BYTES = std::size_t{1} << 30;
+inline constexpr std::size_t HUGE_1G_MIN_REGION = HUGE_1G_BYTES / 2; // below this a 1 GB page wastes most of itself
+
+struct MemoryConfig {
+    PageSize pageSize{PageSize::Regular}; // largest page size to try
+    bool prefault{false};                 // fault every page in at allocation
+    bool lock{false};                     // mlock the pages (bounded by RLIMIT_MEMLOCK)
+
+    // Nothing asked for: buffers keep coming from the heap
+    bool plain() const noexcept { return pageSize == PageSize::Regular && !prefault && !lock; }
+};
+
+// A page-aligned anonymous mapping from allocatePages
+struct PageBlock {
+    void* base{nullptr};
+    std::size_t bytes{0}; // mapped length, a multiple of the page size
+    PageSize pageSize{PageSize::Regular};
+};
+
+// Maps at least bytes, zero-filled, on the largest page size config allows
+// that the system can supply. Throws std::bad_alloc if nothing can be mapped.
+PageBlock allocatePages(std::size_t bytes, const MemoryConfig& config);
+void freePages(const PageBlock& block) noexcept;
+
+// For memory the caller already owns, such as a vector's storage before
+// it is filled: asks for transparent huge pages over the whole 2 MB pages
+// inside [base, base + bytes) and locks the range as config asks. Best
+// effort; pages are faulted in by the caller's first writes (or by mlock).
+void adviseMemory(void* base, std::size_t bytes, const MemoryConfig& config) noexcept;
+
+// Process-wide totals, any thread
+struct MemoryStats {
+    std::uint64_t regions{0};        // allocatePages calls
+    std::uint64_t hugeBytes{0};      // mapped on reserved 2 MB or 1 GB pages
+    std::uint64_t regularBytes{0};   // mapped on regular pages (huge pages not asked for or not available)
+    std::uint64_t hugeFallbacks{0};  // regions that asked for huge pages and did not get them
+    std::uint64_t lockedBytes{0};
+    std::uint64_t lockFailures{0};
+};
+MemoryStats memoryStats() noexcept;
+
+} // namespace ob::core
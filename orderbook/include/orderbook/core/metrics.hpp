@@ -0,0 +1,124 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ob::core {
+
+// Runtime counters and gauges, read for monitoring (METRICS).
+//
+// Each group below is written by one thread and is aligned and padded to
+// whole cache lines, so its writer never shares a line with another
+// thread's stores. A writer updates with a relaxed load and store, not a
+// locked add, and readers take relaxed loads at any time without
+// synchronising with it. A reader may see a group half updated, which
+// monitoring tolerates.
+
+// Written by one thread only
+class Counter {
+public:
+    void add(std::uint64_t n = 1) noexcept {
+        value_.store(value_.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+    std::uint64_t load() const noexcept { return value_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<std::uint64_t> value_{0};
+};
+
+// Written by one thread only: the latest value, or with raise() the highest
+class Gauge {
+public:
+    void set(std::uint64_t value) noexcept { value_.store(value, std::memory_order_relaxed); }
+    void raise(std::uint64_t value) noexcept {
+        if (value > value_.load(std::memory_order_relaxed)) set(value);
+    }
+    std::uint64_t load() const noexcept { return value_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<std::uint64_t> value_{0};
+};
+
+// Written by any thread, so a locked add: only for rare paths such as a
+// push refused by a full queue. Alone on its cache line.
+class alignas(64) SharedCounter {
+public:
+    void add(std::uint64_t n = 1) noexcept { value_.fetch_add(n, std::memory_order_relaxed); }
+    std::uint64_t load() const noexcept { return value_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<std::uint64_t> value_{0};
+};
+
+// Matching thread of one instrument
+struct alignas(64) EngineMetrics {
+    Counter orders;         // new orders applied
+    Counter cancels;        // cancel commands applied
+    Counter amends;         // amend commands applied
+    Counter rejects;        // orders rejected, and amends the risk stage refused
+    Counter trades;
+    Counter tradedQuantity;
+    // Book depth, refreshed when the book image is published
+    Gauge bidLevels;
+    Gauge askLevels;
+    Gauge restingOrders;
+    Gauge stopOrders;       // waiting for their trigger
+};
+
+// Thread draining an ingress queue (OrderProcessor or ShardProcessor)
+struct alignas(64) ProcessorMetrics {
+    Counter batches;    // non-empty pops
+    Counter commands;   // commands popped
+    Gauge ingressPeak;  // deepest queue seen at a pop since start
+
+    // A pop of count commands that left left more behind
+    void popped(std::uint64_t count, std::uint64_t left) noexcept {
+        batches.add();
+        commands.add(count);
+        ingressPeak.raise(count + left);
+    }
+};
+
+// What METRICS reports; plain values copied out of the groups above
+
+struct QueueSample {
+    std::uint64_t depth{0};        // occupancy when sampled
+    std::uint64_t capacity{0};
+    std::uint64_t peak{0};         // deepest seen by the consumer (ingress only)
+    std::uint64_t pushFailures{0}; // items refused because the queue was full
+};
+
+struct ProcessorSample {
+    std::string name; // "shard-<n>", or "instrument-<symbolId>" for a dedicated thread
+    std::uint64_t batches{0};
+    std::uint64_t commands{0};
+    QueueSample ingress;
+};
+
+struct InstrumentSample {
+    std::uint32_t symbolId{0};
+    std::string processor; // ProcessorSample::name of the thread serving it
+    std::uint64_t orders{0};
+    std::uint64_t cancels{0};
+    std::uint64_t amends{0};
+    std::uint64_t rejects{0};
+    std::uint64_t trades{0};
+    std::uint64_t tradedQuantity{0};
+    std::uint64_t submitFull{0}; // submits, cancels and amends refused by a full ingress queue
+    std::uint64_t bidLevels{0};
+    std::uint64_t askLevels{0};
+    std::uint64_t restingOrders{0};
+    std::uint64_t stopOrders{0};
+    std::uint64_t riskRejects{0}; // orders and amends the pre-trade risk stage refused (also in rejects)
+    QueueSample events;          // pushFailures = events dropped
+};
+
+struct ServiceMetrics {
+    std::vector<ProcessorSample> processors;
+    std::vector<InstrumentSample> instruments;
+};
+
+} // namespace ob::core
@@ -6,7 +6,16 @@
 namespace ob::core {
 
 enum class Side : std::uint8_t { Buy = 0, Sell = 1 };
-enum class OrderType : std::uint8_t { Limit = 0, Market = 1 };
+// Stop orders wait off the book until the last trade price reaches their
+// stop price, then enter as a market (Stop) or limit (StopLimit) order
+enum class OrderType : std::uint8_t { Limit = 0, Market = 1, Stop = 2, StopLimit = 3 };
+// What happens to quantity that does not trade on arrival
+enum class TimeInForce : std::uint8_t {
+    GoodTillCancel = 0,    // rests (limit orders); market remainders lapse
+    ImmediateOrCancel = 1, // remainder cancelled
+    FillOrKill = 2,        // all of it trades at once or none of it does
+    PostOnly = 3           // limit only: rests without trading, refused if it would cross
+};
 
 using OrderId = std::uint64_t;
 using Price = std::int64_t; // price in ticks
@@ -17,16 +26,27 @@ struct alignas(64) Order final {
     OrderId     orderId{};
     Side        side{Side::Buy};
     OrderType   type{OrderType::Limit};
-    Price       price{0};
+    TimeInForce tif{TimeInForce::GoodTillCancel};
+    Price       price{0}; // limit price (Limit, StopLimit)
     Quantity    quantity{0};
     Timestamp   ts{}; // arrival timestamp
     std::uint32_t symbolId{0};
+    std::uint32_t account{0}; // risk account named at logon; 0 = the shared account
+    Price       stopPrice{0}; // trigger price (Stop, StopLimit)
 
     Order() = default;
-    Order(OrderId id, std::uint32_t sym, Side s, OrderType t, Price p, Quantity q, Timestamp tstamp) noexcept
-        : orderId(id), side(s), type(t), price(p), quantity(q), ts(tstamp), symbolId(sym) {}
+    Order(OrderId id, std::uint32_t sym, Side s, OrderType t, Price p, Quantity q, Timestamp tstamp,
+          TimeInForce timeInForce = TimeInForce::GoodTillCancel, Price stop = 0) noexcept
+        : orderId(id), side(s), type(t), tif(timeInForce), price(p), quantity(q), ts(tstamp), symbolId(sym),
+          stopPrice(stop) {}
 };
 
+static_assert(sizeof(Order) == 64, "Order should occupy exactly one cache line");
+
+inline constexpr bool isStop(OrderType type) noexcept {
+    return type == OrderType::Stop || type == OrderType::StopLimit;
+}
+
 struct Trade final {
     OrderId makerId{};
     OrderId takerId{};
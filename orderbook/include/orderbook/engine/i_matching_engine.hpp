@@ -1,6 +1,7 @@
 #pragma once
 
 #include "orderbook/core/types.hpp"
+#include "orderbook/core/command.hpp"
 #include "orderbook/events/event_types.hpp"
 #include <vector>
 
@@ -11,6 +12,32 @@ class IMatchingEngine {
 public:
     virtual ~IMatchingEngine() = default;
     virtual std::vector<core::Trade> process(core::Order& order) = 0;
+
+    // Allocation-free variant for the hot path: fills are written into a
+    // caller-owned buffer (cleared first) whose capacity is reused across
+    // calls. Pass nullptr to only publish events.
+    virtual void process(core::Order& order, std::vector<core::Trade>* trades) = 0;
+
+    // Cancel a resting order, publishing CancelAck or CancelReject
+    virtual bool cancel(core::OrderId orderId) = 0;
+
+    // Cancel-replace, publishing AmendAck or AmendReject. newQuantity is the
+    // new open quantity. A size-down at the same price is done in place and
+    // keeps time priority; any other change requeues the order (and may
+    // trade) at the back of its new level.
+    virtual bool amend(core::OrderId orderId, core::Price newPrice, core::Quantity newQuantity) = 0;
+
+    // Apply one ingress command on the matching thread
+    virtual void apply(const core::Command& command) = 0;
+
+    // Copy about budget more orders of a book snapshot started by a
+    // CommandType::Snapshot command. Returns true while one is still in
+    // progress; processors call it between batches until it returns false.
+    virtual bool continueSnapshot(std::size_t budget) = 0;
+
+    // Republish the book image readers query if anything changed since the
+    // last call. Processors call it once per batch, before flushing events.
+    virtual void publishImage() = 0;
 };
 
 } // namespace ob::engine
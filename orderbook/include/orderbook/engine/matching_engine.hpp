@@ -1,9 +1,15 @@
 #pragma once
 
 #include "orderbook/engine/i_matching_engine.hpp"
+#include "orderbook/engine/stop_book.hpp"
+#include "orderbook/book/book_image.hpp"
 #include "orderbook/book/order_book.hpp"
+#include "orderbook/book/ladder_order_book.hpp"
 #include "orderbook/events/event_publisher.hpp"
+#include "orderbook/core/metrics.hpp"
 #include "orderbook/core/types.hpp"
+#include "orderbook/risk/i_risk_check.hpp"
+#include <atomic>
 #include <memory>
 #include <vector>
 #include <stdexcept>
@@ -11,23 +17,105 @@
 namespace ob::engine {
 
 // Concrete matching engine implementation
+// With a risk stage, every new order and amend passes its checks after
+// validation and before it is acknowledged, on this thread; a refusal is
+// published as a Reject (AmendReject for an amend).
+//
+// Time in force is applied in the matching loop: IOC and FOK quantity that
+// does not trade on arrival is published as a CancelAck (a FOK that the
+// contra side's level totals cannot fill never trades at all), and a
+// post-only order that would cross is rejected before its Ack. Stop orders
+// are acknowledged and wait in a StopBook until a trade reaches their stop
+// price, then match as market or limit orders; CANCEL reaches them there.
+//
+// The sweep is compiled per taker side, market or limit, book type and
+// publisher: execute() picks the instantiation once per order, so the loop
+// over levels has no side or type tests, calls the book's level access
+// directly and publishes trades through the concrete SpscEventPublisher
+// (or not at all) without a virtual call. Other publishers go through the
+// interface.
 class MatchingEngine final : public IMatchingEngine {
 public:
     MatchingEngine(
         std::shared_ptr<book::IOrderBook> orderBook,
-        std::shared_ptr<events::IEventPublisher> eventPublisher
+        std::shared_ptr<events::IEventPublisher> eventPublisher,
+        std::uint32_t symbolId = 0, // stamped on every published event
+        std::shared_ptr<risk::IRiskCheck> risk = nullptr, // shared with a replay engine on the same book
+        std::shared_ptr<StopBook> stops = nullptr         // likewise; a fresh one if null
     );
 
     std::vector<core::Trade> process(core::Order& order) override;
+    void process(core::Order& order, std::vector<core::Trade>* trades) override;
+    bool cancel(core::OrderId orderId) override;
+    bool amend(core::OrderId orderId, core::Price newPrice, core::Quantity newQuantity) override;
+    void apply(const core::Command& command) override;
+    bool continueSnapshot(std::size_t budget) override;
+    void publishImage() override;
+
+    // Any thread: top of book and levels as of the last publishImage()
+    const book::PublishedBook& image() const noexcept { return image_; }
+    // Any thread: what this engine applied, and the book depth as of the
+    // last publishImage()
+    const core::EngineMetrics& metrics() const noexcept { return metrics_; }
+
+    // Any thread: the next CommandType::Snapshot applied captures the book
+    // into target, which must stay alive until target->complete is set.
+    // Call before queueing the command; without a request (e.g. in replay)
+    // the command is a no-op.
+    void requestSnapshot(book::BookSnapshot* target) noexcept {
+        snapshotRequest_.store(target, std::memory_order_release);
+    }
 
 private:
-    static bool canMatch(core::Side takerSide, core::Price takerPrice, core::Price makerPrice, core::OrderType type) noexcept;
+    void beginSnapshot();
+
+    bool valid(const core::Order& order) const noexcept;
+    bool wouldCross(const core::Order& order) const noexcept;
+
+    // Publisher policy of an engine without a publisher (replay, tests)
+    struct NoPublisher {};
+
+    // Sweeps the contra side of a concrete book; instantiated per taker
+    // side, market or limit, book type and publisher policy
+    template <core::Side TakerSide, bool Market, typename Book, typename Publisher>
+    void sweep(Book& book, Publisher* publisher, core::Order& order, std::vector<core::Trade>* trades);
+    // The sweep instantiation for order's side and type
+    template <typename Book, typename Publisher>
+    void sweepAs(Book& book, Publisher* publisher, core::Order& order, std::vector<core::Trade>* trades);
+    void sweep(core::Order& order, std::vector<core::Trade>* trades);
+
+    // Match and rest an already validated and acknowledged order
+    void execute(core::Order& order, std::vector<core::Trade>* trades);
+    // Runs every stop the last trade price has reached, and those their
+    // trades trigger in turn
+    void triggerStops();
+    // IOC/FOK quantity that did not trade: published as a CancelAck
+    void expire(const core::Order& order);
+    // amend() for a command that arrived at arrival
+    bool replace(core::OrderId orderId, core::Price newPrice, core::Quantity newQuantity, core::Timestamp arrival);
+    void reject(const core::Order& order);
+    void publishStatus(events::EventType type, core::OrderId orderId, core::Timestamp ts);
     
     std::shared_ptr<book::IOrderBook> orderBook_;
     std::shared_ptr<events::IEventPublisher> eventPublisher_;
+    std::uint32_t symbolId_{0};
+    std::shared_ptr<risk::IRiskCheck> risk_;
+    std::shared_ptr<StopBook> stops_;
+    std::vector<core::Order> triggered_; // triggerStops() scratch, reused
     
-    // Need access to internal methods for matching
-    book::OrderBook* getConcreteBook();
+    // Concrete book resolved once at construction (exactly one is non-null
+    // for a supported book) so the sweep can use internal level access
+    book::OrderBook* mapBook_{nullptr};
+    book::LadderOrderBook* ladderBook_{nullptr};
+    // Likewise the publisher, when it is the SPSC one (null otherwise)
+    events::SpscEventPublisher* spscPublisher_{nullptr};
+
+    std::atomic<book::BookSnapshot*> snapshotRequest_{nullptr};
+    book::BookSnapshot* snapshot_{nullptr}; // capture in progress; matching thread only
+
+    book::PublishedBook image_;
+    bool imageDirty_{true}; // book changed since the last publish; matching thread only
+    core::EngineMetrics metrics_; // matching thread writes
 };
 
 } // namespace ob::engine
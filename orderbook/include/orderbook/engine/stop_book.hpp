@@ -0,0 +1,67 @@
+#pragma once
+
+#include "orderbook/book/book_snapshot.hpp"
+#include "orderbook/core/types.hpp"
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <memory_resource>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace ob::engine {
+
+/**
+ * Stop and stop-limit orders waiting for their trigger.
+ *
+ * A buy stop triggers once the last trade price is at or above its stop
+ * price, a sell stop once it is at or below. Each side maps stop price to
+ * the orders waiting there in arrival order, keyed so the next level to
+ * trigger is always first; checking after a trade compares the last price
+ * with one key per side, and levels are only visited once crossed.
+ *
+ * Matching thread only. An instrument's replay and live engines share one,
+ * as they share the book.
+ */
+class StopBook {
+public:
+    bool empty() const noexcept { return index_.empty(); }
+    std::size_t size() const noexcept { return index_.size(); }
+
+    // Last trade price, which the triggers compare against; 0 before the first trade
+    core::Price lastTradePrice() const noexcept { return lastTradePrice_; }
+    void onTrade(core::Price price) noexcept { lastTradePrice_ = price; }
+
+    bool contains(core::OrderId orderId) const noexcept { return index_.count(orderId) != 0; }
+    // A validated stop order; false if its id is already waiting
+    bool add(const core::Order& order);
+    // The waiting order with orderId, removed; false if none
+    bool cancel(core::OrderId orderId, core::Order* removed = nullptr);
+
+    // Some waiting order is crossed by the last trade price
+    bool triggered() const noexcept {
+        if (lastTradePrice_ == 0) return false;
+        return (!buys_.empty() && buys_.begin()->first <= lastTradePrice_) ||
+               (!sells_.empty() && sells_.begin()->first >= lastTradePrice_);
+    }
+    // Moves every triggered order into out (cleared first): buys by rising
+    // stop price, then sells by falling stop price, each level in arrival order
+    void takeTriggered(std::vector<core::Order>& out);
+
+    // Snapshot support: a copy of every waiting order, and a bulk load of
+    // an empty stop book (orders with an id already waiting are skipped)
+    void copyTo(std::vector<book::SnapshotStop>& out) const;
+    void load(const book::SnapshotStop* stops, std::size_t count, core::Price lastTradePrice);
+
+private:
+    using Level = std::vector<core::Order>;
+    // Levels come and go as stops trigger; the pool reuses their map nodes
+    std::pmr::unsynchronized_pool_resource levelResource_{};
+    std::pmr::map<core::Price, Level, std::less<core::Price>> buys_{&levelResource_};     // lowest stop first
+    std::pmr::map<core::Price, Level, std::greater<core::Price>> sells_{&levelResource_}; // highest stop first
+    std::unordered_map<core::OrderId, std::pair<core::Side, core::Price>> index_; // id -> side and stop price
+    core::Price lastTradePrice_{0};
+};
+
+} // namespace ob::engine
@@ -2,7 +2,11 @@
 
 #include "orderbook/events/event_types.hpp"
 #include "orderbook/queue/spsc_queue.hpp"
+#include "orderbook/queue/wait_strategy.hpp"
+#include <atomic>
+#include <cstdint>
 #include <memory>
+#include <vector>
 
 namespace ob::events {
 
@@ -12,24 +16,74 @@ public:
     virtual ~IEventPublisher() = default;
     virtual bool publish(const Event& event) = 0;
     virtual bool publish(Event&& event) = 0;
+    // Deliver anything staged by publish(); no-op for publishers that
+    // deliver immediately. Called once per processed batch.
+    virtual void flush() {}
 };
 
 // SPSC-based event publisher (lock-free)
+// With batchCapacity > 0 events are staged locally and pushed to the queue
+// with one tryPushN per flush() (or whenever the stage fills), so the
+// consumer sees one head update per batch instead of one per event.
+// Events that do not fit in the queue at flush time are dropped, as with
+// an individual publish into a full queue, and counted in droppedEvents().
+// If a consumer wait strategy is set (see processors::EventDrainer), it is
+// notified after every push so a parked drain thread wakes up.
 class SpscEventPublisher final : public IEventPublisher {
 public:
-    explicit SpscEventPublisher(std::shared_ptr<queue::SpscRingBuffer<Event>> eventQueue)
-        : eventQueue_(std::move(eventQueue)) {}
+    explicit SpscEventPublisher(std::shared_ptr<queue::SpscRingBuffer<Event>> eventQueue, std::size_t batchCapacity = 0)
+        : eventQueue_(std::move(eventQueue)), batchCapacity_(batchCapacity) {
+        staged_.reserve(batchCapacity_);
+    }
 
     bool publish(const Event& event) override {
-        return eventQueue_ && eventQueue_->tryPush(event);
+        if (batchCapacity_ == 0) {
+            const bool ok = eventQueue_ && eventQueue_->tryPush(event);
+            pushed(ok ? 1 : 0, 1);
+            return ok;
+        }
+        staged_.push_back(event);
+        if (staged_.size() >= batchCapacity_) flush();
+        return true;
     }
 
     bool publish(Event&& event) override {
-        return eventQueue_ && eventQueue_->tryPush(std::move(event));
+        if (batchCapacity_ == 0) {
+            const bool ok = eventQueue_ && eventQueue_->tryPush(std::move(event));
+            pushed(ok ? 1 : 0, 1);
+            return ok;
+        }
+        staged_.push_back(std::move(event));
+        if (staged_.size() >= batchCapacity_) flush();
+        return true;
+    }
+
+    void flush() override {
+        if (staged_.empty()) return;
+        pushed(eventQueue_ ? eventQueue_->tryPushN(staged_.data(), staged_.size()) : 0, staged_.size());
+        staged_.clear();
     }
 
+    // Consumer side; may be set while the producer is running
+    void setConsumerWait(queue::WaitStrategy* consumerWait) noexcept {
+        consumerWait_.store(consumerWait, std::memory_order_release);
+    }
+    // Events lost to a full queue since construction; readable from any thread
+    std::uint64_t droppedEvents() const noexcept { return dropped_.load(std::memory_order_relaxed); }
+
 private:
+    void pushed(std::size_t count, std::size_t attempted) noexcept {
+        if (count != attempted) dropped_.fetch_add(attempted - count, std::memory_order_relaxed);
+        if (count != 0) {
+            if (auto* wait = consumerWait_.load(std::memory_order_acquire)) wait->notify();
+        }
+    }
+
     std::shared_ptr<queue::SpscRingBuffer<Event>> eventQueue_;
+    std::size_t batchCapacity_;
+    std::vector<Event> staged_;
+    std::atomic<queue::WaitStrategy*> consumerWait_{nullptr};
+    std::atomic<std::uint64_t> dropped_{0};
 };
 
 } // namespace ob::events
@@ -1,9 +1,9 @@
 #pragma once
 
 #include "orderbook/core/types.hpp"
-#include <optional>
 #include <cstdint>
 #include <chrono>
+#include <type_traits>
 
 namespace ob::events {
 
@@ -12,15 +12,41 @@ enum class EventType : std::uint8_t {
     Trade,         // Trade executed
     CancelAck,     // Cancel acknowledged
     CancelReject,  // Cancel rejected
-    Reject         // Order rejected
+    Reject,        // Order rejected
+    AmendAck,      // Amend applied (in place or requeued)
+    AmendReject    // Amend rejected (order not resting or invalid size/price)
 };
 
+// Fixed-size, trivially copyable record, so the event ring stores it in
+// plain slots and moves it with a copy of 48 bytes. A Trade event carries
+// the fill inline: orderId is the taker, makerId/price/quantity the rest;
+// the trade fields are zero for every other type.
 struct Event final {
     EventType type{EventType::Ack};
+    std::uint32_t symbolId{0}; // instrument whose engine produced the event
     core::OrderId orderId{};
-    std::optional<core::Trade> trade; // present for Trade events
     core::Timestamp ts{}; // event timestamp
+    core::OrderId makerId{};
+    core::Price price{0};
+    core::Quantity quantity{0};
+
+    static Event makeTrade(const core::Trade& trade, std::uint32_t symbolId) noexcept {
+        Event event;
+        event.type = EventType::Trade;
+        event.symbolId = symbolId;
+        event.orderId = trade.takerId;
+        event.ts = trade.ts;
+        event.makerId = trade.makerId;
+        event.price = trade.price;
+        event.quantity = trade.quantity;
+        return event;
+    }
+    // Trade events only
+    core::Trade trade() const noexcept { return core::Trade{makerId, orderId, price, quantity, ts}; }
 };
 
+static_assert(std::is_trivially_copyable_v<Event>);
+static_assert(sizeof(Event) == 48);
+
 } // namespace ob::events
 
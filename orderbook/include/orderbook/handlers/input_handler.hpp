@@ -1,8 +1,13 @@
 #pragma once
 
 #include "orderbook/core/types.hpp"
-#include "orderbook/queue/spsc_queue.hpp"
+#include "orderbook/queue/order_queue.hpp"
+#include "orderbook/queue/wait_strategy.hpp"
 #include "orderbook/core/constants.hpp"
+#include "orderbook/core/latency_stats.hpp"
+#include <algorithm>
+#include <array>
+#include <chrono>
 #include <memory>
 #include <atomic>
 
@@ -12,15 +17,47 @@ namespace ob::handlers {
 // Single Responsibility: Handle order input
 class InputHandler {
 public:
-    explicit InputHandler(std::shared_ptr<queue::SpscRingBuffer<core::Order>> orderQueue)
-        : orderQueue_(std::move(orderQueue)) {}
+    // waitStrategy (optional) is notified after each push so a parked
+    // processor wakes up
+    explicit InputHandler(std::shared_ptr<queue::OrderQueue> orderQueue,
+                          std::shared_ptr<queue::WaitStrategy> waitStrategy = nullptr)
+        : orderQueue_(std::move(orderQueue)), waitStrategy_(std::move(waitStrategy)) {}
 
     bool submitOrder(const core::Order& order) {
-        return orderQueue_ && orderQueue_->tryPush(order);
+        return submitCommand(core::Command::newOrder(order));
     }
 
-    bool submitOrder(core::Order&& order) {
-        return orderQueue_ && orderQueue_->tryPush(std::move(order));
+    // Queues orders[0, count) in order with bulk pushes, waking the
+    // processor once. Returns how many were queued, always a prefix: once
+    // the queue is full the rest is refused.
+    std::size_t submitOrders(const core::Order* orders, std::size_t count) {
+        if (!orderQueue_) return 0;
+        std::array<core::Command, core::DEFAULT_PROCESS_BATCH> chunk;
+        std::size_t queued = 0;
+        while (queued < count) {
+            const std::size_t n = std::min(chunk.size(), count - queued);
+            for (std::size_t i = 0; i < n; ++i) chunk[i] = core::Command::newOrder(orders[queued + i]);
+            const std::size_t pushed = orderQueue_->tryPushN(chunk.data(), n);
+            queued += pushed;
+            if (pushed != n) break; // full: the rest is refused untried
+        }
+        notified(queued != 0);
+        return queued;
+    }
+
+    // Queues the cancel; the outcome arrives as a CancelAck/CancelReject event
+    bool submitCancel(std::uint32_t symbolId, core::OrderId orderId) {
+        return submitCommand(stamped(core::Command::cancel(symbolId, orderId)));
+    }
+
+    // Queues a cancel-replace; the outcome arrives as an AmendAck/AmendReject event
+    bool submitAmend(std::uint32_t symbolId, core::OrderId orderId,
+                     core::Price newPrice, core::Quantity newQuantity) {
+        return submitCommand(stamped(core::Command::amend(symbolId, orderId, newPrice, newQuantity), true));
+    }
+
+    bool submitCommand(const core::Command& command) {
+        return orderQueue_ && notified(orderQueue_->tryPush(command));
     }
 
     bool isQueueFull() const {
@@ -28,7 +65,25 @@ public:
     }
 
 private:
-    std::shared_ptr<queue::SpscRingBuffer<core::Order>> orderQueue_;
+    // Orders arrive stamped by their sender; cancels and amends are stamped
+    // here. Amends always are, as the risk stage throttles them by arrival
+    // time; cancels only when latency stats need their queue wait.
+    static core::Command stamped(core::Command command, bool always = false) noexcept {
+        if (always) {
+            command.ts = core::Timestamp{std::chrono::nanoseconds{static_cast<std::int64_t>(core::nowNs())}};
+        } else if constexpr (core::LATENCY_STATS_ENABLED) {
+            command.ts = core::Timestamp{std::chrono::nanoseconds{static_cast<std::int64_t>(core::stageClock())}};
+        }
+        return command;
+    }
+
+    bool notified(bool pushed) noexcept {
+        if (pushed && waitStrategy_) waitStrategy_->notify();
+        return pushed;
+    }
+
+    std::shared_ptr<queue::OrderQueue> orderQueue_;
+    std::shared_ptr<queue::WaitStrategy> waitStrategy_;
 };
 
 } // namespace ob::handlers
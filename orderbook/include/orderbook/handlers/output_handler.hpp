@@ -2,32 +2,45 @@
 
 #include "orderbook/events/event_types.hpp"
 #include "orderbook/queue/spsc_queue.hpp"
+#include "orderbook/core/constants.hpp"
+#include <cstddef>
 #include <memory>
 #include <functional>
+#include <vector>
 
 namespace ob::handlers {
 
 // Output handler for consuming events from the queue
 // Single Responsibility: Handle event output
+// Events are popped in batches of up to batchSize with one tryPopN, so the
+// producer sees one tail update per batch. Only one thread may drain a
+// handler, and the callback must not be replaced while it does.
 class OutputHandler {
 public:
     using EventCallback = std::function<void(const events::Event&)>;
 
     explicit OutputHandler(
         std::shared_ptr<queue::SpscRingBuffer<events::Event>> eventQueue,
-        EventCallback callback = nullptr
-    ) : eventQueue_(std::move(eventQueue)), callback_(std::move(callback)) {}
-
-    // Process available events (non-blocking)
-    void processEvents() {
-        if (!eventQueue_) return;
+        EventCallback callback = nullptr,
+        std::size_t batchSize = core::DEFAULT_EVENT_DRAIN_BATCH
+    ) : eventQueue_(std::move(eventQueue)), callback_(std::move(callback)),
+        batch_(batchSize == 0 ? 1 : batchSize) {}
+
+    // Process available events (non-blocking), at most maxBatches batches.
+    // Returns the number of events delivered.
+    std::size_t processEvents(std::size_t maxBatches = static_cast<std::size_t>(-1)) {
+        if (!eventQueue_) return 0;
         
-        events::Event event;
-        while (eventQueue_->tryPop(event)) {
+        std::size_t total = 0;
+        for (std::size_t round = 0; round < maxBatches; ++round) {
+            const std::size_t count = eventQueue_->tryPopN(batch_.data(), batch_.size());
+            if (count == 0) break;
             if (callback_) {
-                callback_(event);
+                for (std::size_t i = 0; i < count; ++i) callback_(batch_[i]);
             }
+            total += count;
         }
+        return total;
     }
 
     bool hasEvents() const {
@@ -41,6 +54,7 @@ public:
 private:
     std::shared_ptr<queue::SpscRingBuffer<events::Event>> eventQueue_;
     EventCallback callback_;
+    std::vector<events::Event> batch_;
 };
 
 } // namespace ob::handlers
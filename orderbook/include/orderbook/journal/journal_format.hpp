@@ -0,0 +1,227 @@
+#pragma once
+
+#include "orderbook/core/command.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+namespace ob::journal {
+
+// On-disk layout of the write-ahead journal.
+//
+// A journal directory holds numbered segment files (journal-<index>.log).
+// Each segment starts with a SegmentHeader, followed by records packed
+// back to back on RECORD_ALIGN boundaries. A record is a RecordHeader plus
+// its payload. Segments are preallocated and zero-filled, so a zero length
+// marks the end of written data; a checksum mismatch marks a torn write
+// left by a crash, and replay stops there.
+
+inline constexpr std::uint32_t SEGMENT_MAGIC = 0x4C4E524A; // "JRNL" little-endian
+inline constexpr std::uint16_t FORMAT_VERSION = 3; // 3: risk account; 2: time in force and stop price; reads 1 and 2 too
+inline constexpr std::size_t RECORD_ALIGN = 8;
+
+enum class RecordType : std::uint8_t {
+    Command = 1,           // one sequenced order, cancel or amend (CommandRecord)
+    InstrumentAdded = 2,   // InstrumentRecord followed by its strings
+    InstrumentRemoved = 3  // InstrumentRecord, strings empty
+};
+
+struct SegmentHeader {
+    std::uint32_t magic{SEGMENT_MAGIC};
+    std::uint16_t version{FORMAT_VERSION};
+    std::uint16_t headerSize{sizeof(SegmentHeader)};
+    std::uint64_t index{0};         // matches the file name
+    std::uint64_t firstSequence{0}; // sequence of the first record in the segment
+    std::uint8_t reserved[40]{};
+};
+
+struct RecordHeader {
+    std::uint32_t length{0};   // payload bytes; 0 = end of data
+    std::uint32_t checksum{0}; // over sequence, type and payload
+    std::uint64_t sequence{0}; // journal-wide, strictly increasing
+    RecordType type{RecordType::Command};
+    std::uint8_t reserved[7]{};
+};
+
+// core::Command without its cache-line padding. Version 1 records end
+// after orderType (COMMAND_RECORD_V1_SIZE bytes, timeInForce always 0),
+// version 2 records after stopPrice (COMMAND_RECORD_V2_SIZE, account
+// always 0); fields missing from a shorter record read as zero.
+struct CommandRecord {
+    std::uint64_t orderId{0};
+    std::int64_t price{0};
+    std::int64_t quantity{0};
+    std::int64_t ts{0}; // arrival timestamp, ns
+    std::uint32_t symbolId{0};
+    std::uint8_t type{0};
+    std::uint8_t side{0};
+    std::uint8_t orderType{0};
+    std::uint8_t timeInForce{0};
+    std::int64_t stopPrice{0};
+    std::uint32_t account{0};
+    std::uint8_t reserved[4]{};
+};
+inline constexpr std::size_t COMMAND_RECORD_V1_SIZE = 40;
+inline constexpr std::size_t COMMAND_RECORD_V2_SIZE = 48;
+
+// Fixed part of an instrument record; ticker, description and industry
+// follow it in that order
+struct InstrumentRecord {
+    double initialPrice{0.0};
+    std::uint32_t symbolId{0};
+    std::uint8_t bookType{0};
+    std::uint8_t waitStrategy{0};
+    std::uint16_t tickerLength{0};
+    std::uint16_t descriptionLength{0};
+    std::uint16_t industryLength{0};
+    std::uint8_t reserved[4]{};
+};
+
+static_assert(sizeof(SegmentHeader) == 64, "segment header must stay 64 bytes");
+static_assert(sizeof(RecordHeader) == 24, "record header layout is part of the format");
+static_assert(sizeof(CommandRecord) == 56, "command record layout is part of the format");
+static_assert(sizeof(InstrumentRecord) == 24, "instrument record layout is part of the format");
+
+// Bytes a record with payloadLength bytes occupies in a segment
+constexpr std::size_t recordSize(std::size_t payloadLength) noexcept {
+    return (sizeof(RecordHeader) + payloadLength + RECORD_ALIGN - 1) & ~(RECORD_ALIGN - 1);
+}
+
+// FNV-1a over 64-bit words, folded to 32 bits. Catches torn and partially
+// flushed records, not tampering.
+inline constexpr std::uint64_t HASH_SEED = 14695981039346656037ull;
+inline constexpr std::uint64_t HASH_PRIME = 1099511628211ull;
+
+inline std::uint64_t hashWord(std::uint64_t hash, std::uint64_t word) noexcept {
+    return (hash ^ word) * HASH_PRIME;
+}
+
+inline std::uint64_t hashBytes(std::uint64_t hash, const void* data, std::size_t length) noexcept {
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    std::size_t i = 0;
+    for (; i + sizeof(std::uint64_t) <= length; i += sizeof(std::uint64_t)) {
+        std::uint64_t word;
+        std::memcpy(&word, bytes + i, sizeof(word));
+        hash = hashWord(hash, word);
+    }
+    for (; i < length; ++i) hash = hashWord(hash, bytes[i]);
+    return hash;
+}
+
+inline std::uint32_t foldHash(std::uint64_t hash) noexcept {
+    return static_cast<std::uint32_t>(hash ^ (hash >> 32));
+}
+
+inline std::uint32_t checksum(std::uint64_t sequence, RecordType type, const void* payload, std::size_t length) noexcept {
+    std::uint64_t hash = hashWord(hashWord(HASH_SEED, sequence), static_cast<std::uint64_t>(type));
+    return foldHash(hashBytes(hash, payload, length));
+}
+
+inline CommandRecord toRecord(const core::Command& command) noexcept {
+    CommandRecord record;
+    record.orderId = command.orderId;
+    record.price = command.price;
+    record.quantity = command.quantity;
+    record.ts = command.ts.time_since_epoch().count();
+    record.symbolId = command.symbolId;
+    record.type = static_cast<std::uint8_t>(command.type);
+    record.side = static_cast<std::uint8_t>(command.side);
+    record.orderType = static_cast<std::uint8_t>(command.orderType);
+    record.timeInForce = static_cast<std::uint8_t>(command.tif);
+    record.stopPrice = command.stopPrice;
+    record.account = command.account;
+    return record;
+}
+
+inline core::Command toCommand(const CommandRecord& record) noexcept {
+    core::Command command;
+    command.type = static_cast<core::CommandType>(record.type);
+    command.side = static_cast<core::Side>(record.side);
+    command.orderType = static_cast<core::OrderType>(record.orderType);
+    command.tif = static_cast<core::TimeInForce>(record.timeInForce);
+    command.stopPrice = record.stopPrice;
+    command.account = record.account;
+    command.symbolId = record.symbolId;
+    command.orderId = record.orderId;
+    command.price = record.price;
+    command.quantity = record.quantity;
+    command.ts = core::Timestamp{std::chrono::nanoseconds{record.ts}};
+    return command;
+}
+
+// Decoded InstrumentAdded / InstrumentRemoved payload
+struct InstrumentEntry {
+    std::uint32_t symbolId{0};
+    std::string ticker;
+    std::string description;
+    std::string industry;
+    double initialPrice{0.0};
+    std::uint8_t bookType{0};
+    std::uint8_t waitStrategy{0};
+};
+
+// InstrumentRecord plus strings, as journaled and as stored in snapshots.
+// Strings are cut at 64 KiB.
+inline std::string encodeInstrument(const InstrumentEntry& instrument) {
+    InstrumentRecord record;
+    record.initialPrice = instrument.initialPrice;
+    record.symbolId = instrument.symbolId;
+    record.bookType = instrument.bookType;
+    record.waitStrategy = instrument.waitStrategy;
+    record.tickerLength = static_cast<std::uint16_t>(std::min<std::size_t>(instrument.ticker.size(), UINT16_MAX));
+    record.descriptionLength = static_cast<std::uint16_t>(std::min<std::size_t>(instrument.description.size(), UINT16_MAX));
+    record.industryLength = static_cast<std::uint16_t>(std::min<std::size_t>(instrument.industry.size(), UINT16_MAX));
+
+    std::string payload(reinterpret_cast<const char*>(&record), sizeof(record));
+    payload.append(instrument.ticker, 0, record.tickerLength);
+    payload.append(instrument.description, 0, record.descriptionLength);
+    payload.append(instrument.industry, 0, record.industryLength);
+    return payload;
+}
+
+// Inverse of encodeInstrument; length >= sizeof(InstrumentRecord), and
+// strings running past length are cut short
+inline void decodeInstrument(const char* payload, std::size_t length, InstrumentEntry& out) {
+    InstrumentRecord record;
+    std::memcpy(&record, payload, sizeof(record));
+    out.symbolId = record.symbolId;
+    out.initialPrice = record.initialPrice;
+    out.bookType = record.bookType;
+    out.waitStrategy = record.waitStrategy;
+    const char* text = payload + sizeof(record);
+    const std::size_t available = length - sizeof(record);
+    const std::size_t tickerLength = std::min<std::size_t>(record.tickerLength, available);
+    const std::size_t descriptionLength = std::min<std::size_t>(record.descriptionLength, available - tickerLength);
+    const std::size_t industryLength =
+        std::min<std::size_t>(record.industryLength, available - tickerLength - descriptionLength);
+    out.ticker.assign(text, tickerLength);
+    out.description.assign(text + tickerLength, descriptionLength);
+    out.industry.assign(text + tickerLength + descriptionLength, industryLength);
+}
+
+// <prefix><index as 12+ digits><suffix>, and back (0 for any other name)
+inline std::string numberedFileName(const std::string& prefix, std::uint64_t index, const std::string& suffix) {
+    std::string digits = std::to_string(index);
+    if (digits.size() < 12) digits.insert(0, 12 - digits.size(), '0');
+    return prefix + digits + suffix;
+}
+
+inline std::uint64_t parseFileIndex(const std::string& name, const std::string& prefix, const std::string& suffix) {
+    if (name.size() <= prefix.size() + suffix.size()) return 0;
+    if (name.compare(0, prefix.size(), prefix) != 0) return 0;
+    if (name.compare(name.size() - suffix.size(), suffix.size(), suffix) != 0) return 0;
+    std::uint64_t index = 0;
+    for (std::size_t i = prefix.size(); i < name.size() - suffix.size(); ++i) {
+        if (name[i] < '0' || name[i] > '9') return 0;
+        index = index * 10 + static_cast<std::uint64_t>(name[i] - '0');
+    }
+    return index;
+}
+
+// Segment file name for index, e.g. journal-000000000001.log
+inline std::string segmentFileName(std::uint64_t index) { return numberedFileName("journal-", index, ".log"); }
+inline std::uint64_t parseSegmentIndex(const std::string& name) { return parseFileIndex(name, "journal-", ".log"); }
+
+} // namespace ob::journal
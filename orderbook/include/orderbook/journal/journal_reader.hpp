@@ -0,0 +1,84 @@
+#pragma once
+
+#include "orderbook/core/command.hpp"
+#include "orderbook/core/types.hpp"
+#include "orderbook/journal/journal_format.hpp"
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ob::journal {
+
+struct JournalRecord {
+    RecordType type{RecordType::Command};
+    std::uint64_t sequence{0};
+    core::Command command{};      // RecordType::Command
+    InstrumentEntry instrument{}; // instrument records
+};
+
+// What a journal replay rebuilt (see InstrumentManager::openJournal)
+struct RecoveryStats {
+    std::size_t instruments{0};   // live instruments recreated
+    std::uint64_t records{0};     // valid records read
+    std::uint64_t commands{0};    // commands applied to those instruments' books
+    std::uint64_t lastSequence{0};
+    core::OrderId maxOrderId{0};  // highest order id of any journaled new order
+    std::size_t tornSegments{0};  // segments that ended in a torn write
+    std::uint64_t snapshotId{0};  // snapshot the books were loaded from, 0 = none
+    std::uint64_t snapshotOrders{0}; // resting orders bulk-loaded from it
+    std::chrono::nanoseconds elapsed{0};
+};
+
+/**
+ * Sequential reader over every segment of a journal directory.
+ *
+ * Segments are memory-mapped read-only and read in index order. A torn or
+ * corrupt record ends its segment (a crash leaves at most one per segment,
+ * and the writer restarts on a fresh segment); a sequence gap between
+ * segments ends the journal, since records in between are missing.
+ */
+class JournalReader {
+public:
+    // A missing directory reads as an empty journal. Segments below
+    // firstSegment are ignored (a snapshot covers them). Throws
+    // std::runtime_error if a segment cannot be opened or mapped.
+    explicit JournalReader(const std::string& directory, std::uint64_t firstSegment = 1);
+    ~JournalReader();
+
+    JournalReader(const JournalReader&) = delete;
+    JournalReader& operator=(const JournalReader&) = delete;
+
+    // Next valid record; false at the end of the journal
+    bool next(JournalRecord& out);
+    // Back to the first record, for another pass
+    void rewind() noexcept;
+
+    // Of the last record read; a segment without records counts as ending
+    // just before its first sequence
+    std::uint64_t lastSequence() const noexcept { return lastSequence_; }
+    std::uint64_t lastSegment() const noexcept;                         // highest segment index, 0 if none
+    std::size_t segmentCount() const noexcept { return segments_.size(); }
+    std::size_t tornSegments() const noexcept { return tornSegments_; }
+    bool sequenceGap() const noexcept { return gap_; }
+
+private:
+    struct Segment {
+        std::uint64_t index;
+        const char* base;
+        std::size_t size;
+    };
+
+    bool enterSegment();
+    void leaveSegment(bool torn) noexcept;
+
+    std::vector<Segment> segments_;
+    std::size_t current_{0};
+    std::size_t offset_{0}; // 0 = segment header not read yet
+    std::uint64_t expected_{0};
+    std::uint64_t lastSequence_{0};
+    std::size_t tornSegments_{0};
+    bool gap_{false};
+};
+
+} // namespace ob::journal
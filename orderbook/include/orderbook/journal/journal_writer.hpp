@@ -0,0 +1,147 @@
+#pragma once
+
+#include "orderbook/core/command.hpp"
+#include "orderbook/core/constants.hpp"
+#include "orderbook/journal/journal_format.hpp"
+#include "orderbook/queue/mpsc_queue.hpp"
+#include "orderbook/queue/wait_strategy.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ob::journal {
+
+// When the writer forces journal pages to disk. Records are in the page
+// cache as soon as they are committed, so every policy survives a crash of
+// the process; the policy decides what survives a crash of the machine.
+enum class FsyncPolicy : std::uint8_t {
+    None = 0,        // leave write-back to the kernel
+    EveryCommit = 1, // msync after every group commit
+    Interval = 2     // msync at most once per fsyncInterval
+};
+
+struct JournalConfig {
+    std::string directory;                 // created if missing; empty = no journal
+    std::size_t segmentBytes{core::DEFAULT_JOURNAL_SEGMENT_BYTES};
+    std::size_t ringSize{core::DEFAULT_JOURNAL_RING};
+    std::size_t commitBatch{core::DEFAULT_JOURNAL_COMMIT_BATCH}; // records per group commit
+    FsyncPolicy fsync{FsyncPolicy::None};
+    std::chrono::milliseconds fsyncInterval{10};
+    queue::WaitStrategyType waitStrategy{queue::WaitStrategyType::TimedBackoff};
+    int cpu{-1};                           // writer thread pinned here when >= 0
+};
+
+struct JournalStats {
+    std::uint64_t records{0};  // everything written, commands and instrument records
+    std::uint64_t commands{0};
+    std::uint64_t bytes{0};
+    std::uint64_t commits{0};  // group commits
+    std::uint64_t syncs{0};    // msync calls
+    std::uint64_t stalls{0};   // appends that found the ring full and had to wait
+    std::uint64_t segments{0}; // segment files opened
+    core::OrderId maxOrderId{0}; // highest new-order id written
+};
+
+/**
+ * Append-only journal of the commands the matching threads apply.
+ *
+ * Matching threads hand each batch of commands to append() before applying
+ * it; that is a copy into an MPSC ring and nothing more. The writer thread
+ * drains the ring into a memory-mapped segment file, assigning sequence
+ * numbers as it goes, and makes one commit (and, by policy, one msync) per
+ * drained batch, so the cost of reaching the disk is shared by every
+ * command in the batch. Segments are preallocated with ftruncate and
+ * rolled when full. Instrument add/remove records take a mutex-protected
+ * side queue, since they are rare and carry strings.
+ *
+ * Durability is asynchronous: a command may be matched shortly before it
+ * is on disk. A full ring never drops a command; append() waits for room.
+ */
+class JournalWriter {
+public:
+    // Opens segment firstSegment in config.directory and numbers records
+    // from firstSequence. Throws std::runtime_error if the directory or
+    // segment cannot be created.
+    explicit JournalWriter(const JournalConfig& config, std::uint64_t firstSegment = 1,
+                           std::uint64_t firstSequence = 1);
+    ~JournalWriter();
+
+    JournalWriter(const JournalWriter&) = delete;
+    JournalWriter& operator=(const JournalWriter&) = delete;
+
+    // Matching threads; each thread's commands stay in order
+    void append(const core::Command* commands, std::size_t count) noexcept;
+    void appendInstrumentAdded(const InstrumentEntry& instrument);
+    void appendInstrumentRemoved(std::uint32_t symbolId);
+
+    void start();
+    // Writes what is queued, syncs and trims the open segment, then joins
+    void stop();
+    bool isRunning() const noexcept { return running_.load(); }
+
+    // Blocks until everything appended before the call is committed (and
+    // synced unless the policy is None). The writer must be running.
+    void flush();
+
+    JournalStats stats() const noexcept;
+    // Segment being written; anything appended from now on lands in it or a later one
+    std::uint64_t currentSegment() const noexcept { return currentSegment_.load(std::memory_order_acquire); }
+    const std::string& directory() const noexcept { return config_.directory; }
+
+private:
+    struct Control {
+        RecordType type;
+        std::string payload;
+    };
+
+    void processLoop();
+    std::size_t writeOnce();
+    void writeRecord(RecordType type, const void* payload, std::size_t length);
+    void commit();
+    void sync();
+    void openSegment(std::uint64_t index);
+    void closeSegment();
+    void enqueue(RecordType type, std::string payload);
+
+    JournalConfig config_;
+    queue::MpscRingBuffer<core::Command> ring_;
+    queue::WaitStrategy waitStrategy_;
+    std::vector<core::Command> batch_;
+
+    // Side queue and flush handshake
+    std::mutex controlMutex_;
+    std::condition_variable flushed_;
+    std::vector<Control> control_;
+    std::uint64_t flushRequested_{0};
+    std::uint64_t flushDone_{0};
+
+    // Open segment; writer thread only
+    int fd_{-1};
+    char* base_{nullptr};
+    std::size_t offset_{0};
+    std::size_t syncedOffset_{0};
+    std::uint64_t segmentIndex_{0};
+    std::uint64_t nextSequence_{1};
+    std::chrono::steady_clock::time_point lastSync_{};
+    JournalStats written_{}; // records, commands, bytes and maxOrderId, published by commit()
+
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+
+    std::atomic<std::uint64_t> records_{0};
+    std::atomic<std::uint64_t> commands_{0};
+    std::atomic<std::uint64_t> bytes_{0};
+    std::atomic<std::uint64_t> commits_{0};
+    std::atomic<std::uint64_t> syncs_{0};
+    std::atomic<std::uint64_t> segments_{0};
+    std::atomic<std::uint64_t> currentSegment_{0};
+    std::atomic<core::OrderId> maxOrderId_{0};
+    alignas(64) std::atomic<std::uint64_t> stalls_{0}; // the only counter producers touch
+};
+
+} // namespace ob::journal
@@ -0,0 +1,133 @@
+#pragma once
+
+#include "orderbook/book/book_snapshot.hpp"
+#include "orderbook/core/types.hpp"
+#include "orderbook/journal/journal_format.hpp"
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ob::journal {
+
+// On-disk layout of a book snapshot.
+//
+// Snapshots live next to the journal segments as snapshot-<id>.snap. A file
+// is a SnapshotHeader followed by one section per instrument: a
+// SectionHeader, the instrument as InstrumentRecord plus strings (padded to
+// RECORD_ALIGN), then its resting orders as book::SnapshotOrder and, from
+// version 2, its waiting stop orders as book::SnapshotStop and, from
+// version 3, its risk stage's accounts as book::SnapshotAccount. Each
+// instrument's journal carries a CommandType::Snapshot command with the
+// snapshot id at the point its book was cut; recovery loads the books and
+// replays only what follows those commands, reading the journal from
+// journalSegment on. Files are written under a temporary name and renamed
+// when complete.
+
+inline constexpr std::uint32_t SNAPSHOT_MAGIC = 0x50414E53; // "SNAP" little-endian
+inline constexpr std::uint16_t SNAPSHOT_VERSION = 3; // 2: stop orders and last trade price; 3: risk accounts; reads 1 and 2 too
+
+struct SnapshotHeader {
+    std::uint32_t magic{SNAPSHOT_MAGIC};
+    std::uint16_t version{SNAPSHOT_VERSION};
+    std::uint16_t headerSize{sizeof(SnapshotHeader)};
+    std::uint64_t id{0};             // also carried by the journal's cut commands
+    std::uint64_t journalSegment{0}; // every cut command is in this segment or a later one
+    core::OrderId nextOrderId{0};    // above every order id journaled before the snapshot
+    std::uint32_t nextSymbolId{0};   // above every symbol id used before the snapshot
+    std::uint32_t instrumentCount{0};
+    std::uint32_t checksum{0};       // over the header with this field zero
+    std::uint8_t reserved[20]{};
+};
+
+// Version 1 sections end after checksum (SECTION_HEADER_V1_SIZE bytes),
+// version 2 after lastTradePrice
+struct SectionHeader {
+    std::uint64_t orderCount{0};
+    std::uint32_t instrumentBytes{0}; // InstrumentRecord plus strings, before padding
+    std::uint32_t checksum{0};        // over the instrument bytes, the orders, the stops and lastTradePrice,
+                                      // then the accounts and riskReference
+    std::uint64_t stopCount{0};
+    core::Price lastTradePrice{0};    // what the stops' triggers compare against
+    std::uint64_t accountCount{0};
+    core::Price riskReference{0};     // the risk stage's collar reference; 0 without one
+};
+inline constexpr std::size_t SECTION_HEADER_V1_SIZE = 16;
+inline constexpr std::size_t SECTION_HEADER_V2_SIZE = 32;
+
+static_assert(sizeof(SnapshotHeader) == 64, "snapshot header layout is part of the format");
+static_assert(sizeof(SectionHeader) == 48, "section header layout is part of the format");
+
+// One instrument's book. When read back, orders points into the mapped file.
+struct SnapshotSection {
+    InstrumentEntry instrument;
+    const book::SnapshotOrder* orders{nullptr};
+    std::size_t orderCount{0};
+    const book::SnapshotStop* stops{nullptr};
+    std::size_t stopCount{0};
+    core::Price lastTradePrice{0};
+    const book::SnapshotAccount* accounts{nullptr};
+    std::size_t accountCount{0};
+    core::Price riskReference{0}; // lastTradePrice in snapshots before version 3
+};
+
+// What InstrumentManager::saveSnapshot wrote
+struct SnapshotStats {
+    std::uint64_t id{0};
+    std::size_t instruments{0};
+    std::uint64_t orders{0};
+    std::uint64_t bytes{0};
+    std::uint64_t journalSegment{0};
+    std::chrono::nanoseconds capture{0}; // cut to last book copied
+    std::chrono::nanoseconds elapsed{0}; // including the write
+};
+
+inline std::string snapshotFileName(std::uint64_t id) { return numberedFileName("snapshot-", id, ".snap"); }
+inline std::uint64_t parseSnapshotId(const std::string& name) { return parseFileIndex(name, "snapshot-", ".snap"); }
+
+// Snapshot files in directory as (id, path), oldest first
+std::vector<std::pair<std::uint64_t, std::string>> listSnapshots(const std::string& directory);
+
+// Writes, syncs and renames the snapshot into place; returns the file size.
+// header.instrumentCount and the checksums are filled in. Throws
+// std::runtime_error on I/O failure.
+std::uint64_t writeSnapshot(const std::string& directory, SnapshotHeader header,
+                            const std::vector<SnapshotSection>& sections);
+
+// Deletes snapshots older than keepSnapshot and journal segments below
+// keepSegment; returns the number of files removed
+std::size_t pruneJournal(const std::string& directory, std::uint64_t keepSnapshot, std::uint64_t keepSegment);
+
+/**
+ * Read-only view of one snapshot file.
+ *
+ * The file is memory-mapped and checked up front: a bad header, a
+ * truncated section or a checksum mismatch makes the whole snapshot
+ * invalid, and recovery falls back to an older one. Sections point into
+ * the mapping, so book loads copy straight from the page cache.
+ */
+class SnapshotReader {
+public:
+    // Throws std::runtime_error if the file cannot be opened or mapped
+    explicit SnapshotReader(const std::string& path);
+    ~SnapshotReader();
+
+    SnapshotReader(const SnapshotReader&) = delete;
+    SnapshotReader& operator=(const SnapshotReader&) = delete;
+
+    bool valid() const noexcept { return valid_; }
+    const SnapshotHeader& header() const noexcept { return header_; }
+    const std::vector<SnapshotSection>& sections() const noexcept { return sections_; }
+
+private:
+    bool parse();
+
+    const char* base_{nullptr};
+    std::size_t size_{0};
+    SnapshotHeader header_{};
+    std::vector<SnapshotSection> sections_;
+    bool valid_{false};
+};
+
+} // namespace ob::journal
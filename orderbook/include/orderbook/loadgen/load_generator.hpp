@@ -0,0 +1,71 @@
+#pragma once
+
+#include "orderbook/core/latency_histogram.hpp"
+#include "orderbook/core/types.hpp"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ob::loadgen {
+
+// Open-loop load against a running ob_server over the binary protocol.
+//
+// Each generator thread owns a share of the connections and sends on a
+// fixed schedule: message i of a thread is due at start + i / rate, sent
+// round-robin over its connections and instruments whether or not earlier
+// ones were answered. Latency is measured from that due time, not from the
+// moment the message actually left, so when the server (or the generator)
+// falls behind the time spent waiting counts against it instead of quietly
+// slowing the schedule down (no coordinated omission).
+//
+// The flow is resting limit orders a few ticks either side of the
+// reference price, some of them crossing, and cancels of the connection's
+// own earlier orders, so every book stays small however long the run.
+struct LoadConfig {
+    std::string host{"127.0.0.1"};
+    std::uint16_t port{9999};
+    std::size_t connections{4};
+    std::size_t threads{1};           // generator threads; connections are dealt out among them
+    std::size_t instruments{1};
+    bool createInstruments{true};     // add LOAD<n> instruments first; otherwise use symbol ids 1..instruments
+    bool ladderBooks{false};          // books of the instruments created
+    double rate{50'000};              // messages per second over all connections
+    std::chrono::milliseconds duration{10'000};
+    std::chrono::milliseconds warmup{1'000}; // sent on schedule but not recorded
+    std::chrono::milliseconds drainTimeout{2'000}; // wait for answers after the last send
+    std::uint64_t seed{42};
+    core::Price referencePrice{10'000};
+    core::Price spread{5};            // orders are priced up to this many ticks from the reference
+    double cancelRatio{0.45};         // share of messages that cancel an earlier order
+    std::size_t maxOpen{64};          // per connection; past this every message is a cancel
+    // Also subscribe to each connection's execution reports and measure
+    // due time to the order's Ack: the full path through the matching
+    // thread and event delivery, not just the reactor's queued reply
+    bool acks{false};
+};
+
+struct LoadResult {
+    std::uint64_t sent{0};
+    std::uint64_t answered{0};        // Accepted or Rejected responses
+    std::uint64_t rejected{0};        // of those, Rejected (queue full, unknown instrument, ...)
+    std::uint64_t unanswered{0};      // no response within drainTimeout
+    std::uint64_t acked{0};           // acks: orders whose Ack arrived
+    std::chrono::nanoseconds elapsed{0};  // first due time to the last response
+    std::chrono::nanoseconds maxLag{0};   // furthest the generator itself fell behind its schedule
+    // Recorded messages only (after warmup), in ns from their due time
+    core::LatencyHistogram response; // to the Accepted/Rejected response
+    core::LatencyHistogram ack;      // acks: to the order's Ack execution report
+
+    double throughput() const noexcept {
+        return elapsed.count() > 0 ? static_cast<double>(answered) * 1e9 / static_cast<double>(elapsed.count()) : 0.0;
+    }
+};
+
+// Connects, logs on, creates the instruments if asked to and runs the
+// schedule. Throws std::runtime_error if the server cannot be reached or
+// refuses the setup.
+LoadResult runLoad(const LoadConfig& config);
+
+} // namespace ob::loadgen
@@ -0,0 +1,255 @@
+#pragma once
+
+#include "orderbook/core/types.hpp"
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+
+namespace ob::net::binary {
+
+// Fixed-layout binary message set for ob_server.
+//
+// Every message starts with a 4-byte MessageHeader whose length covers the
+// whole message, header included. All fields are little-endian and naturally
+// aligned with explicit padding, so a frame can be decoded straight out of
+// the receive buffer with one memcpy per message and no parsing.
+//
+// A connection is binary if its first message is a Logon; the server answers
+// with a LogonAck and from then on only binary frames are accepted.
+
+static_assert(std::endian::native == std::endian::little,
+              "binary protocol structs are copied to and from the wire as-is");
+
+inline constexpr std::uint32_t LOGON_MAGIC = 0x3142424F; // "OBB1" on the wire
+inline constexpr std::uint16_t PROTOCOL_VERSION = 1;
+inline constexpr std::uint32_t DEFAULT_SNAPSHOT_DEPTH = 10;
+inline constexpr std::uint32_t MAX_SNAPSHOT_DEPTH = 64;
+
+enum class MsgType : std::uint8_t {
+    // Client -> server
+    Logon = 0x01,
+    NewOrder = 0x02,
+    Cancel = 0x03,
+    Amend = 0x04,
+    SnapshotRequest = 0x05,
+    Subscribe = 0x06,
+    Unsubscribe = 0x07,
+    NewStopOrder = 0x08,    // stop or stop-limit; answered like NewOrder
+    // Server -> client
+    LogonAck = 0x81,
+    Accepted = 0x82,        // request queued; orderId is the server-assigned id
+    Rejected = 0x83,        // request refused; see reason
+    Snapshot = 0x84,        // SnapshotHeader followed by bid then ask levels
+    // Pushed to subscribers
+    ExecutionReport = 0x85, // status change or fill of one of the connection's orders
+    Trade = 0x86,           // public trade on a subscribed symbol
+    TopOfBook = 0x87        // best bid/ask change on a subscribed symbol
+};
+
+enum class Stream : std::uint8_t {
+    Orders = 1,      // execution reports for orders entered on this connection
+    MarketData = 2   // trades and top of book for one symbol
+};
+
+enum class RejectReason : std::uint8_t {
+    None = 0,
+    Malformed = 1,          // length does not match the message type
+    UnknownMessage = 2,
+    UnknownInstrument = 3,
+    InvalidPrice = 4,
+    InvalidQuantity = 5,
+    QueueFull = 6,
+    Unavailable = 7         // server has no subscription support
+};
+
+struct MessageHeader {
+    std::uint16_t length;
+    MsgType type;
+    std::uint8_t reserved;
+};
+
+struct LogonMsg {
+    MessageHeader header;
+    std::uint32_t magic;
+    std::uint16_t version;
+    std::uint16_t account;     // risk account of the session's orders; 0 = the shared account
+};
+
+struct NewOrderMsg {
+    MessageHeader header;
+    std::uint32_t symbolId;
+    core::Side side;
+    core::OrderType orderType; // Limit or Market
+    core::TimeInForce timeInForce; // 0 = good till cancel
+    std::uint8_t reserved0;
+    std::uint32_t reserved1;
+    core::Price price;         // ignored for market orders
+    core::Quantity quantity;
+    std::uint64_t clientTag;   // echoed in the response
+};
+
+struct NewStopOrderMsg {
+    MessageHeader header;
+    std::uint32_t symbolId;
+    core::Side side;
+    core::OrderType orderType; // Stop or StopLimit
+    core::TimeInForce timeInForce; // of the order the stop becomes
+    std::uint8_t reserved0;
+    std::uint32_t reserved1;
+    core::Price price;         // limit once triggered; ignored for Stop
+    core::Price stopPrice;     // trigger: last trade at or through it
+    core::Quantity quantity;
+    std::uint64_t clientTag;
+};
+
+struct CancelMsg {
+    MessageHeader header;
+    std::uint32_t symbolId;
+    core::OrderId orderId;
+    std::uint64_t clientTag;
+};
+
+struct AmendMsg {
+    MessageHeader header;
+    std::uint32_t symbolId;
+    core::OrderId orderId;
+    core::Price price;
+    core::Quantity quantity;   // new open quantity
+    std::uint64_t clientTag;
+};
+
+struct SnapshotRequestMsg {
+    MessageHeader header;
+    std::uint32_t symbolId;
+    std::uint32_t depth;       // levels per side; 0 = DEFAULT_SNAPSHOT_DEPTH
+    std::uint32_t reserved;
+    std::uint64_t clientTag;
+};
+
+struct SubscribeMsg {          // also used for Unsubscribe
+    MessageHeader header;
+    std::uint32_t symbolId;    // MarketData only
+    std::uint64_t clientTag;
+    Stream stream;
+    std::uint8_t reserved0;
+    std::uint16_t reserved1;
+    std::uint32_t reserved2;
+};
+
+// Accepted / Rejected reply to NewOrder, Cancel, Amend and (Un)Subscribe (and
+// Rejected for anything else the server cannot act on)
+struct ResponseMsg {
+    MessageHeader header;
+    std::uint32_t symbolId;
+    core::OrderId orderId;
+    std::uint64_t clientTag;
+    MsgType requestType;
+    RejectReason reason;
+    std::uint16_t reserved0;
+    std::uint32_t reserved1;
+};
+
+struct SnapshotHeader {
+    MessageHeader header;
+    std::uint32_t symbolId;
+    std::uint64_t clientTag;
+    std::uint16_t bidCount;
+    std::uint16_t askCount;
+    std::uint32_t reserved;
+};
+
+struct SnapshotLevel {
+    core::Price price;
+    core::Quantity total;
+    std::uint64_t orderCount;
+};
+
+struct ExecutionReportMsg {
+    MessageHeader header;
+    std::uint32_t symbolId;
+    core::OrderId orderId;
+    core::OrderId contraOrderId;   // fills only
+    core::Price price;             // fills only
+    core::Quantity quantity;       // fills only
+    std::int64_t tsNs;
+    std::uint8_t execType;         // events::EventType
+    std::uint8_t maker;            // fills: 1 if this order was resting
+    std::uint16_t reserved0;
+    std::uint32_t reserved1;
+};
+
+struct TradeMsg {
+    MessageHeader header;
+    std::uint32_t symbolId;
+    core::Price price;
+    core::Quantity quantity;
+    std::int64_t tsNs;
+};
+
+struct TopOfBookMsg {          // quantity 0 = side empty
+    MessageHeader header;
+    std::uint32_t symbolId;
+    core::Price bidPrice;
+    core::Quantity bidQuantity;
+    core::Price askPrice;
+    core::Quantity askQuantity;
+};
+
+static_assert(sizeof(MessageHeader) == 4);
+static_assert(sizeof(LogonMsg) == 12);
+static_assert(sizeof(NewOrderMsg) == 40);
+static_assert(sizeof(NewStopOrderMsg) == 48);
+static_assert(sizeof(CancelMsg) == 24);
+static_assert(sizeof(AmendMsg) == 40);
+static_assert(sizeof(SnapshotRequestMsg) == 24);
+static_assert(sizeof(ResponseMsg) == 32);
+static_assert(sizeof(SnapshotHeader) == 24);
+static_assert(sizeof(SnapshotLevel) == 24);
+static_assert(sizeof(SubscribeMsg) == 24);
+static_assert(sizeof(ExecutionReportMsg) == 56);
+static_assert(sizeof(TradeMsg) == 32);
+static_assert(sizeof(TopOfBookMsg) == 40);
+
+// Largest frame the length field can describe
+inline constexpr std::size_t MAX_FRAME_SIZE = 0xFFFF;
+static_assert(sizeof(SnapshotHeader) + 2 * MAX_SNAPSHOT_DEPTH * sizeof(SnapshotLevel) <= MAX_FRAME_SIZE);
+
+// Copy a message out of (possibly unaligned) wire bytes. The caller has
+// already checked that at least sizeof(Msg) bytes are available.
+template <typename Msg>
+inline Msg load(const char* data) noexcept {
+    static_assert(std::is_trivially_copyable_v<Msg>);
+    Msg msg;
+    std::memcpy(&msg, data, sizeof(Msg));
+    return msg;
+}
+
+// Append a message to an output buffer. The buffer is reused across calls,
+// so steady-state encoding does not allocate.
+template <typename Msg>
+inline void append(std::string& out, const Msg& msg) {
+    static_assert(std::is_trivially_copyable_v<Msg>);
+    out.append(reinterpret_cast<const char*>(&msg), sizeof(Msg));
+}
+
+// Zero-initialised message with its header filled in
+template <typename Msg>
+inline Msg make(MsgType type) noexcept {
+    Msg msg{};
+    msg.header.length = static_cast<std::uint16_t>(sizeof(Msg));
+    msg.header.type = type;
+    return msg;
+}
+
+inline LogonMsg makeLogon(std::uint16_t account = 0) noexcept {
+    auto msg = make<LogonMsg>(MsgType::Logon);
+    msg.magic = LOGON_MAGIC;
+    msg.version = PROTOCOL_VERSION;
+    msg.account = account;
+    return msg;
+}
+
+} // namespace ob::net::binary
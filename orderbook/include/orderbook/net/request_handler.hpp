@@ -0,0 +1,106 @@
+#pragma once
+
+#include "orderbook/net/binary_protocol.hpp"
+#include "orderbook/net/subscription_hub.hpp"
+#include "orderbook/oms/i_order_book_service.hpp"
+#include "orderbook/core/types.hpp"
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ob::net {
+
+enum class WireProtocol : std::uint8_t {
+    Unknown,  // not enough bytes yet to tell
+    Text,
+    Binary,
+    Invalid   // neither a text command nor a binary Logon
+};
+
+/**
+ * Protocol layer of ob_server: turns requests into IOrderBookService calls.
+ *
+ * The text protocol takes one newline-terminated command per call; the
+ * binary protocol (see binary_protocol.hpp) decodes every complete frame in
+ * a receive buffer in place. Socket handling stays with the caller, and one
+ * handler is shared by all connections.
+ *
+ * A connection that opened a Session gets order ids carrying its session id
+ * (SubscriptionHub::orderIdFor) and may subscribe to execution reports and
+ * market data; without one, order ids come from a shared atomic counter.
+ * A session may name its risk account once, at logon (text LOGON or the
+ * binary Logon), and its orders then carry it (core::Order::account), so
+ * the same trader keeps the same limits across reconnects and restarts.
+ */
+class RequestHandler {
+public:
+    static constexpr std::size_t PROTOCOL_ERROR = static_cast<std::size_t>(-1);
+
+    // Per-connection state, owned by the connection
+    struct Session {
+        std::uint32_t id{0};
+        std::uint64_t lastSequence{0};
+        std::uint32_t account{0}; // risk account named at logon; 0 = the shared account
+        Notifier* notifier{nullptr};
+        std::shared_ptr<Subscriber> subscriber; // created on first SUBSCRIBE
+    };
+
+    // hub is optional; without it subscribe requests are refused
+    explicit RequestHandler(oms::IOrderBookService& service, SubscriptionHub* hub = nullptr)
+        : service_(service), hub_(hub) {}
+
+    // notifier is told when the session's subscriber has messages to drain
+    Session openSession(Notifier* notifier = nullptr);
+    void closeSession(Session& session);
+
+    // After a journal replay: hand out no order id at or below maxUsed
+    // again. New sessions are numbered above its owner, and the sessionless
+    // counter moves past it when it came from that counter.
+    void reserveOrderIds(core::OrderId maxUsed) noexcept;
+
+    // Decide from the first bytes of a connection which protocol it speaks
+    static WireProtocol detect(const char* data, std::size_t size) noexcept;
+
+    // Text protocol: one command, one response
+    std::string handleText(const std::string& request, Session* session = nullptr);
+
+    // Binary protocol: handles every complete frame in [data, data + size),
+    // appending the responses to out. Returns the number of bytes consumed
+    // (the tail of a partial frame is left for the next call), or
+    // PROTOCOL_ERROR if the stream cannot be framed and must be dropped.
+    std::size_t handleBinary(const char* data, std::size_t size, std::string& out,
+                             Session* session = nullptr);
+
+    // Encode one pushed message for a connection speaking protocol
+    static void appendPush(const PushMessage& msg, WireProtocol protocol, std::string& out);
+
+private:
+    void onLogon(const char* data, std::size_t length, std::string& out, Session* session);
+    void onNewOrder(const char* data, std::size_t length, std::string& out, Session* session);
+    void onNewStopOrder(const char* data, std::size_t length, std::string& out, Session* session);
+    // Shared tail of both: validates, submits and answers one new order
+    void enterOrder(binary::MsgType requestType, core::Order order, std::uint64_t clientTag, std::string& out,
+                    Session* session, std::uint64_t received);
+    void onCancel(const char* data, std::size_t length, std::string& out);
+    void onAmend(const char* data, std::size_t length, std::string& out);
+    void onSnapshot(const char* data, std::size_t length, std::string& out);
+    void onSubscribe(const char* data, std::size_t length, std::string& out, Session* session, bool subscribe);
+
+    core::OrderId nextOrderId(Session* session) noexcept;
+    static std::uint32_t accountOf(const Session* session) noexcept { return session ? session->account : 0; }
+    // Returns false if this handler has no hub or there is no session
+    bool subscribe(Session& session, binary::Stream stream, std::uint32_t symbolId);
+    bool unsubscribe(Session& session, binary::Stream stream, std::uint32_t symbolId);
+
+    void respond(std::string& out, binary::MsgType requestType, binary::RejectReason reason,
+                 std::uint32_t symbolId, core::OrderId orderId, std::uint64_t clientTag);
+
+    oms::IOrderBookService& service_;
+    SubscriptionHub* hub_;
+    std::atomic<core::OrderId> nextOrderId_{1};
+    std::atomic<std::uint32_t> nextSession_{0};
+};
+
+} // namespace ob::net
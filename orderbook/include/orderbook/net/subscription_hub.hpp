@@ -0,0 +1,140 @@
+#pragma once
+
+#include "orderbook/net/binary_protocol.hpp"
+#include "orderbook/core/constants.hpp"
+#include "orderbook/core/types.hpp"
+#include "orderbook/events/event_types.hpp"
+#include "orderbook/oms/i_order_book_service.hpp"
+#include "orderbook/queue/mpsc_queue.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace ob::net {
+
+// One pushed message in its binary wire form (ExecutionReportMsg is the
+// largest); text connections format it when it is written out
+struct PushMessage {
+    alignas(8) char bytes[sizeof(binary::ExecutionReportMsg)];
+
+    template <typename Msg>
+    static PushMessage of(const Msg& msg) noexcept {
+        static_assert(sizeof(Msg) <= sizeof(bytes));
+        PushMessage push;
+        std::memcpy(push.bytes, &msg, sizeof(Msg));
+        return push;
+    }
+    binary::MessageHeader header() const noexcept { return binary::load<binary::MessageHeader>(bytes); }
+};
+
+// Wakes whoever drains a subscriber (the reactor owning its connection)
+class Notifier {
+public:
+    virtual ~Notifier() = default;
+    virtual void notify() noexcept = 0;
+};
+
+/**
+ * Bounded push buffer of one subscribed connection.
+ *
+ * Filled by the event-drain thread and emptied by the connection's reactor.
+ * Slow-consumer policy: the producer never waits. When the buffer is full
+ * market data (trades, top of book) is dropped and counted; an execution
+ * report cannot be dropped silently, so the subscriber is marked overflowed
+ * and its connection is closed, after which the client must reconnect and
+ * resynchronise.
+ */
+class Subscriber {
+public:
+    explicit Subscriber(std::uint32_t session, Notifier* notifier = nullptr,
+                        std::size_t capacity = core::DEFAULT_SUBSCRIBER_QUEUE)
+        : session_(session), notifier_(notifier), queue_(capacity) {}
+
+    std::uint32_t session() const noexcept { return session_; }
+
+    // Event-drain side
+    void pushReport(const PushMessage& msg) noexcept {
+        if (!queue_.tryPush(msg)) overflowed_.store(true, std::memory_order_release);
+        wake();
+    }
+    void pushMarketData(const PushMessage& msg) noexcept {
+        if (!queue_.tryPush(msg)) droppedMarketData_.fetch_add(1, std::memory_order_relaxed);
+        wake();
+    }
+
+    // Reactor side
+    bool pop(PushMessage& msg) noexcept { return queue_.tryPop(msg); }
+    bool overflowed() const noexcept { return overflowed_.load(std::memory_order_acquire); }
+    std::uint64_t droppedMarketData() const noexcept { return droppedMarketData_.load(std::memory_order_relaxed); }
+
+private:
+    void wake() noexcept {
+        if (notifier_) notifier_->notify();
+    }
+
+    const std::uint32_t session_;
+    Notifier* const notifier_;
+    queue::MpscRingBuffer<PushMessage> queue_;
+    std::atomic<bool> overflowed_{false};
+    std::atomic<std::uint64_t> droppedMarketData_{0};
+};
+
+/**
+ * Routes engine events to subscribed connections.
+ *
+ * Order ids handed out to a session carry the session id in their top bits
+ * (see orderIdFor), so an execution report finds its owner without a
+ * per-order table. Market-data subscribers get every trade on their symbol
+ * and a top-of-book update whenever the best bid or ask changes.
+ *
+ * onEvent and publishTopOfBook run on the event-drain thread; subscribe
+ * calls come from reactors. A mutex covers the subscription tables.
+ */
+class SubscriptionHub {
+public:
+    static constexpr unsigned SESSION_SHIFT = core::ORDER_ID_SESSION_SHIFT;
+    static constexpr std::uint32_t MAX_SESSION = (1u << (64 - SESSION_SHIFT)) - 1;
+
+    static core::OrderId orderIdFor(std::uint32_t session, std::uint64_t sequence) noexcept {
+        return (static_cast<core::OrderId>(session) << SESSION_SHIFT) | sequence;
+    }
+    static std::uint32_t ownerOf(core::OrderId orderId) noexcept {
+        return static_cast<std::uint32_t>(orderId >> SESSION_SHIFT);
+    }
+
+    void subscribeOrders(const std::shared_ptr<Subscriber>& subscriber);
+    void unsubscribeOrders(std::uint32_t session);
+    void subscribeMarketData(const std::shared_ptr<Subscriber>& subscriber, std::uint32_t symbolId);
+    void unsubscribeMarketData(std::uint32_t session, std::uint32_t symbolId);
+    void remove(std::uint32_t session); // connection closed
+
+    // Event-drain thread
+    void onEvent(const events::Event& event);
+    // Push top of book for symbols touched since the last call, if it changed
+    void publishTopOfBook(const oms::IOrderBookService& service);
+
+private:
+    struct Top {
+        core::Price bidPrice{0};
+        core::Quantity bidQuantity{0};
+        core::Price askPrice{0};
+        core::Quantity askQuantity{0};
+        bool operator==(const Top&) const = default;
+    };
+
+    void report(core::OrderId orderId, const binary::ExecutionReportMsg& msg);
+
+    std::mutex mutex_;
+    std::unordered_map<std::uint32_t, std::shared_ptr<Subscriber>> orders_;
+    std::unordered_map<std::uint32_t, std::vector<std::shared_ptr<Subscriber>>> marketData_;
+    std::unordered_map<std::uint32_t, Top> lastTop_;
+    std::unordered_set<std::uint32_t> touched_;
+};
+
+} // namespace ob::net
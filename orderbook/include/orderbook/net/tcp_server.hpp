@@ -0,0 +1,66 @@
+#pragma once
+
+#include "orderbook/net/request_handler.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace ob::net {
+
+struct ServerConfig {
+    std::uint16_t port{9999};               // 0 picks a free port (see TcpServer::port)
+    std::size_t reactors{1};                // event-loop threads, one SO_REUSEPORT listener each
+    std::size_t readBufferSize{64 * 1024};  // per connection; must hold the largest binary frame
+    std::size_t maxPendingOutput{4 * 1024 * 1024}; // stop reading a client whose replies back up past this
+    int maxEventsPerWait{256};
+    int tickMs{1};                          // onTick cadence on reactor 0 when idle
+    std::vector<int> cpus{};                // reactor i pinned to cpus[i % size] (reactor 0 is run()'s caller); empty = unpinned
+};
+
+/**
+ * Edge-triggered epoll server for the ob_server protocols.
+ *
+ * Each reactor thread owns a non-blocking SO_REUSEPORT listener (the kernel
+ * spreads incoming connections across them), an epoll set and the
+ * connections it accepted, so reactors share nothing but the handler.
+ * Connections keep their own read and write buffers: every complete text
+ * line or binary frame in a read is handled before the replies go out in
+ * one send, so pipelined requests cost one syscall each way. A client that
+ * stops reading is not read from again until its backlog drains.
+ */
+class TcpServer {
+public:
+    // Binds all listeners; throws std::runtime_error on failure
+    TcpServer(RequestHandler& handler, ServerConfig config,
+              std::function<void()> onTick = nullptr);
+    ~TcpServer();
+
+    TcpServer(const TcpServer&) = delete;
+    TcpServer& operator=(const TcpServer&) = delete;
+
+    // Runs reactor 0 on the calling thread and the rest on their own
+    // threads; returns after stop()
+    void run();
+    // Thread-safe; wakes every reactor and closes all connections
+    void stop();
+
+    std::uint16_t port() const noexcept { return port_; }
+    std::size_t connectionCount() const noexcept;
+
+private:
+    class Reactor;
+
+    RequestHandler& handler_;
+    ServerConfig config_;
+    std::function<void()> onTick_;
+    std::uint16_t port_{0};
+    std::atomic<bool> running_;   // cleared by stop(), possibly before run()
+    std::vector<std::unique_ptr<Reactor>> reactors_;
+    std::vector<std::thread> threads_;
+};
+
+} // namespace ob::net
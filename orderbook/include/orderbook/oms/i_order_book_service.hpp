@@ -2,12 +2,20 @@
 
 #include "orderbook/core/types.hpp"
 #include "orderbook/core/instrument.hpp"
+#include "orderbook/core/metrics.hpp"
 #include "orderbook/book/order_book.hpp"
+#include "orderbook/book/book_image.hpp"
 #include "orderbook/events/event_types.hpp"
+#include "orderbook/queue/wait_strategy.hpp"
+#include "orderbook/processors/event_drainer.hpp"
+#include "orderbook/journal/journal_reader.hpp"
+#include "orderbook/journal/journal_writer.hpp"
+#include "orderbook/journal/snapshot.hpp"
 #include <string>
 #include <vector>
 #include <optional>
 #include <functional>
+#include <span>
 
 namespace ob::oms {
 
@@ -26,11 +34,15 @@ public:
     virtual ~IOrderBookService() = default;
 
     // Instrument management
+    // bookType selects the price-level storage; Ladder centres its window on initialPrice.
+    // waitStrategy sets how the instrument's processor thread idles.
     virtual std::uint32_t addInstrument(
         const std::string& ticker,
         const std::string& description,
         const std::string& industry,
-        double initialPrice
+        double initialPrice,
+        book::BookType bookType = book::BookType::Map,
+        queue::WaitStrategyType waitStrategy = queue::WaitStrategyType::SpinYield
     ) = 0;
     
     virtual bool removeInstrument(std::uint32_t symbolId) = 0;
@@ -41,7 +53,15 @@ public:
     // Order operations
     virtual bool submitOrder(const core::Order& order) = 0;
     virtual bool submitOrder(core::Order&& order) = 0;
+    // Bulk entry: queued[i] is set to whether orders[i] was queued
+    // (queued.size() >= orders.size()). Each run of consecutive orders for
+    // one symbol is resolved once and queued with one bulk push, so a run
+    // keeps its order when another thread submits too. Returns how many
+    // were queued.
+    virtual std::size_t submitOrders(std::span<const core::Order> orders, std::span<bool> queued) = 0;
     virtual bool cancelOrder(std::uint32_t symbolId, core::OrderId orderId) = 0;
+    virtual bool amendOrder(std::uint32_t symbolId, core::OrderId orderId,
+                            core::Price newPrice, core::Quantity newQuantity) = 0;
 
     // Market data
     virtual std::optional<core::Price> getBestBid(std::uint32_t symbolId) const = 0;
@@ -54,12 +74,36 @@ public:
         std::uint32_t symbolId, 
         std::size_t depth = 0
     ) const = 0;
+    // Both sides, up to depth levels each, from one publish of the book
+    // image; false for an unknown symbol
+    virtual bool getBookImage(std::uint32_t symbolId, book::BookImage& out, std::size_t depth) const = 0;
 
     // Event handling
     virtual void processEvents() = 0;
     virtual void setEventCallback(
         std::function<void(const events::Event&)> callback
     ) = 0;
+    // Deliver events from dedicated drain threads from now on; processEvents()
+    // becomes a no-op. Set the callback first. Returns false if already draining.
+    virtual bool startEventDrain(const processors::EventDrainConfig& config) = 0;
+    // Events lost to a full event queue; symbolId 0 = summed over all instruments
+    virtual std::uint64_t droppedEvents(std::uint32_t symbolId = 0) const = 0;
+
+    // Monitoring: counters and queue depths of every processor thread and
+    // instrument, read without pausing either (out is overwritten)
+    virtual void collectMetrics(core::ServiceMetrics& out) const = 0;
+    
+    // Durability: rebuild the instruments and books recorded in
+    // config.directory, then journal every input applied from now on. Call
+    // before adding instruments. Returns what was recovered, or nullopt if
+    // instruments exist or a journal is already open; throws
+    // std::runtime_error if the journal cannot be read or created.
+    virtual std::optional<journal::RecoveryStats> openJournal(const journal::JournalConfig& config) = 0;
+    // Write a point-in-time snapshot of every book into the journal
+    // directory, so the next recovery replays only the journal after it.
+    // Matching continues meanwhile. Returns nullopt without a running
+    // journal; throws std::runtime_error if the file cannot be written.
+    virtual std::optional<journal::SnapshotStats> saveSnapshot() = 0;
     
     // Type alias for callback (matches handlers::OutputHandler::EventCallback)
     using EventCallback = std::function<void(const events::Event&)>;
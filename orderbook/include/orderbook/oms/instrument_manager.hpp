@@ -4,6 +4,9 @@
 #include "orderbook/core/types.hpp"
 #include "orderbook/oms/order_management_system.hpp"
 #include "orderbook/oms/i_order_book_service.hpp"
+#include "orderbook/oms/symbol_table.hpp"
+#include "orderbook/processors/shard_processor.hpp"
+#include "orderbook/processors/event_drainer.hpp"
 #include <memory>
 #include <unordered_map>
 #include <mutex>
@@ -17,17 +20,69 @@ namespace ob::oms {
  * 
  * This allows the TCP server to depend on the abstraction rather than
  * the concrete implementation, enabling dependency injection and testability.
+ *
+ * Two execution modes:
+ * - Per-instrument (default constructor): every instrument gets its own
+ *   OrderManagementSystem with a dedicated processor thread.
+ * - Sharded (ShardConfig constructor): a fixed pool of ShardProcessor
+ *   workers, optionally pinned to CPUs, each hosting many instruments
+ *   behind one multi-symbol ingress queue. Instruments go to
+ *   symbolId % numShards unless assigned explicitly with assignShard().
+ *
+ * Order-path calls (submit, cancel, best price, snapshots, hasInstrument)
+ * resolve the symbol through a wait-free SymbolTable under an EpochGuard;
+ * the mutex only serialises instrument add/remove and event fan-out.
+ *
+ * Events are delivered by processEvents() on the caller's thread until
+ * startEventDrain() hands them to EventDrainer threads: by default one per
+ * shard, draining that shard's instruments, or one for all instruments in
+ * per-instrument mode.
+ *
+ * openJournal() makes the books durable: every processor appends the
+ * commands it applies to a JournalWriter, and on the next start the same
+ * call replays them. Replay is two passes, so instrument records and
+ * commands need not be ordered against each other: the first finds the
+ * instruments still live at the end, the second applies their commands
+ * through a publisher-less MatchingEngine.
+ *
+ * saveSnapshot() bounds that replay. It queues a cut command to every
+ * instrument; each matching thread copies its own book in slices between
+ * batches (copy-on-write per price level), and the books are written to
+ * one snapshot file. Recovery then bulk-loads the newest valid snapshot
+ * and replays only the journal after each book's cut. The previous
+ * snapshot and its journal are kept as a fallback; older files are deleted.
  */
+// Memory and CPU placement for each instrument's order path
+struct InstrumentResources {
+    core::MemoryConfig memory{};    // its event queue, book arenas and (per-instrument mode) ingress queue
+    std::size_t prewarmOrders{0};   // resting orders each book is sized for up front
+    std::vector<int> cpus{};        // per-instrument mode: symbol n's processor on cpus[(n - 1) % size]; empty = unpinned
+};
+
 class InstrumentManager : public IOrderBookService {
 public:
     InstrumentManager();
+    explicit InstrumentManager(const processors::ShardConfig& shardConfig);
     ~InstrumentManager() = default;
+
+    // Sharded mode only: place the next instrument added with this ticker on
+    // the given shard (index taken modulo the shard count)
+    void assignShard(const std::string& ticker, std::size_t shard);
+    std::size_t shardCount() const noexcept { return shards_.size(); }
+    // Pre-trade risk limits for instruments added (or recovered) after the
+    // call; each instrument checks its own orders against them
+    void setRiskLimits(const risk::RiskLimits& limits);
+    // Likewise for memory backing, prewarming and processor pinning.
+    // Sharded mode pins the shards instead (ShardConfig::cpus).
+    void setResources(const InstrumentResources& resources);
     
     // Instrument management (IOrderBookService interface)
     std::uint32_t addInstrument(const std::string& ticker,
                                 const std::string& description,
                                 const std::string& industry,
-                                double initialPrice) override;
+                                double initialPrice,
+                                book::BookType bookType = book::BookType::Map,
+                                queue::WaitStrategyType waitStrategy = queue::WaitStrategyType::SpinYield) override;
     bool removeInstrument(std::uint32_t symbolId) override;
     bool hasInstrument(std::uint32_t symbolId) const override;
     std::optional<core::Instrument> getInstrument(std::uint32_t symbolId) const override;
@@ -36,17 +91,30 @@ public:
     // Order operations (IOrderBookService interface)
     bool submitOrder(const core::Order& order) override;
     bool submitOrder(core::Order&& order) override;
+    std::size_t submitOrders(std::span<const core::Order> orders, std::span<bool> queued) override;
     bool cancelOrder(std::uint32_t symbolId, core::OrderId orderId) override;
+    bool amendOrder(std::uint32_t symbolId, core::OrderId orderId,
+                    core::Price newPrice, core::Quantity newQuantity) override;
 
     // Market data (IOrderBookService interface)
     std::optional<core::Price> getBestBid(std::uint32_t symbolId) const override;
     std::optional<core::Price> getBestAsk(std::uint32_t symbolId) const override;
     std::vector<book::LevelSummary> getBidsSnapshot(std::uint32_t symbolId, std::size_t depth = 0) const override;
     std::vector<book::LevelSummary> getAsksSnapshot(std::uint32_t symbolId, std::size_t depth = 0) const override;
+    bool getBookImage(std::uint32_t symbolId, book::BookImage& out, std::size_t depth) const override;
 
     // Event handling (IOrderBookService interface)
     void processEvents() override;
     void setEventCallback(EventCallback callback) override;
+    bool startEventDrain(const processors::EventDrainConfig& config) override;
+    std::uint64_t droppedEvents(std::uint32_t symbolId = 0) const override;
+    void collectMetrics(core::ServiceMetrics& out) const override;
+
+    // Durability (IOrderBookService interface)
+    std::optional<journal::RecoveryStats> openJournal(const journal::JournalConfig& config) override;
+    std::optional<journal::SnapshotStats> saveSnapshot() override;
+    // Null until openJournal()
+    const journal::JournalWriter* journal() const noexcept { return journal_.get(); }
     
     // Lifecycle (IOrderBookService interface)
     void start() override;
@@ -55,11 +123,37 @@ public:
     
 private:
     mutable std::mutex mutex_;
+    // Declared first so it is destroyed last, after every processor that appends to it
+    std::unique_ptr<journal::JournalWriter> journal_;
+    // Declared before orderBooks_ so hosted OMS instances detach first
+    std::vector<std::unique_ptr<processors::ShardProcessor>> shards_;
+    std::unordered_map<std::string, std::size_t> shardAssignments_;
+    risk::RiskLimits riskLimits_;
+    InstrumentResources resources_;
+    // Declared before orderBooks_ so every OMS detaches before its drainer goes
+    std::vector<std::unique_ptr<processors::EventDrainer>> drainers_;
     std::unordered_map<std::uint32_t, std::unique_ptr<OrderManagementSystem>> orderBooks_;
     std::unordered_map<std::uint32_t, core::Instrument> instruments_;
+    SymbolTable<OrderManagementSystem> symbols_; // lock-free read path over orderBooks_
     std::atomic<std::uint32_t> nextSymbolId_{1};
+    EventCallback eventCallback_; // also installed on instruments added later
+    std::uint64_t removedDropped_{0}; // droppedEvents() of instruments already removed
+
+    // Snapshots: how each live instrument was added, the newest snapshot id
+    // in the directory, and the last complete snapshot with its first segment
+    std::unordered_map<std::uint32_t, journal::InstrumentEntry> entries_;
+    std::uint64_t lastSnapshotId_{0};
+    std::uint64_t keptSnapshotId_{0};
+    std::uint64_t keptSegment_{0};
+    core::OrderId recoveredMaxOrderId_{0}; // order ids used before this process started
     
     OrderManagementSystem* getOMS(std::uint32_t symbolId) const;
+    void attachDrain(std::uint32_t symbolId, OrderManagementSystem& oms); // mutex_ held
+    // Build an instrument's OMS, not yet started or visible (mutex_ held)
+    std::unique_ptr<OrderManagementSystem> createOms(const core::Instrument& instrument, book::BookType bookType,
+                                                     queue::WaitStrategyType waitStrategy);
+    // Start it and publish it to the order path (mutex_ held)
+    void install(const core::Instrument& instrument, std::unique_ptr<OrderManagementSystem> oms);
 };
 
 } // namespace ob::oms
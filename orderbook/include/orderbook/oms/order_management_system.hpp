@@ -2,57 +2,169 @@
 
 #include "orderbook/core/types.hpp"
 #include "orderbook/core/constants.hpp"
+#include "orderbook/core/metrics.hpp"
+#include "orderbook/queue/order_queue.hpp"
 #include "orderbook/queue/spsc_queue.hpp"
+#include "orderbook/queue/wait_strategy.hpp"
 #include "orderbook/book/order_book.hpp"
+#include "orderbook/book/ladder_order_book.hpp"
 #include "orderbook/engine/matching_engine.hpp"
 #include "orderbook/events/event_publisher.hpp"
 #include "orderbook/processors/order_processor.hpp"
+#include "orderbook/processors/shard_processor.hpp"
+#include "orderbook/processors/event_drainer.hpp"
 #include "orderbook/handlers/input_handler.hpp"
 #include "orderbook/handlers/output_handler.hpp"
+#include "orderbook/risk/pre_trade_risk.hpp"
 #include <memory>
 
 namespace ob::oms {
 
+// Per-instrument construction options
+struct OmsConfig {
+    std::size_t queueSize{core::DEFAULT_QUEUE_SIZE};
+    std::size_t eventQueueSize{0};  // 0 = queueSize; one order can produce several events
+    book::BookType bookType{book::BookType::Map};
+    core::Price referencePrice{0};  // Ladder centre in ticks (ignored by the map book)
+    std::size_t ladderLevels{core::DEFAULT_LADDER_LEVELS};
+    std::size_t processBatch{core::DEFAULT_PROCESS_BATCH}; // Orders drained per processor wakeup
+    std::size_t eventBatch{core::DEFAULT_EVENT_BATCH};     // Staged events per publish flush (0 = unbatched)
+    // Idle behaviour of the processor thread: spin for hot symbols, park or
+    // back off for cold ones so idle instruments do not hold a core
+    queue::WaitStrategyType waitStrategy{queue::WaitStrategyType::SpinYield};
+    std::uint32_t symbolId{0};  // stamped on commands and events (the hosted constructor overrides it)
+    journal::JournalWriter* journal{nullptr}; // processor journals its inputs here (hosted: set on the shard)
+    // Pre-trade checks on the matching thread; none unless a limit is set.
+    // The collar starts from referencePrice.
+    risk::RiskLimits risk{};
+    // Backing of the ingress and event queues and the book arenas, and how
+    // many resting orders the book is sized for before the first arrives
+    // (0 = grow on demand). A hosted instrument's ingress is the shard's.
+    core::MemoryConfig memory{};
+    std::size_t prewarmOrders{0};
+    int cpu{-1}; // processor thread pinned here; -1 = unpinned (ignored when hosted)
+};
+
 // Main OMS class that orchestrates all components
 // Facade pattern: Provides simple interface to complex subsystem
 class OrderManagementSystem {
 public:
     explicit OrderManagementSystem(std::size_t queueSize = core::DEFAULT_QUEUE_SIZE);
+    explicit OrderManagementSystem(const OmsConfig& config);
+    // Hosted mode: the book and engine are served by a shared shard worker
+    // instead of a dedicated processor thread. Orders go into the shard's
+    // ingress queue and must carry symbolId. processBatch/waitStrategy in
+    // config are ignored in favour of the shard's; only the event queue is
+    // sized from config.
+    OrderManagementSystem(const OmsConfig& config, processors::ShardProcessor& shard, std::uint32_t symbolId);
+    ~OrderManagementSystem();
+
+    OrderManagementSystem(const OrderManagementSystem&) = delete;
+    OrderManagementSystem& operator=(const OrderManagementSystem&) = delete;
 
     // Order operations
     bool submitOrder(const core::Order& order);
     bool submitOrder(core::Order&& order);
+    // Queues orders[0, count) with bulk pushes; returns how many were
+    // queued, always a prefix (the ingress queue filled up after that)
+    std::size_t submitOrders(const core::Order* orders, std::size_t count);
+    // Queues the cancel behind earlier orders; returns false only if the
+    // ingress queue is full. The result is a CancelAck/CancelReject event.
     bool cancelOrder(core::OrderId orderId);
 
-    // Market data
+    // Queues a cancel-replace to newPrice / newQuantity (the new open size).
+    // Same price and smaller size keeps queue priority; anything else requeues.
+    // The result is an AmendAck/AmendReject event.
+    bool amendOrder(core::OrderId orderId, core::Price newPrice, core::Quantity newQuantity);
+
+    // Market data, from the book image the matching thread publishes after
+    // each batch: safe from any thread and never touches the live book.
+    // Snapshots hold at most BOOK_IMAGE_DEPTH levels (depth 0 = all of them).
     std::optional<core::Price> getBestBid() const;
     std::optional<core::Price> getBestAsk() const;
     std::vector<book::LevelSummary> getBidsSnapshot(std::size_t depth = 0) const;
     std::vector<book::LevelSummary> getAsksSnapshot(std::size_t depth = 0) const;
+    // Both sides from the same publish
+    void readBookImage(book::BookImage& out, std::size_t depth = core::BOOK_IMAGE_DEPTH) const noexcept {
+        matchingEngine_->image().read(out, depth);
+    }
 
     // Event handling
     void processEvents();
     void setEventCallback(handlers::OutputHandler::EventCallback callback);
+    // Hand event delivery to a drain thread (set the callback first); call
+    // processEvents() no more after this. Detached again on destruction.
+    void attachEventDrain(processors::EventDrainer& drainer);
+    // Events the matching engine could not queue because the event queue was full
+    std::uint64_t droppedEvents() const noexcept;
+
+    // Any thread: this instrument's counters and queue depths. processor is
+    // filled in only with a dedicated processor thread; in hosted mode the
+    // shard's own metrics describe the ingress side.
+    void sampleMetrics(core::InstrumentSample& out, core::ProcessorSample* processor = nullptr) const;
+
+    // Recovery: apply a journaled command straight to the book, without
+    // events. Only before start(); finishReplay() releases the replay engine
+    // and publishes the recovered book to readers.
+    void replay(const core::Command& command);
+    void finishReplay() noexcept {
+        replayEngine_.reset();
+        matchingEngine_->publishImage();
+    }
+    // Recovery: bulk-load a snapshot into the still empty book, before
+    // start(). The risk stage relearns the open orders from it.
+    bool loadSnapshot(const book::SnapshotOrder* orders, std::size_t count);
+    // Recovery: the stop orders waiting at the cut, and the last trade
+    // price their triggers compare against
+    void loadStops(const book::SnapshotStop* stops, std::size_t count, core::Price lastTradePrice);
+    // Recovery: the risk stage's positions, rate windows and collar
+    // reference at the cut; nothing without a risk stage
+    void loadRisk(const book::SnapshotAccount* accounts, std::size_t count, core::Price reference);
+
+    // Queue a snapshot cut behind earlier orders. The matching thread copies
+    // the book into out in slices while it keeps matching, then sets
+    // out.complete; out must stay alive until then. False if the queue is full.
+    bool requestSnapshot(book::BookSnapshot& out, std::uint64_t snapshotId);
 
     // Lifecycle
     void start();
     void stop();
     bool isRunning() const noexcept;
 
+    // Hosting shard, or null for a dedicated processor thread
+    processors::ShardProcessor* shard() const noexcept { return shard_; }
+    // Pre-trade risk stage, or null without limits
+    const risk::PreTradeRisk* risk() const noexcept { return risk_.get(); }
+
 private:
-    // SPSC Queues (lock-free communication)
-    std::shared_ptr<queue::SpscRingBuffer<core::Order>> orderQueue_;
+    // Lock-free queues: MPSC ingress (any client thread), SPSC events
+    std::shared_ptr<queue::OrderQueue> orderQueue_;
     std::shared_ptr<queue::SpscRingBuffer<events::Event>> eventQueue_;
+    std::shared_ptr<queue::WaitStrategy> waitStrategy_; // shared by input handler and processor
 
     // Core components
-    std::shared_ptr<book::OrderBook> orderBook_;
+    std::shared_ptr<book::IOrderBook> orderBook_;
+    std::shared_ptr<risk::PreTradeRisk> risk_;
+    std::shared_ptr<engine::StopBook> stops_; // shared by the live and replay engines
     std::shared_ptr<events::SpscEventPublisher> eventPublisher_;
     std::shared_ptr<engine::MatchingEngine> matchingEngine_;
+    std::unique_ptr<engine::MatchingEngine> replayEngine_; // same book, no publisher
     
     // Processors and handlers
     std::unique_ptr<processors::OrderProcessor> orderProcessor_;
     std::unique_ptr<handlers::InputHandler> inputHandler_;
     std::unique_ptr<handlers::OutputHandler> outputHandler_;
+
+    // Set in hosted mode (orderProcessor_ is then null)
+    processors::ShardProcessor* shard_{nullptr};
+    std::uint32_t symbolId_{0}; // stamped on cancels so a shard can route them
+    processors::EventDrainer* drainer_{nullptr};
+
+    bool counted(bool queued) noexcept {
+        if (!queued) submitFull_.add();
+        return queued;
+    }
+    core::SharedCounter submitFull_; // any client thread, when the ingress queue is full
 };
 
 } // namespace ob::oms
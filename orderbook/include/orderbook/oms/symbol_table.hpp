@@ -0,0 +1,72 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace ob::oms {
+
+// Dense symbolId -> T* map with wait-free lookup. Symbol ids are sequential,
+// so a two-level array (a fixed directory of lazily allocated chunks) gives
+// a lookup of two acquire loads and no hashing or locking. Writers
+// (publish/unpublish) must be serialised by the caller; the objects
+// themselves are not owned, and an unpublished object may only be freed
+// after core::synchronizeEpoch() if readers use core::EpochGuard.
+template <typename T>
+class SymbolTable final {
+public:
+    static constexpr std::size_t CHUNK_BITS = 10;
+    static constexpr std::size_t CHUNK_SIZE = std::size_t{1} << CHUNK_BITS;
+    static constexpr std::size_t MAX_CHUNKS = 1024;
+    static constexpr std::size_t MAX_SYMBOLS = CHUNK_SIZE * MAX_CHUNKS;
+
+    SymbolTable() {
+        for (auto& chunk : chunks_) chunk.store(nullptr, std::memory_order_relaxed);
+    }
+
+    ~SymbolTable() {
+        for (auto& chunk : chunks_) delete chunk.load(std::memory_order_relaxed);
+    }
+
+    SymbolTable(const SymbolTable&) = delete;
+    SymbolTable& operator=(const SymbolTable&) = delete;
+
+    [[nodiscard]] T* find(std::uint32_t symbolId) const noexcept {
+        if (symbolId >= MAX_SYMBOLS) return nullptr;
+        const Chunk* chunk = chunks_[symbolId >> CHUNK_BITS].load(std::memory_order_acquire);
+        return chunk ? chunk->slots[symbolId & (CHUNK_SIZE - 1)].load(std::memory_order_acquire) : nullptr;
+    }
+
+    // Returns false if symbolId is beyond MAX_SYMBOLS
+    bool publish(std::uint32_t symbolId, T* value) {
+        if (symbolId >= MAX_SYMBOLS) return false;
+        auto& dir = chunks_[symbolId >> CHUNK_BITS];
+        Chunk* chunk = dir.load(std::memory_order_relaxed);
+        if (!chunk) {
+            chunk = new Chunk();
+            dir.store(chunk, std::memory_order_release);
+        }
+        chunk->slots[symbolId & (CHUNK_SIZE - 1)].store(value, std::memory_order_release);
+        return true;
+    }
+
+    // Returns the previously published value (nullptr if none)
+    T* unpublish(std::uint32_t symbolId) noexcept {
+        if (symbolId >= MAX_SYMBOLS) return nullptr;
+        Chunk* chunk = chunks_[symbolId >> CHUNK_BITS].load(std::memory_order_relaxed);
+        return chunk ? chunk->slots[symbolId & (CHUNK_SIZE - 1)].exchange(nullptr, std::memory_order_acq_rel) : nullptr;
+    }
+
+private:
+    struct Chunk {
+        Chunk() {
+            for (auto& slot : slots) slot.store(nullptr, std::memory_order_relaxed);
+        }
+        std::atomic<T*> slots[CHUNK_SIZE];
+    };
+
+    std::atomic<Chunk*> chunks_[MAX_CHUNKS];
+};
+
+} // namespace ob::oms
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "orderbook/core/constants.hpp"
+#include "orderbook/events/event_publisher.hpp"
+#include "orderbook/handlers/output_handler.hpp"
+#include "orderbook/queue/wait_strategy.hpp"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ob::processors {
+
+// Event-drain options (see InstrumentManager::startEventDrain)
+struct EventDrainConfig {
+    std::size_t threads{0};                  // 0 = one per shard (one in per-instrument mode)
+    std::size_t maxBatchesPerSource{4};      // OutputHandler batches per source per pass, for fairness
+    queue::WaitStrategyType waitStrategy{queue::WaitStrategyType::SpinPark};
+    std::vector<int> cpus{};                 // drainer i is pinned to cpus[i % cpus.size()]; empty = unpinned
+    std::function<void()> onDrained{};       // run on the drain thread after every pass that delivered events
+};
+
+// Consumer thread for the event queues of a group of instruments.
+//
+// Each pass drains every attached OutputHandler in batches (its callback
+// runs on this thread), then calls onDrained. When a pass finds nothing the
+// thread idles on its wait strategy; attached publishers notify it after
+// every push, so SpinPark costs no CPU while the books are quiet. Keeping
+// the queues drained is what keeps SpscEventPublisher from dropping events.
+class EventDrainer {
+public:
+    EventDrainer(std::size_t index, const EventDrainConfig& config);
+    ~EventDrainer();
+
+    EventDrainer(const EventDrainer&) = delete;
+    EventDrainer& operator=(const EventDrainer&) = delete;
+
+    // Start draining handler; publisher (may be null) is told to wake this
+    // thread. The drainer must outlive the publisher.
+    void attach(std::uint32_t symbolId, handlers::OutputHandler* handler, events::SpscEventPublisher* publisher);
+    // Stop draining symbolId. Returns once the drain thread no longer uses
+    // its handler, so the caller may destroy it.
+    void detach(std::uint32_t symbolId);
+
+    void start();
+    // Drains what is left, then joins the thread
+    void stop();
+    bool isRunning() const noexcept { return running_.load(); }
+
+    std::size_t index() const noexcept { return index_; }
+    std::uint64_t eventsDrained() const noexcept { return drained_.load(std::memory_order_relaxed); }
+
+private:
+    struct Source {
+        std::uint32_t symbolId;
+        handlers::OutputHandler* handler;
+        events::SpscEventPublisher* publisher;
+        std::uint64_t droppedSeen; // publisher drop count at the last check
+    };
+
+    void processLoop();
+    std::size_t drainOnce();
+    bool hasWork();
+
+    const std::size_t index_;
+    const int cpu_; // -1 = unpinned
+    const std::size_t maxBatches_;
+    std::function<void()> onDrained_;
+    queue::WaitStrategy waitStrategy_;
+
+    std::mutex mutex_; // held for a whole pass, so detach waits it out
+    std::vector<Source> sources_;
+
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+    std::atomic<std::uint64_t> drained_{0};
+};
+
+} // namespace ob::processors
@@ -1,24 +1,40 @@
 #pragma once
 
 #include "orderbook/core/types.hpp"
-#include "orderbook/queue/spsc_queue.hpp"
+#include "orderbook/queue/order_queue.hpp"
+#include "orderbook/queue/wait_strategy.hpp"
 #include "orderbook/engine/i_matching_engine.hpp"
 #include "orderbook/book/i_order_book.hpp"
 #include "orderbook/events/event_publisher.hpp"
 #include "orderbook/core/constants.hpp"
+#include "orderbook/core/metrics.hpp"
+#include "orderbook/journal/journal_writer.hpp"
 #include <memory>
 #include <thread>
 #include <atomic>
+#include <vector>
 
 namespace ob::processors {
 
-// Order processor that consumes from SPSC queue and processes orders
+// Order processor that consumes from the ingress queue and processes orders
 // Single Responsibility: Process orders from queue
+// Each wakeup drains up to batchSize commands with one tryPopN, applies them,
+// then republishes the engine's book image and flushes the event publisher
+// once for the whole batch. When the queue
+// is empty the wait strategy decides whether to spin, yield, park or sleep.
+// With a journal, each batch is appended to it before it is applied. A book
+// snapshot in progress is advanced by one slice after every batch, and in
+// place of idling while the queue is empty.
 class OrderProcessor {
 public:
     OrderProcessor(
-        std::shared_ptr<queue::SpscRingBuffer<core::Order>> orderQueue,
-        std::shared_ptr<engine::IMatchingEngine> matchingEngine
+        std::shared_ptr<queue::OrderQueue> orderQueue,
+        std::shared_ptr<engine::IMatchingEngine> matchingEngine,
+        std::shared_ptr<events::IEventPublisher> eventPublisher = nullptr,
+        std::size_t batchSize = core::DEFAULT_PROCESS_BATCH,
+        std::shared_ptr<queue::WaitStrategy> waitStrategy = nullptr,
+        journal::JournalWriter* journal = nullptr, // must outlive the processor
+        int cpu = -1 // processor thread pinned here; -1 = unpinned
     );
 
     ~OrderProcessor();
@@ -27,14 +43,23 @@ public:
     void start();
     void stop();
     bool isRunning() const noexcept { return running_.load(); }
+    // Any thread
+    const core::ProcessorMetrics& metrics() const noexcept { return metrics_; }
 
 private:
     void processLoop();
 
-    std::shared_ptr<queue::SpscRingBuffer<core::Order>> orderQueue_;
+    std::shared_ptr<queue::OrderQueue> orderQueue_;
     std::shared_ptr<engine::IMatchingEngine> matchingEngine_;
+    std::shared_ptr<events::IEventPublisher> eventPublisher_; // flushed after each batch
+    std::vector<core::Command> batch_;
+    std::shared_ptr<queue::WaitStrategy> waitStrategy_; // must be shared with the InputHandler
+    journal::JournalWriter* journal_;
+    const int cpu_; // -1 = unpinned
+    bool snapshotting_{false}; // processor thread only
     std::thread processorThread_;
     std::atomic<bool> running_{false};
+    core::ProcessorMetrics metrics_; // processor thread writes
 };
 
 } // namespace ob::processors
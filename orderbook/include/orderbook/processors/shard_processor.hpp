@@ -0,0 +1,93 @@
+#pragma once
+
+#include "orderbook/core/types.hpp"
+#include "orderbook/core/constants.hpp"
+#include "orderbook/core/metrics.hpp"
+#include "orderbook/queue/order_queue.hpp"
+#include "orderbook/queue/wait_strategy.hpp"
+#include "orderbook/engine/i_matching_engine.hpp"
+#include "orderbook/events/event_publisher.hpp"
+#include "orderbook/journal/journal_writer.hpp"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace ob::processors {
+
+// Sharded execution options (see InstrumentManager(const ShardConfig&))
+struct ShardConfig {
+    std::size_t numShards{1};
+    std::vector<int> cpus{};  // shard i is pinned to cpus[i % cpus.size()]; empty = unpinned
+    std::size_t queueSize{core::DEFAULT_SHARD_QUEUE_SIZE};
+    std::size_t processBatch{core::DEFAULT_PROCESS_BATCH};
+    std::size_t maxSymbols{core::DEFAULT_MAX_SYMBOLS};  // symbol ids must be below this
+    queue::WaitStrategyType waitStrategy{queue::WaitStrategyType::SpinYield};
+    core::MemoryConfig memory{}; // backing of the shared ingress queue
+};
+
+// One worker thread serving many instruments. All of the shard's symbols
+// share a single multi-symbol ingress queue; each popped order is routed by
+// symbolId to the matching engine attached for that symbol. Thread count is
+// therefore bounded by the shard count rather than the instrument count.
+// Book snapshots in progress on any of the shard's symbols advance by one
+// slice each after every batch, and in place of idling.
+class ShardProcessor {
+public:
+    ShardProcessor(std::size_t index, const ShardConfig& config);
+    ~ShardProcessor();
+
+    ShardProcessor(const ShardProcessor&) = delete;
+    ShardProcessor& operator=(const ShardProcessor&) = delete;
+
+    // Route orders for symbolId to engine; its publisher is flushed and its
+    // book image republished after every batch that touched the symbol. Returns false if the id is out
+    // of range or already attached.
+    bool attach(std::uint32_t symbolId, engine::IMatchingEngine* engine, events::IEventPublisher* publisher);
+    // Stop routing symbolId. Blocks until the worker has finished any batch
+    // that could still reference the old engine, so the caller may destroy it.
+    void detach(std::uint32_t symbolId);
+    // Append every popped batch to journal before applying it (null = stop).
+    // The journal must outlive the shard or be cleared first.
+    void setJournal(journal::JournalWriter* journal) noexcept { journal_.store(journal, std::memory_order_release); }
+
+    void start();
+    void stop();
+    bool isRunning() const noexcept { return running_.load(); }
+
+    std::size_t index() const noexcept { return index_; }
+    const std::shared_ptr<queue::OrderQueue>& orderQueue() const noexcept { return orderQueue_; }
+    const std::shared_ptr<queue::WaitStrategy>& waitStrategy() const noexcept { return waitStrategy_; }
+    const core::ProcessorMetrics& metrics() const noexcept { return metrics_; }
+
+private:
+    struct Route {
+        engine::IMatchingEngine* engine;
+        events::IEventPublisher* publisher;
+    };
+
+    void processLoop();
+    void quiesce();
+    void continueSnapshots();
+
+    const std::size_t index_;
+    const int cpu_; // -1 = unpinned
+    std::shared_ptr<queue::OrderQueue> orderQueue_;
+    std::shared_ptr<queue::WaitStrategy> waitStrategy_;
+    std::vector<core::Command> batch_;
+    std::vector<const Route*> touched_;         // publishers to flush, images to publish after a batch
+    std::vector<std::uint32_t> snapshotting_;       // symbols with a snapshot in progress
+
+    // Dense symbolId -> route table; written by attach/detach, read by the worker
+    const std::size_t maxSymbols_;
+    std::unique_ptr<std::atomic<Route*>[]> routes_;
+    std::atomic<journal::JournalWriter*> journal_{nullptr};
+
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+    alignas(64) std::atomic<std::uint64_t> loopEpoch_{0}; // bumped once per worker loop iteration
+    core::ProcessorMetrics metrics_; // worker writes
+};
+
+} // namespace ob::processors
@@ -0,0 +1,200 @@
+#pragma once
+
+#include "orderbook/core/memory.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <new>
+#include <utility>
+
+namespace ob::queue {
+
+// A bounded MPSC ring buffer with power-of-two capacity.
+// Lock-free for any number of producers and a single consumer. Each slot
+// carries a sequence number (Vyukov's bounded queue): producers claim a
+// position with one CAS on the shared head and publish by bumping the slot's
+// sequence, so producers only contend on the head counter, never on a lock.
+// Same interface as SpscRingBuffer so the two are interchangeable, including
+// the optional MemoryConfig for the cells.
+template <typename T>
+class alignas(64) MpscRingBuffer final {
+    static_assert(std::is_nothrow_move_constructible_v<T>,
+                  "a claimed slot must always be published, so construction cannot throw");
+
+public:
+    explicit MpscRingBuffer(std::size_t capacityPowerOfTwo, const core::MemoryConfig& memory = {})
+        : capacity_(normalizeCapacity(capacityPowerOfTwo)), mask_(capacity_ - 1), buffer_(nullptr)
+    {
+        static_assert(alignof(Cell) <= 4096, "mapped cells are only page aligned");
+        if (memory.plain()) {
+            buffer_ = static_cast<Cell*>(::operator new[](sizeof(Cell) * capacity_, std::align_val_t{alignof(Cell)}));
+        } else {
+            pages_ = core::allocatePages(sizeof(Cell) * capacity_, memory);
+            buffer_ = static_cast<Cell*>(pages_.base);
+        }
+        for (std::size_t i = 0; i < capacity_; ++i) {
+            ::new (&buffer_[i]) Cell();
+            buffer_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpscRingBuffer(const MpscRingBuffer&) = delete;
+    MpscRingBuffer& operator=(const MpscRingBuffer&) = delete;
+
+    ~MpscRingBuffer() noexcept {
+        // Producers/consumer must be stopped before destruction
+        for (std::size_t pos = tail_.load(std::memory_order_relaxed);; ++pos) {
+            Cell& cell = buffer_[pos & mask_];
+            if (cell.sequence.load(std::memory_order_relaxed) != pos + 1) break;
+            cell.value().~T();
+        }
+        for (std::size_t i = 0; i < capacity_; ++i) {
+            buffer_[i].~Cell();
+        }
+        if (pages_.base) {
+            core::freePages(pages_);
+        } else {
+            ::operator delete[](buffer_, std::align_val_t{alignof(Cell)});
+        }
+    }
+
+    [[nodiscard]] bool tryPush(const T& value) noexcept {
+        static_assert(std::is_nothrow_copy_constructible_v<T>, "copy push requires a nothrow copy");
+        return emplace(value);
+    }
+
+    [[nodiscard]] bool tryPush(T&& value) noexcept { return emplace(std::move(value)); }
+
+    // Single consumer only
+    [[nodiscard]] bool tryPop(T& out) noexcept(std::is_nothrow_move_assignable_v<T>) {
+        const std::size_t pos = tail_.load(std::memory_order_relaxed);
+        Cell& cell = buffer_[pos & mask_];
+        if (cell.sequence.load(std::memory_order_acquire) != pos + 1) return false; // empty or not yet published
+        out = std::move(cell.value());
+        cell.value().~T();
+        // Hand the slot back to producers for the next lap
+        cell.sequence.store(pos + capacity_, std::memory_order_release);
+        tail_.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Bulk push: claims a run of up to count consecutive free slots with one
+    // CAS, then copies and publishes them in order. Returns how many were
+    // pushed (0 when full).
+    [[nodiscard]] std::size_t tryPushN(const T* items, std::size_t count) noexcept {
+        static_assert(std::is_nothrow_copy_constructible_v<T>, "copy push requires a nothrow copy");
+        if (count == 0) return 0;
+        std::size_t pos = head_.load(std::memory_order_relaxed);
+        std::size_t n = 0;
+        for (;;) {
+            n = 0;
+            while (n < count && buffer_[(pos + n) & mask_].sequence.load(std::memory_order_acquire) == pos + n) ++n;
+            if (n == 0) {
+                const std::size_t seq = buffer_[pos & mask_].sequence.load(std::memory_order_acquire);
+                if (static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos) < 0) { // full
+                    refused(count);
+                    return 0;
+                }
+                pos = head_.load(std::memory_order_relaxed);
+                continue;
+            }
+            if (head_.compare_exchange_weak(pos, pos + n, std::memory_order_relaxed)) break;
+        }
+        for (std::size_t i = 0; i < n; ++i) {
+            Cell& cell = buffer_[(pos + i) & mask_];
+            ::new (cell.storage) T(items[i]);
+            cell.sequence.store(pos + i + 1, std::memory_order_release);
+        }
+        if (n != count) refused(count - n);
+        return n;
+    }
+
+    // Bulk pop (single consumer): moves up to maxCount published items into
+    // out; the tail index is stored once per batch. Returns how many were
+    // popped (0 when empty).
+    [[nodiscard]] std::size_t tryPopN(T* out, std::size_t maxCount) noexcept(std::is_nothrow_move_assignable_v<T>) {
+        const std::size_t pos = tail_.load(std::memory_order_relaxed);
+        std::size_t n = 0;
+        for (; n < maxCount; ++n) {
+            Cell& cell = buffer_[(pos + n) & mask_];
+            if (cell.sequence.load(std::memory_order_acquire) != pos + n + 1) break;
+            out[n] = std::move(cell.value());
+            cell.value().~T();
+            cell.sequence.store(pos + n + capacity_, std::memory_order_release);
+        }
+        if (n != 0) tail_.store(pos + n, std::memory_order_release);
+        return n;
+    }
+
+    [[nodiscard]] bool empty() const noexcept {
+        const std::size_t pos = tail_.load(std::memory_order_acquire);
+        return buffer_[pos & mask_].sequence.load(std::memory_order_acquire) != pos + 1;
+    }
+    [[nodiscard]] bool full() const noexcept {
+        return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire) >= capacity_;
+    }
+    [[nodiscard]] std::size_t capacity() const noexcept { return capacity_; }
+    // Any thread, for monitoring: items claimed and not yet popped, as of
+    // two unsynchronised loads
+    [[nodiscard]] std::size_t size() const noexcept {
+        const std::size_t tail = tail_.load(std::memory_order_relaxed);
+        const std::size_t head = head_.load(std::memory_order_relaxed);
+        return head > tail ? std::min(head - tail, capacity_) : 0;
+    }
+    // Any thread: items producers could not push because the ring was full; a
+    // push retried until it fits counts every refusal
+    [[nodiscard]] std::uint64_t pushFailures() const noexcept { return pushFailures_.load(std::memory_order_relaxed); }
+
+private:
+    // Any producer; only when full, on the line producers already contend for
+    void refused(std::size_t count) noexcept { pushFailures_.fetch_add(count, std::memory_order_relaxed); }
+
+    struct Cell {
+        std::atomic<std::size_t> sequence{0};
+        alignas(T) unsigned char storage[sizeof(T)];
+        T& value() noexcept { return *std::launder(reinterpret_cast<T*>(storage)); }
+    };
+
+    template <typename U>
+    bool emplace(U&& value) noexcept {
+        std::size_t pos = head_.load(std::memory_order_relaxed);
+        Cell* cell = nullptr;
+        for (;;) {
+            cell = &buffer_[pos & mask_];
+            const std::size_t seq = cell->sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+            if (diff == 0) {
+                // Slot is free on this lap; claim it (pos is reloaded on failure)
+                if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            } else if (diff < 0) {
+                refused(1);
+                return false; // full: the consumer has not released this slot yet
+            } else {
+                pos = head_.load(std::memory_order_relaxed); // another producer got here first
+            }
+        }
+        ::new (cell->storage) T(std::forward<U>(value));
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    static std::size_t normalizeCapacity(std::size_t n) noexcept {
+        if (n < 2) n = 2;
+        // round up to power of two
+        std::size_t p = 1;
+        while (p < n) p <<= 1;
+        return p;
+    }
+
+    alignas(64) std::atomic<std::size_t> head_{0}; // next position producers claim
+    std::atomic<std::uint64_t> pushFailures_{0};
+    alignas(64) std::atomic<std::size_t> tail_{0}; // next position the consumer reads
+    const std::size_t capacity_;
+    const std::size_t mask_;
+    Cell* buffer_;
+    core::PageBlock pages_{}; // set when the cells are mapped rather than heap allocated
+};
+
+} // namespace ob::queue
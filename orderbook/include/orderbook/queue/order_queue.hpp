@@ -0,0 +1,14 @@
+#pragma once
+
+#include "orderbook/core/command.hpp"
+#include "orderbook/queue/mpsc_queue.hpp"
+
+namespace ob::queue {
+
+// Ingress queue between InputHandler and OrderProcessor. Multi-producer so
+// every client thread can submit into an instrument without a lock; the
+// processor thread is the single consumer. Carries tagged commands (orders
+// and cancels) so the matching thread sequences all book mutations.
+using OrderQueue = MpscRingBuffer<core::Command>;
+
+} // namespace ob::queue
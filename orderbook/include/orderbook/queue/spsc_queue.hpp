@@ -1,25 +1,42 @@
 #pragma once
 
+#include "orderbook/core/memory.hpp"
 #include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <type_traits>
 #include <new>
 #include <cassert>
+#include <utility>
 
 namespace ob::queue {
 
 // A bounded SPSC ring buffer with power-of-two capacity.
 // Lock-free for single producer and single consumer with relaxed atomics.
-template <typename T>
+//
+// Trivially copyable T is stored in plain slots: no construction flag, no
+// placement new or destructor calls, so a push or pop is a copy of sizeof(T)
+// bytes and the slots pack as tightly as T allows. Other types get a slot
+// with raw storage that is constructed on push and destroyed on pop.
+// PlainSlots can be forced off to measure the difference.
+//
+// The slots come from the heap, or from allocatePages when a MemoryConfig
+// asks for huge pages, prefaulting or locking.
+template <typename T, bool PlainSlots = std::is_trivially_copyable_v<T> && std::is_default_constructible_v<T>>
 class alignas(64) SpscRingBuffer final {
 public:
-    explicit SpscRingBuffer(std::size_t capacityPowerOfTwo)
+    explicit SpscRingBuffer(std::size_t capacityPowerOfTwo, const core::MemoryConfig& memory = {})
         : capacity_(normalizeCapacity(capacityPowerOfTwo)), mask_(capacity_ - 1), buffer_(nullptr)
     {
-        buffer_ = static_cast<Node*>(::operator new[](sizeof(Node) * capacity_, std::align_val_t{alignof(Node)}));
+        static_assert(alignof(Slot) <= 4096, "mapped slots are only page aligned");
+        if (memory.plain()) {
+            buffer_ = static_cast<Slot*>(::operator new[](sizeof(Slot) * capacity_, std::align_val_t{alignof(Slot)}));
+        } else {
+            pages_ = core::allocatePages(sizeof(Slot) * capacity_, memory);
+            buffer_ = static_cast<Slot*>(pages_.base);
+        }
         for (std::size_t i = 0; i < capacity_; ++i) {
-            ::new (&buffer_[i]) Node();
+            ::new (&buffer_[i]) Slot();
         }
     }
 
@@ -29,19 +46,25 @@ public:
     ~SpscRingBuffer() noexcept {
         // Destroy any constructed elements
         // Producer/consumer must be stopped before destruction
-        for (std::size_t i = head_.load(std::memory_order_relaxed); i != tail_.load(std::memory_order_relaxed); i = (i + 1) & mask_) {
-            buffer_[i].destroy();
+        if constexpr (!PlainSlots) {
+            for (std::size_t i = tail_.load(std::memory_order_relaxed); i != head_.load(std::memory_order_relaxed); i = (i + 1) & mask_) {
+                buffer_[i].destroy();
+            }
         }
         for (std::size_t i = 0; i < capacity_; ++i) {
-            buffer_[i].~Node();
+            buffer_[i].~Slot();
+        }
+        if (pages_.base) {
+            core::freePages(pages_);
+        } else {
+            ::operator delete[](buffer_, std::align_val_t{alignof(Slot)});
         }
-        ::operator delete[](buffer_, std::align_val_t{alignof(Node)});
     }
 
     [[nodiscard]] bool tryPush(const T& value) noexcept(std::is_nothrow_copy_constructible_v<T>) {
         const std::size_t head = head_.load(std::memory_order_relaxed);
         const std::size_t next = (head + 1) & mask_;
-        if (next == tail_.load(std::memory_order_acquire)) return false; // full
+        if (next == tail_.load(std::memory_order_acquire)) return refused(1); // full
         buffer_[head].construct(value);
         head_.store(next, std::memory_order_release);
         return true;
@@ -50,7 +73,7 @@ public:
     [[nodiscard]] bool tryPush(T&& value) noexcept(std::is_nothrow_move_constructible_v<T>) {
         const std::size_t head = head_.load(std::memory_order_relaxed);
         const std::size_t next = (head + 1) & mask_;
-        if (next == tail_.load(std::memory_order_acquire)) return false;
+        if (next == tail_.load(std::memory_order_acquire)) return refused(1);
         buffer_[head].construct(std::move(value));
         head_.store(next, std::memory_order_release);
         return true;
@@ -59,21 +82,64 @@ public:
     [[nodiscard]] bool tryPop(T& out) noexcept(std::is_nothrow_move_assignable_v<T>) {
         const std::size_t tail = tail_.load(std::memory_order_relaxed);
         if (tail == head_.load(std::memory_order_acquire)) return false; // empty
-        out = std::move(buffer_[tail].value);
+        out = std::move(buffer_[tail].value());
         buffer_[tail].destroy();
         tail_.store((tail + 1) & mask_, std::memory_order_release);
         return true;
     }
 
+    // Bulk push: copies up to count items and publishes them with a single
+    // head store. Returns how many were pushed (0 when full).
+    [[nodiscard]] std::size_t tryPushN(const T* items, std::size_t count) noexcept(std::is_nothrow_copy_constructible_v<T>) {
+        const std::size_t head = head_.load(std::memory_order_relaxed);
+        const std::size_t free = (tail_.load(std::memory_order_acquire) - head - 1) & mask_;
+        const std::size_t n = count < free ? count : free;
+        for (std::size_t i = 0; i < n; ++i) {
+            buffer_[(head + i) & mask_].construct(items[i]);
+        }
+        if (n != 0) head_.store((head + n) & mask_, std::memory_order_release);
+        if (n != count) refused(count - n);
+        return n;
+    }
+
+    // Bulk pop: moves up to maxCount items into out and releases them with a
+    // single tail store. Returns how many were popped (0 when empty).
+    [[nodiscard]] std::size_t tryPopN(T* out, std::size_t maxCount) noexcept(std::is_nothrow_move_assignable_v<T>) {
+        const std::size_t tail = tail_.load(std::memory_order_relaxed);
+        const std::size_t avail = (head_.load(std::memory_order_acquire) - tail) & mask_;
+        const std::size_t n = maxCount < avail ? maxCount : avail;
+        for (std::size_t i = 0; i < n; ++i) {
+            Slot& slot = buffer_[(tail + i) & mask_];
+            out[i] = std::move(slot.value());
+            slot.destroy();
+        }
+        if (n != 0) tail_.store((tail + n) & mask_, std::memory_order_release);
+        return n;
+    }
+
     [[nodiscard]] bool empty() const noexcept { return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire); }
     [[nodiscard]] bool full() const noexcept { return ((head_.load(std::memory_order_acquire) + 1) & mask_) == tail_.load(std::memory_order_acquire); }
     [[nodiscard]] std::size_t capacity() const noexcept { return capacity_ - 1; }
+    // Any thread, for monitoring: items queued, as of two unsynchronised loads
+    [[nodiscard]] std::size_t size() const noexcept {
+        return (head_.load(std::memory_order_relaxed) - tail_.load(std::memory_order_relaxed)) & mask_;
+    }
+    // Any thread: items the producer could not push because the ring was full; a
+    // push retried until it fits counts every refusal
+    [[nodiscard]] std::uint64_t pushFailures() const noexcept { return pushFailures_.load(std::memory_order_relaxed); }
 
 private:
+    // Producer only, so no locked add; shares the producer's line with head_
+    bool refused(std::size_t count) noexcept {
+        pushFailures_.store(pushFailures_.load(std::memory_order_relaxed) + count, std::memory_order_relaxed);
+        return false;
+    }
+
+    // Raw storage, constructed on push and destroyed on pop
     struct Node {
         alignas(T) unsigned char storage[sizeof(T)];
         bool constructed{false};
-        T& value = *reinterpret_cast<T*>(storage);
+        T& value() noexcept { return *std::launder(reinterpret_cast<T*>(storage)); }
         template <typename... Args>
         void construct(Args&&... args) noexcept(std::is_nothrow_constructible_v<T, Args...>) {
             assert(!constructed);
@@ -82,12 +148,22 @@ private:
         }
         void destroy() noexcept {
             if (constructed) {
-                value.~T();
+                value().~T();
                 constructed = false;
             }
         }
     };
 
+    // Trivially copyable T: the slot is the value
+    struct PlainSlot {
+        T item;
+        T& value() noexcept { return item; }
+        void construct(const T& v) noexcept { item = v; }
+        void destroy() noexcept {}
+    };
+
+    using Slot = std::conditional_t<PlainSlots, PlainSlot, Node>;
+
     static std::size_t normalizeCapacity(std::size_t n) noexcept {
         if (n < 2) n = 2;
         // round up to power of two
@@ -97,10 +173,12 @@ private:
     }
 
     alignas(64) std::atomic<std::size_t> head_{0};
+    std::atomic<std::uint64_t> pushFailures_{0};
     alignas(64) std::atomic<std::size_t> tail_{0};
     const std::size_t capacity_;
     const std::size_t mask_;
-    Node* buffer_;
+    Slot* buffer_;
+    core::PageBlock pages_{}; // set when the slots are mapped rather than heap allocated
 };
 
 } // namespace ob::queue
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace ob::queue {
+
+// Spin-loop hint: lets the sibling hyperthread run and avoids the pipeline
+// flush on loop exit. Compiles to nothing on targets without one.
+inline void cpuRelax() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+    _mm_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield" ::: "memory");
+#endif
+}
+
+// How a queue consumer waits when it finds its queue empty
+enum class WaitStrategyType : std::uint8_t {
+    BusySpin = 0,     // pause-spin forever: lowest latency, burns a core
+    SpinYield = 1,    // short spin, then yield the timeslice
+    SpinPark = 2,     // spin, yield, then park until a producer signals
+    TimedBackoff = 3  // spin, then sleep with exponential backoff
+};
+
+// Shared between the producers of a queue (notify after a push) and its
+// single consumer (idle when the queue is empty). Parking uses C++20
+// atomic wait/notify, which is a futex on Linux; producers only pay for the
+// notify syscall when the consumer is actually parked.
+class WaitStrategy final {
+public:
+    static constexpr std::uint32_t SPIN_ROUNDS = 128;     // pause rounds before yielding
+    static constexpr std::uint32_t YIELD_ROUNDS = 256;    // total rounds before parking/sleeping
+    static constexpr std::chrono::microseconds MIN_BACKOFF{1};
+    static constexpr std::chrono::microseconds MAX_BACKOFF{1000};
+
+    explicit WaitStrategy(WaitStrategyType type = WaitStrategyType::SpinYield) noexcept : type_(type) {}
+
+    WaitStrategyType type() const noexcept { return type_; }
+
+    // Consumer side. idleRounds counts consecutive empty polls and must be
+    // reset to 0 by the caller after it finds work. hasWork is re-checked
+    // before parking so a push that races with going to sleep is not missed.
+    template <typename HasWork>
+    void idle(std::uint32_t& idleRounds, HasWork&& hasWork) {
+        const std::uint32_t round = idleRounds++;
+        switch (type_) {
+            case WaitStrategyType::BusySpin:
+                cpuRelax();
+                return;
+            case WaitStrategyType::SpinYield:
+                if (round < SPIN_ROUNDS) cpuRelax();
+                else std::this_thread::yield();
+                return;
+            case WaitStrategyType::SpinPark:
+                if (round < SPIN_ROUNDS) cpuRelax();
+                else if (round < YIELD_ROUNDS) std::this_thread::yield();
+                else park(hasWork);
+                return;
+            case WaitStrategyType::TimedBackoff:
+                if (round < SPIN_ROUNDS) {
+                    cpuRelax();
+                } else {
+                    const std::uint32_t shift = round - SPIN_ROUNDS < 10 ? round - SPIN_ROUNDS : 10;
+                    const auto backoff = MIN_BACKOFF * (1u << shift);
+                    std::this_thread::sleep_for(backoff < MAX_BACKOFF ? backoff : MAX_BACKOFF);
+                }
+                return;
+        }
+    }
+
+    // Producer side: call after a successful push
+    void notify() noexcept {
+        if (type_ != WaitStrategyType::SpinPark) return;
+        signal_.fetch_add(1, std::memory_order_seq_cst);
+        if (parked_.load(std::memory_order_seq_cst)) signal_.notify_one();
+    }
+
+    // Unconditional wake, e.g. so a parked consumer can observe shutdown
+    void wakeAll() noexcept {
+        signal_.fetch_add(1, std::memory_order_seq_cst);
+        signal_.notify_all();
+    }
+
+private:
+    template <typename HasWork>
+    void park(HasWork&& hasWork) {
+        parked_.store(true, std::memory_order_seq_cst);
+        const std::uint32_t seen = signal_.load(std::memory_order_seq_cst);
+        // Any push after this check bumps signal_, so wait() returns at once
+        if (!hasWork()) signal_.wait(seen, std::memory_order_seq_cst);
+        parked_.store(false, std::memory_order_relaxed);
+    }
+
+    const WaitStrategyType type_;
+    alignas(64) std::atomic<std::uint32_t> signal_{0};
+    std::atomic<bool> parked_{false};
+};
+
+} // namespace ob::queue
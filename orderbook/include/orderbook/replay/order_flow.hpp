@@ -0,0 +1,77 @@
+#pragma once
+
+#include "orderbook/core/types.hpp"
+#include "orderbook/journal/journal_format.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ob::replay {
+
+// On-disk layout of a recorded order flow.
+//
+// A flow file is one instrument's inputs in arrival order: a FlowHeader
+// followed by count journal::CommandRecords (new orders, cancels and
+// amends). A record's ts is its arrival time in ns since the first record,
+// which paced replay reproduces; symbolId is ignored on replay. Flows are
+// written by generateFlow(), or cut out of a server journal with
+// extractFlow().
+
+inline constexpr std::uint32_t FLOW_MAGIC = 0x574F4C46; // "FLOW" little-endian
+inline constexpr std::uint16_t FLOW_VERSION = 3; // 3: 56-byte records (journal format 3); reads 1 and 2 too
+
+struct FlowHeader {
+    std::uint32_t magic{FLOW_MAGIC};
+    std::uint16_t version{FLOW_VERSION};
+    std::uint16_t headerSize{sizeof(FlowHeader)};
+    std::uint64_t count{0};
+    core::Price referencePrice{0}; // where the flow trades; ladder books are centred here
+    std::uint32_t checksum{0};     // over the records
+    std::uint8_t reserved[4]{};
+};
+
+static_assert(sizeof(FlowHeader) == 32, "flow header layout is part of the format");
+
+using FlowRecord = journal::CommandRecord;
+
+struct OrderFlow {
+    core::Price referencePrice{0};
+    std::vector<FlowRecord> records;
+};
+
+// Synthetic flow shaped like a live book rather than uniform noise: prices
+// cluster a few ticks from a slowly drifting touch, most orders are
+// cancelled (recent ones far more often than old ones), a few cross the
+// spread, and arrivals alternate between quiet stretches and bursts.
+struct FlowConfig {
+    std::uint64_t seed{42};
+    std::size_t commands{1'000'000};
+    core::Price referencePrice{10'000};
+    double cancelRatio{0.55};        // share of commands that cancel a resting order
+    double amendRatio{0.10};         // share that amend one
+    double marketRatio{0.01};        // share of new orders sent as market orders
+    double crossRatio{0.04};         // share of limit orders priced through the touch
+    double levelDecay{0.35};         // P(next tick out): distance from the touch is geometric
+    double recentCancelBias{0.8};    // share of cancels and amends aimed at recent orders
+    double driftProbability{0.002};  // chance per new order that the touch moves a tick
+    std::uint64_t quietGapNs{10'000}; // mean gap between arrivals outside bursts
+    std::uint64_t burstGapNs{1'000};  // mean gap inside a burst
+    double burstProbability{0.0002};  // chance per arrival that a burst starts
+    std::size_t burstLength{1'000};   // mean arrivals per burst
+};
+
+OrderFlow generateFlow(const FlowConfig& config);
+
+// Orders, cancels and amends journaled for symbolId, in journal order, with
+// timestamps rebased to the first. symbolId 0 takes the first instrument
+// with a command. The reference price is the instrument's initial price.
+// Throws std::runtime_error if the journal cannot be read.
+OrderFlow extractFlow(const std::string& journalDirectory, std::uint32_t symbolId = 0);
+
+// Throw std::runtime_error on I/O failure or, when reading, on a file that
+// is not a complete flow
+void writeFlow(const std::string& path, const OrderFlow& flow);
+OrderFlow readFlow(const std::string& path);
+
+} // namespace ob::replay
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "orderbook/book/book_snapshot.hpp"
+#include "orderbook/core/types.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ob::risk {
+
+// Why a pre-trade check refused an order or amend
+enum class RiskReject : std::uint8_t {
+    None = 0,
+    OrderSize = 1,   // quantity above the per-order maximum
+    Notional = 2,    // price x quantity above the per-order maximum
+    PriceCollar = 3, // limit price too far from the reference price
+    OpenOrders = 4,  // account already has the maximum of resting orders
+    Position = 5,    // fills plus open orders could pass the position limit
+    Rate = 6,        // account sent too many orders and amends in the window
+    Accounts = 7     // per-account table full: no room to track a new account
+};
+inline constexpr std::size_t RISK_REJECT_REASONS = 8;
+
+// Pre-trade risk stage in front of the matching engine (Dependency
+// Inversion Principle). The engine consults it on its own thread for every
+// new order and amend, and reports back every change to an order's
+// exposure, so the stage keeps its state without locks or a service hop.
+// Checks must be pure functions of that state and the command, arrival
+// time included, so journal replay reaches the same decisions.
+class IRiskCheck {
+public:
+    virtual ~IRiskCheck() = default;
+
+    // A new order, already validated (positive quantity, positive limit
+    // price). arrival is its ingress timestamp.
+    virtual RiskReject checkOrder(const core::Order& order, core::Timestamp arrival) noexcept = 0;
+    // Cancel-replace of resting to newPrice / newQuantity (the new open size)
+    virtual RiskReject checkAmend(const core::Order& resting, core::Price newPrice, core::Quantity newQuantity,
+                                  core::Timestamp arrival) noexcept = 0;
+
+    // Exposure changes, in the order the engine makes them, each for the
+    // account of the order concerned (core::Order::account)
+    virtual void onRested(std::uint32_t account, core::Side side, core::Quantity quantity) noexcept = 0;
+    // Resting order cancelled or pulled by an amend, with its open quantity
+    virtual void onRemoved(std::uint32_t account, core::Side side, core::Quantity quantity) noexcept = 0;
+    // Resting order shrunk in place by quantity
+    virtual void onReduced(std::uint32_t account, core::Side side, core::Quantity quantity) noexcept = 0;
+    // One fill of an order; maker fills leave the book, filled true when
+    // the maker has nothing left
+    virtual void onFill(std::uint32_t account, core::Side side, core::Price price, core::Quantity quantity,
+                        bool maker, bool filled) noexcept = 0;
+
+    // Snapshot: the per-account state open orders do not rebuild, and the
+    // collar reference. load() runs before any check, in recovery.
+    virtual void copyTo(std::vector<book::SnapshotAccount>& out, core::Price& reference) const = 0;
+    virtual void load(const book::SnapshotAccount* accounts, std::size_t count, core::Price reference) noexcept = 0;
+};
+
+} // namespace ob::risk
@@ -0,0 +1,122 @@
+#pragma once
+
+#include "orderbook/core/constants.hpp"
+#include "orderbook/core/metrics.hpp"
+#include "orderbook/core/types.hpp"
+#include "orderbook/risk/i_risk_check.hpp"
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ob::risk {
+
+// Limits of a PreTradeRisk stage; 0 disables a check
+struct RiskLimits {
+    core::Quantity maxOrderQuantity{0};
+    std::int64_t maxOrderNotional{0};      // price x quantity, ticks x lots (market orders: reference price)
+    std::uint32_t priceCollarBps{0};       // limit price within this many basis points of the reference
+    std::uint32_t maxOpenOrders{0};        // resting orders per account
+    core::Quantity maxPosition{0};         // |filled position + open orders on the order's side + the order|
+    std::uint32_t maxMessages{0};          // new orders and amends per account per rateWindow
+    std::chrono::nanoseconds rateWindow{std::chrono::seconds{1}};
+    std::size_t maxAccounts{core::DEFAULT_RISK_ACCOUNTS}; // accounts tracked per instrument
+
+    bool enabled() const noexcept {
+        return maxOrderQuantity != 0 || maxOrderNotional != 0 || priceCollarBps != 0 || maxOpenOrders != 0 ||
+               maxPosition != 0 || maxMessages != 0;
+    }
+};
+
+// Per-instrument pre-trade checks, run inline on the instrument's matching
+// (or shard) thread.
+//
+// An order's account is core::Order::account: the one its connection named
+// at logon, so it outlives the connection, and 0, shared, for connections
+// that named none and for the in-process API.
+//
+// Account state lives in one flat open-addressed table sized at
+// construction: a lookup is a multiplicative hash and a short linear probe
+// over 64-byte slots, and nothing is allocated afterwards. At most
+// maxAccounts accounts are tracked at once. When a new one finds the table
+// full, the slots of idle accounts (no open orders, no position, no rate
+// window still running) are given back first; with none idle the order is
+// refused (Accounts).
+//
+// The collar reference is the last trade price, or the instrument's
+// reference price until the first trade. A snapshot carries it with the
+// positions and rate windows, so a restore resumes where the cut left off.
+// Matching thread only, except rejects(), which any thread may read.
+class PreTradeRisk final : public IRiskCheck {
+public:
+    PreTradeRisk(const RiskLimits& limits, core::Price referencePrice);
+
+    RiskReject checkOrder(const core::Order& order, core::Timestamp arrival) noexcept override;
+    RiskReject checkAmend(const core::Order& resting, core::Price newPrice, core::Quantity newQuantity,
+                          core::Timestamp arrival) noexcept override;
+
+    void onRested(std::uint32_t account, core::Side side, core::Quantity quantity) noexcept override;
+    void onRemoved(std::uint32_t account, core::Side side, core::Quantity quantity) noexcept override;
+    void onReduced(std::uint32_t account, core::Side side, core::Quantity quantity) noexcept override;
+    void onFill(std::uint32_t account, core::Side side, core::Price price, core::Quantity quantity,
+                bool maker, bool filled) noexcept override;
+    void copyTo(std::vector<book::SnapshotAccount>& out, core::Price& reference) const override;
+    void load(const book::SnapshotAccount* accounts, std::size_t count, core::Price reference) noexcept override;
+
+    const RiskLimits& limits() const noexcept { return limits_; }
+    // Per-instrument exposure of one account, for inspection
+    struct Exposure {
+        core::Quantity position{0};  // bought minus sold
+        core::Quantity openBuy{0};   // resting buy quantity
+        core::Quantity openSell{0};
+        std::uint32_t openOrders{0};
+    };
+    Exposure exposure(std::uint32_t account) const noexcept;
+    // Any thread: refusals since start, by reason
+    std::uint64_t rejects(RiskReject reason) const noexcept {
+        return rejects_.counts[static_cast<std::size_t>(reason)].load();
+    }
+    std::uint64_t rejects() const noexcept;
+
+private:
+    struct alignas(64) Account {
+        std::uint32_t key{0};           // account + 1; 0 = free slot
+        std::uint32_t openOrders{0};
+        std::uint32_t windowMessages{0};
+        core::Quantity position{0};
+        core::Quantity openBuy{0};
+        core::Quantity openSell{0};
+        std::int64_t windowStart{0};    // ns, arrival time of the window's first message
+    };
+
+    // Index of key's slot, or of the free slot ending its probe
+    std::size_t slot(std::uint32_t key) const noexcept;
+    // State of account, claiming a slot if absent and claim is set; null
+    // when absent and not claimed, or when maxAccounts busy accounts are
+    // tracked already
+    Account* find(std::uint32_t account, bool claim) noexcept;
+    bool idle(const Account& account) const noexcept;
+    // The account's rate window has nothing left to count at now
+    bool windowOver(const Account& account, std::int64_t now) const noexcept;
+    // Frees every idle account's slot; false if none was
+    bool reclaim() noexcept;
+    void erase(std::size_t index) noexcept;
+    RiskReject reject(RiskReject reason) noexcept;
+    RiskReject checkPrice(core::Price price, core::Quantity quantity, core::OrderType type) const noexcept;
+    bool withinPosition(const Account& account, core::Side side, core::Quantity quantity) const noexcept;
+    // Counts a message against the account's window; true if over the limit
+    bool throttled(Account& account, core::Timestamp arrival) noexcept;
+
+    RiskLimits limits_;
+    core::Price reference_;
+    std::int64_t now_{0}; // ns, arrival time of the last order or amend checked
+    std::vector<Account> accounts_; // power of two, kept at most 3/4 full so probes stay short
+    std::size_t mask_{0};
+    std::size_t used_{0};
+    struct alignas(64) Rejects {
+        std::array<core::Counter, RISK_REJECT_REASONS> counts;
+    } rejects_;
+};
+
+} // namespace ob::risk
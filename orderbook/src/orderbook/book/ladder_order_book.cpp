@@ -0,0 +1,419 @@
+#include "orderbook/book/ladder_order_book.hpp"
+#include "orderbook/core/async_log.hpp"
+#include "orderbook/core/types.hpp"
+
+#include <algorithm>
+
+namespace ob::book {
+
+namespace {
+
+core::Price ladderBase(core::Price referencePrice, std::size_t numLevels) {
+    // Keep the window on strictly positive prices; limit prices are always > 0
+    const auto half = static_cast<core::Price>(numLevels / 2);
+    return std::max<core::Price>(1, referencePrice - half);
+}
+
+} // namespace
+
+LadderOrderBook::LadderOrderBook(core::Price referencePrice, std::size_t numLevels)
+    : numLevels_(std::max<std::size_t>(numLevels, 1)),
+      base_(ladderBase(referencePrice, numLevels_)),
+      bidLevels_(numLevels_),
+      askLevels_(numLevels_) {}
+
+bool LadderOrderBook::addOrder(core::Order order) {
+    // Validate LIMIT order price must be positive
+    // Note: Market orders should not reach here (they're consumed immediately)
+    if (order.type == core::OrderType::Limit && order.price <= 0) {
+        OB_LOG("REJECT id={} invalid price={}", order.orderId, order.price);
+        return false;
+    }
+
+    // Validate quantity
+    if (order.quantity <= 0) {
+        OB_LOG("REJECT id={} invalid quantity={}", order.orderId, order.quantity);
+        return false;
+    }
+
+    const auto price = order.price;
+    const auto side = order.side;
+    const auto orderId = order.orderId;
+
+    if (locators_.find(orderId) != NULL_HANDLE) {
+        OB_LOG("REJECT id={} duplicate order id", orderId);
+        return false;
+    }
+
+    Level* level = &levelFor(side, price);
+    touch(*level);
+    const OrderHandle h = pool_.acquire(order, level);
+    pool_.pushBack(*level, h);
+    locators_.insert(orderId, h);
+    OB_LOG("ADD id={} side={} price={} qty={}", orderId, (side == core::Side::Buy ? 'B' : 'S'), price,
+           pool_[h].quantity);
+    return true;
+}
+
+bool LadderOrderBook::cancelOrder(core::OrderId id) {
+    const OrderHandle h = locators_.find(id);
+    if (h == NULL_HANDLE) return false;
+    locators_.erase(id);
+
+    const auto& info = pool_.info(h);
+    Level& level = *info.level;
+    const auto side = info.side;
+    const auto price = pool_[h].price;
+    OB_LOG("CANCEL id={}", id);
+    touch(level);
+    pool_.erase(level, h);
+    pool_.release(h);
+    removeLevelIfEmpty(side, price);
+    return true;
+}
+
+bool LadderOrderBook::reduceOrder(core::OrderId id, core::Quantity newQuantity) {
+    const OrderHandle h = locators_.find(id);
+    if (h == NULL_HANDLE) return false;
+    if (newQuantity <= 0 || newQuantity >= pool_[h].quantity) return false;
+    OB_LOG("REDUCE id={} qty={}->{}", id, pool_[h].quantity, newQuantity);
+    touch(*pool_.info(h).level);
+    pool_.reduce(h, newQuantity);
+    return true;
+}
+
+std::optional<core::Order> LadderOrderBook::findOrder(core::OrderId id) const {
+    const OrderHandle h = locators_.find(id);
+    if (h == NULL_HANDLE) return std::nullopt;
+    return pool_.toOrder(h, 0);
+}
+
+void LadderOrderBook::eraseFrontAtLevel(core::Side side, core::Price price, core::OrderId expectedId) {
+    Level* level = findLevel(side, price);
+    if (!level) return;
+    if (!level->empty() && pool_.front(*level).orderId == expectedId) {
+        popFront(side, *level);
+    }
+}
+
+void LadderOrderBook::popFront(core::Side side, PriceLevel& level) {
+    touch(level);
+    const OrderHandle h = level.head;
+    const auto& node = pool_[h];
+    const auto orderId = node.orderId;
+    const auto price = node.price;
+    locators_.erase(orderId);
+    pool_.erase(level, h);
+    pool_.release(h);
+    OB_LOG("ERASE_FRONT id={} price={}", orderId, price);
+    removeLevelIfEmpty(side, price);
+}
+
+std::optional<core::Price> LadderOrderBook::findBestBid() const noexcept {
+    std::optional<core::Price> best;
+    if (bestBidIdx_ != NO_LEVEL) best = priceAt(bestBidIdx_);
+    if (!farBids_.empty() && (!best || farBids_.begin()->first > *best)) best = farBids_.begin()->first;
+    return best;
+}
+
+std::optional<core::Price> LadderOrderBook::findBestAsk() const noexcept {
+    std::optional<core::Price> best;
+    if (bestAskIdx_ != NO_LEVEL) best = priceAt(bestAskIdx_);
+    if (!farAsks_.empty() && (!best || farAsks_.begin()->first < *best)) best = farAsks_.begin()->first;
+    return best;
+}
+
+std::vector<LevelSummary> LadderOrderBook::snapshotBidsL2(std::size_t depth) const {
+    const std::size_t levels = activeBidLevels_ + farBids_.size();
+    std::vector<LevelSummary> out(depth == 0 ? levels : std::min(depth, levels));
+    out.resize(copyBids(out.data(), out.size()));
+    return out;
+}
+
+std::vector<LevelSummary> LadderOrderBook::snapshotAsksL2(std::size_t depth) const {
+    const std::size_t levels = activeAskLevels_ + farAsks_.size();
+    std::vector<LevelSummary> out(depth == 0 ? levels : std::min(depth, levels));
+    out.resize(copyAsks(out.data(), out.size()));
+    return out;
+}
+
+std::size_t LadderOrderBook::copyBids(LevelSummary* out, std::size_t maxLevels) const noexcept {
+    std::size_t count = 0;
+    auto emit = [&](core::Price price, const Level& level) {
+        out[count++] = LevelSummary{price, level.totalQuantity, level.orderCount};
+        return count < maxLevels;
+    };
+    if (maxLevels == 0) return 0;
+
+    // Far levels above the window, then the window top-down, then far levels below
+    auto farIt = farBids_.begin();
+    for (; farIt != farBids_.end() && farIt->first > maxLadderPrice(); ++farIt) {
+        if (!emit(farIt->first, farIt->second)) return count;
+    }
+    // Stops at the last active window level rather than scanning the empty
+    // tail below it
+    std::size_t windowLevels = 0;
+    for (std::ptrdiff_t idx = bestBidIdx_; idx >= 0 && windowLevels < activeBidLevels_; --idx) {
+        const auto& level = bidLevels_[static_cast<std::size_t>(idx)];
+        if (level.empty()) continue;
+        ++windowLevels;
+        if (!emit(priceAt(idx), level)) return count;
+    }
+    for (; farIt != farBids_.end(); ++farIt) {
+        if (!emit(farIt->first, farIt->second)) return count;
+    }
+    return count;
+}
+
+std::size_t LadderOrderBook::copyAsks(LevelSummary* out, std::size_t maxLevels) const noexcept {
+    std::size_t count = 0;
+    auto emit = [&](core::Price price, const Level& level) {
+        out[count++] = LevelSummary{price, level.totalQuantity, level.orderCount};
+        return count < maxLevels;
+    };
+    if (maxLevels == 0) return 0;
+
+    // Far levels below the window, then the window bottom-up, then far levels above
+    auto farIt = farAsks_.begin();
+    for (; farIt != farAsks_.end() && farIt->first < base_; ++farIt) {
+        if (!emit(farIt->first, farIt->second)) return count;
+    }
+    if (bestAskIdx_ != NO_LEVEL) {
+        std::size_t windowLevels = 0;
+        for (auto idx = static_cast<std::size_t>(bestAskIdx_); idx < numLevels_ && windowLevels < activeAskLevels_; ++idx) {
+            const auto& level = askLevels_[idx];
+            if (level.empty()) continue;
+            ++windowLevels;
+            if (!emit(priceAt(static_cast<std::ptrdiff_t>(idx)), level)) return count;
+        }
+    }
+    for (; farIt != farAsks_.end(); ++farIt) {
+        if (!emit(farIt->first, farIt->second)) return count;
+    }
+    return count;
+}
+
+void LadderOrderBook::beginSnapshot(std::vector<SnapshotOrder>& out) {
+    capture_.begin(out, pool_.inUse());
+    cursorPhase_ = CursorPhase::BidWindow;
+    cursorIndex_ = 0;
+    cursorStarted_ = false;
+}
+
+bool LadderOrderBook::snapshotStep(std::size_t budget) {
+    if (!capture_.active()) return true;
+    std::size_t visited = 0;
+    // Levels count one each, so empty stretches of the window still end a step
+    auto sweepWindow = [&](std::vector<Level>& levels) {
+        for (; cursorIndex_ < levels.size(); ++cursorIndex_) {
+            if (visited >= budget) return false;
+            visited += capture_.visit(pool_, levels[cursorIndex_]) + 1;
+        }
+        cursorIndex_ = 0;
+        return true;
+    };
+    auto sweepFar = [&](auto& levels) {
+        auto it = cursorStarted_ ? levels.upper_bound(cursorPrice_) : levels.begin();
+        for (; it != levels.end(); ++it) {
+            if (visited >= budget) return false;
+            visited += capture_.visit(pool_, it->second) + 1;
+            cursorPrice_ = it->first;
+            cursorStarted_ = true;
+        }
+        cursorStarted_ = false;
+        return true;
+    };
+    switch (cursorPhase_) {
+        case CursorPhase::BidWindow:
+            if (!sweepWindow(bidLevels_)) return false;
+            cursorPhase_ = CursorPhase::AskWindow;
+            [[fallthrough]];
+        case CursorPhase::AskWindow:
+            if (!sweepWindow(askLevels_)) return false;
+            cursorPhase_ = CursorPhase::FarBids;
+            [[fallthrough]];
+        case CursorPhase::FarBids:
+            if (!sweepFar(farBids_)) return false;
+            cursorPhase_ = CursorPhase::FarAsks;
+            [[fallthrough]];
+        case CursorPhase::FarAsks:
+            if (!sweepFar(farAsks_)) return false;
+            break;
+    }
+    capture_.finish();
+    return true;
+}
+
+void LadderOrderBook::prewarm(std::size_t orders, const core::MemoryConfig& memory) {
+    pool_.prewarm(orders, memory);
+    locators_.prewarm(pool_.inUse() + orders, memory);
+    // The ladder is allocated with the book; this only advises and locks it
+    core::adviseMemory(bidLevels_.data(), bidLevels_.size() * sizeof(Level), memory);
+    core::adviseMemory(askLevels_.data(), askLevels_.size() * sizeof(Level), memory);
+    // Erased far-level nodes stay pooled in farResource_
+    if (!farBids_.empty() || !farAsks_.empty()) return;
+    for (std::size_t i = 1; i <= core::PREWARM_LEVELS; ++i) {
+        farBids_.try_emplace(static_cast<core::Price>(i));
+        farAsks_.try_emplace(static_cast<core::Price>(i));
+    }
+    farBids_.clear();
+    farAsks_.clear();
+}
+
+bool LadderOrderBook::loadSnapshot(const SnapshotOrder* orders, std::size_t count) {
+    if (pool_.inUse() != 0) return false;
+    pool_.reserve(count);
+    locators_.reserve(count);
+    Level* level = nullptr;
+    for (std::size_t i = 0; i < count; ++i) {
+        const SnapshotOrder& order = orders[i];
+        // One level lookup per run of orders at the same price
+        if (!level || order.price != orders[i - 1].price || order.side != orders[i - 1].side) {
+            level = &levelFor(order.side, order.price);
+        }
+        const OrderHandle h = pool_.acquire(toOrder(order), level);
+        if (!locators_.insert(order.orderId, h)) {
+            OB_LOG("SNAPSHOT skip id={} duplicate order id", order.orderId);
+            pool_.release(h);
+            removeLevelIfEmpty(order.side, order.price);
+            level = nullptr;
+            continue;
+        }
+        pool_.pushBack(*level, h);
+    }
+    return true;
+}
+
+core::Quantity LadderOrderBook::availableQuantity(core::Side side, core::Price limit,
+                                                  core::Quantity wanted) const noexcept {
+    core::Quantity total = 0;
+    // Same walk as copyBids/copyAsks, ending at the limit or once enough is found
+    auto take = [&](core::Price price, const Level& level) {
+        const bool reachable = side == core::Side::Buy ? price >= limit : price <= limit;
+        if (!reachable) return false;
+        total += level.totalQuantity;
+        return total < wanted;
+    };
+    if (side == core::Side::Buy) {
+        auto farIt = farBids_.begin();
+        for (; farIt != farBids_.end() && farIt->first > maxLadderPrice(); ++farIt) {
+            if (!take(farIt->first, farIt->second)) return total;
+        }
+        std::size_t windowLevels = 0;
+        for (std::ptrdiff_t idx = bestBidIdx_; idx >= 0 && windowLevels < activeBidLevels_; --idx) {
+            const auto& level = bidLevels_[static_cast<std::size_t>(idx)];
+            if (level.empty()) continue;
+            ++windowLevels;
+            if (!take(priceAt(idx), level)) return total;
+        }
+        for (; farIt != farBids_.end(); ++farIt) {
+            if (!take(farIt->first, farIt->second)) return total;
+        }
+        return total;
+    }
+    auto farIt = farAsks_.begin();
+    for (; farIt != farAsks_.end() && farIt->first < base_; ++farIt) {
+        if (!take(farIt->first, farIt->second)) return total;
+    }
+    if (bestAskIdx_ != NO_LEVEL) {
+        std::size_t windowLevels = 0;
+        for (auto idx = static_cast<std::size_t>(bestAskIdx_); idx < numLevels_ && windowLevels < activeAskLevels_; ++idx) {
+            const auto& level = askLevels_[idx];
+            if (level.empty()) continue;
+            ++windowLevels;
+            if (!take(priceAt(static_cast<std::ptrdiff_t>(idx)), level)) return total;
+        }
+    }
+    for (; farIt != farAsks_.end(); ++farIt) {
+        if (!take(farIt->first, farIt->second)) return total;
+    }
+    return total;
+}
+
+PriceLevel* LadderOrderBook::bestLevel(core::Side side) noexcept {
+    if (side == core::Side::Buy) {
+        Level* best = bestBidIdx_ != NO_LEVEL ? &bidLevels_[static_cast<std::size_t>(bestBidIdx_)] : nullptr;
+        if (!farBids_.empty() && (!best || farBids_.begin()->first > priceAt(bestBidIdx_))) {
+            best = &farBids_.begin()->second;
+        }
+        return best;
+    }
+    Level* best = bestAskIdx_ != NO_LEVEL ? &askLevels_[static_cast<std::size_t>(bestAskIdx_)] : nullptr;
+    if (!farAsks_.empty() && (!best || farAsks_.begin()->first < priceAt(bestAskIdx_))) {
+        best = &farAsks_.begin()->second;
+    }
+    return best;
+}
+
+LadderOrderBook::Level* LadderOrderBook::findLevel(core::Side side, core::Price price) noexcept {
+    if (inLadder(price)) {
+        auto& levels = (side == core::Side::Buy) ? bidLevels_ : askLevels_;
+        return &levels[static_cast<std::size_t>(indexOf(price))];
+    }
+    if (side == core::Side::Buy) {
+        auto it = farBids_.find(price);
+        return it == farBids_.end() ? nullptr : &it->second;
+    }
+    auto it = farAsks_.find(price);
+    return it == farAsks_.end() ? nullptr : &it->second;
+}
+
+LadderOrderBook::Level& LadderOrderBook::levelFor(core::Side side, core::Price price) {
+    if (!inLadder(price)) {
+        return side == core::Side::Buy ? farBids_[price] : farAsks_[price];
+    }
+    const auto idx = indexOf(price);
+    if (side == core::Side::Buy) {
+        Level& level = bidLevels_[static_cast<std::size_t>(idx)];
+        if (level.empty()) ++activeBidLevels_;
+        if (idx > bestBidIdx_) bestBidIdx_ = idx;
+        return level;
+    }
+    Level& level = askLevels_[static_cast<std::size_t>(idx)];
+    if (level.empty()) ++activeAskLevels_;
+    if (bestAskIdx_ == NO_LEVEL || idx < bestAskIdx_) bestAskIdx_ = idx;
+    return level;
+}
+
+void LadderOrderBook::removeLevelIfEmpty(core::Side side, core::Price price) {
+    if (!inLadder(price)) {
+        if (side == core::Side::Buy) {
+            auto it = farBids_.find(price);
+            if (it != farBids_.end() && it->second.empty()) farBids_.erase(it);
+        } else {
+            auto it = farAsks_.find(price);
+            if (it != farAsks_.end() && it->second.empty()) farAsks_.erase(it);
+        }
+        return;
+    }
+
+    const auto idx = indexOf(price);
+    if (side == core::Side::Buy) {
+        if (!bidLevels_[static_cast<std::size_t>(idx)].empty()) return;
+        --activeBidLevels_;
+        if (idx == bestBidIdx_) refreshBestBid();
+    } else {
+        if (!askLevels_[static_cast<std::size_t>(idx)].empty()) return;
+        --activeAskLevels_;
+        if (idx == bestAskIdx_) refreshBestAsk();
+    }
+}
+
+void LadderOrderBook::refreshBestBid() noexcept {
+    if (activeBidLevels_ == 0) {
+        bestBidIdx_ = NO_LEVEL;
+        return;
+    }
+    while (bestBidIdx_ >= 0 && bidLevels_[static_cast<std::size_t>(bestBidIdx_)].empty()) --bestBidIdx_;
+}
+
+void LadderOrderBook::refreshBestAsk() noexcept {
+    if (activeAskLevels_ == 0) {
+        bestAskIdx_ = NO_LEVEL;
+        return;
+    }
+    const auto last = static_cast<std::ptrdiff_t>(numLevels_);
+    while (bestAskIdx_ < last && askLevels_[static_cast<std::size_t>(bestAskIdx_)].empty()) ++bestAskIdx_;
+}
+
+} // namespace ob::book
@@ -1,5 +1,5 @@
 #include "orderbook/book/order_book.hpp"
-#include "orderbook/core/log.hpp"
+#include "orderbook/core/async_log.hpp"
 #include "orderbook/core/types.hpp"
 
 #include <algorithm>
@@ -10,94 +10,98 @@ bool OrderBook::addOrder(core::Order order) {
     // Validate LIMIT order price must be positive
     // Note: Market orders should not reach here (they're consumed immediately)
     if (order.type == core::OrderType::Limit && order.price <= 0) {
-        OB_LOG("REJECT id=" << order.orderId << " invalid price=" << order.price);
+        OB_LOG("REJECT id={} invalid price={}", order.orderId, order.price);
         return false;
     }
     
     // Validate quantity
     if (order.quantity <= 0) {
-        OB_LOG("REJECT id=" << order.orderId << " invalid quantity=" << order.quantity);
+        OB_LOG("REJECT id={} invalid quantity={}", order.orderId, order.quantity);
         return false;
     }
     
-    // Optimized: Cache price and side to avoid repeated access, use emplace for locators
     const auto price = order.price;
     const auto side = order.side;
     const auto orderId = order.orderId;
     
-    if (side == core::Side::Buy) {
-        // Get or create deque for this price level
-        auto& q = bids_[price];
-        
-        // Emplace order and capture iterator efficiently
-        q.emplace_back(std::move(order));
-        auto orderIt = std::prev(q.end());
-        
-        // Use emplace (no hint needed for small maps) - more efficient than operator[]
-        locators_.emplace(orderId, OrderLocator{side, price, orderIt});
-        OB_LOG("ADD id=" << orderId << " side=B price=" << price << " qty=" << orderIt->quantity);
-    } else {
-        auto& q = asks_[price];
-        
-        q.emplace_back(std::move(order));
-        auto orderIt = std::prev(q.end());
-        
-        locators_.emplace(orderId, OrderLocator{side, price, orderIt});
-        OB_LOG("ADD id=" << orderId << " side=S price=" << price << " qty=" << orderIt->quantity);
+    if (locators_.find(orderId) != NULL_HANDLE) {
+        OB_LOG("REJECT id={} duplicate order id", orderId);
+        return false;
     }
+    
+    // Get or create the level for this price
+    PriceLevel& level = (side == core::Side::Buy) ? bids_[price] : asks_[price];
+    touch(level);
+    const OrderHandle h = pool_.acquire(order, &level);
+    pool_.pushBack(level, h);
+    locators_.insert(orderId, h);
+    OB_LOG("ADD id={} side={} price={} qty={}", orderId, (side == core::Side::Buy ? 'B' : 'S'), price,
+           pool_[h].quantity);
     return true;
 }
 
 bool OrderBook::cancelOrder(core::OrderId id) {
-    auto locIt = locators_.find(id);
-    if (locIt == locators_.end()) return false;
+    const OrderHandle h = locators_.find(id);
+    if (h == NULL_HANDLE) return false;
+    locators_.erase(id);
     
-    // Copy the locator before erasing from map to avoid iterator invalidation issues
-    auto loc = locIt->second;
-    
-    // Erase from locators map first to avoid dangling references
-    locators_.erase(locIt);
-    
-    if (loc.side == core::Side::Buy) {
-        auto it = bids_.find(loc.price);
-        if (it == bids_.end()) return false;
-        auto& dq = it->second;
-        OB_LOG("CANCEL id=" << id);
-        dq.erase(loc.it);
-        if (dq.empty()) bids_.erase(it);
-    } else {
-        auto it = asks_.find(loc.price);
-        if (it == asks_.end()) return false;
-        auto& dq = it->second;
-        OB_LOG("CANCEL id=" << id);
-        dq.erase(loc.it);
-        if (dq.empty()) asks_.erase(it);
-    }
+    const auto& info = pool_.info(h);
+    PriceLevel& level = *info.level;
+    const auto side = info.side;
+    const auto price = pool_[h].price;
+    OB_LOG("CANCEL id={}", id);
+    touch(level);
+    pool_.erase(level, h);
+    pool_.release(h);
+    releaseLevelIfEmpty(side, price, level);
+    return true;
+}
+
+bool OrderBook::reduceOrder(core::OrderId id, core::Quantity newQuantity) {
+    const OrderHandle h = locators_.find(id);
+    if (h == NULL_HANDLE) return false;
+    if (newQuantity <= 0 || newQuantity >= pool_[h].quantity) return false;
+    OB_LOG("REDUCE id={} qty={}->{}", id, pool_[h].quantity, newQuantity);
+    touch(*pool_.info(h).level);
+    pool_.reduce(h, newQuantity);
     return true;
 }
 
+std::optional<core::Order> OrderBook::findOrder(core::OrderId id) const {
+    const OrderHandle h = locators_.find(id);
+    if (h == NULL_HANDLE) return std::nullopt;
+    return pool_.toOrder(h, 0);
+}
+
 void OrderBook::eraseFrontAtLevel(core::Side side, core::Price price, core::OrderId expectedId) {
+    PriceLevel* level = nullptr;
     if (side == core::Side::Buy) {
         auto it = bids_.find(price);
         if (it == bids_.end()) return;
-        auto& dq = it->second;
-        if (!dq.empty() && dq.front().orderId == expectedId) {
-            locators_.erase(expectedId);
-            dq.pop_front();
-            OB_LOG("ERASE_FRONT id=" << expectedId << " price=" << price);
-        }
+        level = &it->second;
     } else {
         auto it = asks_.find(price);
         if (it == asks_.end()) return;
-        auto& dq = it->second;
-        if (!dq.empty() && dq.front().orderId == expectedId) {
-            locators_.erase(expectedId);
-            dq.pop_front();
-            OB_LOG("ERASE_FRONT id=" << expectedId << " price=" << price);
-        }
+        level = &it->second;
+    }
+    if (!level->empty() && pool_.front(*level).orderId == expectedId) {
+        popFront(side, *level);
     }
 }
 
+void OrderBook::popFront(core::Side side, PriceLevel& level) {
+    touch(level);
+    const OrderHandle h = level.head;
+    const auto& node = pool_[h];
+    const auto orderId = node.orderId;
+    const auto price = node.price;
+    locators_.erase(orderId);
+    pool_.erase(level, h);
+    pool_.release(h);
+    OB_LOG("ERASE_FRONT id={} price={}", orderId, price);
+    releaseLevelIfEmpty(side, price, level);
+}
+
 std::optional<core::Price> OrderBook::findBestBid() const noexcept {
     if (bids_.empty()) return std::nullopt;
     return bids_.begin()->first;
@@ -109,44 +113,124 @@ std::optional<core::Price> OrderBook::findBestAsk() const noexcept {
 }
 
 std::vector<LevelSummary> OrderBook::snapshotBidsL2(std::size_t depth) const {
-    std::vector<LevelSummary> out;
-    out.reserve(depth == 0 ? bids_.size() : std::min(depth, bids_.size()));
-    std::size_t i = 0;
-    for (const auto& [price, dq] : bids_) {
-        core::Quantity total = 0;
-        for (const auto& o : dq) total += o.quantity;
-        out.push_back(LevelSummary{price, total, dq.size()});
-        if (depth && ++i >= depth) break;
-    }
+    std::vector<LevelSummary> out(depth == 0 ? bids_.size() : std::min(depth, bids_.size()));
+    out.resize(copyBids(out.data(), out.size()));
     return out;
 }
 
 std::vector<LevelSummary> OrderBook::snapshotAsksL2(std::size_t depth) const {
-    std::vector<LevelSummary> out;
-    out.reserve(depth == 0 ? asks_.size() : std::min(depth, asks_.size()));
-    std::size_t i = 0;
-    for (const auto& [price, dq] : asks_) {
-        core::Quantity total = 0;
-        for (const auto& o : dq) total += o.quantity;
-        out.push_back(LevelSummary{price, total, dq.size()});
-        if (depth && ++i >= depth) break;
-    }
+    std::vector<LevelSummary> out(depth == 0 ? asks_.size() : std::min(depth, asks_.size()));
+    out.resize(copyAsks(out.data(), out.size()));
     return out;
 }
 
-std::deque<core::Order>& OrderBook::bestQueue(core::Side side) {
+std::size_t OrderBook::copyBids(LevelSummary* out, std::size_t maxLevels) const noexcept {
+    std::size_t count = 0;
+    for (auto it = bids_.begin(); it != bids_.end() && count < maxLevels; ++it) {
+        out[count++] = LevelSummary{it->first, it->second.totalQuantity, it->second.orderCount};
+    }
+    return count;
+}
+
+std::size_t OrderBook::copyAsks(LevelSummary* out, std::size_t maxLevels) const noexcept {
+    std::size_t count = 0;
+    for (auto it = asks_.begin(); it != asks_.end() && count < maxLevels; ++it) {
+        out[count++] = LevelSummary{it->first, it->second.totalQuantity, it->second.orderCount};
+    }
+    return count;
+}
+
+core::Quantity OrderBook::availableQuantity(core::Side side, core::Price limit, core::Quantity wanted) const noexcept {
+    core::Quantity total = 0;
     if (side == core::Side::Buy) {
-        auto it = bids_.begin();
-        if (it == bids_.end()) throw std::out_of_range("no bid levels");
-        return it->second;
+        for (auto it = bids_.begin(); it != bids_.end() && it->first >= limit && total < wanted; ++it) {
+            total += it->second.totalQuantity;
+        }
     } else {
-        auto it = asks_.begin();
-        if (it == asks_.end()) throw std::out_of_range("no ask levels");
-        return it->second;
+        for (auto it = asks_.begin(); it != asks_.end() && it->first <= limit && total < wanted; ++it) {
+            total += it->second.totalQuantity;
+        }
+    }
+    return total;
+}
+
+void OrderBook::beginSnapshot(std::vector<SnapshotOrder>& out) {
+    capture_.begin(out, pool_.inUse());
+    cursorSide_ = core::Side::Buy;
+    cursorStarted_ = false;
+}
+
+bool OrderBook::snapshotStep(std::size_t budget) {
+    if (!capture_.active()) return true;
+    std::size_t visited = 0;
+    // Levels count one each, so empty stretches still end a step
+    auto sweep = [&](auto& levels) {
+        auto it = cursorStarted_ ? levels.upper_bound(cursorPrice_) : levels.begin();
+        for (; it != levels.end(); ++it) {
+            if (visited >= budget) return false;
+            visited += capture_.visit(pool_, it->second) + 1;
+            cursorPrice_ = it->first;
+            cursorStarted_ = true;
+        }
+        return true;
+    };
+    if (cursorSide_ == core::Side::Buy) {
+        if (!sweep(bids_)) return false;
+        cursorSide_ = core::Side::Sell;
+        cursorStarted_ = false;
+    }
+    if (!sweep(asks_)) return false;
+    capture_.finish();
+    return true;
+}
+
+void OrderBook::prewarm(std::size_t orders, const core::MemoryConfig& memory) {
+    pool_.prewarm(orders, memory);
+    locators_.prewarm(pool_.inUse() + orders, memory);
+    // Erased level nodes stay pooled in levelResource_, so creating and
+    // dropping a working set of levels leaves that many ready for use
+    if (!bids_.empty() || !asks_.empty()) return;
+    for (std::size_t i = 1; i <= core::PREWARM_LEVELS; ++i) {
+        bids_.try_emplace(static_cast<core::Price>(i));
+        asks_.try_emplace(static_cast<core::Price>(i));
+    }
+    bids_.clear();
+    asks_.clear();
+}
+
+bool OrderBook::loadSnapshot(const SnapshotOrder* orders, std::size_t count) {
+    if (pool_.inUse() != 0) return false;
+    pool_.reserve(count);
+    locators_.reserve(count);
+    PriceLevel* level = nullptr;
+    for (std::size_t i = 0; i < count; ++i) {
+        const SnapshotOrder& order = orders[i];
+        // One level lookup per run of orders at the same price
+        if (!level || order.price != orders[i - 1].price || order.side != orders[i - 1].side) {
+            level = order.side == core::Side::Buy ? &bids_.try_emplace(bids_.end(), order.price)->second
+                                                  : &asks_.try_emplace(asks_.end(), order.price)->second;
+        }
+        const OrderHandle h = pool_.acquire(toOrder(order), level);
+        if (!locators_.insert(order.orderId, h)) {
+            OB_LOG("SNAPSHOT skip id={} duplicate order id", order.orderId);
+            pool_.release(h);
+            releaseLevelIfEmpty(order.side, order.price, *level);
+            level = nullptr;
+            continue;
+        }
+        pool_.pushBack(*level, h);
     }
+    return true;
 }
 
-const std::deque<core::Order>* OrderBook::getQueueAt(core::Side side, core::Price price) const {
+PriceLevel* OrderBook::bestLevel(core::Side side) noexcept {
+    if (side == core::Side::Buy) {
+        return bids_.empty() ? nullptr : &bids_.begin()->second;
+    }
+    return asks_.empty() ? nullptr : &asks_.begin()->second;
+}
+
+const PriceLevel* OrderBook::getQueueAt(core::Side side, core::Price price) const {
     if (side == core::Side::Buy) {
         auto it = bids_.find(price);
         if (it == bids_.end()) return nullptr;
@@ -158,5 +242,14 @@ const std::deque<core::Order>* OrderBook::getQueueAt(core::Side side, core::Pric
     }
 }
 
+void OrderBook::releaseLevelIfEmpty(core::Side side, core::Price price, const PriceLevel& level) {
+    if (!level.empty()) return;
+    if (side == core::Side::Buy) {
+        bids_.erase(price);
+    } else {
+        asks_.erase(price);
+    }
+}
+
 } // namespace ob::book
 
@@ -0,0 +1,16 @@
+#include "orderbook/core/affinity.hpp"
+
+#include <pthread.h>
+#include <sched.h>
+
+namespace ob::core {
+
+bool pinCurrentThread(int cpu) noexcept {
+    if (cpu < 0) return true;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+}
+
+} // namespace ob::core
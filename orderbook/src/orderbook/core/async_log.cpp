@@ -0,0 +1,324 @@
+#include "orderbook/core/async_log.hpp"
+#include "orderbook/queue/spsc_queue.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace ob::core {
+
+namespace {
+
+constexpr std::size_t DRAIN_BATCH = 256;          // records taken from one ring per pass
+constexpr std::chrono::milliseconds IDLE_WAIT{1}; // writer sleep when every ring was empty
+
+static_assert(sizeof(LogSiteFrame) == 16);
+
+struct Ring {
+    explicit Ring(std::size_t capacity) : records(capacity) {}
+
+    queue::SpscRingBuffer<LogRecord> records;
+    std::atomic<std::uint64_t> dropped{0}; // stored by the owning thread only
+    std::atomic<bool> closed{false};       // owner exited: freed once drained
+    std::uint64_t reported{0};             // writer: drops already logged
+};
+
+class Logger {
+public:
+    Logger() {
+        droppedSite_ = registerSite(LogSite{"LOG dropped {} records on a full ring", 1, {LogArg::UInt}});
+        thread_ = std::thread([this] { run(); });
+    }
+
+    ~Logger() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        wake_.notify_one();
+        thread_.join();
+        if (file_) std::fclose(file_);
+    }
+
+    std::uint32_t registerSite(const LogSite& site) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        sites_.push_back(site);
+        return static_cast<std::uint32_t>(sites_.size() - 1);
+    }
+
+    Ring* addRing() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        rings_.push_back(std::make_unique<Ring>(DEFAULT_LOG_RING));
+        return rings_.back().get();
+    }
+
+    void open(const LogConfig& config) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        drainAll();
+        std::FILE* file = nullptr;
+        if (!config.binaryPath.empty()) {
+            file = std::fopen(config.binaryPath.c_str(), "wb");
+            if (!file) throw std::runtime_error("cannot open log file " + config.binaryPath);
+            const LogFileHeader header;
+            std::fwrite(&header, sizeof(header), 1, file);
+        }
+        if (file_) std::fclose(file_);
+        file_ = file;
+        siteWritten_.assign(sites_.size(), false);
+    }
+
+    void flush() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        drainAll();
+    }
+
+    std::uint64_t dropped() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::uint64_t total = droppedExited_;
+        for (const auto& ring : rings_) total += ring->dropped.load(std::memory_order_relaxed);
+        return total;
+    }
+
+private:
+    void run() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (!stopping_) {
+            if (!drain()) wake_.wait_for(lock, IDLE_WAIT);
+            if (stopping_) break;
+            // Let a thread registering a site or its ring in between passes
+            lock.unlock();
+            std::this_thread::yield();
+            lock.lock();
+        }
+        drainAll();
+    }
+
+    // Enough passes to empty every ring as it was on entry, fewer if they
+    // run dry; producers that keep logging cannot hold it here
+    void drainAll() {
+        for (std::size_t pass = 0; pass <= DEFAULT_LOG_RING / DRAIN_BATCH && drain(); ++pass) {
+        }
+    }
+
+    // One pass over every ring, at most DRAIN_BATCH records each, written
+    // out before returning; mutex_ held. True if anything was written.
+    bool drain() {
+        std::vector<LogRecord>& batch = batch_;
+        batch.resize(DRAIN_BATCH);
+        bool wrote = false;
+        for (auto it = rings_.begin(); it != rings_.end();) {
+            Ring& ring = **it;
+            const bool closed = ring.closed.load(std::memory_order_acquire); // before the pop: nothing follows it
+            const std::size_t n = ring.records.tryPopN(batch.data(), batch.size());
+            for (std::size_t i = 0; i < n; ++i) emit(batch[i]);
+            const std::uint64_t dropped = ring.dropped.load(std::memory_order_relaxed);
+            if (dropped != ring.reported) {
+                LogRecord record;
+                record.ts = nowNs();
+                record.site = droppedSite_;
+                record.args[0] = dropped - ring.reported;
+                emit(record);
+                ring.reported = dropped;
+            }
+            wrote = wrote || n != 0;
+            if (closed && n == 0) {
+                droppedExited_ += dropped;
+                it = rings_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        if (!out_.empty()) {
+            std::fwrite(out_.data(), 1, out_.size(), file_ ? file_ : stdout);
+            std::fflush(file_ ? file_ : stdout);
+            out_.clear();
+        }
+        return wrote;
+    }
+
+    void emit(const LogRecord& record) {
+        if (record.site >= sites_.size()) return;
+        const LogSite& site = sites_[record.site];
+        if (!file_) {
+            formatLogRecord(site, record, out_);
+            return;
+        }
+        if (siteWritten_.size() < sites_.size()) siteWritten_.resize(sites_.size(), false);
+        if (!siteWritten_[record.site]) {
+            LogSiteFrame frame;
+            frame.site = record.site;
+            frame.argc = site.argc;
+            frame.types = site.types;
+            frame.formatLength = static_cast<std::uint32_t>(std::char_traits<char>::length(site.format));
+            append(LOG_SITE_FRAME);
+            append(frame);
+            out_.append(site.format, frame.formatLength);
+            siteWritten_[record.site] = true;
+        }
+        append(LOG_RECORD_FRAME);
+        append(record);
+    }
+
+    template <typename T>
+    void append(const T& value) {
+        out_.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    bool stopping_{false};
+    std::vector<LogSite> sites_;
+    std::vector<std::unique_ptr<Ring>> rings_;
+    std::uint64_t droppedExited_{0};
+    std::uint32_t droppedSite_{0};
+    std::FILE* file_{nullptr};       // binary output; null = text on stdout
+    std::vector<bool> siteWritten_;  // site frames already in file_
+    std::vector<LogRecord> batch_;
+    std::string out_;                // one pass's output
+    std::thread thread_;             // last: started once the members above exist
+};
+
+Logger& logger() {
+    static Logger instance;
+    return instance;
+}
+
+// The calling thread's ring, handed back to the writer to drain and free on exit
+struct LocalRing {
+    Ring* ring{nullptr};
+
+    ~LocalRing() {
+        if (ring) ring->closed.store(true, std::memory_order_release);
+    }
+};
+
+thread_local LocalRing local;
+
+void appendArg(std::string& out, LogArg type, std::uint64_t bits) {
+    char buffer[32];
+    std::to_chars_result result{buffer, std::errc{}};
+    switch (type) {
+        case LogArg::Int:
+            result = std::to_chars(buffer, buffer + sizeof(buffer), static_cast<std::int64_t>(bits));
+            break;
+        case LogArg::UInt:
+            result = std::to_chars(buffer, buffer + sizeof(buffer), bits);
+            break;
+        case LogArg::Char:
+            out += static_cast<char>(bits);
+            return;
+        case LogArg::Double: {
+            double value;
+            std::memcpy(&value, &bits, sizeof(value));
+            result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+            break;
+        }
+    }
+    out.append(buffer, result.ptr);
+}
+
+template <typename T>
+bool readFrame(std::istream& in, T& value) {
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(value)));
+}
+
+} // namespace
+
+std::uint32_t AsyncLog::registerSite(const LogSite& site) {
+    return logger().registerSite(site);
+}
+
+void AsyncLog::write(const LogRecord& record) noexcept {
+    if (!local.ring) local.ring = logger().addRing();
+    Ring& ring = *local.ring;
+    if (!ring.records.tryPush(record)) {
+        ring.dropped.store(ring.dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+}
+
+void AsyncLog::open(const LogConfig& config) {
+    logger().open(config);
+}
+
+void AsyncLog::flush() {
+    logger().flush();
+}
+
+std::uint64_t AsyncLog::dropped() noexcept {
+    return logger().dropped();
+}
+
+void formatLogRecord(const LogSite& site, const LogRecord& record, std::string& out) {
+    char buffer[24];
+    out.append(buffer, std::to_chars(buffer, buffer + sizeof(buffer), record.ts).ptr);
+    out += " | ";
+    std::size_t arg = 0;
+    for (const char* p = site.format; *p != '\0'; ++p) {
+        if (p[0] == '{' && p[1] == '}' && arg < site.argc) {
+            appendArg(out, site.types[arg], record.args[arg]);
+            ++arg;
+            ++p;
+        } else {
+            out += *p;
+        }
+    }
+    out += '\n';
+}
+
+std::size_t decodeLogFile(const std::string& path, std::ostream& out) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) throw std::runtime_error("cannot open log file " + path);
+    LogFileHeader header;
+    if (!readFrame(in, header) || header.magic != LOG_FILE_MAGIC) {
+        throw std::runtime_error(path + " is not a binary log");
+    }
+
+    std::vector<std::string> formats; // owned by the sites below
+    std::vector<LogSite> sites;
+    std::vector<bool> known;
+    std::string line;
+    std::size_t records = 0;
+    std::uint32_t tag = 0;
+    while (readFrame(in, tag)) {
+        if (tag == LOG_SITE_FRAME) {
+            LogSiteFrame frame;
+            if (!readFrame(in, frame)) break;
+            std::string format(frame.formatLength, '\0');
+            if (!in.read(format.data(), static_cast<std::streamsize>(format.size()))) break;
+            if (frame.site >= sites.size()) {
+                sites.resize(frame.site + 1);
+                formats.resize(frame.site + 1);
+                known.resize(frame.site + 1, false);
+            }
+            formats[frame.site] = std::move(format);
+            sites[frame.site] = LogSite{nullptr, std::min(frame.argc, static_cast<std::uint8_t>(MAX_LOG_ARGS)), frame.types};
+            known[frame.site] = true;
+        } else if (tag == LOG_RECORD_FRAME) {
+            LogRecord record;
+            if (!readFrame(in, record)) break;
+            if (record.site >= sites.size() || !known[record.site]) {
+                throw std::runtime_error("log record of undefined site " + std::to_string(record.site));
+            }
+            LogSite site = sites[record.site];
+            site.format = formats[record.site].c_str();
+            line.clear();
+            formatLogRecord(site, record, line);
+            out << line;
+            ++records;
+        } else {
+            throw std::runtime_error("unknown log frame tag " + std::to_string(tag));
+        }
+    }
+    return records;
+}
+
+} // namespace ob::core
@@ -0,0 +1,151 @@
+#include "orderbook/core/latency_stats.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace ob::core {
+
+namespace {
+
+struct Recorder {
+    std::string name;
+    StageHistograms stages;
+    std::atomic<std::uint64_t> generation{0}; // reset generation the histograms belong to
+};
+
+class Registry {
+public:
+    Recorder* add() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto* recorder = new Recorder{};
+        recorder->name = "thread-" + std::to_string(nextThread_++);
+        recorder->generation.store(generation(), std::memory_order_relaxed);
+        live_.push_back(recorder);
+        return recorder;
+    }
+
+    // A thread is exiting: keep what it recorded, drop its recorder
+    void retire(Recorder* recorder) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (current(*recorder)) {
+            for (std::size_t i = 0; i < STAGE_COUNT; ++i) exited_[i].mergeShared(recorder->stages[i]);
+        }
+        live_.erase(std::remove(live_.begin(), live_.end(), recorder), live_.end());
+        delete recorder;
+    }
+
+    void rename(Recorder* recorder, std::string name) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        recorder->name = std::move(name);
+    }
+
+    void merged(StageHistograms& out) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        out = exited_;
+        for (const Recorder* recorder : live_) {
+            if (!current(*recorder)) continue;
+            for (std::size_t i = 0; i < STAGE_COUNT; ++i) out[i].mergeShared(recorder->stages[i]);
+        }
+    }
+
+    void perThread(const std::function<void(const std::string&, const StageHistograms&)>& fn) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto copy = std::make_unique<StageHistograms>(); // too large for a reactor's stack frame
+        for (const Recorder* recorder : live_) {
+            if (!current(*recorder)) continue;
+            for (std::size_t i = 0; i < STAGE_COUNT; ++i) {
+                (*copy)[i].reset();
+                (*copy)[i].mergeShared(recorder->stages[i]);
+            }
+            fn(recorder->name, *copy);
+        }
+        const bool anyExited = std::any_of(exited_.begin(), exited_.end(),
+                                           [](const LatencyHistogram& h) { return h.count() != 0; });
+        if (anyExited) fn("exited", exited_);
+    }
+
+    void reset() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& stage : exited_) stage.reset();
+        generation_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    std::uint64_t generation() const noexcept { return generation_.load(std::memory_order_relaxed); }
+
+private:
+    bool current(const Recorder& recorder) const noexcept {
+        return recorder.generation.load(std::memory_order_acquire) == generation();
+    }
+
+    std::mutex mutex_;
+    std::vector<Recorder*> live_;
+    StageHistograms exited_{};
+    std::uint64_t nextThread_{0};
+    std::atomic<std::uint64_t> generation_{0};
+};
+
+Registry& registry() {
+    static Registry instance;
+    return instance;
+}
+
+// The calling thread's recorder, folded into the registry's total on exit
+struct LocalRecorder {
+    Recorder* recorder{nullptr};
+
+    Recorder& get() {
+        if (!recorder) recorder = registry().add();
+        return *recorder;
+    }
+
+    ~LocalRecorder() {
+        if (recorder) registry().retire(recorder);
+    }
+};
+
+thread_local LocalRecorder local;
+
+} // namespace
+
+const char* stageName(Stage stage) noexcept {
+    switch (stage) {
+        case Stage::Parse:   return "parse";
+        case Stage::Enqueue: return "enqueue";
+        case Stage::Queue:   return "queue";
+        case Stage::Match:   return "match";
+        case Stage::Publish: return "publish";
+        case Stage::Send:    return "send";
+    }
+    return "unknown";
+}
+
+void LatencyStats::record(Stage stage, std::uint64_t ns) noexcept {
+    Recorder& recorder = local.get();
+    const std::uint64_t generation = registry().generation();
+    if (recorder.generation.load(std::memory_order_relaxed) != generation) {
+        for (auto& histogram : recorder.stages) histogram.resetShared();
+        recorder.generation.store(generation, std::memory_order_release); // after the zeroes
+    }
+    recorder.stages[static_cast<std::size_t>(stage)].recordShared(ns);
+}
+
+void LatencyStats::nameThread(std::string name) {
+    registry().rename(&local.get(), std::move(name));
+}
+
+void LatencyStats::merged(StageHistograms& out) {
+    registry().merged(out);
+}
+
+void LatencyStats::perThread(const std::function<void(const std::string&, const StageHistograms&)>& fn) {
+    registry().perThread(fn);
+}
+
+void LatencyStats::reset() noexcept {
+    registry().reset();
+}
+
+} // namespace ob::core
@@ -0,0 +1,125 @@
+#include "orderbook/core/memory.hpp"
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <new>
+
+#ifndef MAP_HUGE_SHIFT
+#define MAP_HUGE_SHIFT 26
+#endif
+#ifndef MAP_HUGE_2MB
+#define MAP_HUGE_2MB (21 << MAP_HUGE_SHIFT)
+#endif
+#ifndef MAP_HUGE_1GB
+#define MAP_HUGE_1GB (30 << MAP_HUGE_SHIFT)
+#endif
+
+namespace ob::core {
+
+namespace {
+
+struct Totals {
+    std::atomic<std::uint64_t> regions{0};
+    std::atomic<std::uint64_t> hugeBytes{0};
+    std::atomic<std::uint64_t> regularBytes{0};
+    std::atomic<std::uint64_t> hugeFallbacks{0};
+    std::atomic<std::uint64_t> lockedBytes{0};
+    std::atomic<std::uint64_t> lockFailures{0};
+};
+
+Totals& totals() noexcept {
+    static Totals instance;
+    return instance;
+}
+
+std::size_t roundUp(std::size_t bytes, std::size_t page) noexcept { return (bytes + page - 1) / page * page; }
+
+std::size_t regularPage() noexcept {
+    static const std::size_t size = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+    return size;
+}
+
+// Null if the system has no such pages to give
+void* mapHuge(std::size_t bytes, int sizeFlag, bool populate) noexcept {
+    const int flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | sizeFlag | (populate ? MAP_POPULATE : 0);
+    void* base = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, flags, -1, 0);
+    return base == MAP_FAILED ? nullptr : base;
+}
+
+void lockRange(void* base, std::size_t bytes) noexcept {
+    if (::mlock(base, bytes) == 0) {
+        totals().lockedBytes.fetch_add(bytes, std::memory_order_relaxed);
+    } else {
+        totals().lockFailures.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+} // namespace
+
+PageBlock allocatePages(std::size_t bytes, const MemoryConfig& config) {
+    bytes = bytes == 0 ? 1 : bytes;
+    totals().regions.fetch_add(1, std::memory_order_relaxed);
+    PageBlock block;
+    if (config.pageSize == PageSize::Huge1G && bytes >= HUGE_1G_MIN_REGION) {
+        block = {mapHuge(roundUp(bytes, HUGE_1G_BYTES), MAP_HUGE_1GB, config.prefault),
+                 roundUp(bytes, HUGE_1G_BYTES), PageSize::Huge1G};
+    }
+    if (!block.base && config.pageSize != PageSize::Regular) {
+        block = {mapHuge(roundUp(bytes, HUGE_2M_BYTES), MAP_HUGE_2MB, config.prefault),
+                 roundUp(bytes, HUGE_2M_BYTES), PageSize::Huge2M};
+    }
+
+    if (block.base) {
+        totals().hugeBytes.fetch_add(block.bytes, std::memory_order_relaxed);
+    } else {
+        // Regular pages, still marked for transparent huge pages if those were asked for
+        block = {nullptr, roundUp(bytes, regularPage()), PageSize::Regular};
+        const int flags = MAP_PRIVATE | MAP_ANONYMOUS | (config.prefault ? MAP_POPULATE : 0);
+        void* base = ::mmap(nullptr, block.bytes, PROT_READ | PROT_WRITE, flags, -1, 0);
+        if (base == MAP_FAILED) throw std::bad_alloc();
+        block.base = base;
+        if (config.pageSize != PageSize::Regular) {
+            ::madvise(block.base, block.bytes, MADV_HUGEPAGE);
+            totals().hugeFallbacks.fetch_add(1, std::memory_order_relaxed);
+        }
+        totals().regularBytes.fetch_add(block.bytes, std::memory_order_relaxed);
+    }
+    if (config.lock) lockRange(block.base, block.bytes);
+    return block;
+}
+
+void freePages(const PageBlock& block) noexcept {
+    if (block.base) ::munmap(block.base, block.bytes);
+}
+
+void adviseMemory(void* base, std::size_t bytes, const MemoryConfig& config) noexcept {
+    if (!base || bytes == 0 || config.plain()) return;
+    const auto begin = reinterpret_cast<std::uintptr_t>(base);
+    const auto end = begin + bytes;
+    if (config.pageSize != PageSize::Regular) {
+        const std::uintptr_t first = (begin + HUGE_2M_BYTES - 1) & ~(HUGE_2M_BYTES - 1);
+        const std::uintptr_t last = end & ~(HUGE_2M_BYTES - 1);
+        if (first < last) ::madvise(reinterpret_cast<void*>(first), last - first, MADV_HUGEPAGE);
+    }
+    if (config.lock) {
+        // mlock wants page granularity; the partial pages at either end are included
+        const std::uintptr_t first = begin & ~(regularPage() - 1);
+        lockRange(reinterpret_cast<void*>(first), end - first);
+    }
+}
+
+MemoryStats memoryStats() noexcept {
+    const Totals& t = totals();
+    MemoryStats stats;
+    stats.regions = t.regions.load(std::memory_order_relaxed);
+    stats.hugeBytes = t.hugeBytes.load(std::memory_order_relaxed);
+    stats.regularBytes = t.regularBytes.load(std::memory_order_relaxed);
+    stats.hugeFallbacks = t.hugeFallbacks.load(std::memory_order_relaxed);
+    stats.lockedBytes = t.lockedBytes.load(std::memory_order_relaxed);
+    stats.lockFailures = t.lockFailures.load(std::memory_order_relaxed);
+    return stats;
+}
+
+} // namespace ob::core
@@ -1,76 +1,164 @@
 #include "orderbook/engine/matching_engine.hpp"
 #include "orderbook/book/order_book.hpp"
-#include "orderbook/core/log.hpp"
+#include "orderbook/core/async_log.hpp"
 #include "orderbook/core/types.hpp"
 #include "orderbook/events/event_types.hpp"
 
 #include <algorithm>
 #include <chrono>
+#include <cstdint>
+#include <limits>
 #include <stdexcept>
+#include <type_traits>
 
 namespace ob::engine {
 
 MatchingEngine::MatchingEngine(
     std::shared_ptr<book::IOrderBook> orderBook,
-    std::shared_ptr<events::IEventPublisher> eventPublisher
-) : orderBook_(std::move(orderBook)), eventPublisher_(std::move(eventPublisher)) {}
+    std::shared_ptr<events::IEventPublisher> eventPublisher,
+    std::uint32_t symbolId,
+    std::shared_ptr<risk::IRiskCheck> risk,
+    std::shared_ptr<StopBook> stops
+) : orderBook_(std::move(orderBook)), eventPublisher_(std::move(eventPublisher)), symbolId_(symbolId),
+    risk_(std::move(risk)), stops_(stops ? std::move(stops) : std::make_shared<StopBook>()) {
+    mapBook_ = dynamic_cast<book::OrderBook*>(orderBook_.get());
+    if (!mapBook_) {
+        ladderBook_ = dynamic_cast<book::LadderOrderBook*>(orderBook_.get());
+    }
+    spscPublisher_ = dynamic_cast<events::SpscEventPublisher*>(eventPublisher_.get());
+}
 
-bool MatchingEngine::canMatch(core::Side takerSide, core::Price takerPrice, core::Price makerPrice, core::OrderType type) noexcept {
-    if (type == core::OrderType::Market) return true;
-    if (takerSide == core::Side::Buy) return takerPrice >= makerPrice;
-    return takerPrice <= makerPrice;
+// Positive quantity; a positive limit price for limit and stop-limit
+// orders and a positive stop price for stops; post-only only on limit
+// orders; and a book the sweep supports
+bool MatchingEngine::valid(const core::Order& order) const noexcept {
+    if (order.quantity <= 0 || (!mapBook_ && !ladderBook_)) return false;
+    if (static_cast<std::uint8_t>(order.type) > static_cast<std::uint8_t>(core::OrderType::StopLimit) ||
+        static_cast<std::uint8_t>(order.tif) > static_cast<std::uint8_t>(core::TimeInForce::PostOnly)) {
+        return false;
+    }
+    const bool limitPriced = order.type == core::OrderType::Limit || order.type == core::OrderType::StopLimit;
+    if (limitPriced && order.price <= 0) return false;
+    if (core::isStop(order.type) && order.stopPrice <= 0) return false;
+    return order.tif != core::TimeInForce::PostOnly || order.type == core::OrderType::Limit;
 }
 
-book::OrderBook* MatchingEngine::getConcreteBook() {
-    // We know it's OrderBook, but we need to cast to access internal methods
-    // In a production system, we might want to expose these methods through the interface
-    // or use a different design pattern
-    return static_cast<book::OrderBook*>(orderBook_.get());
+bool MatchingEngine::wouldCross(const core::Order& order) const noexcept {
+    if (order.side == core::Side::Buy) {
+        const auto ask = orderBook_->findBestAsk();
+        return ask && order.price >= *ask;
+    }
+    const auto bid = orderBook_->findBestBid();
+    return bid && order.price <= *bid;
+}
+
+template <core::Side TakerSide, bool Market, typename Book, typename Publisher>
+void MatchingEngine::sweep(Book& book, Publisher* publisher, core::Order& order, std::vector<core::Trade>* trades) {
+    constexpr core::Side contraSide = TakerSide == core::Side::Buy ? core::Side::Sell : core::Side::Buy;
+    while (order.quantity > 0) {
+        auto* level = book.bestLevel(contraSide);
+        if (!level) break;
+        const book::RestingOrder& maker = book.frontOrder(*level);
+        if constexpr (!Market) {
+            if constexpr (TakerSide == core::Side::Buy) {
+                if (order.price < maker.price) break;
+            } else {
+                if (order.price > maker.price) break;
+            }
+        }
+
+        const core::Quantity tradeQty = std::min(order.quantity, maker.quantity);
+        core::Trade t{maker.orderId, order.orderId, maker.price, tradeQty, order.ts};
+        if (trades) trades->push_back(t);
+        
+        // Publish trade event
+        if constexpr (!std::is_same_v<Publisher, NoPublisher>) {
+            publisher->publish(events::Event::makeTrade(t, symbolId_));
+        }
+        
+        book.reduceFront(*level, tradeQty); // keeps the level's running total in step
+        order.quantity -= tradeQty;
+        stops_->onTrade(t.price);
+        if (risk_) {
+            risk_->onFill(order.account, TakerSide, t.price, tradeQty, false, false);
+            risk_->onFill(book.frontAccount(*level), contraSide, t.price, tradeQty, true, maker.quantity == 0);
+        }
+        metrics_.trades.add();
+        metrics_.tradedQuantity.add(static_cast<std::uint64_t>(tradeQty));
+        OB_LOG("TRADE maker={} taker={} px={} qty={}", t.makerId, t.takerId, t.price, t.quantity);
+        if (maker.quantity == 0) {
+            // Also drops the level once its queue is empty
+            book.popFront(contraSide, *level);
+        }
+    }
+}
+
+template <typename Book, typename Publisher>
+void MatchingEngine::sweepAs(Book& book, Publisher* publisher, core::Order& order, std::vector<core::Trade>* trades) {
+    const bool market = order.type == core::OrderType::Market;
+    if (order.side == core::Side::Buy) {
+        market ? sweep<core::Side::Buy, true>(book, publisher, order, trades)
+               : sweep<core::Side::Buy, false>(book, publisher, order, trades);
+    } else {
+        market ? sweep<core::Side::Sell, true>(book, publisher, order, trades)
+               : sweep<core::Side::Sell, false>(book, publisher, order, trades);
+    }
+}
+
+void MatchingEngine::sweep(core::Order& order, std::vector<core::Trade>* trades) {
+    auto onBook = [&](auto& book) {
+        if (spscPublisher_) {
+            sweepAs(book, spscPublisher_, order, trades);
+        } else if (eventPublisher_) {
+            sweepAs(book, eventPublisher_.get(), order, trades);
+        } else {
+            sweepAs(book, static_cast<NoPublisher*>(nullptr), order, trades);
+        }
+    };
+    if (mapBook_) {
+        onBook(*mapBook_);
+    } else {
+        onBook(*ladderBook_);
+    }
 }
 
 std::vector<core::Trade> MatchingEngine::process(core::Order& order) {
     std::vector<core::Trade> trades;
+    process(order, &trades);
+    return trades;
+}
+
+void MatchingEngine::process(core::Order& order, std::vector<core::Trade>* trades) {
+    if (trades) trades->clear();
+    const core::Timestamp arrival = order.ts;
     auto now = std::chrono::steady_clock::now();
     auto nowNs = std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch());
     order.ts = core::Timestamp{nowNs};
     
-    // Validate order before processing
-    if (order.quantity <= 0) {
-        // Publish reject event for invalid quantity
-        if (eventPublisher_) {
-            events::Event rejectEvent;
-            rejectEvent.type = events::EventType::Reject;
-            rejectEvent.orderId = order.orderId;
-            rejectEvent.ts = order.ts;
-            eventPublisher_->publish(std::move(rejectEvent));
-        }
-        return trades;
+    if (!valid(order)) {
+        reject(order);
+        return;
     }
-    
-    // Validate LIMIT order price must be positive
-    if (order.type == core::OrderType::Limit && order.price <= 0) {
-        // Publish reject event for invalid price
-        if (eventPublisher_) {
-            events::Event rejectEvent;
-            rejectEvent.type = events::EventType::Reject;
-            rejectEvent.orderId = order.orderId;
-            rejectEvent.ts = order.ts;
-            eventPublisher_->publish(std::move(rejectEvent));
-        }
-        return trades;
+    // A stop reusing the id of one still waiting is refused in place of its Ack
+    if (core::isStop(order.type) && stops_->contains(order.orderId)) {
+        reject(order);
+        return;
     }
-    
-    auto* concreteBook = getConcreteBook();
-    if (!concreteBook) {
-        // Publish reject event
-        if (eventPublisher_) {
-            events::Event rejectEvent;
-            rejectEvent.type = events::EventType::Reject;
-            rejectEvent.orderId = order.orderId;
-            rejectEvent.ts = order.ts;
-            eventPublisher_->publish(std::move(rejectEvent));
+
+    // Pre-trade risk, by arrival time (unstamped orders count as arriving now)
+    if (risk_) {
+        const risk::RiskReject refused = risk_->checkOrder(order, arrival == core::Timestamp{} ? order.ts : arrival);
+        if (refused != risk::RiskReject::None) {
+            OB_LOG("RISK_REJECT id={} reason={}", order.orderId, static_cast<unsigned>(refused));
+            reject(order);
+            return;
         }
-        return trades;
+    }
+
+    if (order.tif == core::TimeInForce::PostOnly && wouldCross(order)) {
+        OB_LOG("POST_ONLY_REJECT id={} px={}", order.orderId, order.price);
+        reject(order);
+        return;
     }
 
     // Publish acknowledgment
@@ -79,96 +167,212 @@ std::vector<core::Trade> MatchingEngine::process(core::Order& order) {
         ackEvent.type = events::EventType::Ack;
         ackEvent.orderId = order.orderId;
         ackEvent.ts = order.ts;
+        ackEvent.symbolId = symbolId_;
         eventPublisher_->publish(std::move(ackEvent));
     }
 
-    if (order.side == core::Side::Buy) {
-        auto& contra = concreteBook->asks();
-        while (order.quantity > 0 && !contra.empty()) {
-            auto levelIt = contra.begin();
-            core::Price makerPrice = levelIt->first;
-            if (!canMatch(order.side, order.price, makerPrice, order.type)) break;
-            auto& dq = levelIt->second;
-            while (order.quantity > 0 && !dq.empty()) {
-                core::Order& maker = dq.front();
-                const core::Quantity tradeQty = std::min(order.quantity, maker.quantity);
-                core::Trade t{maker.orderId, order.orderId, maker.price, tradeQty, order.ts};
-                trades.push_back(t);
-                
-                // Publish trade event
-                if (eventPublisher_) {
-                    events::Event tradeEvent;
-                    tradeEvent.type = events::EventType::Trade;
-                    tradeEvent.orderId = order.orderId;
-                    tradeEvent.trade = t;
-                    tradeEvent.ts = order.ts;
-                    eventPublisher_->publish(std::move(tradeEvent));
-                }
-                
-                maker.quantity -= tradeQty;
-                order.quantity -= tradeQty;
-                OB_LOG("TRADE maker=" << t.makerId << " taker=" << t.takerId << " px=" << t.price << " qty=" << t.quantity);
-                if (maker.quantity == 0) {
-                    concreteBook->eraseFrontAtLevel(core::Side::Sell, maker.price, maker.orderId);
-                }
-            }
-            if (dq.empty()) contra.erase(levelIt);
-        }
-    } else {
-        auto& contra = concreteBook->bids();
-        while (order.quantity > 0 && !contra.empty()) {
-            auto levelIt = contra.begin();
-            core::Price makerPrice = levelIt->first;
-            if (!canMatch(order.side, order.price, makerPrice, order.type)) break;
-            auto& dq = levelIt->second;
-            while (order.quantity > 0 && !dq.empty()) {
-                core::Order& maker = dq.front();
-                const core::Quantity tradeQty = std::min(order.quantity, maker.quantity);
-                core::Trade t{maker.orderId, order.orderId, maker.price, tradeQty, order.ts};
-                trades.push_back(t);
-                
-                // Publish trade event
-                if (eventPublisher_) {
-                    events::Event tradeEvent;
-                    tradeEvent.type = events::EventType::Trade;
-                    tradeEvent.orderId = order.orderId;
-                    tradeEvent.trade = t;
-                    tradeEvent.ts = order.ts;
-                    eventPublisher_->publish(std::move(tradeEvent));
-                }
-                
-                maker.quantity -= tradeQty;
-                order.quantity -= tradeQty;
-                OB_LOG("TRADE maker=" << t.makerId << " taker=" << t.takerId << " px=" << t.price << " qty=" << t.quantity);
-                if (maker.quantity == 0) {
-                    concreteBook->eraseFrontAtLevel(core::Side::Buy, maker.price, maker.orderId);
-                }
-            }
-            if (dq.empty()) contra.erase(levelIt);
+    if (core::isStop(order.type)) {
+        // Waits for its trigger, which the last trade may have reached already
+        stops_->add(order);
+        triggerStops();
+        return;
+    }
+    execute(order, trades);
+    triggerStops();
+}
+
+void MatchingEngine::execute(core::Order& order, std::vector<core::Trade>* trades) {
+    if (order.tif == core::TimeInForce::FillOrKill) {
+        // Kill before any fill unless the reachable levels hold enough
+        const core::Price limit = order.type == core::OrderType::Market
+            ? (order.side == core::Side::Buy ? std::numeric_limits<core::Price>::max()
+                                             : std::numeric_limits<core::Price>::min())
+            : order.price;
+        const core::Side contraSide = (order.side == core::Side::Buy) ? core::Side::Sell : core::Side::Buy;
+        if (orderBook_->availableQuantity(contraSide, limit, order.quantity) < order.quantity) {
+            expire(order);
+            order.quantity = 0;
+            return;
         }
     }
 
+    sweep(order, trades);
+
+    if (order.quantity > 0 &&
+        (order.tif == core::TimeInForce::ImmediateOrCancel || order.tif == core::TimeInForce::FillOrKill)) {
+        expire(order);
+        order.quantity = 0;
+        return;
+    }
     // Market orders do not rest
     if (order.type == core::OrderType::Market) {
         order.quantity = 0;
-        return trades;
+        return;
     }
 
     if (order.quantity > 0 && order.type == core::OrderType::Limit) {
-        bool added = orderBook_->addOrder(std::move(order));
-        if (!added) {
-            // Order was rejected (e.g., invalid price), publish reject event
-            if (eventPublisher_) {
-                events::Event rejectEvent;
-                rejectEvent.type = events::EventType::Reject;
-                rejectEvent.orderId = order.orderId;
-                rejectEvent.ts = order.ts;
-                eventPublisher_->publish(std::move(rejectEvent));
-            }
+        if (!orderBook_->addOrder(order)) {
+            // Order was rejected (e.g., invalid price)
+            reject(order);
+        } else if (risk_) {
+            risk_->onRested(order.account, order.side, order.quantity);
         }
     }
+}
 
-    return trades;
+void MatchingEngine::triggerStops() {
+    while (stops_->triggered()) {
+        stops_->takeTriggered(triggered_);
+        for (core::Order& order : triggered_) {
+            OB_LOG("STOP_TRIGGER id={} stop={} last={}", order.orderId, order.stopPrice, stops_->lastTradePrice());
+            order.type = order.type == core::OrderType::Stop ? core::OrderType::Market : core::OrderType::Limit;
+            execute(order, nullptr);
+        }
+    }
+}
+
+void MatchingEngine::expire(const core::Order& order) {
+    OB_LOG("EXPIRE id={} qty={}", order.orderId, order.quantity);
+    publishStatus(events::EventType::CancelAck, order.orderId, order.ts);
+}
+
+void MatchingEngine::reject(const core::Order& order) {
+    metrics_.rejects.add();
+    publishStatus(events::EventType::Reject, order.orderId, order.ts);
+}
+
+bool MatchingEngine::cancel(core::OrderId orderId) {
+    auto nowNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch());
+    // The risk stage needs the open quantity the cancel releases
+    const auto resting = risk_ ? orderBook_->findOrder(orderId) : std::nullopt;
+    bool cancelled = orderBook_->cancelOrder(orderId);
+    if (cancelled && resting) risk_->onRemoved(resting->account, resting->side, resting->quantity);
+    if (!cancelled) cancelled = stops_->cancel(orderId); // a stop still waiting for its trigger
+    publishStatus(cancelled ? events::EventType::CancelAck : events::EventType::CancelReject,
+                  orderId, core::Timestamp{nowNs});
+    return cancelled;
+}
+
+bool MatchingEngine::amend(core::OrderId orderId, core::Price newPrice, core::Quantity newQuantity) {
+    return replace(orderId, newPrice, newQuantity, core::Timestamp{});
+}
+
+bool MatchingEngine::replace(core::OrderId orderId, core::Price newPrice, core::Quantity newQuantity,
+                             core::Timestamp arrival) {
+    auto nowNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch());
+    const core::Timestamp now{nowNs};
+
+    auto resting = orderBook_->findOrder(orderId);
+    if (!resting || newQuantity <= 0 || newPrice <= 0 || (!mapBook_ && !ladderBook_)) {
+        publishStatus(events::EventType::AmendReject, orderId, now);
+        return false;
+    }
+    if (risk_) {
+        const risk::RiskReject refused =
+            risk_->checkAmend(*resting, newPrice, newQuantity, arrival == core::Timestamp{} ? now : arrival);
+        if (refused != risk::RiskReject::None) {
+            OB_LOG("RISK_REJECT amend id={} reason={}", orderId, static_cast<unsigned>(refused));
+            metrics_.rejects.add();
+            publishStatus(events::EventType::AmendReject, orderId, now);
+            return false;
+        }
+    }
+
+    if (newPrice == resting->price && newQuantity <= resting->quantity) {
+        // Size-down (or no-op) in place: queue position is kept
+        if (newQuantity < resting->quantity) {
+            orderBook_->reduceOrder(orderId, newQuantity);
+            if (risk_) risk_->onReduced(resting->account, resting->side, resting->quantity - newQuantity);
+        }
+        publishStatus(events::EventType::AmendAck, orderId, now);
+        return true;
+    }
+
+    core::Order replacement = *resting;
+    replacement.price = newPrice;
+    replacement.quantity = newQuantity;
+    replacement.ts = now;
+    // A post-only order keeps its terms: refused, and left resting as it
+    // was, if the new price would trade, as it would be at entry
+    if (replacement.tif == core::TimeInForce::PostOnly && wouldCross(replacement)) {
+        OB_LOG("POST_ONLY_REJECT amend id={} px={}", orderId, newPrice);
+        metrics_.rejects.add();
+        publishStatus(events::EventType::AmendReject, orderId, now);
+        return false;
+    }
+
+    // Price change or size-up loses priority: pull the order and run it
+    // again as a fresh arrival, all on this thread so nothing interleaves
+    orderBook_->cancelOrder(orderId);
+    if (risk_) risk_->onRemoved(resting->account, resting->side, resting->quantity);
+    publishStatus(events::EventType::AmendAck, orderId, now);
+    execute(replacement, nullptr);
+    triggerStops();
+    return true;
+}
+
+void MatchingEngine::apply(const core::Command& command) {
+    imageDirty_ |= command.type != core::CommandType::Snapshot;
+    switch (command.type) {
+        case core::CommandType::NewOrder: {
+            metrics_.orders.add();
+            core::Order order = command.toOrder();
+            process(order, nullptr);
+            break;
+        }
+        case core::CommandType::Cancel:
+            metrics_.cancels.add();
+            cancel(command.orderId);
+            break;
+        case core::CommandType::Amend:
+            metrics_.amends.add();
+            replace(command.orderId, command.price, command.quantity, command.ts);
+            break;
+        case core::CommandType::Snapshot:
+            beginSnapshot();
+            break;
+    }
+}
+
+void MatchingEngine::beginSnapshot() {
+    book::BookSnapshot* target = snapshotRequest_.exchange(nullptr, std::memory_order_acq_rel);
+    if (!target) return;
+    continueSnapshot(SIZE_MAX); // one at a time: finish the previous capture first
+    stops_->copyTo(target->stops);
+    target->lastTradePrice = stops_->lastTradePrice();
+    if (risk_) risk_->copyTo(target->accounts, target->riskReference);
+    orderBook_->beginSnapshot(target->orders);
+    snapshot_ = target;
+}
+
+bool MatchingEngine::continueSnapshot(std::size_t budget) {
+    if (!snapshot_) return false;
+    if (!orderBook_->snapshotStep(budget)) return true;
+    snapshot_->complete.store(true, std::memory_order_release);
+    snapshot_ = nullptr;
+    return false;
+}
+
+void MatchingEngine::publishImage() {
+    if (!imageDirty_) return;
+    image_.publish(*orderBook_);
+    imageDirty_ = false;
+    metrics_.bidLevels.set(orderBook_->levelCount(core::Side::Buy));
+    metrics_.askLevels.set(orderBook_->levelCount(core::Side::Sell));
+    metrics_.restingOrders.set(orderBook_->orderCount());
+    metrics_.stopOrders.set(stops_->size());
+}
+
+void MatchingEngine::publishStatus(events::EventType type, core::OrderId orderId, core::Timestamp ts) {
+    if (!eventPublisher_) return;
+    events::Event event;
+    event.type = type;
+    event.orderId = orderId;
+    event.ts = ts;
+    event.symbolId = symbolId_;
+    eventPublisher_->publish(std::move(event));
 }
 
 } // namespace ob::engine
@@ -0,0 +1,91 @@
+#include "orderbook/engine/stop_book.hpp"
+
+#include <algorithm>
+
+namespace ob::engine {
+
+namespace {
+
+template <typename Map>
+bool eraseFrom(Map& levels, core::Price stopPrice, core::OrderId orderId, core::Order* removed) {
+    auto level = levels.find(stopPrice);
+    if (level == levels.end()) return false;
+    auto& orders = level->second;
+    auto it = std::find_if(orders.begin(), orders.end(),
+                           [orderId](const core::Order& order) { return order.orderId == orderId; });
+    if (it == orders.end()) return false;
+    if (removed) *removed = *it;
+    orders.erase(it);
+    if (orders.empty()) levels.erase(level);
+    return true;
+}
+
+// Appends the orders of every level before end, in order, and drops those levels
+template <typename Map>
+void takeUntil(Map& levels, typename Map::iterator end, std::vector<core::Order>& out) {
+    for (auto level = levels.begin(); level != end; ++level) {
+        out.insert(out.end(), level->second.begin(), level->second.end());
+    }
+    levels.erase(levels.begin(), end);
+}
+
+} // namespace
+
+bool StopBook::add(const core::Order& order) {
+    if (!index_.emplace(order.orderId, std::make_pair(order.side, order.stopPrice)).second) return false;
+    if (order.side == core::Side::Buy) {
+        buys_[order.stopPrice].push_back(order);
+    } else {
+        sells_[order.stopPrice].push_back(order);
+    }
+    return true;
+}
+
+bool StopBook::cancel(core::OrderId orderId, core::Order* removed) {
+    auto it = index_.find(orderId);
+    if (it == index_.end()) return false;
+    const auto [side, stopPrice] = it->second;
+    index_.erase(it);
+    return side == core::Side::Buy ? eraseFrom(buys_, stopPrice, orderId, removed)
+                                   : eraseFrom(sells_, stopPrice, orderId, removed);
+}
+
+void StopBook::takeTriggered(std::vector<core::Order>& out) {
+    out.clear();
+    if (lastTradePrice_ == 0) return;
+    // Buy levels at or below the last price, sell levels at or above it
+    takeUntil(buys_, buys_.upper_bound(lastTradePrice_), out);
+    takeUntil(sells_, sells_.upper_bound(lastTradePrice_), out);
+    for (const core::Order& order : out) index_.erase(order.orderId);
+}
+
+void StopBook::copyTo(std::vector<book::SnapshotStop>& out) const {
+    out.clear();
+    out.reserve(index_.size());
+    auto copyLevels = [&out](const auto& levels) {
+        for (const auto& [stopPrice, orders] : levels) {
+            for (const core::Order& order : orders) {
+                book::SnapshotStop stop;
+                stop.orderId = order.orderId;
+                stop.price = order.price;
+                stop.stopPrice = order.stopPrice;
+                stop.quantity = order.quantity;
+                stop.ts = order.ts.time_since_epoch().count();
+                stop.side = order.side;
+                stop.type = order.type;
+                stop.tif = order.tif;
+                stop.account = order.account;
+                out.push_back(stop);
+            }
+        }
+    };
+    copyLevels(buys_);
+    copyLevels(sells_);
+}
+
+void StopBook::load(const book::SnapshotStop* stops, std::size_t count, core::Price lastTradePrice) {
+    lastTradePrice_ = lastTradePrice;
+    for (std::size_t i = 0; i < count; ++i) add(book::toOrder(stops[i]));
+}
+
+} // namespace ob::engine
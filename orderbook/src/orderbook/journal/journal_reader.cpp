@@ -0,0 +1,145 @@
+#include "orderbook/journal/journal_reader.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace ob::journal {
+
+JournalReader::JournalReader(const std::string& directory, std::uint64_t firstSegment) {
+    std::error_code ec;
+    if (!std::filesystem::is_directory(directory, ec)) return;
+
+    std::vector<std::pair<std::uint64_t, std::string>> files;
+    for (const auto& entry : std::filesystem::directory_iterator(directory, ec)) {
+        const std::uint64_t index = parseSegmentIndex(entry.path().filename().string());
+        if (index != 0 && index >= firstSegment) files.emplace_back(index, entry.path().string());
+    }
+    std::sort(files.begin(), files.end());
+
+    for (const auto& [index, path] : files) {
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            throw std::runtime_error("Failed to open journal segment " + path);
+        }
+        struct stat st {};
+        if (::fstat(fd, &st) != 0) {
+            ::close(fd);
+            throw std::runtime_error("Failed to stat journal segment " + path);
+        }
+        const auto size = static_cast<std::size_t>(st.st_size);
+        const char* base = nullptr;
+        if (size != 0) {
+            void* mapped = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapped == MAP_FAILED) {
+                ::close(fd);
+                throw std::runtime_error("Failed to map journal segment " + path);
+            }
+            ::madvise(mapped, size, MADV_SEQUENTIAL);
+            base = static_cast<const char*>(mapped);
+        }
+        ::close(fd); // the mapping keeps the file
+        segments_.push_back(Segment{index, base, size});
+    }
+}
+
+JournalReader::~JournalReader() {
+    for (const auto& segment : segments_) {
+        if (segment.base) ::munmap(const_cast<char*>(segment.base), segment.size);
+    }
+}
+
+std::uint64_t JournalReader::lastSegment() const noexcept {
+    return segments_.empty() ? 0 : segments_.back().index;
+}
+
+void JournalReader::rewind() noexcept {
+    current_ = 0;
+    offset_ = 0;
+    expected_ = 0;
+    lastSequence_ = 0;
+    tornSegments_ = 0;
+    gap_ = false;
+}
+
+bool JournalReader::enterSegment() {
+    const Segment& segment = segments_[current_];
+    SegmentHeader header;
+    if (segment.size < sizeof(header)) return false;
+    std::memcpy(&header, segment.base, sizeof(header));
+    if (header.magic != SEGMENT_MAGIC || header.version == 0 || header.version > FORMAT_VERSION ||
+        header.headerSize < sizeof(header) || header.headerSize > segment.size) {
+        return false;
+    }
+    if (lastSequence_ != 0 && header.firstSequence != lastSequence_ + 1) {
+        gap_ = true; // records between the segments are missing
+        return false;
+    }
+    expected_ = header.firstSequence;
+    lastSequence_ = header.firstSequence - 1;
+    offset_ = header.headerSize;
+    return true;
+}
+
+void JournalReader::leaveSegment(bool torn) noexcept {
+    if (torn) ++tornSegments_;
+    ++current_;
+    offset_ = 0;
+}
+
+bool JournalReader::next(JournalRecord& out) {
+    while (!gap_ && current_ < segments_.size()) {
+        if (offset_ == 0 && !enterSegment()) {
+            if (gap_) return false;
+            leaveSegment(true); // unreadable header, e.g. created just before a crash
+            continue;
+        }
+        const Segment& segment = segments_[current_];
+        if (offset_ + sizeof(RecordHeader) > segment.size) {
+            leaveSegment(false); // trimmed on close
+            continue;
+        }
+        RecordHeader header;
+        std::memcpy(&header, segment.base + offset_, sizeof(header));
+        if (header.length == 0) {
+            leaveSegment(header.sequence != 0); // zero fill = end of data
+            continue;
+        }
+        const std::size_t size = recordSize(header.length);
+        const char* payload = segment.base + offset_ + sizeof(RecordHeader);
+        if (offset_ + size > segment.size || header.sequence != expected_ ||
+            header.checksum != checksum(header.sequence, header.type, payload, header.length)) {
+            leaveSegment(true);
+            continue;
+        }
+        offset_ += size;
+        ++expected_;
+        lastSequence_ = header.sequence;
+
+        out.type = header.type;
+        out.sequence = header.sequence;
+        switch (header.type) {
+            case RecordType::Command: {
+                if (header.length < COMMAND_RECORD_V1_SIZE) break;
+                CommandRecord record;
+                std::memcpy(&record, payload, std::min<std::size_t>(header.length, sizeof(record)));
+                out.command = toCommand(record);
+                return true;
+            }
+            case RecordType::InstrumentAdded:
+            case RecordType::InstrumentRemoved:
+                if (header.length < sizeof(InstrumentRecord)) break;
+                decodeInstrument(payload, header.length, out.instrument);
+                return true;
+        }
+        // Valid but not understood (newer writer): skip it
+    }
+    return false;
+}
+
+} // namespace ob::journal
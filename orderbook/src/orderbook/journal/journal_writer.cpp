@@ -0,0 +1,286 @@
+#include "orderbook/journal/journal_writer.hpp"
+#include "orderbook/core/affinity.hpp"
+#include "orderbook/core/async_log.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace ob::journal {
+
+namespace {
+
+std::size_t pageSize() {
+    static const std::size_t size = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+    return size;
+}
+
+} // namespace
+
+JournalWriter::JournalWriter(const JournalConfig& config, std::uint64_t firstSegment, std::uint64_t firstSequence)
+    : config_(config),
+      ring_(config.ringSize),
+      waitStrategy_(config.waitStrategy),
+      batch_(std::max<std::size_t>(std::min(config.commitBatch, config.ringSize), 1)),
+      nextSequence_(firstSequence) {
+    // Room for the header and the largest instrument record
+    config_.segmentBytes = std::max(config_.segmentBytes, pageSize() * 64);
+    std::error_code ec;
+    std::filesystem::create_directories(config_.directory, ec);
+    if (ec) {
+        throw std::runtime_error("Failed to create journal directory " + config_.directory);
+    }
+    openSegment(firstSegment);
+}
+
+JournalWriter::~JournalWriter() {
+    stop();
+    closeSegment();
+}
+
+void JournalWriter::append(const core::Command* commands, std::size_t count) noexcept {
+    while (count != 0) {
+        const std::size_t pushed = ring_.tryPushN(commands, count);
+        if (pushed == 0) {
+            // Never drop an input: wait for the writer to make room
+            stalls_.fetch_add(1, std::memory_order_relaxed);
+            std::this_thread::yield();
+            continue;
+        }
+        commands += pushed;
+        count -= pushed;
+    }
+}
+
+void JournalWriter::appendInstrumentAdded(const InstrumentEntry& instrument) {
+    enqueue(RecordType::InstrumentAdded, encodeInstrument(instrument));
+}
+
+void JournalWriter::appendInstrumentRemoved(std::uint32_t symbolId) {
+    InstrumentEntry instrument;
+    instrument.symbolId = symbolId;
+    enqueue(RecordType::InstrumentRemoved, encodeInstrument(instrument));
+}
+
+void JournalWriter::enqueue(RecordType type, std::string payload) {
+    std::lock_guard<std::mutex> lock(controlMutex_);
+    control_.push_back(Control{type, std::move(payload)});
+}
+
+void JournalWriter::start() {
+    if (running_.exchange(true)) {
+        return; // Already running
+    }
+    thread_ = std::thread(&JournalWriter::processLoop, this);
+}
+
+void JournalWriter::stop() {
+    if (!running_.exchange(false)) {
+        return; // Already stopped
+    }
+    waitStrategy_.wakeAll();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void JournalWriter::flush() {
+    std::unique_lock<std::mutex> lock(controlMutex_);
+    const std::uint64_t ticket = ++flushRequested_;
+    flushed_.wait(lock, [this, ticket] { return flushDone_ >= ticket || !running_.load(); });
+}
+
+JournalStats JournalWriter::stats() const noexcept {
+    JournalStats stats;
+    stats.records = records_.load(std::memory_order_relaxed);
+    stats.commands = commands_.load(std::memory_order_relaxed);
+    stats.bytes = bytes_.load(std::memory_order_relaxed);
+    stats.commits = commits_.load(std::memory_order_relaxed);
+    stats.syncs = syncs_.load(std::memory_order_relaxed);
+    stats.stalls = stalls_.load(std::memory_order_relaxed);
+    stats.segments = segments_.load(std::memory_order_relaxed);
+    stats.maxOrderId = maxOrderId_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void JournalWriter::processLoop() {
+    if (!core::pinCurrentThread(config_.cpu)) OB_LOG("JOURNAL could not pin to cpu={}", config_.cpu);
+
+    std::uint32_t idleRounds = 0;
+    auto hasWork = [this] { return !ring_.empty() || !running_.load(); };
+    while (running_.load()) {
+        if (writeOnce() == 0) {
+            // A quiet journal still gets its interval sync
+            if (config_.fsync == FsyncPolicy::Interval &&
+                std::chrono::steady_clock::now() - lastSync_ >= config_.fsyncInterval) {
+                sync();
+            }
+            waitStrategy_.idle(idleRounds, hasWork);
+            continue;
+        }
+        idleRounds = 0;
+    }
+    // Producers are stopped first on shutdown; write what they left
+    while (writeOnce() != 0) {}
+    sync(); // a clean shutdown is durable whatever the policy
+    std::lock_guard<std::mutex> lock(controlMutex_);
+    flushDone_ = flushRequested_;
+    flushed_.notify_all();
+}
+
+std::size_t JournalWriter::writeOnce() {
+    std::vector<Control> control;
+    std::uint64_t flushTicket = 0;
+    {
+        std::lock_guard<std::mutex> lock(controlMutex_);
+        control.swap(control_);
+        if (flushRequested_ > flushDone_) flushTicket = flushRequested_;
+    }
+
+    // One group commit: up to commitBatch commands, then the side records
+    std::size_t written = 0;
+    bool drained = false;
+    while (written < config_.commitBatch) {
+        const std::size_t want = std::min(batch_.size(), config_.commitBatch - written);
+        const std::size_t count = ring_.tryPopN(batch_.data(), want);
+        for (std::size_t i = 0; i < count; ++i) {
+            const CommandRecord record = toRecord(batch_[i]);
+            writeRecord(RecordType::Command, &record, sizeof(record));
+            if (batch_[i].type == core::CommandType::NewOrder) {
+                written_.maxOrderId = std::max(written_.maxOrderId, record.orderId);
+            }
+        }
+        written += count;
+        if (count < want) {
+            drained = true;
+            break;
+        }
+    }
+    written_.commands += written;
+    for (const auto& entry : control) {
+        writeRecord(entry.type, entry.payload.data(), entry.payload.size());
+    }
+    written += control.size();
+
+    if (written != 0) commit();
+    if (drained && flushTicket != 0) {
+        // Everything appended before the ticket was taken is now committed
+        if (config_.fsync != FsyncPolicy::None) sync();
+        std::lock_guard<std::mutex> lock(controlMutex_);
+        flushDone_ = std::max(flushDone_, flushTicket);
+        flushed_.notify_all();
+    }
+    return written;
+}
+
+void JournalWriter::writeRecord(RecordType type, const void* payload, std::size_t length) {
+    const std::size_t size = recordSize(length);
+    if (offset_ + size > config_.segmentBytes) {
+        const std::uint64_t next = segmentIndex_ + 1;
+        closeSegment();
+        openSegment(next);
+    }
+
+    char* at = base_ + offset_;
+    RecordHeader header;
+    header.length = static_cast<std::uint32_t>(length);
+    header.sequence = nextSequence_++;
+    header.type = type;
+    header.checksum = checksum(header.sequence, type, payload, length);
+    std::memcpy(at + sizeof(RecordHeader), payload, length);
+    std::memcpy(at, &header, sizeof(header));
+    offset_ += size;
+    ++written_.records;
+    written_.bytes += size;
+}
+
+void JournalWriter::commit() {
+    // Counters are published once per commit rather than per record
+    records_.store(written_.records, std::memory_order_relaxed);
+    commands_.store(written_.commands, std::memory_order_relaxed);
+    bytes_.store(written_.bytes, std::memory_order_relaxed);
+    maxOrderId_.store(written_.maxOrderId, std::memory_order_relaxed);
+    commits_.fetch_add(1, std::memory_order_relaxed);
+    switch (config_.fsync) {
+        case FsyncPolicy::None:
+            return;
+        case FsyncPolicy::EveryCommit:
+            sync();
+            return;
+        case FsyncPolicy::Interval:
+            if (std::chrono::steady_clock::now() - lastSync_ >= config_.fsyncInterval) sync();
+            return;
+    }
+}
+
+void JournalWriter::sync() {
+    if (!base_ || syncedOffset_ == offset_) return;
+    // msync wants a page-aligned start; rewriting part of a synced page is harmless
+    const std::size_t from = syncedOffset_ & ~(pageSize() - 1);
+    if (::msync(base_ + from, offset_ - from, MS_SYNC) != 0) {
+        OB_LOG("JOURNAL msync failed errno={}", errno);
+    }
+    syncedOffset_ = offset_;
+    lastSync_ = std::chrono::steady_clock::now();
+    syncs_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void JournalWriter::openSegment(std::uint64_t index) {
+    const std::string path = (std::filesystem::path(config_.directory) / segmentFileName(index)).string();
+    const int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        throw std::runtime_error("Failed to create journal segment " + path);
+    }
+    // Preallocate: the zero fill is what marks the end of written data
+    if (::ftruncate(fd, static_cast<off_t>(config_.segmentBytes)) != 0) {
+        ::close(fd);
+        throw std::runtime_error("Failed to size journal segment " + path);
+    }
+    void* base = ::mmap(nullptr, config_.segmentBytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (base == MAP_FAILED) {
+        ::close(fd);
+        throw std::runtime_error("Failed to map journal segment " + path);
+    }
+
+    fd_ = fd;
+    base_ = static_cast<char*>(base);
+    segmentIndex_ = index;
+    currentSegment_.store(index, std::memory_order_release);
+    SegmentHeader header;
+    header.index = index;
+    header.firstSequence = nextSequence_;
+    std::memcpy(base_, &header, sizeof(header));
+    offset_ = sizeof(SegmentHeader);
+    syncedOffset_ = 0;
+    segments_.fetch_add(1, std::memory_order_relaxed);
+
+    if (config_.fsync != FsyncPolicy::None) {
+        // Make the new file itself durable, not just its pages
+        sync();
+        const int dir = ::open(config_.directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (dir >= 0) {
+            ::fsync(dir);
+            ::close(dir);
+        }
+    }
+}
+
+void JournalWriter::closeSegment() {
+    if (!base_) return;
+    if (config_.fsync != FsyncPolicy::None) sync();
+    ::munmap(base_, config_.segmentBytes);
+    // Give back the unused preallocation; replay stops at end of file too
+    if (::ftruncate(fd_, static_cast<off_t>(offset_)) != 0) {
+        OB_LOG("JOURNAL could not trim segment {} errno={}", segmentIndex_, errno);
+    }
+    ::close(fd_);
+    base_ = nullptr;
+    fd_ = -1;
+}
+
+} // namespace ob::journal
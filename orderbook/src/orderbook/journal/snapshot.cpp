@@ -0,0 +1,239 @@
+#include "orderbook/journal/snapshot.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace ob::journal {
+
+namespace {
+
+constexpr std::size_t padded(std::size_t length) noexcept {
+    return (length + RECORD_ALIGN - 1) & ~(RECORD_ALIGN - 1);
+}
+
+std::uint32_t headerChecksum(SnapshotHeader header) noexcept {
+    header.checksum = 0;
+    return foldHash(hashBytes(HASH_SEED, &header, sizeof(header)));
+}
+
+// Covers only what the section's version holds: version 1 has no stops and
+// no last trade price, version 2 no risk accounts
+std::uint32_t sectionChecksum(std::uint64_t id, const void* instrument, std::size_t instrumentBytes,
+                              const SnapshotSection& section, std::uint16_t version) noexcept {
+    std::uint64_t hash = hashWord(HASH_SEED, id);
+    hash = hashBytes(hash, instrument, instrumentBytes);
+    hash = hashBytes(hash, section.orders, section.orderCount * sizeof(book::SnapshotOrder));
+    if (version >= 2) {
+        hash = hashBytes(hash, section.stops, section.stopCount * sizeof(book::SnapshotStop));
+        hash = hashWord(hash, static_cast<std::uint64_t>(section.lastTradePrice));
+    }
+    if (version >= 3) {
+        hash = hashBytes(hash, section.accounts, section.accountCount * sizeof(book::SnapshotAccount));
+        hash = hashWord(hash, static_cast<std::uint64_t>(section.riskReference));
+    }
+    return foldHash(hash);
+}
+
+void writeAll(int fd, const void* data, std::size_t length, const std::string& path) {
+    const auto* bytes = static_cast<const char*>(data);
+    while (length != 0) {
+        const ssize_t n = ::write(fd, bytes, length);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            throw std::runtime_error("Failed to write snapshot " + path);
+        }
+        bytes += n;
+        length -= static_cast<std::size_t>(n);
+    }
+}
+
+void syncDirectory(const std::string& directory) {
+    const int dir = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dir >= 0) {
+        ::fsync(dir);
+        ::close(dir);
+    }
+}
+
+} // namespace
+
+std::vector<std::pair<std::uint64_t, std::string>> listSnapshots(const std::string& directory) {
+    std::vector<std::pair<std::uint64_t, std::string>> files;
+    std::error_code ec;
+    if (!std::filesystem::is_directory(directory, ec)) return files;
+    for (const auto& entry : std::filesystem::directory_iterator(directory, ec)) {
+        const std::uint64_t id = parseSnapshotId(entry.path().filename().string());
+        if (id != 0) files.emplace_back(id, entry.path().string());
+    }
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
+std::uint64_t writeSnapshot(const std::string& directory, SnapshotHeader header,
+                            const std::vector<SnapshotSection>& sections) {
+    const std::filesystem::path dir(directory);
+    const std::string path = (dir / snapshotFileName(header.id)).string();
+    const std::string temporary = path + ".tmp";
+    const int fd = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        throw std::runtime_error("Failed to create snapshot " + temporary);
+    }
+
+    std::uint64_t bytes = 0;
+    try {
+        header.instrumentCount = static_cast<std::uint32_t>(sections.size());
+        header.checksum = headerChecksum(header);
+        writeAll(fd, &header, sizeof(header), temporary);
+        bytes += sizeof(header);
+
+        for (const auto& section : sections) {
+            std::string instrument = encodeInstrument(section.instrument);
+            SectionHeader sectionHeader;
+            sectionHeader.orderCount = section.orderCount;
+            sectionHeader.instrumentBytes = static_cast<std::uint32_t>(instrument.size());
+            sectionHeader.stopCount = section.stopCount;
+            sectionHeader.lastTradePrice = section.lastTradePrice;
+            sectionHeader.accountCount = section.accountCount;
+            sectionHeader.riskReference = section.riskReference;
+            sectionHeader.checksum =
+                sectionChecksum(header.id, instrument.data(), instrument.size(), section, SNAPSHOT_VERSION);
+            instrument.resize(padded(instrument.size()), '\0');
+            writeAll(fd, &sectionHeader, sizeof(sectionHeader), temporary);
+            writeAll(fd, instrument.data(), instrument.size(), temporary);
+            writeAll(fd, section.orders, section.orderCount * sizeof(book::SnapshotOrder), temporary);
+            writeAll(fd, section.stops, section.stopCount * sizeof(book::SnapshotStop), temporary);
+            writeAll(fd, section.accounts, section.accountCount * sizeof(book::SnapshotAccount), temporary);
+            bytes += sizeof(sectionHeader) + instrument.size() + section.orderCount * sizeof(book::SnapshotOrder) +
+                     section.stopCount * sizeof(book::SnapshotStop) +
+                     section.accountCount * sizeof(book::SnapshotAccount);
+        }
+        if (::fsync(fd) != 0) {
+            throw std::runtime_error("Failed to sync snapshot " + temporary);
+        }
+    } catch (...) {
+        ::close(fd);
+        ::unlink(temporary.c_str());
+        throw;
+    }
+    ::close(fd);
+
+    if (::rename(temporary.c_str(), path.c_str()) != 0) {
+        ::unlink(temporary.c_str());
+        throw std::runtime_error("Failed to rename snapshot into place " + path);
+    }
+    syncDirectory(directory);
+    return bytes;
+}
+
+std::size_t pruneJournal(const std::string& directory, std::uint64_t keepSnapshot, std::uint64_t keepSegment) {
+    std::size_t removed = 0;
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator(directory, ec)) {
+        const std::string name = entry.path().filename().string();
+        const std::uint64_t snapshot = parseSnapshotId(name);
+        const std::uint64_t segment = parseSegmentIndex(name);
+        if ((snapshot != 0 && snapshot < keepSnapshot) || (segment != 0 && segment < keepSegment)) {
+            std::error_code removeError;
+            if (std::filesystem::remove(entry.path(), removeError)) ++removed;
+        }
+    }
+    return removed;
+}
+
+SnapshotReader::SnapshotReader(const std::string& path) {
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw std::runtime_error("Failed to open snapshot " + path);
+    }
+    struct stat st {};
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw std::runtime_error("Failed to stat snapshot " + path);
+    }
+    size_ = static_cast<std::size_t>(st.st_size);
+    if (size_ != 0) {
+        void* mapped = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped == MAP_FAILED) {
+            ::close(fd);
+            throw std::runtime_error("Failed to map snapshot " + path);
+        }
+        ::madvise(mapped, size_, MADV_SEQUENTIAL);
+        ::madvise(mapped, size_, MADV_WILLNEED); // the whole file is read right away
+        base_ = static_cast<const char*>(mapped);
+    }
+    ::close(fd); // the mapping keeps the file
+    valid_ = parse();
+    if (!valid_) sections_.clear();
+}
+
+SnapshotReader::~SnapshotReader() {
+    if (base_) ::munmap(const_cast<char*>(base_), size_);
+}
+
+bool SnapshotReader::parse() {
+    if (size_ < sizeof(SnapshotHeader)) return false;
+    std::memcpy(&header_, base_, sizeof(header_));
+    if (header_.magic != SNAPSHOT_MAGIC || header_.version == 0 || header_.version > SNAPSHOT_VERSION ||
+        header_.headerSize < sizeof(SnapshotHeader) || header_.headerSize > size_ ||
+        header_.checksum != headerChecksum(header_)) {
+        return false;
+    }
+
+    const std::uint16_t version = header_.version;
+    const std::size_t sectionHeaderSize = version >= 3   ? sizeof(SectionHeader)
+                                          : version == 2 ? SECTION_HEADER_V2_SIZE
+                                                         : SECTION_HEADER_V1_SIZE;
+    std::size_t offset = padded(header_.headerSize);
+    sections_.reserve(header_.instrumentCount);
+    for (std::uint32_t i = 0; i < header_.instrumentCount; ++i) {
+        SectionHeader section;
+        if (offset + sectionHeaderSize > size_) return false;
+        std::memcpy(&section, base_ + offset, sectionHeaderSize);
+        offset += sectionHeaderSize;
+
+        const char* instrument = base_ + offset;
+        if (section.instrumentBytes < sizeof(InstrumentRecord) || offset + padded(section.instrumentBytes) > size_) {
+            return false;
+        }
+        offset += padded(section.instrumentBytes);
+        if (section.orderCount > (size_ - offset) / sizeof(book::SnapshotOrder)) return false;
+        // Sections stay 8-byte aligned, so the orders can be used in place
+        const auto* orders = reinterpret_cast<const book::SnapshotOrder*>(base_ + offset);
+        const auto count = static_cast<std::size_t>(section.orderCount);
+        offset += count * sizeof(book::SnapshotOrder);
+        if (section.stopCount > (size_ - offset) / sizeof(book::SnapshotStop)) return false;
+        const auto* stops = reinterpret_cast<const book::SnapshotStop*>(base_ + offset);
+        const auto stopCount = static_cast<std::size_t>(section.stopCount);
+        offset += stopCount * sizeof(book::SnapshotStop);
+        if (section.accountCount > (size_ - offset) / sizeof(book::SnapshotAccount)) return false;
+        const auto* accounts = reinterpret_cast<const book::SnapshotAccount*>(base_ + offset);
+        const auto accountCount = static_cast<std::size_t>(section.accountCount);
+        offset += accountCount * sizeof(book::SnapshotAccount);
+
+        SnapshotSection out;
+        out.orders = orders;
+        out.orderCount = count;
+        out.stops = stops;
+        out.stopCount = stopCount;
+        out.lastTradePrice = section.lastTradePrice;
+        out.accounts = accounts;
+        out.accountCount = accountCount;
+        // Older snapshots kept no collar reference: the last trade is the nearest
+        out.riskReference = version >= 3 ? section.riskReference : section.lastTradePrice;
+        if (section.checksum != sectionChecksum(header_.id, instrument, section.instrumentBytes, out, version)) {
+            return false;
+        }
+        decodeInstrument(instrument, section.instrumentBytes, out.instrument);
+        sections_.push_back(std::move(out));
+    }
+    return true;
+}
+
+} // namespace ob::journal
@@ -0,0 +1,434 @@
+#include "orderbook/loadgen/load_generator.hpp"
+#include "orderbook/core/log.hpp"
+#include "orderbook/events/event_types.hpp"
+#include "orderbook/net/binary_protocol.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace ob::loadgen {
+
+namespace {
+
+namespace binary = net::binary;
+
+constexpr std::size_t READ_CHUNK = 64 * 1024;
+constexpr std::int64_t START_DELAY_NS = 10'000'000; // lets every thread reach its loop before the first due time
+constexpr int MAX_EVENTS = 64;
+
+std::runtime_error socketError(const std::string& what) {
+    return std::runtime_error(what + ": " + std::strerror(errno));
+}
+
+// Blocking, TCP_NODELAY
+int connectTo(const std::string& host, std::uint16_t port) {
+    addrinfo hints{};
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* found = nullptr;
+    if (::getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &found) != 0 || !found) {
+        throw std::runtime_error("cannot resolve " + host);
+    }
+    const int fd = ::socket(found->ai_family, found->ai_socktype | SOCK_CLOEXEC, found->ai_protocol);
+    if (fd < 0) {
+        ::freeaddrinfo(found);
+        throw socketError("socket");
+    }
+    const int connected = ::connect(fd, found->ai_addr, found->ai_addrlen);
+    ::freeaddrinfo(found);
+    if (connected < 0) {
+        ::close(fd);
+        throw socketError("cannot connect to " + host + ":" + std::to_string(port));
+    }
+    int one = 1;
+    ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    return fd;
+}
+
+void sendAll(int fd, const char* data, std::size_t size) {
+    while (size > 0) {
+        const ssize_t n = ::send(fd, data, size, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            throw socketError("send");
+        }
+        data += n;
+        size -= static_cast<std::size_t>(n);
+    }
+}
+
+void recvAll(int fd, char* data, std::size_t size) {
+    while (size > 0) {
+        const ssize_t n = ::recv(fd, data, size, 0);
+        if (n == 0) throw std::runtime_error("server closed the connection during setup");
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            throw socketError("recv");
+        }
+        data += n;
+        size -= static_cast<std::size_t>(n);
+    }
+}
+
+// Adds LOAD1..LOADn over one text connection and returns their symbol ids
+std::vector<std::uint32_t> createInstruments(const LoadConfig& config) {
+    const int fd = connectTo(config.host, config.port);
+    std::vector<std::uint32_t> symbols;
+    try {
+        for (std::size_t i = 1; i <= config.instruments; ++i) {
+            const std::string request = "ADD_INSTRUMENT LOAD" + std::to_string(i) + "|Load test|Load|" +
+                                        std::to_string(config.referencePrice) +
+                                        (config.ladderBooks ? "|LADDER" : "|MAP") + "\n";
+            sendAll(fd, request.data(), request.size());
+            std::string reply;
+            for (char c = 0; c != '\n';) {
+                recvAll(fd, &c, 1);
+                reply += c;
+            }
+            if (reply.rfind("OK ", 0) != 0) throw std::runtime_error("ADD_INSTRUMENT refused: " + reply);
+            symbols.push_back(static_cast<std::uint32_t>(std::stoul(reply.substr(3))));
+        }
+    } catch (...) {
+        ::close(fd);
+        throw;
+    }
+    ::close(fd);
+    return symbols;
+}
+
+struct Pending {
+    std::uint64_t clientTag;
+    std::int64_t due;
+    bool order;    // NewOrder rather than Cancel
+    bool recorded; // due after the warmup
+};
+
+struct OpenOrder {
+    core::OrderId orderId;
+    std::uint32_t symbolId; // a cancel names the instrument the order was entered on
+};
+
+struct AwaitedAck {
+    std::int64_t due;
+    bool recorded;
+};
+
+// One binary session. Responses come back in request order, so a FIFO
+// pairs each with its request; execution reports are matched by order id.
+struct Connection {
+    int fd{-1};
+    std::mt19937_64 rng;
+    std::string out;                 // encoded, not yet sent
+    std::vector<char> in;            // received, not yet decoded
+    std::size_t inSize{0};
+    std::uint64_t nextTag{1};
+    std::size_t nextInstrument{0};
+    std::deque<Pending> pending;
+    std::deque<OpenOrder> open;      // accepted orders, oldest first, to cancel later
+    std::unordered_map<core::OrderId, AwaitedAck> awaitingAck;
+    std::unordered_map<core::OrderId, std::int64_t> earlyAcks; // Ack seen before its Accepted
+
+    ~Connection() {
+        if (fd >= 0) ::close(fd);
+    }
+};
+
+void logon(Connection& connection, bool acks) {
+    const auto logonMsg = binary::makeLogon();
+    sendAll(connection.fd, reinterpret_cast<const char*>(&logonMsg), sizeof(logonMsg));
+    char reply[sizeof(binary::LogonMsg)];
+    recvAll(connection.fd, reply, sizeof(reply));
+    if (binary::load<binary::LogonMsg>(reply).header.type != binary::MsgType::LogonAck) {
+        throw std::runtime_error("server refused the binary logon");
+    }
+    if (!acks) return;
+    auto subscribe = binary::make<binary::SubscribeMsg>(binary::MsgType::Subscribe);
+    subscribe.stream = binary::Stream::Orders;
+    sendAll(connection.fd, reinterpret_cast<const char*>(&subscribe), sizeof(subscribe));
+    char response[sizeof(binary::ResponseMsg)];
+    recvAll(connection.fd, response, sizeof(response));
+    if (binary::load<binary::ResponseMsg>(response).header.type != binary::MsgType::Accepted) {
+        throw std::runtime_error("server does not deliver execution reports");
+    }
+}
+
+// Runs the schedule of one generator thread over its connections
+class Worker {
+public:
+    Worker(const LoadConfig& config, const std::vector<std::uint32_t>& symbols)
+        : config_(config), symbols_(symbols) {}
+
+    ~Worker() {
+        if (epoll_ >= 0) ::close(epoll_);
+    }
+
+    void add(std::unique_ptr<Connection> connection) { connections_.push_back(std::move(connection)); }
+
+    // Message i is due at start + phase + i * interval
+    void run(std::int64_t start, std::int64_t end, std::int64_t recordFrom, double interval, double phase) {
+        epoll_ = ::epoll_create1(EPOLL_CLOEXEC);
+        if (epoll_ < 0) throw socketError("epoll_create1");
+        for (std::size_t i = 0; i < connections_.size(); ++i) {
+            ::fcntl(connections_[i]->fd, F_SETFL, ::fcntl(connections_[i]->fd, F_GETFL) | O_NONBLOCK);
+            epoll_event event{};
+            event.events = EPOLLIN;
+            event.data.u64 = i;
+            if (::epoll_ctl(epoll_, EPOLL_CTL_ADD, connections_[i]->fd, &event) < 0) throw socketError("epoll_ctl");
+        }
+
+        const std::int64_t drainUntil = end + std::chrono::nanoseconds(config_.drainTimeout).count();
+        std::uint64_t next = 0;
+        std::size_t turn = 0;
+        bool sending = true;
+        epoll_event events[MAX_EVENTS];
+        for (;;) {
+            std::int64_t now = static_cast<std::int64_t>(core::nowNs());
+            std::int64_t due = start + static_cast<std::int64_t>(phase + static_cast<double>(next) * interval);
+            while (sending && due <= now) {
+                if (due >= end) {
+                    sending = false;
+                    break;
+                }
+                result_.maxLag = std::max(result_.maxLag, std::chrono::nanoseconds(now - due));
+                encode(*connections_[turn], due, due >= recordFrom);
+                turn = turn + 1 == connections_.size() ? 0 : turn + 1;
+                due = start + static_cast<std::int64_t>(phase + static_cast<double>(++next) * interval);
+            }
+            if (sending && due >= end) sending = false;
+            flush();
+
+            if (!sending && (settled() || now >= drainUntil)) break;
+            // Sleep in epoll only while the next send is a millisecond or more away
+            const int timeout = sending ? static_cast<int>(std::max<std::int64_t>(0, (due - now) / 1'000'000)) : 1;
+            const int ready = ::epoll_wait(epoll_, events, MAX_EVENTS, timeout);
+            if (ready < 0 && errno != EINTR) throw socketError("epoll_wait");
+            now = static_cast<std::int64_t>(core::nowNs());
+            for (int i = 0; i < ready; ++i) receive(*connections_[events[i].data.u64], now);
+        }
+
+        for (const auto& connection : connections_) {
+            result_.unanswered += connection->pending.size();
+        }
+    }
+
+    const LoadResult& result() const noexcept { return result_; }
+    std::int64_t lastAnswer() const noexcept { return lastAnswer_; }
+
+private:
+    bool settled() const noexcept {
+        return std::all_of(connections_.begin(), connections_.end(), [](const auto& connection) {
+            return connection->pending.empty() && connection->awaitingAck.empty();
+        });
+    }
+
+    // The connection's next message: a cancel of its oldest order, or a
+    // limit order up to spread ticks either side of the reference price
+    void encode(Connection& c, std::int64_t due, bool recorded) {
+        const std::uint64_t tag = c.nextTag++;
+        const bool cancel = !c.open.empty() && (c.open.size() >= config_.maxOpen ||
+                                                std::uniform_real_distribution<double>(0, 1)(c.rng) < config_.cancelRatio);
+        const std::uint32_t symbolId = symbols_[c.nextInstrument];
+        c.nextInstrument = c.nextInstrument + 1 == symbols_.size() ? 0 : c.nextInstrument + 1;
+        if (cancel) {
+            auto msg = binary::make<binary::CancelMsg>(binary::MsgType::Cancel);
+            msg.orderId = c.open.front().orderId;
+            msg.symbolId = c.open.front().symbolId;
+            msg.clientTag = tag;
+            c.open.pop_front();
+            binary::append(c.out, msg);
+        } else {
+            auto msg = binary::make<binary::NewOrderMsg>(binary::MsgType::NewOrder);
+            msg.symbolId = symbolId;
+            msg.side = (c.rng() & 1) != 0 ? core::Side::Buy : core::Side::Sell;
+            msg.orderType = core::OrderType::Limit;
+            msg.price = config_.referencePrice +
+                        std::uniform_int_distribution<core::Price>(-config_.spread, config_.spread)(c.rng);
+            msg.quantity = std::uniform_int_distribution<core::Quantity>(1, 10)(c.rng);
+            msg.clientTag = tag;
+            binary::append(c.out, msg);
+        }
+        c.pending.push_back(Pending{tag, due, !cancel, recorded});
+        ++result_.sent;
+    }
+
+    void flush() {
+        for (const auto& connection : connections_) {
+            std::string& out = connection->out;
+            if (out.empty()) continue;
+            const ssize_t n = ::send(connection->fd, out.data(), out.size(), MSG_NOSIGNAL | MSG_DONTWAIT);
+            if (n < 0) {
+                if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) continue;
+                throw socketError("send");
+            }
+            out.erase(0, static_cast<std::size_t>(n));
+        }
+    }
+
+    void receive(Connection& c, std::int64_t now) {
+        for (;;) {
+            if (c.in.size() - c.inSize < READ_CHUNK) c.in.resize(c.inSize + READ_CHUNK);
+            const ssize_t n = ::recv(c.fd, c.in.data() + c.inSize, c.in.size() - c.inSize, 0);
+            if (n == 0) throw std::runtime_error("server closed a load connection");
+            if (n < 0) {
+                if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+                if (errno == EINTR) continue;
+                throw socketError("recv");
+            }
+            c.inSize += static_cast<std::size_t>(n);
+        }
+        std::size_t at = 0;
+        while (c.inSize - at >= sizeof(binary::MessageHeader)) {
+            const auto header = binary::load<binary::MessageHeader>(c.in.data() + at);
+            if (header.length < sizeof(binary::MessageHeader)) throw std::runtime_error("malformed frame from server");
+            if (c.inSize - at < header.length) break;
+            decode(c, c.in.data() + at, header, now);
+            at += header.length;
+        }
+        std::memmove(c.in.data(), c.in.data() + at, c.inSize - at);
+        c.inSize -= at;
+    }
+
+    void decode(Connection& c, const char* frame, const binary::MessageHeader& header, std::int64_t now) {
+        if ((header.type == binary::MsgType::Accepted || header.type == binary::MsgType::Rejected) &&
+            header.length == sizeof(binary::ResponseMsg)) {
+            onResponse(c, binary::load<binary::ResponseMsg>(frame), now);
+        } else if (header.type == binary::MsgType::ExecutionReport && header.length == sizeof(binary::ExecutionReportMsg)) {
+            onReport(c, binary::load<binary::ExecutionReportMsg>(frame), now);
+        }
+    }
+
+    void onResponse(Connection& c, const binary::ResponseMsg& msg, std::int64_t now) {
+        // In order; anything before this tag went unanswered
+        while (!c.pending.empty() && c.pending.front().clientTag != msg.clientTag) {
+            ++result_.unanswered;
+            c.pending.pop_front();
+        }
+        if (c.pending.empty()) return;
+        const Pending request = c.pending.front();
+        c.pending.pop_front();
+        ++result_.answered;
+        lastAnswer_ = now;
+        if (request.recorded) result_.response.record(static_cast<std::uint64_t>(std::max<std::int64_t>(0, now - request.due)));
+        if (msg.header.type == binary::MsgType::Rejected) {
+            ++result_.rejected;
+            return;
+        }
+        if (!request.order) return;
+        c.open.push_back(OpenOrder{msg.orderId, msg.symbolId});
+        if (!config_.acks) return;
+        const auto early = c.earlyAcks.find(msg.orderId);
+        if (early == c.earlyAcks.end()) {
+            c.awaitingAck.emplace(msg.orderId, AwaitedAck{request.due, request.recorded});
+            return;
+        }
+        ackOf(request.due, request.recorded, early->second);
+        c.earlyAcks.erase(early);
+    }
+
+    void onReport(Connection& c, const binary::ExecutionReportMsg& msg, std::int64_t now) {
+        const auto type = static_cast<events::EventType>(msg.execType);
+        if (type != events::EventType::Ack && type != events::EventType::Reject) return;
+        const auto awaited = c.awaitingAck.find(msg.orderId);
+        if (awaited == c.awaitingAck.end()) {
+            if (type == events::EventType::Ack) c.earlyAcks.emplace(msg.orderId, now);
+            return;
+        }
+        if (type == events::EventType::Ack) ackOf(awaited->second.due, awaited->second.recorded, now);
+        c.awaitingAck.erase(awaited);
+    }
+
+    void ackOf(std::int64_t due, bool recorded, std::int64_t at) {
+        ++result_.acked;
+        if (recorded) result_.ack.record(static_cast<std::uint64_t>(std::max<std::int64_t>(0, at - due)));
+    }
+
+    const LoadConfig& config_;
+    const std::vector<std::uint32_t>& symbols_;
+    std::vector<std::unique_ptr<Connection>> connections_;
+    int epoll_{-1};
+    LoadResult result_;
+    std::int64_t lastAnswer_{0};
+};
+
+} // namespace
+
+LoadResult runLoad(const LoadConfig& config) {
+    if (config.connections == 0 || config.instruments == 0 || config.rate <= 0.0) {
+        throw std::invalid_argument("connections, instruments and rate must be positive");
+    }
+    std::vector<std::uint32_t> symbols;
+    if (config.createInstruments) {
+        symbols = createInstruments(config);
+    } else {
+        for (std::uint32_t id = 1; id <= config.instruments; ++id) symbols.push_back(id);
+    }
+
+    const std::size_t threads = std::clamp<std::size_t>(config.threads, 1, config.connections);
+    std::vector<std::unique_ptr<Worker>> workers;
+    for (std::size_t t = 0; t < threads; ++t) workers.push_back(std::make_unique<Worker>(config, symbols));
+    for (std::size_t i = 0; i < config.connections; ++i) {
+        auto connection = std::make_unique<Connection>();
+        connection->fd = connectTo(config.host, config.port);
+        connection->rng.seed(config.seed + i);
+        connection->nextInstrument = i % symbols.size();
+        logon(*connection, config.acks);
+        workers[i % threads]->add(std::move(connection));
+    }
+
+    // Threads interleave: thread t sends at phase t of the overall interval
+    const double overall = 1e9 / config.rate;
+    const double interval = overall * static_cast<double>(threads);
+    const std::int64_t start = static_cast<std::int64_t>(core::nowNs()) + START_DELAY_NS;
+    const std::int64_t recordFrom = start + std::chrono::nanoseconds(config.warmup).count();
+    const std::int64_t end = recordFrom + std::chrono::nanoseconds(config.duration).count();
+
+    std::vector<std::exception_ptr> errors(threads);
+    std::vector<std::thread> running;
+    for (std::size_t t = 0; t < threads; ++t) {
+        running.emplace_back([&, t] {
+            try {
+                workers[t]->run(start, end, recordFrom, interval, overall * static_cast<double>(t));
+            } catch (...) {
+                errors[t] = std::current_exception();
+            }
+        });
+    }
+    for (auto& thread : running) thread.join();
+    for (const auto& error : errors) {
+        if (error) std::rethrow_exception(error);
+    }
+
+    LoadResult total;
+    std::int64_t last = start;
+    for (const auto& worker : workers) {
+        const LoadResult& part = worker->result();
+        total.sent += part.sent;
+        total.answered += part.answered;
+        total.rejected += part.rejected;
+        total.unanswered += part.unanswered;
+        total.acked += part.acked;
+        total.maxLag = std::max(total.maxLag, part.maxLag);
+        total.response.merge(part.response);
+        total.ack.merge(part.ack);
+        last = std::max(last, worker->lastAnswer());
+    }
+    total.elapsed = std::chrono::nanoseconds(last - start);
+    return total;
+}
+
+} // namespace ob::loadgen
@@ -0,0 +1,797 @@
+#include "orderbook/net/request_handler.hpp"
+#include "orderbook/core/latency_stats.hpp"
+#include "orderbook/core/constants.hpp"
+#include "orderbook/core/memory.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+
+namespace ob::net {
+
+namespace {
+
+std::string trim(const std::string& input) {
+    const auto start = input.find_first_not_of(" \t\r\n");
+    if (start == std::string::npos) {
+        return "";
+    }
+    const auto end = input.find_last_not_of(" \t\r\n");
+    return input.substr(start, end - start + 1);
+}
+
+core::Timestamp arrivalTime() noexcept {
+    return core::Timestamp{std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch())};
+}
+
+// The fields of an ADD (and of each BATCH entry) after the command word:
+// <symbolId> <B|S> <L|M|S|T> <price> <qty> [<stopPrice>] [GTC|IOC|FOK|POST].
+// S (stop) and T (stop-limit) take the stop price after qty; a stop's
+// price is ignored, as a market order's is. Fills order but its id and
+// timestamp; returns the ERROR line for invalid fields, null if valid.
+const char* parseOrder(std::istream& in, core::Order& order) {
+    std::uint32_t symbolId = 0;
+    char sideChar = 0, typeChar = 0;
+    long long price = 0;
+    long long qty = 0;
+    in >> symbolId >> sideChar >> typeChar >> price >> qty;
+    order.symbolId = symbolId;
+    order.side = (sideChar == 'B' ? core::Side::Buy : core::Side::Sell);
+    switch (typeChar) {
+        case 'L': order.type = core::OrderType::Limit; break;
+        case 'S': order.type = core::OrderType::Stop; break;
+        case 'T': order.type = core::OrderType::StopLimit; break;
+        default:  order.type = core::OrderType::Market; break;
+    }
+
+    // Validate LIMIT order price must be positive
+    const bool limited = order.type == core::OrderType::Limit || order.type == core::OrderType::StopLimit;
+    if (limited && price <= 0) {
+        return "ERROR Invalid price for LIMIT order (must be > 0)\n";
+    }
+    // Validate quantity must be positive
+    if (qty <= 0) {
+        return "ERROR Invalid quantity (must be > 0)\n";
+    }
+    if (core::isStop(order.type)) {
+        long long stopPrice = 0;
+        if (!(in >> stopPrice) || stopPrice <= 0) {
+            return "ERROR Invalid stop price (must be > 0)\n";
+        }
+        order.stopPrice = static_cast<core::Price>(stopPrice);
+    }
+    std::string tif;
+    if (in >> tif) {
+        if (tif == "GTC") order.tif = core::TimeInForce::GoodTillCancel;
+        else if (tif == "IOC") order.tif = core::TimeInForce::ImmediateOrCancel;
+        else if (tif == "FOK") order.tif = core::TimeInForce::FillOrKill;
+        else if (tif == "POST") order.tif = core::TimeInForce::PostOnly;
+        else return "ERROR Invalid time in force (GTC, IOC, FOK or POST)\n";
+    }
+    if (order.tif == core::TimeInForce::PostOnly && order.type != core::OrderType::Limit) {
+        return "ERROR Post-only applies to LIMIT orders only\n";
+    }
+    if (!limited) {
+        price = (order.side == core::Side::Buy
+            ? std::numeric_limits<long long>::max()
+            : std::numeric_limits<long long>::min());
+    }
+    order.price = static_cast<core::Price>(price);
+    order.quantity = static_cast<core::Quantity>(qty);
+    return nullptr;
+}
+
+const char* execTypeName(std::uint8_t execType) noexcept {
+    switch (static_cast<events::EventType>(execType)) {
+        case events::EventType::Ack:          return "ACK";
+        case events::EventType::Reject:       return "REJECT";
+        case events::EventType::Trade:        return "FILL";
+        case events::EventType::CancelAck:    return "CANCEL_ACK";
+        case events::EventType::CancelReject: return "CANCEL_REJECT";
+        case events::EventType::AmendAck:     return "AMEND_ACK";
+        case events::EventType::AmendReject:  return "AMEND_REJECT";
+    }
+    return "UNKNOWN";
+}
+
+// One line per stage: count, then mean and percentiles in ns. Per-thread
+// listings (non-empty prefix) leave out the stages a thread never ran.
+void appendStages(std::ostringstream& oss, const std::string& prefix, const core::StageHistograms& stages) {
+    for (std::size_t i = 0; i < core::STAGE_COUNT; ++i) {
+        const core::LatencyHistogram& h = stages[i];
+        if (!prefix.empty() && h.count() == 0) continue;
+        oss << prefix << core::stageName(static_cast<core::Stage>(i)) << " count=" << h.count()
+            << " mean=" << static_cast<std::uint64_t>(h.mean()) << " p50=" << h.percentile(50.0)
+            << " p99=" << h.percentile(99.0) << " p99.9=" << h.percentile(99.9) << " max=" << h.max() << "\n";
+    }
+}
+
+std::string statsReply(const std::string& what) {
+    if (!core::LATENCY_STATS_ENABLED) {
+        return "ERROR Latency stats not built (ORDERBOOK_LATENCY_STATS)\n";
+    }
+    if (what == "RESET") {
+        core::LatencyStats::reset();
+        return "OK\n";
+    }
+    std::ostringstream oss;
+    oss << "STATS\n";
+    if (what == "THREADS") {
+        core::LatencyStats::perThread([&oss](const std::string& name, const core::StageHistograms& stages) {
+            appendStages(oss, name + " ", stages);
+        });
+    } else if (what.empty()) {
+        auto stages = std::make_unique<core::StageHistograms>();
+        core::LatencyStats::merged(*stages);
+        appendStages(oss, "", *stages);
+    } else {
+        return "ERROR Invalid stats request\n";
+    }
+    oss << "END\n";
+    return oss.str();
+}
+
+// One line per processor thread, then one per instrument, as key=value
+// counters (totals since start) and gauges (depths as sampled), then what
+// the page-backed queues obtained from the system
+std::string metricsReply(const oms::IOrderBookService& service) {
+    core::ServiceMetrics metrics;
+    service.collectMetrics(metrics);
+    std::ostringstream oss;
+    oss << "METRICS\n";
+    for (const core::ProcessorSample& p : metrics.processors) {
+        oss << "processor " << p.name << " batches=" << p.batches << " commands=" << p.commands
+            << " ingress_depth=" << p.ingress.depth << " ingress_capacity=" << p.ingress.capacity
+            << " ingress_peak=" << p.ingress.peak << " ingress_full=" << p.ingress.pushFailures << "\n";
+    }
+    for (const core::InstrumentSample& i : metrics.instruments) {
+        oss << "instrument " << i.symbolId << " processor=" << i.processor << " orders=" << i.orders
+            << " cancels=" << i.cancels << " amends=" << i.amends << " rejects=" << i.rejects
+            << " trades=" << i.trades << " traded_qty=" << i.tradedQuantity << " submit_full=" << i.submitFull
+            << " bid_levels=" << i.bidLevels << " ask_levels=" << i.askLevels << " resting=" << i.restingOrders << " stops=" << i.stopOrders
+            << " risk_rejects=" << i.riskRejects
+            << " events_depth=" << i.events.depth << " events_capacity=" << i.events.capacity
+            << " events_dropped=" << i.events.pushFailures << "\n";
+    }
+    const core::MemoryStats memory = core::memoryStats();
+    oss << "memory regions=" << memory.regions << " huge_bytes=" << memory.hugeBytes
+        << " regular_bytes=" << memory.regularBytes << " huge_fallbacks=" << memory.hugeFallbacks
+        << " locked_bytes=" << memory.lockedBytes << " lock_failures=" << memory.lockFailures << "\n";
+    oss << "END\n";
+    return oss.str();
+}
+
+} // namespace
+
+RequestHandler::Session RequestHandler::openSession(Notifier* notifier) {
+    Session session;
+    // Session ids must fit above SESSION_SHIFT; 0 means "no session"
+    do {
+        session.id = nextSession_.fetch_add(1, std::memory_order_relaxed) & SubscriptionHub::MAX_SESSION;
+    } while (session.id == 0);
+    session.notifier = notifier;
+    return session;
+}
+
+void RequestHandler::closeSession(Session& session) {
+    if (hub_ && session.subscriber) hub_->remove(session.id);
+    session.subscriber.reset();
+}
+
+void RequestHandler::reserveOrderIds(core::OrderId maxUsed) noexcept {
+    const std::uint32_t owner = SubscriptionHub::ownerOf(maxUsed);
+    if (owner == 0) {
+        core::OrderId next = nextOrderId_.load();
+        while (next <= maxUsed && !nextOrderId_.compare_exchange_weak(next, maxUsed + 1)) {}
+        return;
+    }
+    std::uint32_t session = nextSession_.load();
+    while (session <= owner && !nextSession_.compare_exchange_weak(session, owner + 1)) {}
+}
+
+core::OrderId RequestHandler::nextOrderId(Session* session) noexcept {
+    if (session && session->id != 0) {
+        return SubscriptionHub::orderIdFor(session->id, ++session->lastSequence);
+    }
+    return nextOrderId_++;
+}
+
+bool RequestHandler::subscribe(Session& session, binary::Stream stream, std::uint32_t symbolId) {
+    if (!hub_ || session.id == 0) return false;
+    if (!session.subscriber) {
+        session.subscriber = std::make_shared<Subscriber>(session.id, session.notifier);
+    }
+    if (stream == binary::Stream::Orders) {
+        hub_->subscribeOrders(session.subscriber);
+    } else {
+        hub_->subscribeMarketData(session.subscriber, symbolId);
+    }
+    return true;
+}
+
+bool RequestHandler::unsubscribe(Session& session, binary::Stream stream, std::uint32_t symbolId) {
+    if (!hub_ || session.id == 0) return false;
+    if (stream == binary::Stream::Orders) {
+        hub_->unsubscribeOrders(session.id);
+    } else {
+        hub_->unsubscribeMarketData(session.id, symbolId);
+    }
+    return true;
+}
+
+std::string RequestHandler::handleText(const std::string& request, Session* session) {
+    const std::uint64_t received = core::stageClock();
+    std::istringstream iss(request);
+    std::string cmd;
+    iss >> cmd;
+    
+    if (cmd == "ADD_INSTRUMENT") {
+        std::string payload;
+        std::getline(iss, payload);
+        payload = trim(payload);
+        
+        std::vector<std::string> parts;
+        std::stringstream payloadStream(payload);
+        std::string part;
+        while (std::getline(payloadStream, part, '|')) {
+            parts.push_back(trim(part));
+        }
+        
+        if (parts.size() < 4) {
+            return "ERROR Invalid instrument payload\n";
+        }
+        
+        const std::string& ticker = parts[0];
+        const std::string& description = parts[1];
+        const std::string& industry = parts[2];
+        double initialPrice = 0.0;
+        try {
+            initialPrice = std::stod(parts[3]);
+        } catch (...) {
+            return "ERROR Invalid initial price\n";
+        }
+        
+        if (ticker.empty() || initialPrice <= 0.0) {
+            return "ERROR Invalid ticker\n";
+        }
+        
+        // Optional 5th field selects the book layout: MAP (default) or LADDER
+        book::BookType bookType = book::BookType::Map;
+        if (parts.size() >= 5 && !parts[4].empty()) {
+            if (parts[4] == "LADDER") {
+                bookType = book::BookType::Ladder;
+            } else if (parts[4] != "MAP") {
+                return "ERROR Invalid book type\n";
+            }
+        }
+        
+        // Optional 6th field selects the processor's idle behaviour
+        queue::WaitStrategyType waitStrategy = queue::WaitStrategyType::SpinYield;
+        if (parts.size() >= 6 && !parts[5].empty()) {
+            if (parts[5] == "SPIN") {
+                waitStrategy = queue::WaitStrategyType::BusySpin;
+            } else if (parts[5] == "PARK") {
+                waitStrategy = queue::WaitStrategyType::SpinPark;
+            } else if (parts[5] == "BACKOFF") {
+                waitStrategy = queue::WaitStrategyType::TimedBackoff;
+            } else if (parts[5] != "YIELD") {
+                return "ERROR Invalid wait strategy\n";
+            }
+        }
+        
+        std::uint32_t symbolId = 0;
+        try {
+            symbolId = service_.addInstrument(ticker, description, industry, initialPrice,
+                                               bookType, waitStrategy);
+        } catch (const std::exception&) {
+            return "ERROR Cannot add instrument\n"; // e.g. shard routing table full
+        }
+        return "OK " + std::to_string(symbolId) + "\n";
+        
+    } else if (cmd == "REMOVE_INSTRUMENT") {
+        std::uint32_t symbolId;
+        iss >> symbolId;
+        bool ok = service_.removeInstrument(symbolId);
+        return ok ? "OK\n" : "ERROR Instrument not found\n";
+        
+    } else if (cmd == "LIST_INSTRUMENTS") {
+        std::ostringstream oss;
+        auto instruments = service_.listInstruments();
+        oss << "INSTRUMENTS " << instruments.size() << "\n";
+        for (const auto& inst : instruments) {
+            oss << inst.symbolId << "|" << inst.ticker << "|" 
+                << inst.description << "|" << inst.industry << "|" << inst.initialPrice << "\n";
+        }
+        oss << "END\n";
+        return oss.str();
+        
+    } else if (cmd == "ADD") {
+        core::Order o;
+        const char* error = parseOrder(iss, o);
+        if (!service_.hasInstrument(o.symbolId)) {
+            return "ERROR Instrument not found\n";
+        }
+        if (error) {
+            return error;
+        }
+        
+        const core::OrderId orderId = nextOrderId(session);
+        o.orderId = orderId;
+        o.account = accountOf(session);
+        o.ts = arrivalTime();
+        
+        const std::uint64_t parsed = core::recordStage(core::Stage::Parse, received);
+        bool submitted = service_.submitOrder(std::move(o));
+        core::recordStage(core::Stage::Enqueue, parsed);
+        if (!submitted) {
+            return "ERROR Failed to submit order (queue full or validation failed)\n";
+        }
+        return "OK " + std::to_string(orderId) + "\n";
+        
+    } else if (cmd == "BATCH") {
+        // Up to MAX_BATCH_ORDERS orders on one line, each in ADD's fields,
+        // separated by ';'. Valid orders are handed to the service in one
+        // call; the reply has one line per entry, in entry order.
+        std::string payload;
+        std::getline(iss, payload);
+        thread_local std::vector<core::Order> orders;
+        thread_local std::vector<const char*> errors; // per entry; null: the next of orders
+        thread_local std::istringstream entry;
+        orders.clear();
+        errors.clear();
+        const core::Timestamp arrival = arrivalTime();
+        for (std::size_t start = 0; start < payload.size();) {
+            const std::size_t end = std::min(payload.find(';', start), payload.size());
+            const std::string fields = trim(payload.substr(start, end - start));
+            start = end + 1;
+            if (fields.empty()) continue;
+            if (errors.size() == core::MAX_BATCH_ORDERS) {
+                return "ERROR Batch too large (max " + std::to_string(core::MAX_BATCH_ORDERS) + " orders)\n";
+            }
+            entry.clear();
+            entry.str(fields);
+            core::Order o;
+            const char* error = parseOrder(entry, o);
+            errors.push_back(error);
+            if (error) continue;
+            o.ts = arrival;
+            o.account = accountOf(session);
+            orders.push_back(o);
+        }
+        if (errors.empty()) {
+            return "ERROR Empty batch\n";
+        }
+        // Ids only once the whole batch is accepted, so a refused one uses none
+        for (core::Order& o : orders) o.orderId = nextOrderId(session);
+
+        thread_local std::array<bool, core::MAX_BATCH_ORDERS> queued;
+        const std::uint64_t parsed = core::recordStage(core::Stage::Parse, received);
+        service_.submitOrders(orders, queued);
+        core::recordStage(core::Stage::Enqueue, parsed);
+
+        std::ostringstream oss;
+        oss << "BATCH " << errors.size() << "\n";
+        std::size_t next = 0;
+        for (const char* error : errors) {
+            if (error) {
+                oss << error;
+                continue;
+            }
+            const core::Order& o = orders[next];
+            if (queued[next++]) {
+                oss << "OK " << o.orderId << "\n";
+            } else if (!service_.hasInstrument(o.symbolId)) { // only looked up on the failure path
+                oss << "ERROR Instrument not found\n";
+            } else {
+                oss << "ERROR Failed to submit order (queue full)\n";
+            }
+        }
+        oss << "END\n";
+        return oss.str();
+        
+    } else if (cmd == "CANCEL") {
+        std::uint32_t symbolId;
+        unsigned long long orderId;
+        iss >> symbolId >> orderId;
+        if (!service_.hasInstrument(symbolId)) {
+            return "NOTFOUND\n";
+        }
+        // Queued behind earlier orders; the outcome is a CANCEL_ACK/CANCEL_REJECT event
+        const std::uint64_t parsed = core::recordStage(core::Stage::Parse, received);
+        bool ok = service_.cancelOrder(symbolId, orderId);
+        core::recordStage(core::Stage::Enqueue, parsed);
+        return ok ? "OK\n" : "ERROR Failed to submit cancel (queue full)\n";
+        
+    } else if (cmd == "AMEND") {
+        std::uint32_t symbolId;
+        unsigned long long orderId;
+        long long price;
+        long long qty;
+        iss >> symbolId >> orderId >> price >> qty;
+        if (!service_.hasInstrument(symbolId)) {
+            return "NOTFOUND\n";
+        }
+        // Outcome is an AMEND_ACK/AMEND_REJECT event
+        const std::uint64_t parsed = core::recordStage(core::Stage::Parse, received);
+        bool ok = service_.amendOrder(symbolId, orderId,
+                                       static_cast<core::Price>(price), static_cast<core::Quantity>(qty));
+        core::recordStage(core::Stage::Enqueue, parsed);
+        return ok ? "OK\n" : "ERROR Failed to submit amend (queue full)\n";
+        
+    } else if (cmd == "SNAPSHOT") {
+        std::uint32_t symbolId;
+        iss >> symbolId;
+        
+        if (!service_.hasInstrument(symbolId)) {
+            return "ERROR Instrument not found\n";
+        }
+        
+        std::ostringstream oss;
+        book::BookImage image;
+        service_.getBookImage(symbolId, image, 10);
+        
+        oss << "SNAPSHOT " << symbolId << "\n";
+        oss << "BIDS " << image.bidCount << "\n";
+        for (std::size_t i = 0; i < image.bidCount; ++i) {
+            const auto& l = image.bids[i];
+            oss << l.price << " " << l.total << " " << l.numOrders << "\n";
+        }
+        oss << "ASKS " << image.askCount << "\n";
+        for (std::size_t i = 0; i < image.askCount; ++i) {
+            const auto& l = image.asks[i];
+            oss << l.price << " " << l.total << " " << l.numOrders << "\n";
+        }
+        oss << "END\n";
+        return oss.str();
+        
+    } else if (cmd == "STATS") {
+        // STATS [THREADS | RESET]: per-stage latency, merged or per thread
+        std::string what;
+        iss >> what;
+        return statsReply(what);
+        
+    } else if (cmd == "METRICS") {
+        // Counters and queue depths per processor thread and instrument
+        return metricsReply(service_);
+        
+    } else if (cmd == "DROPPED_EVENTS") {
+        // Events lost to a full event queue, for one instrument or all of them
+        std::uint32_t symbolId = 0;
+        iss >> symbolId;
+        if (symbolId != 0 && !service_.hasInstrument(symbolId)) {
+            return "ERROR Instrument not found\n";
+        }
+        return "OK " + std::to_string(service_.droppedEvents(symbolId)) + "\n";
+        
+    } else if (cmd == "SUBSCRIBE" || cmd == "UNSUBSCRIBE") {
+        // SUBSCRIBE ORDERS | SUBSCRIBE MD <symbolId>; updates are pushed on this connection
+        std::string what;
+        iss >> what;
+        std::uint32_t symbolId = 0;
+        binary::Stream stream;
+        if (what == "ORDERS") {
+            stream = binary::Stream::Orders;
+        } else if (what == "MD" && (iss >> symbolId)) {
+            stream = binary::Stream::MarketData;
+            if (!service_.hasInstrument(symbolId)) {
+                return "ERROR Instrument not found\n";
+            }
+        } else {
+            return "ERROR Invalid subscription\n";
+        }
+        if (!session) {
+            return "ERROR Subscriptions not available\n";
+        }
+        const bool ok = cmd == "SUBSCRIBE" ? subscribe(*session, stream, symbolId)
+                                           : unsubscribe(*session, stream, symbolId);
+        return ok ? "OK\n" : "ERROR Subscriptions not available\n";
+        
+    } else if (cmd == "LOGON") {
+        // LOGON <account>: the risk account of this connection's orders, set once
+        unsigned long long account = 0;
+        if (!(iss >> account) || account == 0 || account > std::numeric_limits<std::uint32_t>::max()) {
+            return "ERROR Invalid account\n";
+        }
+        if (!session) {
+            return "ERROR Accounts not available\n";
+        }
+        if (session->account != 0 && session->account != account) {
+            return "ERROR Already logged on\n";
+        }
+        session->account = static_cast<std::uint32_t>(account);
+        return "OK\n";
+        
+    } else {
+        return "ERROR Unknown command\n";
+    }
+}
+
+WireProtocol RequestHandler::detect(const char* data, std::size_t size) noexcept {
+    if (size == 0) return WireProtocol::Unknown;
+    // Text commands start with a printable character; a binary stream starts
+    // with the low byte of the Logon length
+    const auto first = static_cast<unsigned char>(data[0]);
+    if (first >= 0x20 && first < 0x7F) return WireProtocol::Text;
+    if (size < sizeof(binary::LogonMsg)) return WireProtocol::Unknown;
+
+    const auto logon = binary::load<binary::LogonMsg>(data);
+    if (logon.header.type == binary::MsgType::Logon &&
+        logon.header.length == sizeof(binary::LogonMsg) &&
+        logon.magic == binary::LOGON_MAGIC) {
+        return WireProtocol::Binary;
+    }
+    return WireProtocol::Invalid;
+}
+
+std::size_t RequestHandler::handleBinary(const char* data, std::size_t size, std::string& out,
+                                         Session* session) {
+    std::size_t offset = 0;
+    while (size - offset >= sizeof(binary::MessageHeader)) {
+        const char* frame = data + offset;
+        const auto header = binary::load<binary::MessageHeader>(frame);
+        const std::size_t length = header.length;
+        if (length < sizeof(binary::MessageHeader)) return PROTOCOL_ERROR;
+        if (size - offset < length) break; // wait for the rest of the frame
+
+        switch (header.type) {
+            case binary::MsgType::Logon:           onLogon(frame, length, out, session); break;
+            case binary::MsgType::NewOrder:        onNewOrder(frame, length, out, session); break;
+            case binary::MsgType::NewStopOrder:    onNewStopOrder(frame, length, out, session); break;
+            case binary::MsgType::Cancel:          onCancel(frame, length, out); break;
+            case binary::MsgType::Amend:           onAmend(frame, length, out); break;
+            case binary::MsgType::SnapshotRequest: onSnapshot(frame, length, out); break;
+            case binary::MsgType::Subscribe:       onSubscribe(frame, length, out, session, true); break;
+            case binary::MsgType::Unsubscribe:     onSubscribe(frame, length, out, session, false); break;
+            default:
+                respond(out, header.type, binary::RejectReason::UnknownMessage, 0, 0, 0);
+                break;
+        }
+        offset += length;
+    }
+    return offset;
+}
+
+void RequestHandler::respond(std::string& out, binary::MsgType requestType, binary::RejectReason reason,
+                             std::uint32_t symbolId, core::OrderId orderId, std::uint64_t clientTag) {
+    auto msg = binary::make<binary::ResponseMsg>(
+        reason == binary::RejectReason::None ? binary::MsgType::Accepted : binary::MsgType::Rejected);
+    msg.symbolId = symbolId;
+    msg.orderId = orderId;
+    msg.clientTag = clientTag;
+    msg.requestType = requestType;
+    msg.reason = reason;
+    binary::append(out, msg);
+}
+
+void RequestHandler::onLogon(const char* data, std::size_t length, std::string& out, Session* session) {
+    if (length != sizeof(binary::LogonMsg)) {
+        respond(out, binary::MsgType::Logon, binary::RejectReason::Malformed, 0, 0, 0);
+        return;
+    }
+    const auto logon = binary::load<binary::LogonMsg>(data);
+    if (logon.account != 0) {
+        // The account is fixed by the first logon that names one
+        if (!session || (session->account != 0 && session->account != logon.account)) {
+            respond(out, binary::MsgType::Logon, binary::RejectReason::Malformed, 0, 0, 0);
+            return;
+        }
+        session->account = logon.account;
+    }
+    auto ack = binary::make<binary::LogonMsg>(binary::MsgType::LogonAck);
+    ack.magic = binary::LOGON_MAGIC;
+    ack.version = std::min(logon.version, binary::PROTOCOL_VERSION);
+    ack.account = static_cast<std::uint16_t>(accountOf(session));
+    binary::append(out, ack);
+}
+
+void RequestHandler::onNewOrder(const char* data, std::size_t length, std::string& out, Session* session) {
+    const std::uint64_t received = core::stageClock();
+    if (length != sizeof(binary::NewOrderMsg)) {
+        respond(out, binary::MsgType::NewOrder, binary::RejectReason::Malformed, 0, 0, 0);
+        return;
+    }
+    const auto msg = binary::load<binary::NewOrderMsg>(data);
+    if (msg.orderType != core::OrderType::Limit && msg.orderType != core::OrderType::Market) {
+        return respond(out, binary::MsgType::NewOrder, binary::RejectReason::Malformed, msg.symbolId, 0,
+                       msg.clientTag);
+    }
+    core::Order order{0, msg.symbolId, msg.side, msg.orderType, msg.price, msg.quantity, {}, msg.timeInForce};
+    enterOrder(binary::MsgType::NewOrder, order, msg.clientTag, out, session, received);
+}
+
+void RequestHandler::onNewStopOrder(const char* data, std::size_t length, std::string& out, Session* session) {
+    const std::uint64_t received = core::stageClock();
+    if (length != sizeof(binary::NewStopOrderMsg)) {
+        respond(out, binary::MsgType::NewStopOrder, binary::RejectReason::Malformed, 0, 0, 0);
+        return;
+    }
+    const auto msg = binary::load<binary::NewStopOrderMsg>(data);
+    if (!core::isStop(msg.orderType)) {
+        return respond(out, binary::MsgType::NewStopOrder, binary::RejectReason::Malformed, msg.symbolId, 0,
+                       msg.clientTag);
+    }
+    if (msg.stopPrice <= 0) {
+        return respond(out, binary::MsgType::NewStopOrder, binary::RejectReason::InvalidPrice, msg.symbolId, 0,
+                       msg.clientTag);
+    }
+    core::Order order{0, msg.symbolId, msg.side, msg.orderType, msg.price, msg.quantity, {}, msg.timeInForce,
+                      msg.stopPrice};
+    enterOrder(binary::MsgType::NewStopOrder, order, msg.clientTag, out, session, received);
+}
+
+void RequestHandler::enterOrder(binary::MsgType requestType, core::Order order, std::uint64_t clientTag,
+                                std::string& out, Session* session, std::uint64_t received) {
+    auto reject = [&](binary::RejectReason reason) {
+        respond(out, requestType, reason, order.symbolId, 0, clientTag);
+    };
+
+    // Same validation as the text ADD command
+    const bool limited = order.type == core::OrderType::Limit || order.type == core::OrderType::StopLimit;
+    if (order.side != core::Side::Buy && order.side != core::Side::Sell) return reject(binary::RejectReason::Malformed);
+    if (order.tif > core::TimeInForce::PostOnly) return reject(binary::RejectReason::Malformed);
+    if (order.tif == core::TimeInForce::PostOnly && order.type != core::OrderType::Limit) {
+        return reject(binary::RejectReason::Malformed);
+    }
+    if (limited && order.price <= 0) return reject(binary::RejectReason::InvalidPrice);
+    if (order.quantity <= 0) return reject(binary::RejectReason::InvalidQuantity);
+
+    if (!limited) {
+        order.price = (order.side == core::Side::Buy
+            ? std::numeric_limits<core::Price>::max()
+            : std::numeric_limits<core::Price>::min());
+    }
+
+    const std::uint32_t symbolId = order.symbolId;
+    const core::OrderId orderId = nextOrderId(session);
+    order.orderId = orderId;
+    order.account = accountOf(session);
+    order.ts = arrivalTime();
+    const std::uint64_t parsed = core::recordStage(core::Stage::Parse, received);
+    const bool submitted = service_.submitOrder(std::move(order));
+    core::recordStage(core::Stage::Enqueue, parsed);
+    if (!submitted) {
+        // Only look the instrument up again on the failure path
+        return reject(service_.hasInstrument(symbolId) ? binary::RejectReason::QueueFull
+                                                       : binary::RejectReason::UnknownInstrument);
+    }
+    respond(out, requestType, binary::RejectReason::None, symbolId, orderId, clientTag);
+}
+
+void RequestHandler::onCancel(const char* data, std::size_t length, std::string& out) {
+    const std::uint64_t received = core::stageClock();
+    if (length != sizeof(binary::CancelMsg)) {
+        respond(out, binary::MsgType::Cancel, binary::RejectReason::Malformed, 0, 0, 0);
+        return;
+    }
+    const auto msg = binary::load<binary::CancelMsg>(data);
+    auto reason = binary::RejectReason::None;
+    const std::uint64_t parsed = core::recordStage(core::Stage::Parse, received);
+    const bool queued = service_.cancelOrder(msg.symbolId, msg.orderId);
+    core::recordStage(core::Stage::Enqueue, parsed);
+    if (!queued) {
+        reason = service_.hasInstrument(msg.symbolId) ? binary::RejectReason::QueueFull
+                                                      : binary::RejectReason::UnknownInstrument;
+    }
+    respond(out, binary::MsgType::Cancel, reason, msg.symbolId, msg.orderId, msg.clientTag);
+}
+
+void RequestHandler::onAmend(const char* data, std::size_t length, std::string& out) {
+    const std::uint64_t received = core::stageClock();
+    if (length != sizeof(binary::AmendMsg)) {
+        respond(out, binary::MsgType::Amend, binary::RejectReason::Malformed, 0, 0, 0);
+        return;
+    }
+    const auto msg = binary::load<binary::AmendMsg>(data);
+    auto reason = binary::RejectReason::None;
+    const std::uint64_t parsed = core::recordStage(core::Stage::Parse, received);
+    const bool queued = service_.amendOrder(msg.symbolId, msg.orderId, msg.price, msg.quantity);
+    core::recordStage(core::Stage::Enqueue, parsed);
+    if (!queued) {
+        reason = service_.hasInstrument(msg.symbolId) ? binary::RejectReason::QueueFull
+                                                      : binary::RejectReason::UnknownInstrument;
+    }
+    respond(out, binary::MsgType::Amend, reason, msg.symbolId, msg.orderId, msg.clientTag);
+}
+
+static_assert(binary::MAX_SNAPSHOT_DEPTH <= core::BOOK_IMAGE_DEPTH, "snapshots are served from the book image");
+
+void RequestHandler::onSnapshot(const char* data, std::size_t length, std::string& out) {
+    if (length != sizeof(binary::SnapshotRequestMsg)) {
+        respond(out, binary::MsgType::SnapshotRequest, binary::RejectReason::Malformed, 0, 0, 0);
+        return;
+    }
+    const auto msg = binary::load<binary::SnapshotRequestMsg>(data);
+    if (!service_.hasInstrument(msg.symbolId)) {
+        respond(out, binary::MsgType::SnapshotRequest, binary::RejectReason::UnknownInstrument,
+                msg.symbolId, 0, msg.clientTag);
+        return;
+    }
+
+    const std::size_t depth = msg.depth == 0 ? binary::DEFAULT_SNAPSHOT_DEPTH
+                                             : std::min(msg.depth, binary::MAX_SNAPSHOT_DEPTH);
+    book::BookImage image;
+    service_.getBookImage(msg.symbolId, image, depth);
+
+    auto head = binary::make<binary::SnapshotHeader>(binary::MsgType::Snapshot);
+    head.header.length = static_cast<std::uint16_t>(
+        sizeof(binary::SnapshotHeader) + (image.bidCount + image.askCount) * sizeof(binary::SnapshotLevel));
+    head.symbolId = msg.symbolId;
+    head.clientTag = msg.clientTag;
+    head.bidCount = static_cast<std::uint16_t>(image.bidCount);
+    head.askCount = static_cast<std::uint16_t>(image.askCount);
+    binary::append(out, head);
+    auto appendLevels = [&out](const auto& levels, std::size_t count) {
+        for (std::size_t i = 0; i < count; ++i) {
+            binary::append(out, binary::SnapshotLevel{levels[i].price, levels[i].total,
+                                                      static_cast<std::uint64_t>(levels[i].numOrders)});
+        }
+    };
+    appendLevels(image.bids, image.bidCount);
+    appendLevels(image.asks, image.askCount);
+}
+
+void RequestHandler::onSubscribe(const char* data, std::size_t length, std::string& out,
+                                 Session* session, bool subscribe) {
+    const auto type = subscribe ? binary::MsgType::Subscribe : binary::MsgType::Unsubscribe;
+    if (length != sizeof(binary::SubscribeMsg)) {
+        respond(out, type, binary::RejectReason::Malformed, 0, 0, 0);
+        return;
+    }
+    const auto msg = binary::load<binary::SubscribeMsg>(data);
+    auto reason = binary::RejectReason::None;
+    if (msg.stream != binary::Stream::Orders && msg.stream != binary::Stream::MarketData) {
+        reason = binary::RejectReason::Malformed;
+    } else if (msg.stream == binary::Stream::MarketData && !service_.hasInstrument(msg.symbolId)) {
+        reason = binary::RejectReason::UnknownInstrument;
+    } else if (!session || !(subscribe ? this->subscribe(*session, msg.stream, msg.symbolId)
+                                       : unsubscribe(*session, msg.stream, msg.symbolId))) {
+        reason = binary::RejectReason::Unavailable;
+    }
+    respond(out, type, reason, msg.symbolId, 0, msg.clientTag);
+}
+
+void RequestHandler::appendPush(const PushMessage& msg, WireProtocol protocol, std::string& out) {
+    const auto header = msg.header();
+    if (protocol == WireProtocol::Binary) {
+        out.append(msg.bytes, header.length);
+        return;
+    }
+
+    // Text: one line per message
+    switch (header.type) {
+        case binary::MsgType::ExecutionReport: {
+            const auto report = binary::load<binary::ExecutionReportMsg>(msg.bytes);
+            out += "EXEC ";
+            out += execTypeName(report.execType);
+            out += ' ' + std::to_string(report.symbolId) + ' ' + std::to_string(report.orderId);
+            if (static_cast<events::EventType>(report.execType) == events::EventType::Trade) {
+                out += ' ' + std::to_string(report.contraOrderId) + ' ' + std::to_string(report.price) +
+                       ' ' + std::to_string(report.quantity) + (report.maker ? " MAKER" : " TAKER");
+            }
+            out += '\n';
+            break;
+        }
+        case binary::MsgType::Trade: {
+            const auto trade = binary::load<binary::TradeMsg>(msg.bytes);
+            out += "TRADE " + std::to_string(trade.symbolId) + ' ' + std::to_string(trade.price) + ' ' +
+                   std::to_string(trade.quantity) + '\n';
+            break;
+        }
+        case binary::MsgType::TopOfBook: {
+            const auto top = binary::load<binary::TopOfBookMsg>(msg.bytes);
+            out += "TOB " + std::to_string(top.symbolId) + ' ' + std::to_string(top.bidPrice) + ' ' +
+                   std::to_string(top.bidQuantity) + ' ' + std::to_string(top.askPrice) + ' ' +
+                   std::to_string(top.askQuantity) + '\n';
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+} // namespace ob::net
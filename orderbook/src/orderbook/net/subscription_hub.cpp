@@ -0,0 +1,140 @@
+#include "orderbook/net/subscription_hub.hpp"
+
+#include <algorithm>
+
+namespace ob::net {
+
+void SubscriptionHub::subscribeOrders(const std::shared_ptr<Subscriber>& subscriber) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    orders_[subscriber->session()] = subscriber;
+}
+
+void SubscriptionHub::unsubscribeOrders(std::uint32_t session) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    orders_.erase(session);
+}
+
+void SubscriptionHub::subscribeMarketData(const std::shared_ptr<Subscriber>& subscriber, std::uint32_t symbolId) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& subscribers = marketData_[symbolId];
+    if (std::find(subscribers.begin(), subscribers.end(), subscriber) == subscribers.end()) {
+        subscribers.push_back(subscriber);
+    }
+    // Send the current top of book to the newcomer on the next publish
+    lastTop_.erase(symbolId);
+    touched_.insert(symbolId);
+}
+
+void SubscriptionHub::unsubscribeMarketData(std::uint32_t session, std::uint32_t symbolId) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = marketData_.find(symbolId);
+    if (it == marketData_.end()) return;
+    auto& subscribers = it->second;
+    subscribers.erase(std::remove_if(subscribers.begin(), subscribers.end(),
+                                     [session](const auto& s) { return s->session() == session; }),
+                      subscribers.end());
+    if (subscribers.empty()) {
+        marketData_.erase(it);
+        lastTop_.erase(symbolId);
+    }
+}
+
+void SubscriptionHub::remove(std::uint32_t session) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    orders_.erase(session);
+    for (auto it = marketData_.begin(); it != marketData_.end();) {
+        auto& subscribers = it->second;
+        subscribers.erase(std::remove_if(subscribers.begin(), subscribers.end(),
+                                         [session](const auto& s) { return s->session() == session; }),
+                          subscribers.end());
+        if (subscribers.empty()) {
+            lastTop_.erase(it->first);
+            it = marketData_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void SubscriptionHub::report(core::OrderId orderId, const binary::ExecutionReportMsg& msg) {
+    const std::uint32_t owner = ownerOf(orderId);
+    if (owner == 0) return; // entered without a session
+    auto it = orders_.find(owner);
+    if (it != orders_.end()) it->second->pushReport(PushMessage::of(msg));
+}
+
+void SubscriptionHub::onEvent(const events::Event& event) {
+    const auto tsNs = static_cast<std::int64_t>(event.ts.time_since_epoch().count());
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto msg = binary::make<binary::ExecutionReportMsg>(binary::MsgType::ExecutionReport);
+    msg.symbolId = event.symbolId;
+    msg.execType = static_cast<std::uint8_t>(event.type);
+    msg.tsNs = tsNs;
+
+    if (event.type == events::EventType::Trade) {
+        const core::Trade trade = event.trade();
+        msg.price = trade.price;
+        msg.quantity = trade.quantity;
+        if (!orders_.empty()) {
+            msg.orderId = trade.takerId;
+            msg.contraOrderId = trade.makerId;
+            msg.maker = 0;
+            report(trade.takerId, msg);
+            msg.orderId = trade.makerId;
+            msg.contraOrderId = trade.takerId;
+            msg.maker = 1;
+            report(trade.makerId, msg);
+        }
+
+        auto subscribers = marketData_.find(event.symbolId);
+        if (subscribers != marketData_.end()) {
+            auto print = binary::make<binary::TradeMsg>(binary::MsgType::Trade);
+            print.symbolId = event.symbolId;
+            print.price = trade.price;
+            print.quantity = trade.quantity;
+            print.tsNs = tsNs;
+            const auto push = PushMessage::of(print);
+            for (const auto& subscriber : subscribers->second) subscriber->pushMarketData(push);
+            touched_.insert(event.symbolId);
+        }
+        return;
+    }
+
+    msg.orderId = event.orderId;
+    report(event.orderId, msg);
+    if (event.type == events::EventType::Ack || event.type == events::EventType::CancelAck ||
+        event.type == events::EventType::AmendAck) {
+        if (marketData_.count(event.symbolId)) touched_.insert(event.symbolId);
+    }
+}
+
+void SubscriptionHub::publishTopOfBook(const oms::IOrderBookService& service) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const std::uint32_t symbolId : touched_) {
+        auto subscribers = marketData_.find(symbolId);
+        if (subscribers == marketData_.end()) continue;
+
+        Top top;
+        book::BookImage image;
+        if (!service.getBookImage(symbolId, image, 1)) continue;
+        if (image.bidCount) top.bidPrice = image.bids[0].price, top.bidQuantity = image.bids[0].total;
+        if (image.askCount) top.askPrice = image.asks[0].price, top.askQuantity = image.asks[0].total;
+
+        auto last = lastTop_.find(symbolId);
+        if (last != lastTop_.end() && last->second == top) continue;
+        lastTop_[symbolId] = top;
+
+        auto msg = binary::make<binary::TopOfBookMsg>(binary::MsgType::TopOfBook);
+        msg.symbolId = symbolId;
+        msg.bidPrice = top.bidPrice;
+        msg.bidQuantity = top.bidQuantity;
+        msg.askPrice = top.askPrice;
+        msg.askQuantity = top.askQuantity;
+        const auto push = PushMessage::of(msg);
+        for (const auto& subscriber : subscribers->second) subscriber->pushMarketData(push);
+    }
+    touched_.clear();
+}
+
+} // namespace ob::net
@@ -0,0 +1,405 @@
+#include "orderbook/net/tcp_server.hpp"
+#include "orderbook/core/affinity.hpp"
+#include "orderbook/core/latency_stats.hpp"
+#include "orderbook/core/async_log.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace ob::net {
+
+namespace {
+
+void pinReactor(int cpu) {
+    if (!core::pinCurrentThread(cpu)) OB_LOG("REACTOR could not pin to cpu={}", cpu);
+}
+
+int openListener(std::uint16_t port, bool reusePort) {
+    const int fd = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        throw std::runtime_error("Failed to create socket");
+    }
+    int opt = 1;
+    ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+    // Only when there are several reactors: SO_REUSEPORT would also let a
+    // second server process bind the same port without an error
+    if (reusePort) ::setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &opt, sizeof(opt));
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(port);
+    if (::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+        ::close(fd);
+        throw std::runtime_error("Failed to bind socket");
+    }
+    if (::listen(fd, SOMAXCONN) < 0) {
+        ::close(fd);
+        throw std::runtime_error("Failed to listen on socket");
+    }
+    return fd;
+}
+
+std::uint16_t boundPort(int fd) {
+    sockaddr_in addr{};
+    socklen_t len = sizeof(addr);
+    ::getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &len);
+    return ntohs(addr.sin_port);
+}
+
+// Send stage: from the engine's event time to the report entering the
+// connection's output buffer
+void recordSend(const PushMessage& msg) noexcept {
+    if constexpr (core::LATENCY_STATS_ENABLED) {
+        if (msg.header().type != binary::MsgType::ExecutionReport) return;
+        const auto report = binary::load<binary::ExecutionReportMsg>(msg.bytes);
+        if (report.tsNs > 0) core::recordStage(core::Stage::Send, static_cast<std::uint64_t>(report.tsNs));
+    }
+}
+
+} // namespace
+
+// One epoll loop: a listener, a wake-up eventfd, and the connections it
+// accepted. The eventfd doubles as the Notifier for subscribed connections,
+// so pushed messages are written by the reactor that owns the socket.
+class TcpServer::Reactor final : public Notifier {
+public:
+    Reactor(TcpServer& server, std::uint16_t port, bool reusePort)
+        : server_(server),
+          listenFd_(openListener(port, reusePort)),
+          epollFd_(::epoll_create1(EPOLL_CLOEXEC)),
+          wakeFd_(::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)) {
+        if (epollFd_ < 0 || wakeFd_ < 0) {
+            closeFds();
+            throw std::runtime_error("Failed to create epoll instance");
+        }
+        epoll_event ev{};
+        ev.events = EPOLLIN | EPOLLET;
+        ev.data.ptr = &listenFd_;
+        ::epoll_ctl(epollFd_, EPOLL_CTL_ADD, listenFd_, &ev);
+        ev.events = EPOLLIN;
+        ev.data.ptr = &wakeFd_;
+        ::epoll_ctl(epollFd_, EPOLL_CTL_ADD, wakeFd_, &ev);
+    }
+
+    ~Reactor() override {
+        closeAll();
+        closeFds();
+    }
+
+    std::uint16_t port() const { return boundPort(listenFd_); }
+    std::size_t connectionCount() const noexcept { return connectionCount_.load(std::memory_order_relaxed); }
+
+    void wake() noexcept {
+        const std::uint64_t one = 1;
+        [[maybe_unused]] auto n = ::write(wakeFd_, &one, sizeof(one));
+    }
+
+    // Called by the event-drain thread for every push; only the first push
+    // since the last drain costs a syscall
+    void notify() noexcept override {
+        if (!pushPending_.exchange(true, std::memory_order_acq_rel)) wake();
+    }
+
+    void run(bool ticks) {
+        const auto& config = server_.config_;
+        std::vector<epoll_event> events(static_cast<std::size_t>(std::max(config.maxEventsPerWait, 1)));
+        const int timeout = (ticks && server_.onTick_) ? config.tickMs : -1;
+
+        while (server_.running_.load(std::memory_order_acquire)) {
+            const int n = ::epoll_wait(epollFd_, events.data(), static_cast<int>(events.size()), timeout);
+            for (int i = 0; i < n; ++i) {
+                void* tag = events[static_cast<std::size_t>(i)].data.ptr;
+                const std::uint32_t mask = events[static_cast<std::size_t>(i)].events;
+                if (tag == &listenFd_) {
+                    acceptAll();
+                } else if (tag == &wakeFd_) {
+                    onWake();
+                } else {
+                    Connection& conn = *static_cast<Connection*>(tag);
+                    if (!conn.closed) onConnectionEvent(conn, mask);
+                }
+            }
+            // Only now: later entries of the batch may still point at them
+            for (Connection* conn : closing_) connections_.erase(conn->fd);
+            closing_.clear();
+            if (timeout >= 0) server_.onTick_();
+        }
+        closeAll();
+    }
+
+private:
+    struct Connection {
+        int fd{-1};
+        WireProtocol protocol{WireProtocol::Unknown};
+        bool readPaused{false};      // backlog above maxPendingOutput
+        bool closed{false};          // session closed; freed after the current epoll batch
+        std::vector<char> in;
+        std::size_t inUsed{0};
+        std::string out;
+        std::size_t outSent{0};
+        RequestHandler::Session session;
+
+        ~Connection() {
+            if (fd >= 0) ::close(fd);
+        }
+        std::size_t pendingOutput() const noexcept { return out.size() - outSent; }
+    };
+
+    void closeFds() noexcept {
+        if (listenFd_ >= 0) ::close(listenFd_);
+        if (epollFd_ >= 0) ::close(epollFd_);
+        if (wakeFd_ >= 0) ::close(wakeFd_);
+    }
+
+    void acceptAll() {
+        for (;;) {
+            const int fd = ::accept4(listenFd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd < 0) {
+                // EAGAIN: drained. Anything else (EMFILE, aborted handshake)
+                // drops this attempt; edge-triggered, so keep going or stop
+                if (errno == EAGAIN || errno == EWOULDBLOCK) return;
+                if (errno == EINTR || errno == ECONNABORTED) continue;
+                return;
+            }
+            int one = 1;
+            ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+            auto conn = std::make_unique<Connection>();
+            conn->fd = fd;
+            conn->in.resize(server_.config_.readBufferSize);
+            epoll_event ev{};
+            ev.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+            ev.data.ptr = conn.get();
+            if (::epoll_ctl(epollFd_, EPOLL_CTL_ADD, fd, &ev) < 0) continue; // conn closes fd
+            // Only once registered, so a refused fd leaves no session behind;
+            // no event for it is handled before acceptAll returns
+            conn->session = server_.handler_.openSession(this);
+            connections_.emplace(fd, std::move(conn));
+            connectionCount_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    void onConnectionEvent(Connection& conn, std::uint32_t mask) {
+        bool open = (mask & EPOLLERR) == 0;
+        if (open && (mask & EPOLLOUT)) open = flush(conn);
+        if (open && (mask & (EPOLLIN | EPOLLRDHUP | EPOLLHUP))) open = readAll(conn);
+        if (!open) closeConnection(conn);
+    }
+
+    // Edge-triggered: read until EAGAIN, handling complete requests as they
+    // arrive. Returns false if the connection should be closed.
+    bool readAll(Connection& conn) {
+        if (conn.readPaused) return true;
+        for (;;) {
+            if (conn.inUsed == conn.in.size()) return false; // request larger than the buffer
+            const ssize_t n = ::recv(conn.fd, conn.in.data() + conn.inUsed, conn.in.size() - conn.inUsed, 0);
+            if (n == 0) return false;
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+                return false;
+            }
+            conn.inUsed += static_cast<std::size_t>(n);
+            if (!consume(conn)) return false;
+            if (conn.pendingOutput() > server_.config_.maxPendingOutput) {
+                if (!writeOut(conn)) return false;
+                if (conn.pendingOutput() > server_.config_.maxPendingOutput) {
+                    // Stop reading; flush() resumes once the client catches up
+                    conn.readPaused = true;
+                    return true;
+                }
+            }
+        }
+        return writeOut(conn);
+    }
+
+    // Handle every complete request in the read buffer and keep the tail
+    bool consume(Connection& conn) {
+        if (conn.protocol == WireProtocol::Unknown) {
+            conn.protocol = RequestHandler::detect(conn.in.data(), conn.inUsed);
+            if (conn.protocol == WireProtocol::Unknown) return true;
+            if (conn.protocol == WireProtocol::Invalid) return false;
+        }
+
+        std::size_t consumed = 0;
+        if (conn.protocol == WireProtocol::Text) {
+            const char* data = conn.in.data();
+            for (;;) {
+                const void* nl = std::memchr(data + consumed, '\n', conn.inUsed - consumed);
+                if (!nl) break;
+                const auto end = static_cast<std::size_t>(static_cast<const char*>(nl) - data) + 1;
+                conn.out += server_.handler_.handleText(std::string(data + consumed, end - consumed),
+                                                        &conn.session);
+                consumed = end;
+            }
+        } else {
+            consumed = server_.handler_.handleBinary(conn.in.data(), conn.inUsed, conn.out, &conn.session);
+            if (consumed == RequestHandler::PROTOCOL_ERROR) return false;
+        }
+
+        if (consumed > 0) {
+            std::memmove(conn.in.data(), conn.in.data() + consumed, conn.inUsed - consumed);
+            conn.inUsed -= consumed;
+        }
+        if (conn.session.subscriber) subscribed_.insert(&conn);
+        return true;
+    }
+
+    void onWake() {
+        std::uint64_t count = 0;
+        [[maybe_unused]] auto n = ::read(wakeFd_, &count, sizeof(count));
+        pushPending_.store(false, std::memory_order_release);
+
+        std::vector<Connection*> closing;
+        for (Connection* conn : subscribed_) {
+            if (!drainPushes(*conn)) closing.push_back(conn);
+        }
+        for (Connection* conn : closing) closeConnection(*conn);
+    }
+
+    // Write pushed messages out in batches of up to maxPendingOutput bytes.
+    // Stops when the subscriber is empty or the socket is full (EPOLLOUT
+    // calls back via flush). Returns false if the connection must be closed,
+    // including when the subscriber lost an execution report.
+    bool drainPushes(Connection& conn) {
+        const auto& subscriber = conn.session.subscriber;
+        if (!subscriber) return true;
+        if (subscriber->overflowed()) return false;
+        PushMessage msg;
+        for (;;) {
+            bool more = true;
+            while (conn.pendingOutput() < server_.config_.maxPendingOutput) {
+                if (!(more = subscriber->pop(msg))) break;
+                recordSend(msg);
+                RequestHandler::appendPush(msg, conn.protocol, conn.out);
+            }
+            if (!writeOut(conn)) return false;
+            if (!more || conn.pendingOutput() > 0) return true;
+        }
+    }
+
+    // Write as much of the backlog as the socket takes; EPOLLOUT (already
+    // registered) brings us back for the rest
+    bool writeOut(Connection& conn) {
+        while (conn.pendingOutput() > 0) {
+            const ssize_t n = ::send(conn.fd, conn.out.data() + conn.outSent, conn.pendingOutput(), MSG_NOSIGNAL);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                if (errno == EAGAIN || errno == EWOULDBLOCK) return true;
+                return false;
+            }
+            conn.outSent += static_cast<std::size_t>(n);
+        }
+        conn.out.clear();
+        conn.outSent = 0;
+        return true;
+    }
+
+    // Socket became writable
+    bool flush(Connection& conn) {
+        if (!writeOut(conn)) return false;
+        // Pushes left queued while the backlog was full
+        if (!drainPushes(conn)) return false;
+        if (conn.readPaused && conn.pendingOutput() == 0) {
+            conn.readPaused = false;
+            // Input may already be buffered (no new edge will come for it)
+            return consume(conn) && readAll(conn);
+        }
+        return true;
+    }
+
+    // The fd stays open until the connection is freed, so it cannot be
+    // reused by an accept within the same batch
+    void closeConnection(Connection& conn) {
+        if (conn.closed) return;
+        conn.closed = true;
+        ::epoll_ctl(epollFd_, EPOLL_CTL_DEL, conn.fd, nullptr);
+        server_.handler_.closeSession(conn.session);
+        subscribed_.erase(&conn);
+        closing_.push_back(&conn);
+        connectionCount_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    void closeAll() {
+        for (auto& [fd, conn] : connections_) {
+            if (!conn->closed) server_.handler_.closeSession(conn->session);
+        }
+        subscribed_.clear();
+        closing_.clear();
+        connections_.clear();
+        connectionCount_.store(0, std::memory_order_relaxed);
+    }
+
+    TcpServer& server_;
+    int listenFd_{-1};
+    int epollFd_{-1};
+    int wakeFd_{-1};
+    std::unordered_map<int, std::unique_ptr<Connection>> connections_;
+    std::unordered_set<Connection*> subscribed_;   // connections with a push subscriber
+    std::vector<Connection*> closing_;             // closed during this epoll batch, still owned by connections_
+    std::atomic<std::size_t> connectionCount_{0};
+    std::atomic<bool> pushPending_{false};
+};
+
+TcpServer::TcpServer(RequestHandler& handler, ServerConfig config, std::function<void()> onTick)
+    : handler_(handler), config_(config), onTick_(std::move(onTick)), running_(true) {
+    const std::size_t count = std::max<std::size_t>(config_.reactors, 1);
+    reactors_.reserve(count);
+    // The first listener may pick the port; the rest share it via SO_REUSEPORT
+    reactors_.push_back(std::make_unique<Reactor>(*this, config_.port, count > 1));
+    port_ = reactors_.front()->port();
+    for (std::size_t i = 1; i < count; ++i) {
+        reactors_.push_back(std::make_unique<Reactor>(*this, port_, true));
+    }
+}
+
+TcpServer::~TcpServer() {
+    stop();
+    for (auto& thread : threads_) {
+        if (thread.joinable()) thread.join();
+    }
+}
+
+void TcpServer::run() {
+    const std::vector<int>& cpus = config_.cpus;
+    for (std::size_t i = 1; i < reactors_.size(); ++i) {
+        threads_.emplace_back([this, i, &cpus] {
+            if (!cpus.empty()) pinReactor(cpus[i % cpus.size()]);
+            core::nameStatsThread("reactor-" + std::to_string(i));
+            reactors_[i]->run(false);
+        });
+    }
+    if (!cpus.empty()) pinReactor(cpus.front());
+    core::nameStatsThread("reactor-0");
+    reactors_.front()->run(true);
+    for (auto& thread : threads_) {
+        if (thread.joinable()) thread.join();
+    }
+    threads_.clear();
+}
+
+void TcpServer::stop() {
+    running_.store(false, std::memory_order_release);
+    for (auto& reactor : reactors_) reactor->wake();
+}
+
+std::size_t TcpServer::connectionCount() const noexcept {
+    std::size_t total = 0;
+    for (const auto& reactor : reactors_) total += reactor->connectionCount();
+    return total;
+}
+
+} // namespace ob::net
@@ -1,27 +1,116 @@
 #include "orderbook/oms/instrument_manager.hpp"
+#include "orderbook/core/epoch.hpp"
+#include "orderbook/core/async_log.hpp"
 #include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <map>
+#include <stdexcept>
+#include <thread>
 
 namespace ob::oms {
 
+namespace {
+
+journal::InstrumentEntry toJournalEntry(const core::Instrument& instrument, book::BookType bookType,
+                                        queue::WaitStrategyType waitStrategy) {
+    journal::InstrumentEntry entry;
+    entry.symbolId = instrument.symbolId;
+    entry.ticker = instrument.ticker;
+    entry.description = instrument.description;
+    entry.industry = instrument.industry;
+    entry.initialPrice = instrument.initialPrice;
+    entry.bookType = static_cast<std::uint8_t>(bookType);
+    entry.waitStrategy = static_cast<std::uint8_t>(waitStrategy);
+    return entry;
+}
+
+} // namespace
+
 InstrumentManager::InstrumentManager() = default;
 
+InstrumentManager::InstrumentManager(const processors::ShardConfig& shardConfig) {
+    const std::size_t numShards = std::max<std::size_t>(shardConfig.numShards, 1);
+    shards_.reserve(numShards);
+    for (std::size_t i = 0; i < numShards; ++i) {
+        shards_.push_back(std::make_unique<processors::ShardProcessor>(i, shardConfig));
+        shards_.back()->start();
+    }
+}
+
+void InstrumentManager::assignShard(const std::string& ticker, std::size_t shard) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    shardAssignments_[ticker] = shard;
+}
+
+void InstrumentManager::setRiskLimits(const risk::RiskLimits& limits) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    riskLimits_ = limits;
+}
+
+void InstrumentManager::setResources(const InstrumentResources& resources) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    resources_ = resources;
+}
+
 std::uint32_t InstrumentManager::addInstrument(const std::string& ticker,
                                                const std::string& description,
                                                const std::string& industry,
-                                               double initialPrice) {
+                                               double initialPrice,
+                                               book::BookType bookType,
+                                               queue::WaitStrategyType waitStrategy) {
     std::lock_guard<std::mutex> lock(mutex_);
     
     std::uint32_t symbolId = nextSymbolId_++;
+    const core::Instrument instrument(symbolId, ticker, description, industry, initialPrice);
+    auto oms = createOms(instrument, bookType, waitStrategy);
+    const auto entry = toJournalEntry(instrument, bookType, waitStrategy);
+    if (journal_) journal_->appendInstrumentAdded(entry);
+    install(instrument, std::move(oms));
+    entries_[symbolId] = entry;
     
+    return symbolId;
+}
+
+std::unique_ptr<OrderManagementSystem> InstrumentManager::createOms(const core::Instrument& instrument,
+                                                                    book::BookType bookType,
+                                                                    queue::WaitStrategyType waitStrategy) {
     // Create new OMS instance for this instrument
-    auto oms = std::make_unique<OrderManagementSystem>();
-    oms->start();
+    OmsConfig config;
+    config.bookType = bookType;
+    config.waitStrategy = waitStrategy;
+    config.referencePrice = static_cast<core::Price>(std::llround(instrument.initialPrice));
+    config.symbolId = instrument.symbolId;
+    config.eventQueueSize = core::DEFAULT_EVENT_QUEUE_SIZE;
+    config.journal = journal_.get();
+    config.risk = riskLimits_;
+    config.memory = resources_.memory;
+    config.prewarmOrders = resources_.prewarmOrders;
+    if (shards_.empty()) {
+        if (!resources_.cpus.empty()) {
+            config.cpu = resources_.cpus[(instrument.symbolId - 1) % resources_.cpus.size()];
+        }
+        return std::make_unique<OrderManagementSystem>(config);
+    }
+    auto assigned = shardAssignments_.find(instrument.ticker);
+    const std::size_t shard =
+        (assigned != shardAssignments_.end() ? assigned->second : instrument.symbolId) % shards_.size();
+    return std::make_unique<OrderManagementSystem>(config, *shards_[shard], instrument.symbolId);
+}
+
+void InstrumentManager::install(const core::Instrument& instrument, std::unique_ptr<OrderManagementSystem> oms) {
+    const std::uint32_t symbolId = instrument.symbolId;
+    if (!oms->shard()) oms->start();
+    if (eventCallback_) oms->setEventCallback(eventCallback_);
+    if (!drainers_.empty()) attachDrain(symbolId, *oms);
     
-    // Store instrument metadata
-    instruments_[symbolId] = core::Instrument(symbolId, ticker, description, industry, initialPrice);
+    // Store instrument metadata, then make the OMS visible to lock-free readers
+    OrderManagementSystem* published = oms.get();
+    if (!symbols_.publish(symbolId, published)) {
+        throw std::length_error("symbol id space exhausted");
+    }
+    instruments_[symbolId] = instrument;
     orderBooks_[symbolId] = std::move(oms);
-    
-    return symbolId;
 }
 
 bool InstrumentManager::removeInstrument(std::uint32_t symbolId) {
@@ -32,17 +121,22 @@ bool InstrumentManager::removeInstrument(std::uint32_t symbolId) {
         return false;
     }
     
-    // Stop the OMS before removing
+    // Unlink from the lookup table and wait out readers that may still hold
+    // the pointer before the OMS is stopped and destroyed
+    symbols_.unpublish(symbolId);
+    core::synchronizeEpoch();
     it->second->stop();
+    removedDropped_ += it->second->droppedEvents();
     orderBooks_.erase(it);
     instruments_.erase(symbolId);
+    entries_.erase(symbolId);
+    if (journal_) journal_->appendInstrumentRemoved(symbolId);
     
     return true;
 }
 
 bool InstrumentManager::hasInstrument(std::uint32_t symbolId) const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return orderBooks_.find(symbolId) != orderBooks_.end();
+    return symbols_.find(symbolId) != nullptr;
 }
 
 std::optional<core::Instrument> InstrumentManager::getInstrument(std::uint32_t symbolId) const {
@@ -70,6 +164,7 @@ std::vector<core::Instrument> InstrumentManager::listInstruments() const {
 }
 
 bool InstrumentManager::submitOrder(const core::Order& order) {
+    core::EpochGuard guard;
     auto* oms = getOMS(order.symbolId);
     if (!oms) {
         return false;
@@ -78,6 +173,7 @@ bool InstrumentManager::submitOrder(const core::Order& order) {
 }
 
 bool InstrumentManager::submitOrder(core::Order&& order) {
+    core::EpochGuard guard;
     auto* oms = getOMS(order.symbolId);
     if (!oms) {
         return false;
@@ -85,7 +181,24 @@ bool InstrumentManager::submitOrder(core::Order&& order) {
     return oms->submitOrder(std::move(order));
 }
 
+std::size_t InstrumentManager::submitOrders(std::span<const core::Order> orders, std::span<bool> queued) {
+    core::EpochGuard guard;
+    std::size_t total = 0;
+    for (std::size_t begin = 0; begin < orders.size();) {
+        const std::uint32_t symbolId = orders[begin].symbolId;
+        std::size_t end = begin + 1;
+        while (end < orders.size() && orders[end].symbolId == symbolId) ++end;
+        auto* oms = getOMS(symbolId);
+        const std::size_t n = oms ? oms->submitOrders(orders.data() + begin, end - begin) : 0;
+        for (std::size_t i = begin; i < end; ++i) queued[i] = i - begin < n;
+        total += n;
+        begin = end;
+    }
+    return total;
+}
+
 bool InstrumentManager::cancelOrder(std::uint32_t symbolId, core::OrderId orderId) {
+    core::EpochGuard guard;
     auto* oms = getOMS(symbolId);
     if (!oms) {
         return false;
@@ -93,7 +206,18 @@ bool InstrumentManager::cancelOrder(std::uint32_t symbolId, core::OrderId orderI
     return oms->cancelOrder(orderId);
 }
 
+bool InstrumentManager::amendOrder(std::uint32_t symbolId, core::OrderId orderId,
+                                   core::Price newPrice, core::Quantity newQuantity) {
+    core::EpochGuard guard;
+    auto* oms = getOMS(symbolId);
+    if (!oms) {
+        return false;
+    }
+    return oms->amendOrder(orderId, newPrice, newQuantity);
+}
+
 std::optional<core::Price> InstrumentManager::getBestBid(std::uint32_t symbolId) const {
+    core::EpochGuard guard;
     auto* oms = getOMS(symbolId);
     if (!oms) {
         return std::nullopt;
@@ -102,6 +226,7 @@ std::optional<core::Price> InstrumentManager::getBestBid(std::uint32_t symbolId)
 }
 
 std::optional<core::Price> InstrumentManager::getBestAsk(std::uint32_t symbolId) const {
+    core::EpochGuard guard;
     auto* oms = getOMS(symbolId);
     if (!oms) {
         return std::nullopt;
@@ -110,6 +235,7 @@ std::optional<core::Price> InstrumentManager::getBestAsk(std::uint32_t symbolId)
 }
 
 std::vector<book::LevelSummary> InstrumentManager::getBidsSnapshot(std::uint32_t symbolId, std::size_t depth) const {
+    core::EpochGuard guard;
     auto* oms = getOMS(symbolId);
     if (!oms) {
         return {};
@@ -118,6 +244,7 @@ std::vector<book::LevelSummary> InstrumentManager::getBidsSnapshot(std::uint32_t
 }
 
 std::vector<book::LevelSummary> InstrumentManager::getAsksSnapshot(std::uint32_t symbolId, std::size_t depth) const {
+    core::EpochGuard guard;
     auto* oms = getOMS(symbolId);
     if (!oms) {
         return {};
@@ -125,8 +252,19 @@ std::vector<book::LevelSummary> InstrumentManager::getAsksSnapshot(std::uint32_t
     return oms->getAsksSnapshot(depth);
 }
 
+bool InstrumentManager::getBookImage(std::uint32_t symbolId, book::BookImage& out, std::size_t depth) const {
+    core::EpochGuard guard;
+    auto* oms = getOMS(symbolId);
+    if (!oms) {
+        return false;
+    }
+    oms->readBookImage(out, depth);
+    return true;
+}
+
 void InstrumentManager::processEvents() {
     std::lock_guard<std::mutex> lock(mutex_);
+    if (!drainers_.empty()) return; // the drain threads own the event queues
     for (auto& [symbolId, oms] : orderBooks_) {
         oms->processEvents();
     }
@@ -134,16 +272,267 @@ void InstrumentManager::processEvents() {
 
 void InstrumentManager::setEventCallback(EventCallback callback) {
     std::lock_guard<std::mutex> lock(mutex_);
+    eventCallback_ = std::move(callback);
+    for (auto& [symbolId, oms] : orderBooks_) {
+        oms->setEventCallback(eventCallback_);
+    }
+}
+
+bool InstrumentManager::startEventDrain(const processors::EventDrainConfig& config) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!drainers_.empty()) return false;
+    const std::size_t count = config.threads != 0 ? config.threads : std::max<std::size_t>(shards_.size(), 1);
+    drainers_.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        drainers_.push_back(std::make_unique<processors::EventDrainer>(i, config));
+    }
+    for (auto& [symbolId, oms] : orderBooks_) {
+        attachDrain(symbolId, *oms);
+    }
+    for (auto& drainer : drainers_) {
+        drainer->start();
+    }
+    return true;
+}
+
+void InstrumentManager::attachDrain(std::uint32_t symbolId, OrderManagementSystem& oms) {
+    // A shard's instruments share a drainer, so one thread sees all of them
+    const std::size_t group = oms.shard() ? oms.shard()->index() : symbolId;
+    oms.attachEventDrain(*drainers_[group % drainers_.size()]);
+}
+
+std::uint64_t InstrumentManager::droppedEvents(std::uint32_t symbolId) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (symbolId != 0) {
+        auto it = orderBooks_.find(symbolId);
+        return it != orderBooks_.end() ? it->second->droppedEvents() : 0;
+    }
+    std::uint64_t total = removedDropped_;
+    for (const auto& [id, oms] : orderBooks_) {
+        total += oms->droppedEvents();
+    }
+    return total;
+}
+
+void InstrumentManager::collectMetrics(core::ServiceMetrics& out) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    out.processors.clear();
+    out.instruments.clear();
+    for (const auto& shard : shards_) {
+        const core::ProcessorMetrics& metrics = shard->metrics();
+        const queue::OrderQueue& ingress = *shard->orderQueue();
+        core::ProcessorSample& sample = out.processors.emplace_back();
+        sample.name = "shard-" + std::to_string(shard->index());
+        sample.batches = metrics.batches.load();
+        sample.commands = metrics.commands.load();
+        sample.ingress = core::QueueSample{ingress.size(), ingress.capacity(), metrics.ingressPeak.load(),
+                                           ingress.pushFailures()};
+    }
+    std::vector<std::uint32_t> symbolIds;
+    symbolIds.reserve(orderBooks_.size());
+    for (const auto& entry : orderBooks_) symbolIds.push_back(entry.first);
+    std::sort(symbolIds.begin(), symbolIds.end());
+    for (const std::uint32_t symbolId : symbolIds) {
+        const OrderManagementSystem* oms = orderBooks_.at(symbolId).get();
+        core::InstrumentSample& sample = out.instruments.emplace_back();
+        if (auto* shard = oms->shard()) {
+            oms->sampleMetrics(sample);
+            sample.processor = "shard-" + std::to_string(shard->index());
+        } else {
+            core::ProcessorSample& processor = out.processors.emplace_back();
+            oms->sampleMetrics(sample, &processor);
+            processor.name = "instrument-" + std::to_string(symbolId);
+            sample.processor = processor.name;
+        }
+    }
+}
+
+std::optional<journal::RecoveryStats> InstrumentManager::openJournal(const journal::JournalConfig& config) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (journal_ || !orderBooks_.empty()) return std::nullopt;
+
+    const auto started = std::chrono::steady_clock::now();
+    journal::RecoveryStats stats;
+
+    // Newest valid snapshot first: it stands in for the journal before its cuts
+    std::unique_ptr<journal::SnapshotReader> snapshot;
+    const auto snapshots = journal::listSnapshots(config.directory);
+    if (!snapshots.empty()) lastSnapshotId_ = snapshots.back().first;
+    for (auto it = snapshots.rbegin(); it != snapshots.rend() && !snapshot; ++it) {
+        auto candidate = std::make_unique<journal::SnapshotReader>(it->second);
+        if (candidate->valid()) {
+            snapshot = std::move(candidate);
+        } else {
+            OB_LOG("SNAPSHOT {} is damaged, trying an older one", it->first);
+        }
+    }
+
+    std::map<std::uint32_t, journal::InstrumentEntry> live;
+    std::unordered_map<std::uint32_t, const journal::SnapshotSection*> loaded;
+    std::uint32_t maxSymbolId = 0;
+    std::uint64_t firstSegment = 1;
+    if (snapshot) {
+        const auto& header = snapshot->header();
+        stats.snapshotId = header.id;
+        stats.maxOrderId = header.nextOrderId != 0 ? header.nextOrderId - 1 : 0;
+        maxSymbolId = header.nextSymbolId != 0 ? header.nextSymbolId - 1 : 0;
+        firstSegment = header.journalSegment;
+        keptSnapshotId_ = header.id;
+        keptSegment_ = header.journalSegment;
+        for (const auto& section : snapshot->sections()) {
+            live[section.instrument.symbolId] = section.instrument;
+            loaded[section.instrument.symbolId] = &section;
+        }
+    }
+
+    journal::JournalReader reader(config.directory, firstSegment);
+    journal::JournalRecord record;
+
+    // Pass 1: the instruments still live at the end, and the ids already used
+    while (reader.next(record)) {
+        ++stats.records;
+        if (record.type == journal::RecordType::Command) {
+            if (record.command.type == core::CommandType::NewOrder) {
+                stats.maxOrderId = std::max(stats.maxOrderId, record.command.orderId);
+            }
+        } else if (record.type == journal::RecordType::InstrumentAdded) {
+            maxSymbolId = std::max(maxSymbolId, record.instrument.symbolId);
+            live[record.instrument.symbolId] = record.instrument;
+        } else if (record.type == journal::RecordType::InstrumentRemoved) {
+            live.erase(record.instrument.symbolId);
+        }
+    }
+    stats.lastSequence = reader.lastSequence();
+    stats.tornSegments = reader.tornSegments();
+    recoveredMaxOrderId_ = stats.maxOrderId;
+
+    // New records go to a fresh segment, so a torn tail is never appended to
+    journal_ = std::make_unique<journal::JournalWriter>(config, reader.lastSegment() + 1, stats.lastSequence + 1);
+    for (auto& shard : shards_) {
+        shard->setJournal(journal_.get());
+    }
+
+    // Pass 2: rebuild their books, from the snapshot where there is one,
+    // then bring them up as if just added
+    std::unordered_map<std::uint32_t, std::unique_ptr<OrderManagementSystem>> rebuilt;
+    for (const auto& [symbolId, entry] : live) {
+        const core::Instrument instrument(symbolId, entry.ticker, entry.description, entry.industry, entry.initialPrice);
+        auto oms = createOms(instrument, static_cast<book::BookType>(entry.bookType),
+                             static_cast<queue::WaitStrategyType>(entry.waitStrategy));
+        auto section = loaded.find(symbolId);
+        if (section != loaded.end()) {
+            oms->loadSnapshot(section->second->orders, section->second->orderCount);
+            oms->loadStops(section->second->stops, section->second->stopCount, section->second->lastTradePrice);
+            oms->loadRisk(section->second->accounts, section->second->accountCount, section->second->riskReference);
+            stats.snapshotOrders += section->second->orderCount;
+        }
+        rebuilt[symbolId] = std::move(oms);
+    }
+    reader.rewind();
+    while (reader.next(record)) {
+        if (record.type != journal::RecordType::Command) continue;
+        const core::Command& command = record.command;
+        auto it = rebuilt.find(command.symbolId);
+        if (it == rebuilt.end()) continue; // removed since, or never existed
+        auto section = loaded.find(command.symbolId);
+        if (section != loaded.end()) {
+            // Already in the snapshot up to and including the book's cut
+            if (command.type == core::CommandType::Snapshot && command.orderId == stats.snapshotId) {
+                loaded.erase(section);
+            }
+            continue;
+        }
+        it->second->replay(command);
+        ++stats.commands;
+    }
+    for (auto& [symbolId, oms] : rebuilt) {
+        oms->finishReplay();
+        const auto& entry = live[symbolId];
+        install(core::Instrument(symbolId, entry.ticker, entry.description, entry.industry, entry.initialPrice),
+                std::move(oms));
+        entries_[symbolId] = entry;
+    }
+    stats.instruments = rebuilt.size();
+    if (maxSymbolId >= nextSymbolId_) nextSymbolId_ = maxSymbolId + 1; // ids of removed instruments stay retired
+    journal_->start();
+    stats.elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - started);
+    return stats;
+}
+
+std::optional<journal::SnapshotStats> InstrumentManager::saveSnapshot() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!journal_ || !journal_->isRunning()) return std::nullopt;
+
+    const auto started = std::chrono::steady_clock::now();
+    journal::SnapshotStats stats;
+    stats.id = ++lastSnapshotId_;
+    // Taken before any cut is queued, so every cut lands in this segment or later
+    stats.journalSegment = journal_->currentSegment();
+
+    // Cut every book; add and remove wait on mutex_ until the snapshot is
+    // written, so the set of instruments cannot change underneath
+    std::vector<std::pair<std::uint32_t, std::unique_ptr<book::BookSnapshot>>> captures;
+    captures.reserve(orderBooks_.size());
     for (auto& [symbolId, oms] : orderBooks_) {
-        oms->setEventCallback(callback);
+        auto capture = std::make_unique<book::BookSnapshot>();
+        while (!oms->requestSnapshot(*capture, stats.id)) {
+            std::this_thread::yield(); // ingress queue full
+        }
+        captures.emplace_back(symbolId, std::move(capture));
     }
+    for (const auto& [symbolId, capture] : captures) {
+        while (!capture->complete.load(std::memory_order_acquire)) {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+    }
+    stats.capture = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - started);
+
+    // The cuts must be in the journal before a snapshot refers to them
+    journal_->flush();
+    journal::SnapshotHeader header;
+    header.id = stats.id;
+    header.journalSegment = stats.journalSegment;
+    header.nextOrderId = std::max(recoveredMaxOrderId_, journal_->stats().maxOrderId) + 1;
+    header.nextSymbolId = nextSymbolId_.load();
+    std::vector<journal::SnapshotSection> sections;
+    sections.reserve(captures.size());
+    for (const auto& [symbolId, capture] : captures) {
+        journal::SnapshotSection& section = sections.emplace_back();
+        section.instrument = entries_[symbolId];
+        section.orders = capture->orders.data();
+        section.orderCount = capture->orders.size();
+        section.stops = capture->stops.data();
+        section.stopCount = capture->stops.size();
+        section.lastTradePrice = capture->lastTradePrice;
+        section.accounts = capture->accounts.data();
+        section.accountCount = capture->accounts.size();
+        section.riskReference = capture->riskReference;
+        stats.orders += section.orderCount;
+    }
+    stats.bytes = journal::writeSnapshot(journal_->directory(), header, sections);
+    stats.instruments = sections.size();
+
+    // Keep the previous snapshot (and the journal it needs) in case this one
+    // turns out unreadable; anything older is superseded
+    if (keptSnapshotId_ != 0) journal::pruneJournal(journal_->directory(), keptSnapshotId_, keptSegment_);
+    keptSnapshotId_ = stats.id;
+    keptSegment_ = stats.journalSegment;
+    stats.elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - started);
+    return stats;
 }
 
 void InstrumentManager::start() {
     std::lock_guard<std::mutex> lock(mutex_);
+    if (journal_) journal_->start();
+    for (auto& shard : shards_) {
+        shard->start();
+    }
     for (auto& [symbolId, oms] : orderBooks_) {
         oms->start();
     }
+    for (auto& drainer : drainers_) {
+        drainer->start();
+    }
 }
 
 void InstrumentManager::stop() {
@@ -151,6 +540,15 @@ void InstrumentManager::stop() {
     for (auto& [symbolId, oms] : orderBooks_) {
         oms->stop();
     }
+    for (auto& shard : shards_) {
+        shard->stop();
+    }
+    // Once nothing appends any more, so every applied input is written
+    if (journal_) journal_->stop();
+    // Last, so events published before the engines stopped are still delivered
+    for (auto& drainer : drainers_) {
+        drainer->stop();
+    }
 }
 
 bool InstrumentManager::isRunning() const noexcept {
@@ -159,12 +557,8 @@ bool InstrumentManager::isRunning() const noexcept {
 }
 
 OrderManagementSystem* InstrumentManager::getOMS(std::uint32_t symbolId) const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    auto it = orderBooks_.find(symbolId);
-    if (it == orderBooks_.end()) {
-        return nullptr;
-    }
-    return it->second.get();
+    // Wait-free; the caller must hold an EpochGuard while using the result
+    return symbols_.find(symbolId);
 }
 
 } // namespace ob::oms
@@ -1,50 +1,137 @@
 #include "orderbook/oms/order_management_system.hpp"
 
+#include <stdexcept>
+
 namespace ob::oms {
 
-OrderManagementSystem::OrderManagementSystem(std::size_t queueSize) {
-    // Create SPSC queues
-    orderQueue_ = std::make_shared<queue::SpscRingBuffer<core::Order>>(queueSize);
-    eventQueue_ = std::make_shared<queue::SpscRingBuffer<events::Event>>(queueSize);
+namespace {
+
+std::shared_ptr<book::IOrderBook> makeOrderBook(const OmsConfig& config) {
+    std::shared_ptr<book::IOrderBook> book;
+    switch (config.bookType) {
+        case book::BookType::Ladder:
+            book = std::make_shared<book::LadderOrderBook>(config.referencePrice, config.ladderLevels);
+            break;
+        case book::BookType::Map:
+        default:
+            book = std::make_shared<book::OrderBook>();
+            break;
+    }
+    if (config.prewarmOrders != 0 || !config.memory.plain()) book->prewarm(config.prewarmOrders, config.memory);
+    return book;
+}
+
+std::shared_ptr<risk::PreTradeRisk> makeRisk(const OmsConfig& config) {
+    if (!config.risk.enabled()) return nullptr;
+    return std::make_shared<risk::PreTradeRisk>(config.risk, config.referencePrice);
+}
+
+std::size_t eventQueueSize(const OmsConfig& config) {
+    return config.eventQueueSize != 0 ? config.eventQueueSize : config.queueSize;
+}
+
+OmsConfig withQueueSize(std::size_t queueSize) {
+    OmsConfig config;
+    config.queueSize = queueSize;
+    return config;
+}
+
+} // namespace
+
+OrderManagementSystem::OrderManagementSystem(std::size_t queueSize)
+    : OrderManagementSystem(withQueueSize(queueSize)) {}
+
+OrderManagementSystem::OrderManagementSystem(const OmsConfig& config) : symbolId_(config.symbolId) {
+    // Create ingress and event queues
+    orderQueue_ = std::make_shared<queue::OrderQueue>(config.queueSize, config.memory);
+    eventQueue_ = std::make_shared<queue::SpscRingBuffer<events::Event>>(eventQueueSize(config), config.memory);
+    waitStrategy_ = std::make_shared<queue::WaitStrategy>(config.waitStrategy);
 
     // Create core components
-    orderBook_ = std::make_shared<book::OrderBook>();
-    eventPublisher_ = std::make_shared<events::SpscEventPublisher>(eventQueue_);
-    matchingEngine_ = std::make_shared<engine::MatchingEngine>(orderBook_, eventPublisher_);
+    orderBook_ = makeOrderBook(config);
+    risk_ = makeRisk(config);
+    stops_ = std::make_shared<engine::StopBook>();
+    eventPublisher_ = std::make_shared<events::SpscEventPublisher>(eventQueue_, config.eventBatch);
+    matchingEngine_ = std::make_shared<engine::MatchingEngine>(orderBook_, eventPublisher_, symbolId_, risk_, stops_);
 
     // Create processors and handlers
-    orderProcessor_ = std::make_unique<processors::OrderProcessor>(orderQueue_, matchingEngine_);
-    inputHandler_ = std::make_unique<handlers::InputHandler>(orderQueue_);
+    orderProcessor_ = std::make_unique<processors::OrderProcessor>(
+        orderQueue_, matchingEngine_, eventPublisher_, config.processBatch, waitStrategy_, config.journal, config.cpu);
+    inputHandler_ = std::make_unique<handlers::InputHandler>(orderQueue_, waitStrategy_);
     outputHandler_ = std::make_unique<handlers::OutputHandler>(eventQueue_);
 }
 
+OrderManagementSystem::OrderManagementSystem(const OmsConfig& config, processors::ShardProcessor& shard,
+                                             std::uint32_t symbolId)
+    : shard_(&shard), symbolId_(symbolId) {
+    orderQueue_ = shard.orderQueue();
+    eventQueue_ = std::make_shared<queue::SpscRingBuffer<events::Event>>(eventQueueSize(config), config.memory);
+    waitStrategy_ = shard.waitStrategy();
+
+    orderBook_ = makeOrderBook(config);
+    risk_ = makeRisk(config);
+    stops_ = std::make_shared<engine::StopBook>();
+    eventPublisher_ = std::make_shared<events::SpscEventPublisher>(eventQueue_, config.eventBatch);
+    matchingEngine_ = std::make_shared<engine::MatchingEngine>(orderBook_, eventPublisher_, symbolId_, risk_, stops_);
+
+    inputHandler_ = std::make_unique<handlers::InputHandler>(orderQueue_, waitStrategy_);
+    outputHandler_ = std::make_unique<handlers::OutputHandler>(eventQueue_);
+    if (!shard.attach(symbolId, matchingEngine_.get(), eventPublisher_.get())) {
+        throw std::invalid_argument("symbol cannot be attached to shard");
+    }
+}
+
+OrderManagementSystem::~OrderManagementSystem() {
+    stop();
+    if (shard_) shard_->detach(symbolId_); // waits until the worker no longer sees our engine
+    if (drainer_) drainer_->detach(symbolId_); // then stop draining the now idle event queue
+}
+
 bool OrderManagementSystem::submitOrder(const core::Order& order) {
-    return inputHandler_->submitOrder(order);
+    return counted(inputHandler_->submitOrder(order));
 }
 
 bool OrderManagementSystem::submitOrder(core::Order&& order) {
-    return inputHandler_->submitOrder(std::move(order));
+    return counted(inputHandler_->submitOrder(order));
+}
+
+std::size_t OrderManagementSystem::submitOrders(const core::Order* orders, std::size_t count) {
+    const std::size_t queued = inputHandler_->submitOrders(orders, count);
+    if (queued != count) submitFull_.add(count - queued);
+    return queued;
 }
 
 bool OrderManagementSystem::cancelOrder(core::OrderId orderId) {
-    // Cancel is synchronous for now (could be queued as well)
-    return orderBook_->cancelOrder(orderId);
+    // Sequenced through the matching thread; see CancelAck/CancelReject events
+    return counted(inputHandler_->submitCancel(symbolId_, orderId));
+}
+
+bool OrderManagementSystem::amendOrder(core::OrderId orderId, core::Price newPrice, core::Quantity newQuantity) {
+    return counted(inputHandler_->submitAmend(symbolId_, orderId, newPrice, newQuantity));
 }
 
 std::optional<core::Price> OrderManagementSystem::getBestBid() const {
-    return orderBook_->findBestBid();
+    const book::TopOfBook top = matchingEngine_->image().top();
+    if (top.bidQuantity == 0) return std::nullopt;
+    return top.bidPrice;
 }
 
 std::optional<core::Price> OrderManagementSystem::getBestAsk() const {
-    return orderBook_->findBestAsk();
+    const book::TopOfBook top = matchingEngine_->image().top();
+    if (top.askQuantity == 0) return std::nullopt;
+    return top.askPrice;
 }
 
 std::vector<book::LevelSummary> OrderManagementSystem::getBidsSnapshot(std::size_t depth) const {
-    return orderBook_->snapshotBidsL2(depth);
+    book::BookImage image;
+    readBookImage(image, depth == 0 ? core::BOOK_IMAGE_DEPTH : depth);
+    return std::vector<book::LevelSummary>(image.bids.begin(), image.bids.begin() + image.bidCount);
 }
 
 std::vector<book::LevelSummary> OrderManagementSystem::getAsksSnapshot(std::size_t depth) const {
-    return orderBook_->snapshotAsksL2(depth);
+    book::BookImage image;
+    readBookImage(image, depth == 0 ? core::BOOK_IMAGE_DEPTH : depth);
+    return std::vector<book::LevelSummary>(image.asks.begin(), image.asks.begin() + image.askCount);
 }
 
 void OrderManagementSystem::processEvents() {
@@ -55,16 +142,82 @@ void OrderManagementSystem::setEventCallback(handlers::OutputHandler::EventCallb
     outputHandler_->setCallback(std::move(callback));
 }
 
+void OrderManagementSystem::attachEventDrain(processors::EventDrainer& drainer) {
+    if (drainer_) return;
+    drainer_ = &drainer;
+    drainer.attach(symbolId_, outputHandler_.get(), eventPublisher_.get());
+}
+
+std::uint64_t OrderManagementSystem::droppedEvents() const noexcept {
+    return eventPublisher_->droppedEvents();
+}
+
+void OrderManagementSystem::sampleMetrics(core::InstrumentSample& out, core::ProcessorSample* processor) const {
+    const core::EngineMetrics& engine = matchingEngine_->metrics();
+    out.symbolId = symbolId_;
+    out.orders = engine.orders.load();
+    out.cancels = engine.cancels.load();
+    out.amends = engine.amends.load();
+    out.rejects = engine.rejects.load();
+    out.trades = engine.trades.load();
+    out.tradedQuantity = engine.tradedQuantity.load();
+    out.submitFull = submitFull_.load();
+    out.bidLevels = engine.bidLevels.load();
+    out.askLevels = engine.askLevels.load();
+    out.restingOrders = engine.restingOrders.load();
+    out.stopOrders = engine.stopOrders.load();
+    out.riskRejects = risk_ ? risk_->rejects() : 0;
+    out.events = core::QueueSample{eventQueue_->size(), eventQueue_->capacity(), 0, eventPublisher_->droppedEvents()};
+    if (processor && orderProcessor_) {
+        const core::ProcessorMetrics& metrics = orderProcessor_->metrics();
+        processor->batches = metrics.batches.load();
+        processor->commands = metrics.commands.load();
+        processor->ingress = core::QueueSample{orderQueue_->size(), orderQueue_->capacity(),
+                                               metrics.ingressPeak.load(), orderQueue_->pushFailures()};
+    }
+}
+
+void OrderManagementSystem::replay(const core::Command& command) {
+    if (!replayEngine_) {
+        replayEngine_ = std::make_unique<engine::MatchingEngine>(orderBook_, nullptr, symbolId_, risk_, stops_);
+    }
+    replayEngine_->apply(command);
+}
+
+bool OrderManagementSystem::loadSnapshot(const book::SnapshotOrder* orders, std::size_t count) {
+    if (!orderBook_->loadSnapshot(orders, count)) return false;
+    if (risk_) {
+        for (std::size_t i = 0; i < count; ++i) risk_->onRested(orders[i].account, orders[i].side, orders[i].quantity);
+    }
+    return true;
+}
+
+void OrderManagementSystem::loadStops(const book::SnapshotStop* stops, std::size_t count, core::Price lastTradePrice) {
+    stops_->load(stops, count, lastTradePrice);
+}
+
+void OrderManagementSystem::loadRisk(const book::SnapshotAccount* accounts, std::size_t count, core::Price reference) {
+    if (risk_) risk_->load(accounts, count, reference);
+}
+
+bool OrderManagementSystem::requestSnapshot(book::BookSnapshot& out, std::uint64_t snapshotId) {
+    matchingEngine_->requestSnapshot(&out);
+    if (inputHandler_->submitCommand(core::Command::snapshot(symbolId_, snapshotId))) return true;
+    matchingEngine_->requestSnapshot(nullptr);
+    return false;
+}
+
+// In hosted mode the shard's lifecycle is owned by InstrumentManager
 void OrderManagementSystem::start() {
-    orderProcessor_->start();
+    if (orderProcessor_) orderProcessor_->start();
 }
 
 void OrderManagementSystem::stop() {
-    orderProcessor_->stop();
+    if (orderProcessor_) orderProcessor_->stop();
 }
 
 bool OrderManagementSystem::isRunning() const noexcept {
-    return orderProcessor_->isRunning();
+    return orderProcessor_ ? orderProcessor_->isRunning() : shard_->isRunning();
 }
 
 } // namespace ob::oms
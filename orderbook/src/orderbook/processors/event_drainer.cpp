@@ -0,0 +1,105 @@
+#include "orderbook/processors/event_drainer.hpp"
+#include "orderbook/core/affinity.hpp"
+#include "orderbook/core/async_log.hpp"
+
+#include <algorithm>
+
+namespace ob::processors {
+
+EventDrainer::EventDrainer(std::size_t index, const EventDrainConfig& config)
+    : index_(index),
+      cpu_(config.cpus.empty() ? -1 : config.cpus[index % config.cpus.size()]),
+      maxBatches_(config.maxBatchesPerSource == 0 ? 1 : config.maxBatchesPerSource),
+      onDrained_(config.onDrained),
+      waitStrategy_(config.waitStrategy) {}
+
+EventDrainer::~EventDrainer() {
+    stop();
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& source : sources_) {
+        if (source.publisher) source.publisher->setConsumerWait(nullptr);
+    }
+}
+
+void EventDrainer::attach(std::uint32_t symbolId, handlers::OutputHandler* handler,
+                          events::SpscEventPublisher* publisher) {
+    if (!handler) return;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        sources_.push_back(Source{symbolId, handler, publisher, publisher ? publisher->droppedEvents() : 0});
+    }
+    if (publisher) publisher->setConsumerWait(&waitStrategy_);
+    waitStrategy_.wakeAll(); // events may already be queued
+}
+
+void EventDrainer::detach(std::uint32_t symbolId) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = std::find_if(sources_.begin(), sources_.end(),
+                           [symbolId](const Source& s) { return s.symbolId == symbolId; });
+    if (it == sources_.end()) return;
+    if (it->publisher) it->publisher->setConsumerWait(nullptr);
+    sources_.erase(it);
+}
+
+void EventDrainer::start() {
+    if (running_.exchange(true)) {
+        return; // Already running
+    }
+    thread_ = std::thread(&EventDrainer::processLoop, this);
+}
+
+void EventDrainer::stop() {
+    if (!running_.exchange(false)) {
+        return; // Already stopped
+    }
+    waitStrategy_.wakeAll();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+std::size_t EventDrainer::drainOnce() {
+    std::size_t total = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& source : sources_) {
+            total += source.handler->processEvents(maxBatches_);
+            if (source.publisher) {
+                const std::uint64_t dropped = source.publisher->droppedEvents();
+                if (dropped != source.droppedSeen) {
+                    OB_LOG("DRAIN symbol={} dropped events total={}", source.symbolId, dropped);
+                    source.droppedSeen = dropped;
+                }
+            }
+        }
+    }
+    if (total != 0) {
+        drained_.fetch_add(total, std::memory_order_relaxed);
+        if (onDrained_) onDrained_();
+    }
+    return total;
+}
+
+bool EventDrainer::hasWork() {
+    if (!running_.load()) return true;
+    std::lock_guard<std::mutex> lock(mutex_);
+    return std::any_of(sources_.begin(), sources_.end(),
+                       [](const Source& s) { return s.handler->hasEvents(); });
+}
+
+void EventDrainer::processLoop() {
+    if (!core::pinCurrentThread(cpu_)) OB_LOG("DRAIN could not pin to cpu={}", cpu_);
+
+    std::uint32_t idleRounds = 0;
+    while (running_.load()) {
+        if (drainOnce() == 0) {
+            waitStrategy_.idle(idleRounds, [this] { return hasWork(); });
+            continue;
+        }
+        idleRounds = 0;
+    }
+    // Producers are stopped first on shutdown; hand over what they left
+    while (drainOnce() != 0) {}
+}
+
+} // namespace ob::processors
@@ -1,13 +1,26 @@
 #include "orderbook/processors/order_processor.hpp"
+#include "orderbook/core/affinity.hpp"
+#include "orderbook/core/latency_stats.hpp"
 #include "orderbook/core/log.hpp"
-#include <thread>
+#include "orderbook/core/async_log.hpp"
 
 namespace ob::processors {
 
 OrderProcessor::OrderProcessor(
-    std::shared_ptr<queue::SpscRingBuffer<core::Order>> orderQueue,
-    std::shared_ptr<engine::IMatchingEngine> matchingEngine
-) : orderQueue_(std::move(orderQueue)), matchingEngine_(std::move(matchingEngine)) {}
+    std::shared_ptr<queue::OrderQueue> orderQueue,
+    std::shared_ptr<engine::IMatchingEngine> matchingEngine,
+    std::shared_ptr<events::IEventPublisher> eventPublisher,
+    std::size_t batchSize,
+    std::shared_ptr<queue::WaitStrategy> waitStrategy,
+    journal::JournalWriter* journal,
+    int cpu
+) : orderQueue_(std::move(orderQueue)),
+    matchingEngine_(std::move(matchingEngine)),
+    eventPublisher_(std::move(eventPublisher)),
+    batch_(batchSize == 0 ? 1 : batchSize),
+    waitStrategy_(waitStrategy ? std::move(waitStrategy) : std::make_shared<queue::WaitStrategy>()),
+    journal_(journal),
+    cpu_(cpu) {}
 
 OrderProcessor::~OrderProcessor() {
     stop();
@@ -24,20 +37,44 @@ void OrderProcessor::stop() {
     if (!running_.exchange(false)) {
         return; // Already stopped
     }
+    waitStrategy_->wakeAll(); // a parked loop must see running_ == false
     if (processorThread_.joinable()) {
         processorThread_.join();
     }
 }
 
 void OrderProcessor::processLoop() {
-    core::Order order;
+    if (!core::pinCurrentThread(cpu_)) OB_LOG("PROCESSOR could not pin to cpu={}", cpu_);
+    core::nameStatsThread("processor");
+    std::uint32_t idleRounds = 0;
+    auto hasWork = [this] { return !orderQueue_->empty() || !running_.load(); };
     while (running_.load()) {
-        if (orderQueue_->tryPop(order)) {
-            matchingEngine_->process(order);
-        } else {
-            // Queue is empty, yield to avoid busy-waiting
-            std::this_thread::yield();
+        const std::size_t count = orderQueue_->tryPopN(batch_.data(), batch_.size());
+        if (count == 0) {
+            if (snapshotting_) {
+                snapshotting_ = matchingEngine_->continueSnapshot(core::DEFAULT_SNAPSHOT_STEP);
+                continue;
+            }
+            waitStrategy_->idle(idleRounds, hasWork);
+            continue;
         }
+        idleRounds = 0;
+        // Only a full pop can have left commands behind
+        metrics_.popped(count, count == batch_.size() ? orderQueue_->size() : 0);
+        if (journal_) journal_->append(batch_.data(), count);
+        std::uint64_t stamp = core::stageClock();
+        for (std::size_t i = 0; i < count; ++i) {
+            // Fills and cancel outcomes are delivered as events
+            core::recordQueueWait(batch_[i].ts, stamp);
+            matchingEngine_->apply(batch_[i]);
+            stamp = core::recordStage(core::Stage::Match, stamp);
+            snapshotting_ |= batch_[i].type == core::CommandType::Snapshot;
+        }
+        // Image first, so a client that sees its Ack also sees its order
+        matchingEngine_->publishImage();
+        if (eventPublisher_) eventPublisher_->flush();
+        core::recordStage(core::Stage::Publish, stamp);
+        if (snapshotting_) snapshotting_ = matchingEngine_->continueSnapshot(core::DEFAULT_SNAPSHOT_STEP);
     }
 }
 
@@ -0,0 +1,135 @@
+#include "orderbook/processors/shard_processor.hpp"
+#include "orderbook/core/affinity.hpp"
+#include "orderbook/core/latency_stats.hpp"
+#include "orderbook/core/async_log.hpp"
+
+namespace ob::processors {
+
+ShardProcessor::ShardProcessor(std::size_t index, const ShardConfig& config)
+    : index_(index),
+      cpu_(config.cpus.empty() ? -1 : config.cpus[index % config.cpus.size()]),
+      orderQueue_(std::make_shared<queue::OrderQueue>(config.queueSize, config.memory)),
+      waitStrategy_(std::make_shared<queue::WaitStrategy>(config.waitStrategy)),
+      batch_(config.processBatch == 0 ? 1 : config.processBatch),
+      maxSymbols_(config.maxSymbols),
+      routes_(std::make_unique<std::atomic<Route*>[]>(config.maxSymbols)) {
+    touched_.reserve(batch_.size());
+    for (std::size_t i = 0; i < maxSymbols_; ++i) {
+        routes_[i].store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+ShardProcessor::~ShardProcessor() {
+    stop();
+    for (std::size_t i = 0; i < maxSymbols_; ++i) {
+        delete routes_[i].load(std::memory_order_relaxed);
+    }
+}
+
+bool ShardProcessor::attach(std::uint32_t symbolId, engine::IMatchingEngine* engine, events::IEventPublisher* publisher) {
+    if (symbolId >= maxSymbols_ || !engine) return false;
+    auto* route = new Route{engine, publisher};
+    Route* expected = nullptr;
+    if (!routes_[symbolId].compare_exchange_strong(expected, route, std::memory_order_release)) {
+        delete route;
+        return false;
+    }
+    return true;
+}
+
+void ShardProcessor::detach(std::uint32_t symbolId) {
+    if (symbolId >= maxSymbols_) return;
+    Route* route = routes_[symbolId].exchange(nullptr, std::memory_order_acq_rel);
+    if (!route) return;
+    quiesce();
+    delete route;
+}
+
+void ShardProcessor::quiesce() {
+    if (!running_.load() || std::this_thread::get_id() == thread_.get_id()) return;
+    // Any iteration that loaded the old route ends by bumping loopEpoch_
+    const std::uint64_t target = loopEpoch_.load(std::memory_order_acquire) + 1;
+    while (running_.load() && loopEpoch_.load(std::memory_order_acquire) < target) {
+        waitStrategy_->wakeAll(); // a parked worker must run one iteration
+        std::this_thread::yield();
+    }
+}
+
+void ShardProcessor::start() {
+    if (running_.exchange(true)) {
+        return; // Already running
+    }
+    thread_ = std::thread(&ShardProcessor::processLoop, this);
+}
+
+void ShardProcessor::stop() {
+    if (!running_.exchange(false)) {
+        return; // Already stopped
+    }
+    waitStrategy_->wakeAll();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void ShardProcessor::processLoop() {
+    if (!core::pinCurrentThread(cpu_)) OB_LOG("SHARD could not pin to cpu={}", cpu_);
+    core::nameStatsThread("shard-" + std::to_string(index_));
+
+    std::uint32_t idleRounds = 0;
+    auto hasWork = [this] { return !orderQueue_->empty() || !running_.load(); };
+    while (running_.load()) {
+        const std::size_t count = orderQueue_->tryPopN(batch_.data(), batch_.size());
+        if (count == 0) {
+            if (snapshotting_.empty()) {
+                waitStrategy_->idle(idleRounds, hasWork);
+            } else {
+                continueSnapshots();
+            }
+            loopEpoch_.fetch_add(1, std::memory_order_release);
+            continue;
+        }
+        idleRounds = 0;
+        // Only a full pop can have left commands behind
+        metrics_.popped(count, count == batch_.size() ? orderQueue_->size() : 0);
+        if (auto* journal = journal_.load(std::memory_order_acquire)) journal->append(batch_.data(), count);
+        std::uint64_t stamp = core::stageClock();
+        for (std::size_t i = 0; i < count; ++i) {
+            const core::Command& command = batch_[i];
+            const Route* route = command.symbolId < maxSymbols_
+                ? routes_[command.symbolId].load(std::memory_order_acquire)
+                : nullptr;
+            if (!route) {
+                OB_LOG("SHARD drop id={} unknown symbol={}", command.orderId, command.symbolId);
+                continue;
+            }
+            core::recordQueueWait(command.ts, stamp);
+            route->engine->apply(command);
+            stamp = core::recordStage(core::Stage::Match, stamp);
+            if (command.type == core::CommandType::Snapshot) snapshotting_.push_back(command.symbolId);
+            if (touched_.empty() || touched_.back() != route) touched_.push_back(route);
+        }
+        for (const Route* route : touched_) {
+            route->engine->publishImage(); // before the events, as in OrderProcessor
+            if (route->publisher) route->publisher->flush();
+        }
+        core::recordStage(core::Stage::Publish, stamp);
+        touched_.clear();
+        if (!snapshotting_.empty()) continueSnapshots();
+        loopEpoch_.fetch_add(1, std::memory_order_release);
+    }
+}
+
+void ShardProcessor::continueSnapshots() {
+    // Routes are looked up again each time: a symbol may have been detached
+    std::size_t kept = 0;
+    for (const std::uint32_t symbolId : snapshotting_) {
+        const Route* route = routes_[symbolId].load(std::memory_order_acquire);
+        if (route && route->engine->continueSnapshot(core::DEFAULT_SNAPSHOT_STEP)) {
+            snapshotting_[kept++] = symbolId;
+        }
+    }
+    snapshotting_.resize(kept);
+}
+
+} // namespace ob::processors
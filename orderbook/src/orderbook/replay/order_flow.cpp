@@ -0,0 +1,257 @@
+#include "orderbook/replay/order_flow.hpp"
+#include "orderbook/journal/journal_reader.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+
+namespace ob::replay {
+
+namespace {
+
+std::uint32_t flowChecksum(const std::vector<FlowRecord>& records) noexcept {
+    return journal::foldHash(journal::hashBytes(journal::HASH_SEED, records.data(), records.size() * sizeof(FlowRecord)));
+}
+
+core::Timestamp offset(std::uint64_t ns) noexcept {
+    return core::Timestamp{std::chrono::nanoseconds{static_cast<std::int64_t>(ns)}};
+}
+
+// The generator's own view of the book: what it has sent and not yet
+// cancelled. It does not match, so some of its cancels and amends target
+// orders that have already traded and are rejected, as in live flow.
+struct Resting {
+    core::OrderId id;
+    core::Price price;
+    core::Quantity quantity;
+};
+
+class FlowGenerator {
+public:
+    explicit FlowGenerator(const FlowConfig& config)
+        : config_(config),
+          rng_(config.seed),
+          level_(1.0 - std::clamp(config.levelDecay, 0.0, 0.99)),
+          recent_(0.05),
+          size_(0.2),
+          mid_(std::max<core::Price>(config.referencePrice, 2)) {}
+
+    OrderFlow run() {
+        OrderFlow flow;
+        flow.referencePrice = config_.referencePrice;
+        flow.records.reserve(config_.commands);
+        for (std::size_t i = 0; i < config_.commands; ++i) {
+            ts_ += nextGap();
+            const double kind = uniform();
+            core::Command command;
+            if (!resting_.empty() && kind < config_.cancelRatio) {
+                command = cancel();
+            } else if (!resting_.empty() && kind < config_.cancelRatio + config_.amendRatio) {
+                command = amend();
+            } else {
+                command = newOrder();
+            }
+            command.symbolId = 1;
+            command.ts = offset(ts_);
+            flow.records.push_back(journal::toRecord(command));
+        }
+        return flow;
+    }
+
+private:
+    double uniform() { return std::uniform_real_distribution<double>(0.0, 1.0)(rng_); }
+
+    std::uint64_t exponential(std::uint64_t mean) {
+        if (mean == 0) return 0;
+        return static_cast<std::uint64_t>(std::exponential_distribution<double>(1.0 / static_cast<double>(mean))(rng_));
+    }
+
+    // Quiet stretches with occasional bursts of closely spaced arrivals
+    std::uint64_t nextGap() {
+        if (burstLeft_ == 0 && uniform() < config_.burstProbability) {
+            burstLeft_ = 1 + exponential(config_.burstLength);
+        }
+        if (burstLeft_ != 0) {
+            --burstLeft_;
+            return exponential(config_.burstGapNs);
+        }
+        return exponential(config_.quietGapNs);
+    }
+
+    // Recent orders are far more likely to be pulled than old ones
+    std::size_t pick() {
+        const std::size_t n = resting_.size();
+        if (uniform() < config_.recentCancelBias) {
+            const auto back = static_cast<std::size_t>(recent_(rng_));
+            return n - 1 - std::min(back, n - 1);
+        }
+        return std::uniform_int_distribution<std::size_t>(0, n - 1)(rng_);
+    }
+
+    core::Command cancel() {
+        const std::size_t i = pick();
+        const core::OrderId id = resting_[i].id;
+        resting_[i] = resting_.back();
+        resting_.pop_back();
+        return core::Command::cancel(1, id);
+    }
+
+    // Mostly size-downs, which keep queue priority; otherwise a one-tick reprice
+    core::Command amend() {
+        Resting& order = resting_[pick()];
+        if (order.quantity > 1 && uniform() < 0.7) {
+            order.quantity = std::uniform_int_distribution<core::Quantity>(1, order.quantity - 1)(rng_);
+        } else {
+            order.price = std::max<core::Price>(1, order.price + (uniform() < 0.5 ? -1 : 1));
+        }
+        return core::Command::amend(1, order.id, order.price, order.quantity);
+    }
+
+    core::Command newOrder() {
+        if (uniform() < config_.driftProbability) {
+            mid_ = std::max<core::Price>(2, mid_ + (uniform() < 0.5 ? -1 : 1));
+        }
+        core::Order order{};
+        order.orderId = nextId_++;
+        order.symbolId = 1;
+        order.side = uniform() < 0.5 ? core::Side::Buy : core::Side::Sell;
+        order.quantity = 1 + std::min<core::Quantity>(size_(rng_), 999);
+        if (uniform() < config_.marketRatio) {
+            order.type = core::OrderType::Market;
+            return core::Command::newOrder(order);
+        }
+
+        // Bids rest from mid - 1 down and asks from mid + 1 up; a crossing
+        // order is priced at or just through the opposite touch
+        const auto ticks = static_cast<core::Price>(level_(rng_));
+        const bool buy = order.side == core::Side::Buy;
+        if (uniform() < config_.crossRatio) {
+            order.price = buy ? mid_ + 1 + std::min<core::Price>(ticks, 2) : mid_ - 1 - std::min<core::Price>(ticks, 2);
+        } else {
+            order.price = buy ? mid_ - 1 - ticks : mid_ + 1 + ticks;
+        }
+        order.type = core::OrderType::Limit;
+        order.price = std::max<core::Price>(1, order.price);
+        resting_.push_back(Resting{order.orderId, order.price, order.quantity});
+        return core::Command::newOrder(order);
+    }
+
+    FlowConfig config_;
+    std::mt19937_64 rng_;
+    std::geometric_distribution<int> level_;          // ticks from the touch
+    std::geometric_distribution<std::size_t> recent_; // places from the newest order
+    std::geometric_distribution<core::Quantity> size_;
+    std::vector<Resting> resting_;
+    core::Price mid_;
+    core::OrderId nextId_{1};
+    std::uint64_t ts_{0};
+    std::uint64_t burstLeft_{0};
+};
+
+} // namespace
+
+OrderFlow generateFlow(const FlowConfig& config) {
+    return FlowGenerator(config).run();
+}
+
+OrderFlow extractFlow(const std::string& journalDirectory, std::uint32_t symbolId) {
+    OrderFlow flow;
+    std::unordered_map<std::uint32_t, double> initialPrices;
+    journal::JournalReader reader(journalDirectory);
+    journal::JournalRecord record;
+    std::int64_t first = 0;
+    std::int64_t last = 0;
+    while (reader.next(record)) {
+        if (record.type == journal::RecordType::InstrumentAdded) {
+            initialPrices[record.instrument.symbolId] = record.instrument.initialPrice;
+            continue;
+        }
+        if (record.type != journal::RecordType::Command) continue;
+        core::Command& command = record.command;
+        if (command.type == core::CommandType::Snapshot) continue;
+        if (symbolId == 0) symbolId = command.symbolId;
+        if (command.symbolId != symbolId) continue;
+
+        // Only new orders carry an arrival time; cancels and amends take
+        // the previous one
+        const std::int64_t ts = command.ts.time_since_epoch().count();
+        if (first == 0 && ts != 0) first = last = ts;
+        last = std::max(last, ts);
+        command.ts = offset(static_cast<std::uint64_t>(last - first));
+        flow.records.push_back(journal::toRecord(command));
+        if (flow.referencePrice == 0 && command.type == core::CommandType::NewOrder) flow.referencePrice = command.price;
+    }
+    const auto initial = initialPrices.find(symbolId);
+    if (initial != initialPrices.end() && initial->second > 0.0) {
+        flow.referencePrice = static_cast<core::Price>(std::llround(initial->second));
+    }
+    return flow;
+}
+
+void writeFlow(const std::string& path, const OrderFlow& flow) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        throw std::runtime_error("Failed to create flow file " + path);
+    }
+    FlowHeader header;
+    header.count = flow.records.size();
+    header.referencePrice = flow.referencePrice;
+    header.checksum = flowChecksum(flow.records);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(flow.records.data()),
+              static_cast<std::streamsize>(flow.records.size() * sizeof(FlowRecord)));
+    if (!out.flush()) {
+        throw std::runtime_error("Failed to write flow file " + path);
+    }
+}
+
+OrderFlow readFlow(const std::string& path) {
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in) {
+        throw std::runtime_error("Failed to open flow file " + path);
+    }
+    const auto size = static_cast<std::uint64_t>(in.tellg());
+    in.seekg(0);
+    FlowHeader header;
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)) || header.magic != FLOW_MAGIC ||
+        header.version == 0 || header.version > FLOW_VERSION || header.headerSize < sizeof(FlowHeader) ||
+        header.headerSize > size) {
+        throw std::runtime_error("Not a flow file: " + path);
+    }
+    const std::size_t recordBytes = header.version == 1   ? journal::COMMAND_RECORD_V1_SIZE
+                                    : header.version == 2 ? journal::COMMAND_RECORD_V2_SIZE
+                                                          : sizeof(FlowRecord);
+    if (header.count > (size - header.headerSize) / recordBytes) {
+        throw std::runtime_error("Truncated flow file " + path);
+    }
+    in.seekg(header.headerSize);
+
+    OrderFlow flow;
+    flow.referencePrice = header.referencePrice;
+    flow.records.resize(static_cast<std::size_t>(header.count));
+    if (recordBytes == sizeof(FlowRecord)) {
+        if (!in.read(reinterpret_cast<char*>(flow.records.data()),
+                     static_cast<std::streamsize>(flow.records.size() * sizeof(FlowRecord))) ||
+            flowChecksum(flow.records) != header.checksum) {
+            throw std::runtime_error("Truncated or corrupt flow file " + path);
+        }
+        return flow;
+    }
+    // Versions 1 and 2: shorter records, checksummed as stored
+    std::vector<char> raw(flow.records.size() * recordBytes);
+    if (!in.read(raw.data(), static_cast<std::streamsize>(raw.size())) ||
+        journal::foldHash(journal::hashBytes(journal::HASH_SEED, raw.data(), raw.size())) != header.checksum) {
+        throw std::runtime_error("Truncated or corrupt flow file " + path);
+    }
+    for (std::size_t i = 0; i < flow.records.size(); ++i) {
+        std::memcpy(&flow.records[i], raw.data() + i * recordBytes, recordBytes);
+    }
+    return flow;
+}
+
+} // namespace ob::replay
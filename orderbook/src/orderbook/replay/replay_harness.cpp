@@ -0,0 +1,198 @@
+#include "orderbook/replay/replay_harness.hpp"
+#include "orderbook/book/order_book.hpp"
+#include "orderbook/book/ladder_order_book.hpp"
+#include "orderbook/engine/matching_engine.hpp"
+#include "orderbook/events/event_publisher.hpp"
+#include "orderbook/oms/order_management_system.hpp"
+
+#include <deque>
+#include <memory>
+#include <thread>
+
+namespace ob::replay {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr std::uint32_t REPLAY_SYMBOL = 1;
+constexpr std::size_t REPLAY_EVENT_QUEUE = 1 << 16;
+constexpr auto DRAIN_TIMEOUT = std::chrono::seconds(5);
+
+bool isReject(events::EventType type) noexcept {
+    return type == events::EventType::Reject || type == events::EventType::CancelReject ||
+           type == events::EventType::AmendReject;
+}
+
+// Counts what the engine reports; delivers nothing
+class CountingPublisher final : public events::IEventPublisher {
+public:
+    bool publish(const events::Event& event) override {
+        count(event);
+        return true;
+    }
+    bool publish(events::Event&& event) override {
+        count(event);
+        return true;
+    }
+
+    std::uint64_t trades{0};
+    std::uint64_t rejects{0};
+
+private:
+    void count(const events::Event& event) noexcept {
+        trades += event.type == events::EventType::Trade;
+        rejects += isReject(event.type);
+    }
+};
+
+std::shared_ptr<book::IOrderBook> makeBook(const ReplayConfig& config, core::Price referencePrice) {
+    if (config.bookType == book::BookType::Ladder) {
+        return std::make_shared<book::LadderOrderBook>(referencePrice, config.ladderLevels);
+    }
+    return std::make_shared<book::OrderBook>();
+}
+
+core::Command replayCommand(const FlowRecord& record) noexcept {
+    core::Command command = journal::toCommand(record);
+    command.symbolId = REPLAY_SYMBOL;
+    return command;
+}
+
+// Release times: recorded arrival offsets scaled by 1 / speed
+class Schedule {
+public:
+    Schedule(double speed, Clock::time_point start) : speed_(speed), start_(start) {}
+
+    bool paced() const noexcept { return speed_ > 0.0; }
+
+    Clock::time_point releaseOf(const FlowRecord& record) const noexcept {
+        const auto offset = static_cast<double>(record.ts) / speed_;
+        return start_ + std::chrono::nanoseconds(static_cast<std::int64_t>(offset));
+    }
+
+    // Spins the last few microseconds, yields before that; idle() runs
+    // while waiting
+    template <typename Idle>
+    static void waitUntil(Clock::time_point release, Idle&& idle) {
+        for (Clock::time_point now = Clock::now(); now < release; now = Clock::now()) {
+            idle();
+            if (release - now > std::chrono::microseconds(20)) std::this_thread::yield();
+        }
+    }
+
+private:
+    double speed_;
+    Clock::time_point start_;
+};
+
+ReplayResult replayEngine(const OrderFlow& flow, const ReplayConfig& config) {
+    auto publisher = std::make_shared<CountingPublisher>();
+    engine::MatchingEngine engine(makeBook(config, flow.referencePrice), publisher, REPLAY_SYMBOL);
+    ReplayResult result;
+
+    const Clock::time_point start = Clock::now();
+    const Schedule schedule(config.speed, start);
+    for (const FlowRecord& record : flow.records) {
+        const core::Command command = replayCommand(record);
+        Clock::time_point from;
+        if (schedule.paced()) {
+            from = schedule.releaseOf(record);
+            Schedule::waitUntil(from, [] {});
+            result.maxLag = std::max(result.maxLag, std::chrono::nanoseconds(Clock::now() - from));
+        } else {
+            from = Clock::now();
+        }
+        engine.apply(command);
+        result.latency.record(static_cast<std::uint64_t>(std::chrono::nanoseconds(Clock::now() - from).count()));
+    }
+    result.elapsed = Clock::now() - start;
+    result.commands = flow.records.size();
+    result.trades = publisher->trades;
+    result.rejects = publisher->rejects;
+    return result;
+}
+
+// Every command gets exactly one first report (Ack or Reject for an order,
+// CancelAck/Reject, AmendAck/Reject) and the matching thread sends them in
+// command order, so a FIFO of release times pairs each report with its
+// command without a per-order lookup
+ReplayResult replayOms(const OrderFlow& flow, const ReplayConfig& config) {
+    struct Pending {
+        core::OrderId orderId;
+        Clock::time_point from;
+    };
+
+    oms::OmsConfig omsConfig;
+    omsConfig.bookType = config.bookType;
+    omsConfig.referencePrice = flow.referencePrice;
+    omsConfig.ladderLevels = config.ladderLevels;
+    omsConfig.waitStrategy = config.waitStrategy;
+    omsConfig.eventQueueSize = REPLAY_EVENT_QUEUE;
+    omsConfig.symbolId = REPLAY_SYMBOL;
+    oms::OrderManagementSystem oms(omsConfig);
+
+    ReplayResult result;
+    std::deque<Pending> pending;
+    oms.setEventCallback([&](const events::Event& event) {
+        if (event.type == events::EventType::Trade) {
+            ++result.trades;
+            return;
+        }
+        // A second report for the same command (an amend's requeue that is
+        // rejected) finds another command at the front and is not paired
+        if (pending.empty() || pending.front().orderId != event.orderId) return;
+        result.latency.record(
+            static_cast<std::uint64_t>(std::chrono::nanoseconds(Clock::now() - pending.front().from).count()));
+        pending.pop_front();
+        result.rejects += isReject(event.type);
+    });
+    oms.start();
+
+    const Clock::time_point start = Clock::now();
+    const Schedule schedule(config.speed, start);
+    auto drain = [&oms] { oms.processEvents(); };
+    for (const FlowRecord& record : flow.records) {
+        const core::Command command = replayCommand(record);
+        Clock::time_point from;
+        if (schedule.paced()) {
+            from = schedule.releaseOf(record);
+            Schedule::waitUntil(from, drain);
+            result.maxLag = std::max(result.maxLag, std::chrono::nanoseconds(Clock::now() - from));
+        } else {
+            from = Clock::now();
+        }
+        pending.push_back(Pending{command.orderId, from});
+
+        auto submit = [&] {
+            switch (command.type) {
+                case core::CommandType::NewOrder: return oms.submitOrder(command.toOrder());
+                case core::CommandType::Cancel:   return oms.cancelOrder(command.orderId);
+                case core::CommandType::Amend:    return oms.amendOrder(command.orderId, command.price, command.quantity);
+                case core::CommandType::Snapshot: break;
+            }
+            return true;
+        };
+        while (!submit()) drain();
+        drain();
+    }
+
+    const Clock::time_point deadline = Clock::now() + DRAIN_TIMEOUT;
+    while (!pending.empty() && Clock::now() < deadline) {
+        oms.processEvents();
+        std::this_thread::yield();
+    }
+    result.elapsed = Clock::now() - start;
+    result.commands = flow.records.size();
+    result.unanswered = pending.size();
+    oms.stop();
+    return result;
+}
+
+} // namespace
+
+ReplayResult replayFlow(const OrderFlow& flow, const ReplayConfig& config) {
+    return config.target == ReplayTarget::Oms ? replayOms(flow, config) : replayEngine(flow, config);
+}
+
+} // namespace ob::replay
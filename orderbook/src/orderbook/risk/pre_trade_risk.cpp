@@ -0,0 +1,234 @@
+#include "orderbook/risk/pre_trade_risk.hpp"
+
+#include <algorithm>
+#include <bit>
+
+namespace ob::risk {
+
+namespace {
+
+constexpr std::uint64_t HASH_MULTIPLIER = 0x9E3779B97F4A7C15ull; // 2^64 / golden ratio
+
+std::size_t homeSlot(std::uint32_t key, std::size_t mask) noexcept {
+    return static_cast<std::size_t>((key * HASH_MULTIPLIER) >> 32) & mask;
+}
+
+// Room for maxAccounts at a load of at most 3/4
+std::size_t tableSize(std::size_t maxAccounts) {
+    const std::size_t wanted = std::max<std::size_t>(maxAccounts, 1);
+    return std::bit_ceil(wanted + wanted / 3 + 1);
+}
+
+} // namespace
+
+PreTradeRisk::PreTradeRisk(const RiskLimits& limits, core::Price referencePrice)
+    : limits_(limits), reference_(referencePrice), accounts_(tableSize(limits.maxAccounts)),
+      mask_(accounts_.size() - 1) {
+    limits_.maxAccounts = std::max<std::size_t>(limits_.maxAccounts, 1);
+}
+
+std::size_t PreTradeRisk::slot(std::uint32_t key) const noexcept {
+    std::size_t i = homeSlot(key, mask_);
+    while (accounts_[i].key != key && accounts_[i].key != 0) i = (i + 1) & mask_;
+    return i;
+}
+
+PreTradeRisk::Account* PreTradeRisk::find(std::uint32_t account, bool claim) noexcept {
+    const std::uint32_t key = account + 1;
+    std::size_t i = slot(key);
+    if (accounts_[i].key == key) return &accounts_[i];
+    if (!claim) return nullptr;
+    if (used_ == limits_.maxAccounts) {
+        if (!reclaim()) return nullptr;
+        i = slot(key); // entries may have moved
+    }
+    accounts_[i].key = key;
+    ++used_;
+    return &accounts_[i];
+}
+
+// Nothing the next check would read differs from a fresh slot
+bool PreTradeRisk::idle(const Account& account) const noexcept {
+    return account.openOrders == 0 && account.openBuy == 0 && account.openSell == 0 && account.position == 0 &&
+           windowOver(account, now_);
+}
+
+// Arrival times are steady clock, so a window restored from a snapshot
+// taken before a reboot can lie far in the future: over as well. Arrivals
+// a little out of order across sessions still count against it.
+bool PreTradeRisk::windowOver(const Account& account, std::int64_t now) const noexcept {
+    const std::int64_t window = limits_.rateWindow.count();
+    return account.windowMessages == 0 || now - account.windowStart >= window ||
+           account.windowStart - now >= window;
+}
+
+bool PreTradeRisk::reclaim() noexcept {
+    const std::size_t before = used_;
+    for (std::size_t i = 0; i < accounts_.size();) {
+        if (accounts_[i].key != 0 && idle(accounts_[i])) {
+            erase(i); // may pull a later entry into i: look at it again
+        } else {
+            ++i;
+        }
+    }
+    return used_ != before;
+}
+
+// Backward-shift deletion, so probes need no tombstones: later entries of
+// the probe run move up into the hole unless that would put them before
+// their home slot
+void PreTradeRisk::erase(std::size_t index) noexcept {
+    std::size_t hole = index;
+    for (std::size_t j = (index + 1) & mask_; accounts_[j].key != 0; j = (j + 1) & mask_) {
+        const std::size_t home = homeSlot(accounts_[j].key, mask_);
+        if (((j - home) & mask_) >= ((j - hole) & mask_)) {
+            accounts_[hole] = accounts_[j];
+            hole = j;
+        }
+    }
+    accounts_[hole] = Account{};
+    --used_;
+}
+
+RiskReject PreTradeRisk::reject(RiskReject reason) noexcept {
+    rejects_.counts[static_cast<std::size_t>(reason)].add();
+    return reason;
+}
+
+RiskReject PreTradeRisk::checkPrice(core::Price price, core::Quantity quantity, core::OrderType type) const noexcept {
+    if (limits_.maxOrderQuantity != 0 && quantity > limits_.maxOrderQuantity) return RiskReject::OrderSize;
+    // Market and stop orders carry no usable price; value them at the reference
+    const bool unpriced = type == core::OrderType::Market || type == core::OrderType::Stop;
+    const core::Price valuation = unpriced ? reference_ : price;
+    if (limits_.maxOrderNotional != 0 && valuation > 0 && quantity > limits_.maxOrderNotional / valuation) {
+        return RiskReject::Notional;
+    }
+    if (limits_.priceCollarBps != 0 && type == core::OrderType::Limit && reference_ > 0) {
+        const core::Price distance = price > reference_ ? price - reference_ : reference_ - price;
+        if (static_cast<double>(distance) * 10'000.0 > static_cast<double>(reference_) * limits_.priceCollarBps) {
+            return RiskReject::PriceCollar;
+        }
+    }
+    return RiskReject::None;
+}
+
+// Worst case if every open order on that side fills as well
+bool PreTradeRisk::withinPosition(const Account& account, core::Side side, core::Quantity quantity) const noexcept {
+    const core::Quantity committed = side == core::Side::Buy ? account.position + account.openBuy
+                                                             : account.openSell - account.position;
+    return quantity <= limits_.maxPosition - committed;
+}
+
+bool PreTradeRisk::throttled(Account& account, core::Timestamp arrival) noexcept {
+    const std::int64_t now = arrival.time_since_epoch().count();
+    if (windowOver(account, now)) {
+        account.windowStart = now;
+        account.windowMessages = 0;
+    }
+    if (account.windowMessages >= limits_.maxMessages) return true;
+    ++account.windowMessages;
+    return false;
+}
+
+RiskReject PreTradeRisk::checkOrder(const core::Order& order, core::Timestamp arrival) noexcept {
+    now_ = arrival.time_since_epoch().count();
+    Account* account = find(order.account, true);
+    if (!account) return reject(RiskReject::Accounts);
+    if (limits_.maxMessages != 0 && throttled(*account, arrival)) return reject(RiskReject::Rate);
+    const RiskReject priced = checkPrice(order.price, order.quantity, order.type);
+    if (priced != RiskReject::None) return reject(priced);
+    // Only limit and stop-limit orders left to stand may rest
+    const bool mayRest = (order.type == core::OrderType::Limit || order.type == core::OrderType::StopLimit) &&
+                         order.tif != core::TimeInForce::ImmediateOrCancel &&
+                         order.tif != core::TimeInForce::FillOrKill;
+    if (limits_.maxOpenOrders != 0 && mayRest && account->openOrders >= limits_.maxOpenOrders) {
+        return reject(RiskReject::OpenOrders);
+    }
+    if (limits_.maxPosition != 0 && !withinPosition(*account, order.side, order.quantity)) {
+        return reject(RiskReject::Position);
+    }
+    return RiskReject::None;
+}
+
+RiskReject PreTradeRisk::checkAmend(const core::Order& resting, core::Price newPrice, core::Quantity newQuantity,
+                                    core::Timestamp arrival) noexcept {
+    now_ = arrival.time_since_epoch().count();
+    Account* account = find(resting.account, true);
+    if (!account) return reject(RiskReject::Accounts);
+    if (limits_.maxMessages != 0 && throttled(*account, arrival)) return reject(RiskReject::Rate);
+    const RiskReject priced = checkPrice(newPrice, newQuantity, core::OrderType::Limit);
+    if (priced != RiskReject::None) return reject(priced);
+    // Only a size-up adds exposure; the order is already counted as open
+    const core::Quantity added = newQuantity - resting.quantity;
+    if (limits_.maxPosition != 0 && added > 0 && !withinPosition(*account, resting.side, added)) {
+        return reject(RiskReject::Position);
+    }
+    return RiskReject::None;
+}
+
+void PreTradeRisk::onRested(std::uint32_t accountId, core::Side side, core::Quantity quantity) noexcept {
+    Account* account = find(accountId, true);
+    if (!account) return;
+    ++account->openOrders;
+    (side == core::Side::Buy ? account->openBuy : account->openSell) += quantity;
+}
+
+void PreTradeRisk::onRemoved(std::uint32_t accountId, core::Side side, core::Quantity quantity) noexcept {
+    Account* account = find(accountId, false);
+    if (!account) return;
+    if (account->openOrders != 0) --account->openOrders;
+    (side == core::Side::Buy ? account->openBuy : account->openSell) -= quantity;
+}
+
+void PreTradeRisk::onReduced(std::uint32_t accountId, core::Side side, core::Quantity quantity) noexcept {
+    Account* account = find(accountId, false);
+    if (!account) return;
+    (side == core::Side::Buy ? account->openBuy : account->openSell) -= quantity;
+}
+
+void PreTradeRisk::onFill(std::uint32_t accountId, core::Side side, core::Price price, core::Quantity quantity,
+                          bool maker, bool filled) noexcept {
+    reference_ = price;
+    Account* account = find(accountId, true);
+    if (!account) return;
+    account->position += side == core::Side::Buy ? quantity : -quantity;
+    if (!maker) return;
+    (side == core::Side::Buy ? account->openBuy : account->openSell) -= quantity;
+    if (filled && account->openOrders != 0) --account->openOrders;
+}
+
+// Open orders are left out: they come back with the book's resting orders
+void PreTradeRisk::copyTo(std::vector<book::SnapshotAccount>& out, core::Price& reference) const {
+    out.clear();
+    for (const Account& account : accounts_) {
+        if (account.key == 0 || (account.position == 0 && account.windowMessages == 0)) continue;
+        out.push_back(book::SnapshotAccount{account.key - 1, account.windowMessages, account.position,
+                                            account.windowStart});
+    }
+    reference = reference_;
+}
+
+void PreTradeRisk::load(const book::SnapshotAccount* accounts, std::size_t count, core::Price reference) noexcept {
+    if (reference > 0) reference_ = reference;
+    for (std::size_t i = 0; i < count; ++i) {
+        Account* account = find(accounts[i].account, true);
+        if (!account) continue; // maxAccounts lowered since the snapshot
+        account->position = accounts[i].position;
+        account->windowMessages = accounts[i].windowMessages;
+        account->windowStart = accounts[i].windowStart;
+    }
+}
+
+PreTradeRisk::Exposure PreTradeRisk::exposure(std::uint32_t account) const noexcept {
+    const Account& entry = accounts_[slot(account + 1)];
+    if (entry.key != account + 1) return {};
+    return Exposure{entry.position, entry.openBuy, entry.openSell, entry.openOrders};
+}
+
+std::uint64_t PreTradeRisk::rejects() const noexcept {
+    std::uint64_t total = 0;
+    for (const core::Counter& count : rejects_.counts) total += count.load();
+    return total;
+}
+
+} // namespace ob::risk
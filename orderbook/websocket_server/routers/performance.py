@@ -1,13 +1,23 @@
 """Performance metrics REST endpoints."""
 
+import time
+
 from fastapi import APIRouter
 
+from state import ob_client
+
 router = APIRouter(prefix="/api/performance", tags=["Performance"])
 
 # Performance metrics will be injected via dependency or passed at router registration
 # For now, we use a module-level variable that will be set by server.py
 _performance_metrics = None
 
+# Ingress fill ratio above which a processor is reported as backpressured
+INGRESS_WARN_RATIO = 0.5
+
+# Previous METRICS sample, to turn the engine's counters into rates
+_last_engine_sample = None
+
 
 def set_performance_metrics(metrics):
     """Set the performance metrics instance."""
@@ -27,3 +37,58 @@ async def get_performance_metrics():
             return {"error": "Performance metrics not available"}
     return _performance_metrics.get_stats()
 
+
+def _rate(current, previous, key, elapsed):
+    if previous is None or elapsed <= 0:
+        return 0.0
+    return max(0, current.get(key, 0) - previous.get(key, 0)) / elapsed
+
+
+@router.get("/engine")
+async def get_engine_metrics():
+    """Get the engine's counters and queue depths, with rates since the last call.
+
+    A processor is flagged when its ingress queue is more than half full, or
+    has refused a push since the last call; an instrument when orders were
+    refused or events dropped since the last call.
+    """
+    global _last_engine_sample
+    metrics = ob_client.get_metrics()
+    if metrics.get("status") != "success":
+        return metrics
+
+    now = time.time()
+    previous, elapsed = None, 0.0
+    if _last_engine_sample is not None:
+        previous, elapsed = _last_engine_sample[1], now - _last_engine_sample[0]
+    _last_engine_sample = (now, metrics)
+
+    alerts = []
+    for name, proc in metrics["processors"].items():
+        before = previous["processors"].get(name) if previous else None
+        capacity = proc.get("ingress_capacity", 0)
+        fill = proc.get("ingress_depth", 0) / capacity if capacity else 0.0
+        proc["ingress_fill"] = round(fill, 4)
+        proc["commands_per_sec"] = round(_rate(proc, before, "commands", elapsed), 1)
+        refused = proc.get("ingress_full", 0) - (before or {}).get("ingress_full", 0)
+        if fill > INGRESS_WARN_RATIO:
+            alerts.append(f"{name}: ingress queue {fill:.0%} full")
+        if before is not None and refused > 0:
+            alerts.append(f"{name}: {refused} pushes refused by a full ingress queue")
+
+    for symbol_id, inst in metrics["instruments"].items():
+        before = previous["instruments"].get(symbol_id) if previous else None
+        inst["orders_per_sec"] = round(_rate(inst, before, "orders", elapsed), 1)
+        inst["trades_per_sec"] = round(_rate(inst, before, "trades", elapsed), 1)
+        if before is None:
+            continue
+        refused = inst.get("submit_full", 0) - before.get("submit_full", 0)
+        dropped = inst.get("events_dropped", 0) - before.get("events_dropped", 0)
+        if refused > 0:
+            alerts.append(f"instrument {symbol_id}: {refused} requests refused with queue full")
+        if dropped > 0:
+            alerts.append(f"instrument {symbol_id}: {dropped} events dropped")
+
+    metrics["interval_sec"] = round(elapsed, 3)
+    metrics["alerts"] = alerts
+    return metrics
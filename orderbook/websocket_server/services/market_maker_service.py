@@ -127,30 +127,30 @@ class MarketMakerService:
             levels = self.levels
             label = "normal"
         
+        quotes = []
         for level in range(1, levels + 1):
             offset = spread + (level - 1) * self.tick_size
             bid_price = max(1.0, mid_price - offset)
             ask_price = max(bid_price + self.tick_size, mid_price + offset)
-            
-            bid_order = self.ob_client.add_order(symbol_id, "BUY", "LIMIT", bid_price, qty)
-            if bid_order.get("status") == "success":
-                order_id = int(bid_order.get("orderId", 0))
-                bids.append(order_id)
-                logger.debug("Market maker [%s] placed BUY order: %d @ %.2f qty=%d (%s)", 
-                            symbol_id, order_id, bid_price, qty, label)
-            else:
-                logger.warning("Market maker [%s] failed to place BUY order @ %.2f: %s", 
-                             symbol_id, bid_price, bid_order.get("message", "unknown error"))
-            
-            ask_order = self.ob_client.add_order(symbol_id, "SELL", "LIMIT", ask_price, qty)
-            if ask_order.get("status") == "success":
-                order_id = int(ask_order.get("orderId", 0))
-                asks.append(order_id)
-                logger.debug("Market maker [%s] placed SELL order: %d @ %.2f qty=%d (%s)", 
-                            symbol_id, order_id, ask_price, qty, label)
+            quotes.append({"symbol_id": symbol_id, "side": "BUY", "order_type": "LIMIT", "price": bid_price, "quantity": qty})
+            quotes.append({"symbol_id": symbol_id, "side": "SELL", "order_type": "LIMIT", "price": ask_price, "quantity": qty})
+        
+        # Every level in one BATCH round trip
+        batch = self.ob_client.add_orders(quotes)
+        if batch.get("status") != "success":
+            logger.warning("Market maker [%s] failed to place quotes: %s",
+                           symbol_id, batch.get("message", "unknown error"))
+            return
+        for quote, result in zip(quotes, batch["results"]):
+            side, price = quote["side"], quote["price"]
+            if result.get("status") == "success":
+                order_id = int(result.get("orderId", 0))
+                (bids if side == "BUY" else asks).append(order_id)
+                logger.debug("Market maker [%s] placed %s order: %d @ %.2f qty=%d (%s)", 
+                            symbol_id, side, order_id, price, qty, label)
             else:
-                logger.warning("Market maker [%s] failed to place SELL order @ %.2f: %s", 
-                             symbol_id, ask_price, ask_order.get("message", "unknown error"))
+                logger.warning("Market maker [%s] failed to place %s order @ %.2f: %s", 
+                             symbol_id, side, price, result.get("message", "unknown error"))
         
         self._active_orders[symbol_id] = {"buy": bids, "sell": asks}
         
@@ -8,10 +8,35 @@ from __future__ import annotations
 import socket
 import threading
 import time
-from typing import Any, Dict, Optional
+from typing import Any, Dict, List, Optional
 from collections import deque
 
 
+def _response_complete(response: bytes) -> bool:
+    """True once a reply to one command has fully arrived."""
+    # A BATCH reply carries an OK/ERROR line per order: wait for its END
+    if response.startswith(b"BATCH"):
+        return response.endswith(b"END\n")
+    return any(marker in response for marker in (b"END\n", b"OK", b"ERROR", b"NOTFOUND"))
+
+
+_ORDER_TYPES = {"LIMIT": "L", "MARKET": "M", "STOP": "S", "STOP_LIMIT": "T"}
+
+
+def _order_fields(symbol_id: int, side: str, order_type: str, price: float, quantity: float,
+                  time_in_force: Optional[str] = None, stop_price: Optional[float] = None) -> str:
+    """The ADD / BATCH entry fields of one order."""
+    type_char = _ORDER_TYPES.get(order_type.upper(), "M")
+    side_char = "B" if side.upper() == "BUY" else "S"
+    price_int = int(price) if type_char in ("L", "T") else 0
+    fields = f"{symbol_id} {side_char} {type_char} {price_int} {int(quantity)}"
+    if type_char in ("S", "T"):
+        fields += f" {int(stop_price or 0)}"
+    if time_in_force:
+        fields += f" {time_in_force.upper()}"
+    return fields
+
+
 class ConnectionPool:
     """Thread-safe connection pool for TCP connections."""
     
@@ -158,7 +183,7 @@ class OrderBookClient:
                     if not chunk:
                         break
                     response += chunk
-                    if any(marker in response for marker in (b"END\n", b"OK", b"ERROR", b"NOTFOUND")):
+                    if _response_complete(response):
                         break
                 
                 # Return connection to pool
@@ -217,7 +242,7 @@ class OrderBookClient:
                     if not chunk:
                         break
                     response += chunk
-                    if any(marker in response for marker in (b"END\n", b"OK", b"ERROR", b"NOTFOUND")):
+                    if _response_complete(response):
                         break
 
                 return response.decode("utf-8", errors="ignore")
@@ -233,14 +258,42 @@ class OrderBookClient:
         """Alias for clarity when called externally."""
         return self._send_raw_command(command)
 
-    def add_order(self, symbol_id: int, side: str, order_type: str, price: float, quantity: float) -> Dict[str, Any]:
-        """Add order to orderbook."""
-        side_char = "B" if side.upper() == "BUY" else "S"
-        type_char = "L" if order_type.upper() == "LIMIT" else "M"
-        price_int = int(price) if order_type.upper() == "LIMIT" else 0
-        qty_int = int(quantity)
+    def add_orders(self, orders: List[Dict[str, Any]]) -> Dict[str, Any]:
+        """Add several orders in one BATCH round trip.
+
+        Each order has symbol_id, side, order_type, price and quantity, and
+        optionally time_in_force and stop_price, as for add_order. Returns one result per order, in the same order.
+        """
+        entries = [
+            _order_fields(order["symbol_id"], order["side"], order["order_type"], order.get("price", 0),
+                          order["quantity"], order.get("time_in_force"), order.get("stop_price"))
+            for order in orders
+        ]
+
+        response = self._send_raw_command("BATCH " + ";".join(entries))
+        lines = response.strip().split("\n")
+        if not lines or not lines[0].startswith("BATCH"):
+            return {"status": "error", "message": response.strip() or "Invalid response"}
 
-        cmd = f"ADD {symbol_id} {side_char} {type_char} {price_int} {qty_int}"
+        results = []
+        for line in lines[1:]:
+            if line == "END":
+                break
+            if line.startswith("OK"):
+                parts = line.split()
+                results.append({"status": "success", "orderId": parts[1] if len(parts) > 1 else "0"})
+            else:
+                results.append({"status": "error", "message": line.strip()})
+        return {"status": "success", "results": results}
+
+    def add_order(self, symbol_id: int, side: str, order_type: str, price: float, quantity: float,
+                  time_in_force: Optional[str] = None, stop_price: Optional[float] = None) -> Dict[str, Any]:
+        """Add order to orderbook.
+
+        order_type is LIMIT, MARKET, STOP or STOP_LIMIT (STOP and STOP_LIMIT
+        need stop_price); time_in_force is GTC (default), IOC, FOK or POST.
+        """
+        cmd = "ADD " + _order_fields(symbol_id, side, order_type, price, quantity, time_in_force, stop_price)
         response = self._send_raw_command(cmd)
 
         if response.startswith("OK"):
@@ -321,3 +374,30 @@ class OrderBookClient:
         except Exception as exc:
             return {"status": "error", "message": str(exc)}
 
+
+    def get_metrics(self) -> Dict[str, Any]:
+        """Get engine counters and queue depths (the METRICS command)."""
+        response = self._send_raw_command("METRICS")
+        lines = response.strip().split("\n")
+        if not lines or lines[0].strip() != "METRICS":
+            return {"status": "error", "message": response.strip() or "Invalid response"}
+
+        processors: Dict[str, Dict[str, Any]] = {}
+        instruments: Dict[int, Dict[str, Any]] = {}
+        for line in lines[1:]:
+            parts = line.split()
+            if len(parts) < 2 or parts[0] not in ("processor", "instrument"):
+                continue
+            fields: Dict[str, Any] = {}
+            for part in parts[2:]:
+                key, _, value = part.partition("=")
+                fields[key] = int(value) if value.isdigit() else value
+            if parts[0] == "processor":
+                processors[parts[1]] = fields
+            else:
+                try:
+                    instruments[int(parts[1])] = fields
+                except ValueError:
+                    pass
+
+        return {"status": "success", "processors": processors, "instruments": instruments}